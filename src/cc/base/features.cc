@@ -4,7 +4,10 @@
 
 #include "cc/base/features.h"
 
+#include <algorithm>
+
 #include "base/feature_list.h"
+#include "base/metrics/field_trial_params.h"
 #include "build/build_config.h"
 
 namespace features {
@@ -74,4 +77,40 @@ bool IsDocumentTransitionEnabled() {
   return base::FeatureList::IsEnabled(kDocumentTransition);
 }
 
+const base::Feature kParallelSoftwareRaster{"ParallelSoftwareRaster",
+                                            base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::FeatureParam<int> kParallelSoftwareRasterMaxBands{
+    &kParallelSoftwareRaster, "max_bands", 4};
+
+int GetMaxSoftwareRasterPlaybackBands() {
+  if (!base::FeatureList::IsEnabled(kParallelSoftwareRaster))
+    return 1;
+  return std::max(1, kParallelSoftwareRasterMaxBands.Get());
+}
+
+const base::Feature kParallelDrawProperties{"ParallelDrawProperties",
+                                            base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::FeatureParam<int> kParallelDrawPropertiesMaxWorkers{
+    &kParallelDrawProperties, "max_workers", 4};
+
+int GetMaxDrawPropertiesWorkers() {
+  if (!base::FeatureList::IsEnabled(kParallelDrawProperties))
+    return 1;
+  return std::max(1, kParallelDrawPropertiesMaxWorkers.Get());
+}
+
+const base::Feature kTileRasterCache{"TileRasterCache",
+                                     base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::FeatureParam<int> kTileRasterCacheMaxTiles{&kTileRasterCache,
+                                                       "max_tiles", 64};
+
+size_t GetMaxRasterCacheTiles() {
+  if (!base::FeatureList::IsEnabled(kTileRasterCache))
+    return 0u;
+  return static_cast<size_t>(std::max(0, kTileRasterCacheMaxTiles.Get()));
+}
+
 }  // namespace features
@@ -5,6 +5,8 @@
 #ifndef CC_BASE_FEATURES_H_
 #define CC_BASE_FEATURES_H_
 
+#include <stddef.h>
+
 #include "base/feature_list.h"
 #include "build/build_config.h"
 #include "cc/base/base_export.h"
@@ -57,6 +59,30 @@ CC_BASE_EXPORT extern const base::Feature kDocumentTransition;
 // Helper for DocumentTransition feature.
 CC_BASE_EXPORT bool IsDocumentTransitionEnabled();
 
+// When enabled, software raster splits the tiles needed for the next frame
+// into horizontal bands that are rasterized on several threads.
+CC_BASE_EXPORT extern const base::Feature kParallelSoftwareRaster;
+
+// Returns the maximum number of bands per tile for kParallelSoftwareRaster,
+// or 1 if it is disabled.
+CC_BASE_EXPORT int GetMaxSoftwareRasterPlaybackBands();
+
+// When enabled, the draw properties of large layer lists are computed on
+// several threads.
+CC_BASE_EXPORT extern const base::Feature kParallelDrawProperties;
+
+// Returns the maximum number of threads, including the compositor thread, for
+// kParallelDrawProperties, or 1 if it is disabled.
+CC_BASE_EXPORT int GetMaxDrawPropertiesWorkers();
+
+// When enabled, the rasters of released tiles are kept for new tiles with the
+// same recorded content.
+CC_BASE_EXPORT extern const base::Feature kTileRasterCache;
+
+// Returns the maximum number of cached rasters for kTileRasterCache, or 0 if it
+// is disabled.
+CC_BASE_EXPORT size_t GetMaxRasterCacheTiles();
+
 }  // namespace features
 
 #endif  // CC_BASE_FEATURES_H_
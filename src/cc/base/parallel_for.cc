@@ -0,0 +1,71 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/base/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/bind.h"
+#include "base/task/post_job.h"
+
+namespace cc {
+namespace {
+
+class ParallelForJob {
+ public:
+  ParallelForJob(size_t count,
+                 size_t max_workers,
+                 const base::RepeatingCallback<void(size_t)>& task)
+      : count_(count), max_workers_(max_workers), task_(task) {}
+  ParallelForJob(const ParallelForJob&) = delete;
+  ParallelForJob& operator=(const ParallelForJob&) = delete;
+
+  void Run() {
+    // The calling thread is blocked on the result, so the helpers run at the
+    // priority of the work that is waiting for it.
+    base::JobHandle handle = base::PostJob(
+        FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+        base::BindRepeating(&ParallelForJob::RunTasks, base::Unretained(this)),
+        base::BindRepeating(&ParallelForJob::GetMaxConcurrency,
+                            base::Unretained(this)));
+    handle.Join();
+  }
+
+ private:
+  void RunTasks(base::JobDelegate* delegate) {
+    while (!delegate->ShouldYield()) {
+      size_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count_)
+        return;
+      task_.Run(index);
+    }
+  }
+
+  size_t GetMaxConcurrency(size_t worker_count) const {
+    size_t next_index = next_index_.load(std::memory_order_relaxed);
+    size_t remaining = next_index < count_ ? count_ - next_index : 0;
+    return std::min(remaining, max_workers_);
+  }
+
+  const size_t count_;
+  const size_t max_workers_;
+  const base::RepeatingCallback<void(size_t)>& task_;
+  std::atomic<size_t> next_index_{0};
+};
+
+}  // namespace
+
+void ParallelFor(size_t count,
+                 int max_workers,
+                 const base::RepeatingCallback<void(size_t)>& task) {
+  if (max_workers <= 1 || count <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      task.Run(i);
+    return;
+  }
+  ParallelForJob(count, static_cast<size_t>(max_workers), task).Run();
+}
+
+}  // namespace cc
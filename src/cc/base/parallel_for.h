@@ -0,0 +1,32 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_BASE_PARALLEL_FOR_H_
+#define CC_BASE_PARALLEL_FOR_H_
+
+#include <stddef.h>
+
+#include "base/callback.h"
+#include "cc/base/base_export.h"
+
+namespace cc {
+
+// Runs |task| once for every index in [0, |count|) on up to |max_workers|
+// threads, including the calling one, and returns once all of them have run.
+// Indices are claimed one at a time in increasing order, so callers that want
+// coarser work items should make each index cover a chunk of work.
+//
+// The helper threads come from a base::Job at USER_BLOCKING priority, and the
+// calling thread takes part in the work, so this makes progress even when no
+// worker is available. If |max_workers| or |count| is at most 1, everything
+// runs on the calling thread. |task| may run concurrently with itself and must
+// only write state that belongs to the index it is given.
+CC_BASE_EXPORT void ParallelFor(
+    size_t count,
+    int max_workers,
+    const base::RepeatingCallback<void(size_t)>& task);
+
+}  // namespace cc
+
+#endif  // CC_BASE_PARALLEL_FOR_H_
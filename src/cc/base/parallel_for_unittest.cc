@@ -0,0 +1,36 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/base/parallel_for.h"
+
+#include <atomic>
+#include <vector>
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+void CountRun(std::vector<std::atomic<int>>* runs, size_t index) {
+  (*runs)[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+TEST(ParallelForTest, RunsEveryIndexOnce) {
+  for (int max_workers : {0, 1, 2, 8}) {
+    for (size_t count : {0u, 1u, 2u, 100u}) {
+      std::vector<std::atomic<int>> runs(count);
+      ParallelFor(count, max_workers,
+                  base::BindRepeating(&CountRun, base::Unretained(&runs)));
+      for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(1, runs[i].load())
+            << "max_workers=" << max_workers << " count=" << count
+            << " index=" << i;
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace cc
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/stl_util.h"
 #include "base/timer/lap_timer.h"
 #include "cc/base/rtree.h"
 
@@ -69,6 +70,36 @@ class RTreePerfTest : public testing::Test {
     reporter.AddResult("_search", timer_.LapsPerSecond());
   }
 
+  // Searches a tree of page-like content (overlapping items of varying size)
+  // with tile-sized queries sweeping over the whole page, as done when
+  // rastering a layer's tiles.
+  void RunTileSearchTest(const std::string& test_name, int rect_count) {
+    std::vector<gfx::Rect> rects = BuildPageRects(rect_count);
+    RTree<size_t> rtree;
+    rtree.Build(rects);
+    gfx::Rect page_bounds = rtree.GetBoundsOrDie();
+
+    const int kTileSize = 256;
+    std::vector<gfx::Rect> queries;
+    for (int y = page_bounds.y(); y < page_bounds.bottom(); y += kTileSize) {
+      for (int x = page_bounds.x(); x < page_bounds.right(); x += kTileSize)
+        queries.push_back(gfx::Rect(x, y, kTileSize, kTileSize));
+    }
+    size_t query_index = 0;
+
+    std::vector<size_t> results;
+    timer_.Reset();
+    do {
+      rtree.Search(queries[query_index], &results);
+      Accumulate(results);
+      query_index = (query_index + 1) % queries.size();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter = SetUpReporter(test_name);
+    reporter.AddResult("_tile_search", timer_.LapsPerSecond());
+  }
+
   std::vector<gfx::Rect> BuildRects(int count) {
     std::vector<gfx::Rect> result;
     int width = std::sqrt(count);
@@ -84,11 +115,38 @@ class RTreePerfTest : public testing::Test {
     return result;
   }
 
+  // Returns rects laid out in paint order of a simple page: rows of items of
+  // a few different sizes, some of which overlap their neighbours.
+  std::vector<gfx::Rect> BuildPageRects(int count) {
+    const int kPageWidth = 1920;
+    const int kSizes[] = {12, 40, 96, 300};
+    std::vector<gfx::Rect> result;
+    result.reserve(count);
+    int x = 0;
+    int y = 0;
+    int row_height = 0;
+    for (int i = 0; i < count; ++i) {
+      int width = kSizes[i % base::size(kSizes)];
+      int height = kSizes[(i / 3) % base::size(kSizes)] / 2 + 8;
+      if (x + width > kPageWidth) {
+        x = 0;
+        y += row_height;
+        row_height = 0;
+      }
+      result.push_back(gfx::Rect(x, y, width, height));
+      // Every fourth item overlaps the previous one.
+      x += i % 4 ? width : width / 2;
+      row_height = std::max(row_height, height);
+    }
+    return result;
+  }
+
  protected:
   perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
     perf_test::PerfResultReporter reporter("rtree", story_name);
     reporter.RegisterImportantMetric("_construct", "runs/s");
     reporter.RegisterImportantMetric("_search", "runs/s");
+    reporter.RegisterImportantMetric("_tile_search", "runs/s");
     return reporter;
   }
 
@@ -109,5 +167,11 @@ TEST_F(RTreePerfTest, Search) {
   RunSearchTest("100000", 100000);
 }
 
+TEST_F(RTreePerfTest, TileSearch) {
+  RunTileSearchTest("1000", 1000);
+  RunTileSearchTest("10000", 10000);
+  RunTileSearchTest("100000", 100000);
+}
+
 }  // namespace
 }  // namespace cc
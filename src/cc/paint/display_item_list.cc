@@ -6,13 +6,17 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 
+#include "base/atomic_sequence_num.h"
+#include "base/hash/hash.h"
 #include "base/trace_event/trace_event.h"
 #include "base/trace_event/traced_value.h"
 #include "cc/base/math_util.h"
 #include "cc/debug/picture_debug_util.h"
+#include "cc/paint/paint_shader.h"
 #include "cc/paint/solid_color_analyzer.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -25,6 +29,8 @@ namespace cc {
 
 namespace {
 
+base::AtomicSequenceNumber g_next_display_item_list_id;
+
 bool GetCanvasClipBounds(SkCanvas* canvas, gfx::Rect* clip_bounds) {
   SkRect canvas_clip_bounds;
   if (!canvas->getLocalClipBounds(&canvas_clip_bounds))
@@ -67,10 +73,78 @@ void IterateTextContentByOffsets(const PaintOpBuffer& buffer,
     ++index;
   }
 }
+
+uint32_t HashCombine(uint32_t seed, uint32_t value) {
+  return static_cast<uint32_t>(base::HashInts32(seed, value));
+}
+
+uint32_t HashCombine(uint32_t seed, const void* data, size_t length) {
+  return HashCombine(seed, base::PersistentHash(data, length));
+}
+
+bool RecordContentEquals(const PaintOpBuffer& buffer,
+                         const PaintOpBuffer& other);
+
+// PaintOp::operator== leaves out images and the records of record shaders,
+// since they are not serialized. Compare images here, and treat shaders that
+// hold either as never equal.
+bool OpContentEquals(const PaintOp* op, const PaintOp* other) {
+  if (op->GetType() != other->GetType())
+    return false;
+  if (op->IsPaintOpWithFlags()) {
+    const PaintShader* shader =
+        static_cast<const PaintOpWithFlags*>(op)->flags.getShader();
+    if (shader && (shader->shader_type() == PaintShader::Type::kImage ||
+                   shader->shader_type() == PaintShader::Type::kPaintRecord)) {
+      return false;
+    }
+  }
+
+  switch (op->GetType()) {
+    case PaintOpType::DrawImage:
+      return *op == *other &&
+             static_cast<const DrawImageOp*>(op)->image ==
+                 static_cast<const DrawImageOp*>(other)->image;
+    case PaintOpType::DrawImageRect:
+      return *op == *other &&
+             static_cast<const DrawImageRectOp*>(op)->image ==
+                 static_cast<const DrawImageRectOp*>(other)->image;
+    case PaintOpType::DrawRecord: {
+      const PaintRecord* record =
+          static_cast<const DrawRecordOp*>(op)->record.get();
+      const PaintRecord* other_record =
+          static_cast<const DrawRecordOp*>(other)->record.get();
+      if (!record || !other_record)
+        return record == other_record;
+      return RecordContentEquals(*record, *other_record);
+    }
+    default:
+      return *op == *other;
+  }
+}
+
+bool RecordContentEquals(const PaintOpBuffer& buffer,
+                         const PaintOpBuffer& other) {
+  if (buffer.size() != other.size())
+    return false;
+  PaintOpBuffer::Iterator other_it(&other);
+  for (const PaintOp* op : PaintOpBuffer::Iterator(&buffer)) {
+    if (!OpContentEquals(op, *other_it))
+      return false;
+    ++other_it;
+  }
+  return true;
+}
+
 }  // namespace
 
+DisplayItemList::RasterQueryCache::RasterQueryCache() = default;
+
+DisplayItemList::RasterQueryCache::~RasterQueryCache() = default;
+
 DisplayItemList::DisplayItemList(UsageHint usage_hint)
-    : usage_hint_(usage_hint) {
+    : usage_hint_(usage_hint),
+      unique_id_(g_next_display_item_list_id.GetNext()) {
   if (usage_hint_ == kTopLevelDisplayItemList) {
     visual_rects_.reserve(1024);
     offsets_.reserve(1024);
@@ -92,6 +166,26 @@ void DisplayItemList::Raster(SkCanvas* canvas,
   paint_op_buffer_.Playback(canvas, PlaybackParams(image_provider), &offsets);
 }
 
+void DisplayItemList::Raster(SkCanvas* canvas,
+                             ImageProvider* image_provider,
+                             RasterQueryCache* query_cache) const {
+  DCHECK(usage_hint_ == kTopLevelDisplayItemList);
+  DCHECK(query_cache);
+  gfx::Rect canvas_playback_rect;
+  if (!GetCanvasClipBounds(canvas, &canvas_playback_rect))
+    return;
+
+  if (!query_cache->valid_ || query_cache->list_id_ != unique_id_ ||
+      query_cache->rect_ != canvas_playback_rect) {
+    rtree_.Search(canvas_playback_rect, &query_cache->offsets_);
+    query_cache->list_id_ = unique_id_;
+    query_cache->rect_ = canvas_playback_rect;
+    query_cache->valid_ = true;
+  }
+  paint_op_buffer_.Playback(canvas, PlaybackParams(image_provider),
+                            &query_cache->offsets_);
+}
+
 void DisplayItemList::CaptureContent(const gfx::Rect& rect,
                                      std::vector<NodeInfo>* content) const {
   if (!paint_op_buffer_.has_draw_text_ops())
@@ -318,6 +412,7 @@ void DisplayItemList::Reset() {
   offsets_.shrink_to_fit();
   paired_begin_stack_.clear();
   paired_begin_stack_.shrink_to_fit();
+  unique_id_ = g_next_display_item_list_id.GetNext();
 }
 
 sk_sp<PaintRecord> DisplayItemList::ReleaseAsRecord() {
@@ -349,6 +444,88 @@ bool DisplayItemList::GetColorIfSolidInRect(const gfx::Rect& rect,
   return false;
 }
 
+size_t DisplayItemList::ContentHashInRect(const gfx::Rect& rect) const {
+  DCHECK(usage_hint_ == kTopLevelDisplayItemList);
+  std::vector<size_t> offsets;
+  std::vector<gfx::Rect> rects;
+  rtree_.Search(rect, &offsets, &rects);
+
+  size_t hash = offsets.size();
+  size_t index = 0;
+  for (const PaintOp* op :
+       PaintOpBuffer::OffsetIterator(&paint_op_buffer_, &offsets)) {
+    const gfx::Rect& visual_rect = rects[index++];
+    hash = base::HashInts64(hash, HashOp(op));
+    hash = base::HashInts64(
+        hash, base::HashInts64(base::HashInts32(visual_rect.x(),
+                                                visual_rect.y()),
+                               base::HashInts32(visual_rect.width(),
+                                                visual_rect.height())));
+  }
+  return hash;
+}
+
+bool DisplayItemList::ContentInRectEquals(const gfx::Rect& rect,
+                                          const DisplayItemList& other) const {
+  DCHECK(usage_hint_ == kTopLevelDisplayItemList);
+  DCHECK(other.usage_hint_ == kTopLevelDisplayItemList);
+  std::vector<size_t> offsets;
+  std::vector<gfx::Rect> rects;
+  rtree_.Search(rect, &offsets, &rects);
+  std::vector<size_t> other_offsets;
+  std::vector<gfx::Rect> other_rects;
+  other.rtree_.Search(rect, &other_offsets, &other_rects);
+  if (rects != other_rects)
+    return false;
+
+  // Compare the cheap hash of every op first, so that most mismatches never
+  // get to the full comparison of its params.
+  PaintOpBuffer::OffsetIterator other_it(&other.paint_op_buffer_,
+                                         &other_offsets);
+  for (const PaintOp* op :
+       PaintOpBuffer::OffsetIterator(&paint_op_buffer_, &offsets)) {
+    if (HashOp(op) != HashOp(*other_it) || !OpContentEquals(op, *other_it))
+      return false;
+    ++other_it;
+  }
+  return true;
+}
+
+// static
+uint32_t DisplayItemList::HashOp(const PaintOp* op) {
+  uint32_t hash = op->type;
+  if (op->IsPaintOpWithFlags()) {
+    const PaintFlags& flags = static_cast<const PaintOpWithFlags*>(op)->flags;
+    hash = HashCombine(hash, flags.getColor());
+    hash = HashCombine(hash, static_cast<uint32_t>(flags.getBlendMode()));
+  }
+
+  SkRect rect;
+  if (op->IsDrawOp() && PaintOp::GetBounds(op, &rect))
+    return HashCombine(hash, &rect, sizeof(rect));
+
+  // State ops do not have bounds; hash the parameters of the common ones.
+  switch (op->GetType()) {
+    case PaintOpType::ClipRect:
+      rect = static_cast<const ClipRectOp*>(op)->rect;
+      return HashCombine(hash, &rect, sizeof(rect));
+    case PaintOpType::Translate: {
+      auto* translate = static_cast<const TranslateOp*>(op);
+      SkPoint offset = SkPoint::Make(translate->dx, translate->dy);
+      return HashCombine(hash, &offset, sizeof(offset));
+    }
+    case PaintOpType::Scale: {
+      auto* scale = static_cast<const ScaleOp*>(op);
+      SkPoint factor = SkPoint::Make(scale->sx, scale->sy);
+      return HashCombine(hash, &factor, sizeof(factor));
+    }
+    case PaintOpType::SaveLayerAlpha:
+      return HashCombine(hash, static_cast<const SaveLayerAlphaOp*>(op)->alpha);
+    default:
+      return hash;
+  }
+}
+
 base::Optional<DisplayItemList::DirectlyCompositedImageResult>
 DisplayItemList::GetDirectlyCompositedImageResult(
     gfx::Size containing_layer_bounds) const {
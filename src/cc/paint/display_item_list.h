@@ -56,11 +56,37 @@ class CC_PAINT_EXPORT DisplayItemList
   // PaintOpBuffer directly when we needed to release this as a paint op buffer.
   enum UsageHint { kTopLevelDisplayItemList, kToBeReleasedAsPaintOpBuffer };
 
+  // Caller-owned cache of the op offsets found by the last raster query.
+  // Passing the same cache to repeated Raster() calls whose clip bounds have
+  // not changed, e.g. re-rasters of the same tile, skips the rtree search. A
+  // cache that is passed with a different list than last time is refilled.
+  class CC_PAINT_EXPORT RasterQueryCache {
+   public:
+    RasterQueryCache();
+    RasterQueryCache(const RasterQueryCache&) = delete;
+    ~RasterQueryCache();
+
+    RasterQueryCache& operator=(const RasterQueryCache&) = delete;
+
+   private:
+    friend class DisplayItemList;
+
+    bool valid_ = false;
+    int list_id_ = 0;
+    gfx::Rect rect_;
+    std::vector<size_t> offsets_;
+  };
+
   explicit DisplayItemList(UsageHint = kTopLevelDisplayItemList);
   DisplayItemList(const DisplayItemList&) = delete;
   DisplayItemList& operator=(const DisplayItemList&) = delete;
 
   void Raster(SkCanvas* canvas, ImageProvider* image_provider = nullptr) const;
+  // Same as above, but reuses the result of the previous query stored in
+  // |query_cache| if the canvas clip bounds match it.
+  void Raster(SkCanvas* canvas,
+              ImageProvider* image_provider,
+              RasterQueryCache* query_cache) const;
 
   // Captures |DrawTextBlobOp|s intersecting |rect| and returns the associated
   // |NodeId|s in |content|.
@@ -178,8 +204,26 @@ class CC_PAINT_EXPORT DisplayItemList
                              SkColor* color,
                              int max_ops_to_analyze = 1);
 
+  // Returns a hash of the ops that a raster of |rect| would play back and of
+  // their visual rects. Lists that would raster |rect| the same way return
+  // the same hash; the converse needs ContentInRectEquals(). The ops are
+  // hashed on each call, nothing is computed while recording. Must be called
+  // after Finalize().
+  size_t ContentHashInRect(const gfx::Rect& rect) const;
+
+  // Returns true if a raster of |rect| plays back equal ops with equal visual
+  // rects in |this| and |other|, so that both produce the same pixels. Lists
+  // with ops whose content can not be compared, e.g. image shaders, are never
+  // equal. Must be called after Finalize().
+  bool ContentInRectEquals(const gfx::Rect& rect,
+                           const DisplayItemList& other) const;
+
   std::string ToString() const;
 
+  // Identifies the content of this list. No other list, and no later content
+  // of this list, e.g. after ReleaseAsRecord(), has the same id.
+  int unique_id() const { return unique_id_; }
+
   bool has_draw_ops() const { return paint_op_buffer_.has_draw_ops(); }
   bool has_draw_text_ops() const {
     return paint_op_buffer_.has_draw_text_ops();
@@ -203,6 +247,10 @@ class CC_PAINT_EXPORT DisplayItemList
 
   void Reset();
 
+  // Hashes the parameters of |op| that are cheap to read, see
+  // ContentHashInRect().
+  static uint32_t HashOp(const PaintOp* op);
+
   std::unique_ptr<base::trace_event::TracedValue> CreateTracedValue(
       bool include_items) const;
   void AddToValue(base::trace_event::TracedValue*, bool include_items) const;
@@ -215,8 +263,7 @@ class CC_PAINT_EXPORT DisplayItemList
       visual_rects_[paired_begin_stack_.back().first_index].Union(visual_rect);
   }
 
-  // RTree stores indices into the paint op buffer.
-  // TODO(vmpstr): Update the rtree to store offsets instead.
+  // RTree stores byte offsets into the paint op buffer.
   RTree<size_t> rtree_;
   DiscardableImageMap image_map_;
   PaintOpBuffer paint_op_buffer_;
@@ -246,6 +293,7 @@ class CC_PAINT_EXPORT DisplayItemList
 #endif
 
   UsageHint usage_hint_;
+  int unique_id_;
 
   friend class base::RefCountedThreadSafe<DisplayItemList>;
   FRIEND_TEST_ALL_PREFIXES(DisplayItemListTest, BytesUsed);
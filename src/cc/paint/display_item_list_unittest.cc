@@ -1187,4 +1187,171 @@ TEST_F(DisplayItemListTest, AreaOfDrawText) {
             static_cast<int>(list->AreaOfDrawText(gfx::Rect(500, 500))));
 }
 
+TEST_F(DisplayItemListTest, RasterWithQueryCache) {
+  gfx::Rect layer_rect(100, 100);
+  PaintFlags red_flags;
+  red_flags.setColor(SK_ColorRED);
+  PaintFlags blue_flags;
+  blue_flags.setColor(SK_ColorBLUE);
+  auto list = base::MakeRefCounted<DisplayItemList>();
+
+  list->StartPaint();
+  list->push<DrawRectOp>(SkRect::MakeXYWH(0, 0, 40, 40), red_flags);
+  list->EndPaintOfUnpaired(gfx::Rect(40, 40));
+  list->StartPaint();
+  list->push<DrawRectOp>(SkRect::MakeXYWH(60, 60, 40, 40), blue_flags);
+  list->EndPaintOfUnpaired(gfx::Rect(60, 60, 40, 40));
+  list->Finalize();
+
+  unsigned char expected_pixels[4 * 100 * 100] = {0};
+  DrawDisplayList(expected_pixels, layer_rect, list);
+
+  SkImageInfo info =
+      SkImageInfo::MakeN32Premul(layer_rect.width(), layer_rect.height());
+  DisplayItemList::RasterQueryCache query_cache;
+
+  // The first raster fills the cache, the second one reuses it. Both must
+  // match a raster without a cache.
+  for (int i = 0; i < 2; ++i) {
+    unsigned char pixels[4 * 100 * 100] = {0};
+    SkBitmap bitmap;
+    bitmap.installPixels(info, pixels, info.minRowBytes());
+    SkCanvas canvas(bitmap, SkSurfaceProps{});
+    canvas.clipRect(gfx::RectToSkRect(layer_rect));
+    list->Raster(&canvas, nullptr, &query_cache);
+    EXPECT_TRUE(CompareN32Pixels(pixels, expected_pixels, 100, 100));
+  }
+
+  // A different clip must not reuse the cached query.
+  unsigned char pixels[4 * 100 * 100] = {0};
+  unsigned char clipped_expected_pixels[4 * 100 * 100] = {0};
+  SkBitmap bitmap;
+  bitmap.installPixels(info, pixels, info.minRowBytes());
+  SkCanvas canvas(bitmap, SkSurfaceProps{});
+  canvas.clipRect(SkRect::MakeXYWH(50, 50, 50, 50));
+  list->Raster(&canvas, nullptr, &query_cache);
+
+  SkBitmap expected_bitmap;
+  expected_bitmap.installPixels(info, clipped_expected_pixels,
+                                info.minRowBytes());
+  SkCanvas expected_canvas(expected_bitmap, SkSurfaceProps{});
+  expected_canvas.clipRect(SkRect::MakeXYWH(50, 50, 50, 50));
+  list->Raster(&expected_canvas);
+  EXPECT_TRUE(CompareN32Pixels(pixels, clipped_expected_pixels, 100, 100));
+}
+
+TEST_F(DisplayItemListTest, RasterQueryCacheIsRefilledForAnotherList) {
+  gfx::Rect layer_rect(100, 100);
+  PaintFlags red_flags;
+  red_flags.setColor(SK_ColorRED);
+  PaintFlags blue_flags;
+  blue_flags.setColor(SK_ColorBLUE);
+
+  auto first_list = base::MakeRefCounted<DisplayItemList>();
+  first_list->StartPaint();
+  first_list->push<DrawRectOp>(SkRect::MakeXYWH(0, 0, 40, 40), red_flags);
+  first_list->EndPaintOfUnpaired(gfx::Rect(40, 40));
+  first_list->Finalize();
+
+  auto second_list = base::MakeRefCounted<DisplayItemList>();
+  second_list->StartPaint();
+  second_list->push<SaveOp>();
+  second_list->push<DrawRectOp>(SkRect::MakeXYWH(60, 60, 40, 40), blue_flags);
+  second_list->push<RestoreOp>();
+  second_list->EndPaintOfUnpaired(gfx::Rect(60, 60, 40, 40));
+  second_list->Finalize();
+  EXPECT_NE(first_list->unique_id(), second_list->unique_id());
+
+  unsigned char expected_pixels[4 * 100 * 100] = {0};
+  DrawDisplayList(expected_pixels, layer_rect, second_list);
+
+  SkImageInfo info =
+      SkImageInfo::MakeN32Premul(layer_rect.width(), layer_rect.height());
+  DisplayItemList::RasterQueryCache query_cache;
+  {
+    unsigned char pixels[4 * 100 * 100] = {0};
+    SkBitmap bitmap;
+    bitmap.installPixels(info, pixels, info.minRowBytes());
+    SkCanvas canvas(bitmap, SkSurfaceProps{});
+    canvas.clipRect(gfx::RectToSkRect(layer_rect));
+    first_list->Raster(&canvas, nullptr, &query_cache);
+  }
+
+  // Same clip, but the offsets cached for |first_list| do not point at the
+  // ops of |second_list|.
+  unsigned char pixels[4 * 100 * 100] = {0};
+  SkBitmap bitmap;
+  bitmap.installPixels(info, pixels, info.minRowBytes());
+  SkCanvas canvas(bitmap, SkSurfaceProps{});
+  canvas.clipRect(gfx::RectToSkRect(layer_rect));
+  second_list->Raster(&canvas, nullptr, &query_cache);
+  EXPECT_TRUE(CompareN32Pixels(pixels, expected_pixels, 100, 100));
+}
+
+namespace {
+
+// Records a slide: a background and a square whose color depends on |index|.
+scoped_refptr<DisplayItemList> RecordSlide(
+    int index,
+    const PaintImage& image = PaintImage()) {
+  auto list = base::MakeRefCounted<DisplayItemList>();
+  PaintFlags flags;
+  flags.setColor(SK_ColorWHITE);
+  list->StartPaint();
+  list->push<DrawRectOp>(SkRect::MakeWH(200, 100), flags);
+  list->EndPaintOfUnpaired(gfx::Rect(200, 100));
+
+  list->StartPaint();
+  list->push<SaveOp>();
+  list->push<TranslateOp>(10.f, 10.f);
+  flags.setColor(index % 2 ? SK_ColorRED : SK_ColorBLUE);
+  list->push<DrawRectOp>(SkRect::MakeWH(50, 50), flags);
+  if (image)
+    list->push<DrawImageOp>(image, 0.f, 0.f);
+  list->push<RestoreOp>();
+  list->EndPaintOfUnpaired(gfx::Rect(10, 10, 50, 50));
+
+  list->Finalize();
+  return list;
+}
+
+}  // namespace
+
+TEST_F(DisplayItemListTest, ContentHashInRect) {
+  scoped_refptr<DisplayItemList> first = RecordSlide(0);
+  scoped_refptr<DisplayItemList> second = RecordSlide(1);
+  scoped_refptr<DisplayItemList> third = RecordSlide(2);
+
+  // Re-recorded content matches, wherever it is queried.
+  gfx::Rect square_rect(0, 0, 100, 100);
+  EXPECT_EQ(first->ContentHashInRect(square_rect),
+            third->ContentHashInRect(square_rect));
+  EXPECT_TRUE(first->ContentInRectEquals(square_rect, *third));
+
+  // Changed content does not.
+  EXPECT_NE(first->ContentHashInRect(square_rect),
+            second->ContentHashInRect(square_rect));
+  EXPECT_FALSE(first->ContentInRectEquals(square_rect, *second));
+
+  // Unless the rect does not intersect the change.
+  gfx::Rect background_rect(100, 0, 100, 100);
+  EXPECT_EQ(first->ContentHashInRect(background_rect),
+            second->ContentHashInRect(background_rect));
+  EXPECT_TRUE(first->ContentInRectEquals(background_rect, *second));
+}
+
+TEST_F(DisplayItemListTest, ContentInRectEqualsComparesImages) {
+  PaintImage image = CreateDiscardablePaintImage(gfx::Size(10, 10));
+  PaintImage other_image = CreateDiscardablePaintImage(gfx::Size(10, 10));
+  scoped_refptr<DisplayItemList> list = RecordSlide(0, image);
+  scoped_refptr<DisplayItemList> same_list = RecordSlide(0, image);
+  scoped_refptr<DisplayItemList> other_list = RecordSlide(0, other_image);
+
+  // PaintOp::operator== does not compare images, so the hashes collide.
+  gfx::Rect rect(100, 100);
+  EXPECT_EQ(list->ContentHashInRect(rect), other_list->ContentHashInRect(rect));
+  EXPECT_TRUE(list->ContentInRectEquals(rect, *same_list));
+  EXPECT_FALSE(list->ContentInRectEquals(rect, *other_list));
+}
+
 }  // namespace cc
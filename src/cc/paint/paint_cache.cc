@@ -24,6 +24,7 @@ void EraseFromMap(T* map, size_t n, const volatile PaintCacheId* ids) {
 }  // namespace
 
 constexpr size_t ClientPaintCache::kNoCachingBudget;
+constexpr size_t ClientPaintCache::kMaxPaintFlagsEntries;
 
 ClientPaintCache::ClientPaintCache(size_t max_budget_bytes)
     : cache_map_(CacheMap::NO_AUTO_EVICT), max_budget_(max_budget_bytes) {}
@@ -46,6 +47,26 @@ void ClientPaintCache::Put(PaintCacheDataType type,
   bytes_used_ += size;
 }
 
+PaintCacheEntryState ClientPaintCache::GetOrPutPaintFlags(
+    const PaintFlagsCacheKey& key,
+    PaintCacheId* id) {
+  if (max_budget_ == kNoCachingBudget)
+    return PaintCacheEntryState::kEmpty;
+
+  auto it = paint_flags_ids_.find(key);
+  if (it != paint_flags_ids_.end()) {
+    *id = it->second;
+    return PaintCacheEntryState::kCached;
+  }
+  if (paint_flags_ids_.size() >= kMaxPaintFlagsEntries)
+    return PaintCacheEntryState::kEmpty;
+
+  *id = next_paint_flags_id_++;
+  paint_flags_ids_.emplace(key, *id);
+  pending_paint_flags_.push_back(key);
+  return PaintCacheEntryState::kInlined;
+}
+
 template <typename Iterator>
 void ClientPaintCache::EraseFromMap(Iterator it) {
   DCHECK_GE(bytes_used_, it->second);
@@ -55,6 +76,7 @@ void ClientPaintCache::EraseFromMap(Iterator it) {
 
 void ClientPaintCache::FinalizePendingEntries() {
   pending_entries_->clear();
+  pending_paint_flags_.clear();
 }
 
 void ClientPaintCache::AbortPendingEntries() {
@@ -64,6 +86,12 @@ void ClientPaintCache::AbortPendingEntries() {
     EraseFromMap(it);
   }
   pending_entries_->clear();
+
+  for (const auto& key : pending_paint_flags_) {
+    DCHECK(paint_flags_ids_.count(key));
+    paint_flags_ids_.erase(key);
+  }
+  pending_paint_flags_.clear();
 }
 
 void ClientPaintCache::Purge(PurgedData* purged_data) {
@@ -81,10 +109,12 @@ void ClientPaintCache::Purge(PurgedData* purged_data) {
 
 bool ClientPaintCache::PurgeAll() {
   DCHECK(pending_entries_->empty());
+  DCHECK(pending_paint_flags_.empty());
 
-  bool has_data = !cache_map_.empty();
+  bool has_data = !cache_map_.empty() || !paint_flags_ids_.empty();
   cache_map_.Clear();
   bytes_used_ = 0u;
+  paint_flags_ids_.clear();
   return has_data;
 }
 
@@ -112,6 +142,20 @@ bool ServicePaintCache::GetPath(PaintCacheId id, SkPath* path) const {
   return true;
 }
 
+void ServicePaintCache::PutPaintFlags(PaintCacheId id,
+                                      const PaintFlags& flags) {
+  cached_paint_flags_.emplace(id, flags);
+}
+
+bool ServicePaintCache::GetPaintFlags(PaintCacheId id,
+                                      PaintFlags* flags) const {
+  auto it = cached_paint_flags_.find(id);
+  if (it == cached_paint_flags_.end())
+    return false;
+  *flags = it->second;
+  return true;
+}
+
 void ServicePaintCache::Purge(PaintCacheDataType type,
                               size_t n,
                               const volatile PaintCacheId* ids) {
@@ -130,6 +174,7 @@ void ServicePaintCache::Purge(PaintCacheDataType type,
 void ServicePaintCache::PurgeAll() {
   cached_blobs_.clear();
   cached_paths_.clear();
+  cached_paint_flags_.clear();
 }
 
 }  // namespace cc
@@ -5,12 +5,15 @@
 #ifndef CC_PAINT_PAINT_CACHE_H_
 #define CC_PAINT_PAINT_CACHE_H_
 
+#include <array>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "base/containers/mru_cache.h"
 #include "base/containers/stack_container.h"
 #include "cc/paint/paint_export.h"
+#include "cc/paint/paint_flags.h"
 #include "third_party/skia/include/core/SkPath.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
@@ -33,6 +36,11 @@ namespace cc {
 // controlled PaintCache with a tighter budget is better for these data types
 // since it avoids the need for cross-process ref-counting required by the
 // TransferCache.
+//
+// Simple PaintFlags, which have no effects, filters or shaders, are cached by
+// value since text and rect heavy content records many ops with identical
+// flags. They are not budgeted and are only dropped in PurgeAll(). Their number
+// is bounded by ClientPaintCache::kMaxPaintFlagsEntries instead.
 
 using PaintCacheId = uint32_t;
 using PaintCacheIds = std::vector<PaintCacheId>;
@@ -47,6 +55,10 @@ enum class PaintCacheEntryState : uint32_t {
 constexpr size_t PaintCacheDataTypeCount =
     static_cast<uint32_t>(PaintCacheDataType::kLast) + 1u;
 
+// The bits of the color, stroke width, miter limit, blend mode and bitfields
+// of a simple PaintFlags.
+using PaintFlagsCacheKey = std::array<uint32_t, 5>;
+
 class CC_PAINT_EXPORT ClientPaintCache {
  public:
   // If ClientPaintCache is constructed with a max_budget_bytes of
@@ -54,6 +66,9 @@ class CC_PAINT_EXPORT ClientPaintCache {
   // a no-op instance.
   static constexpr size_t kNoCachingBudget = 0u;
 
+  // The maximum number of PaintFlags entries kept in the cache.
+  static constexpr size_t kMaxPaintFlagsEntries = 1024u;
+
   explicit ClientPaintCache(size_t max_budget_bytes);
   ClientPaintCache(const ClientPaintCache&) = delete;
   ~ClientPaintCache();
@@ -63,6 +78,13 @@ class CC_PAINT_EXPORT ClientPaintCache {
   bool Get(PaintCacheDataType type, PaintCacheId id);
   void Put(PaintCacheDataType type, PaintCacheId id, size_t size);
 
+  // Looks up the simple PaintFlags with |key|. Returns kCached with the id of
+  // the service-side entry in |id| if the flags were sent before, and kInlined
+  // with a new id if the caller has to send them with that id. Returns kEmpty
+  // if the flags can not be cached.
+  PaintCacheEntryState GetOrPutPaintFlags(const PaintFlagsCacheKey& key,
+                                          PaintCacheId* id);
+
   // Populates |purged_data| with the list of ids which should be purged from
   // the ServicePaintCache.
   using PurgedData = PaintCacheIds[PaintCacheDataTypeCount];
@@ -81,6 +103,7 @@ class CC_PAINT_EXPORT ClientPaintCache {
   bool PurgeAll();
 
   size_t bytes_used() const { return bytes_used_; }
+  size_t paint_flags_count() const { return paint_flags_ids_.size(); }
 
  private:
   using CacheKey = std::pair<PaintCacheDataType, PaintCacheId>;
@@ -97,6 +120,10 @@ class CC_PAINT_EXPORT ClientPaintCache {
   // send them to the service-side cache. This is necessary to ensure we
   // maintain an accurate mirror of the service-side state.
   base::StackVector<CacheKey, 1> pending_entries_;
+
+  std::map<PaintFlagsCacheKey, PaintCacheId> paint_flags_ids_;
+  std::vector<PaintFlagsCacheKey> pending_paint_flags_;
+  PaintCacheId next_paint_flags_id_ = 1u;
 };
 
 class CC_PAINT_EXPORT ServicePaintCache {
@@ -118,17 +145,29 @@ class CC_PAINT_EXPORT ServicePaintCache {
   // |path| pointed memory. Returns false, if the entry is not found.
   bool GetPath(PaintCacheId id, SkPath* path) const;
 
+  // Stores the simple |flags| received from the client in the cache.
+  void PutPaintFlags(PaintCacheId id, const PaintFlags& flags);
+
+  // Retrieves the flags stored for |id| in |flags|. Returns false if the entry
+  // is not found.
+  bool GetPaintFlags(PaintCacheId id, PaintFlags* flags) const;
+
   void Purge(PaintCacheDataType type,
              size_t n,
              const volatile PaintCacheId* ids);
   void PurgeAll();
-  bool empty() const { return cached_blobs_.empty() && cached_paths_.empty(); }
+  bool empty() const {
+    return cached_blobs_.empty() && cached_paths_.empty() &&
+           cached_paint_flags_.empty();
+  }
 
  private:
   using BlobMap = std::map<PaintCacheId, sk_sp<SkTextBlob>>;
   BlobMap cached_blobs_;
   using PathMap = std::map<PaintCacheId, SkPath>;
   PathMap cached_paths_;
+  using PaintFlagsMap = std::map<PaintCacheId, PaintFlags>;
+  PaintFlagsMap cached_paint_flags_;
 };
 
 }  // namespace cc
@@ -123,6 +123,71 @@ TEST_P(PaintCacheTest, ServiceBasic) {
   EXPECT_TRUE(service_cache.empty());
 }
 
+TEST(PaintFlagsCacheTest, Client) {
+  ClientPaintCache client_cache(kDefaultBudget);
+  PaintFlagsCacheKey key = {1u, 2u, 3u, 4u, 5u};
+  PaintCacheId id = 0u;
+  EXPECT_EQ(PaintCacheEntryState::kInlined,
+            client_cache.GetOrPutPaintFlags(key, &id));
+  PaintCacheId cached_id = 0u;
+  EXPECT_EQ(PaintCacheEntryState::kCached,
+            client_cache.GetOrPutPaintFlags(key, &cached_id));
+  EXPECT_EQ(id, cached_id);
+
+  // Aborted entries are sent again.
+  client_cache.AbortPendingEntries();
+  EXPECT_EQ(PaintCacheEntryState::kInlined,
+            client_cache.GetOrPutPaintFlags(key, &id));
+  client_cache.FinalizePendingEntries();
+  EXPECT_EQ(PaintCacheEntryState::kCached,
+            client_cache.GetOrPutPaintFlags(key, &id));
+
+  EXPECT_TRUE(client_cache.PurgeAll());
+  EXPECT_EQ(0u, client_cache.paint_flags_count());
+  EXPECT_EQ(PaintCacheEntryState::kInlined,
+            client_cache.GetOrPutPaintFlags(key, &id));
+}
+
+TEST(PaintFlagsCacheTest, ClientLimit) {
+  ClientPaintCache client_cache(kDefaultBudget);
+  PaintFlagsCacheKey key = {};
+  PaintCacheId id = 0u;
+  for (size_t i = 0; i < ClientPaintCache::kMaxPaintFlagsEntries; ++i) {
+    key[0] = static_cast<uint32_t>(i);
+    EXPECT_EQ(PaintCacheEntryState::kInlined,
+              client_cache.GetOrPutPaintFlags(key, &id));
+  }
+  client_cache.FinalizePendingEntries();
+
+  key[0] = ClientPaintCache::kMaxPaintFlagsEntries;
+  EXPECT_EQ(PaintCacheEntryState::kEmpty,
+            client_cache.GetOrPutPaintFlags(key, &id));
+  key[0] = 0u;
+  EXPECT_EQ(PaintCacheEntryState::kCached,
+            client_cache.GetOrPutPaintFlags(key, &id));
+
+  ClientPaintCache no_caching(ClientPaintCache::kNoCachingBudget);
+  EXPECT_EQ(PaintCacheEntryState::kEmpty,
+            no_caching.GetOrPutPaintFlags(key, &id));
+}
+
+TEST(PaintFlagsCacheTest, Service) {
+  ServicePaintCache service_cache;
+  PaintFlags flags;
+  flags.setColor(SK_ColorRED);
+  flags.setStrokeWidth(2.f);
+
+  PaintFlags cached_flags;
+  EXPECT_FALSE(service_cache.GetPaintFlags(1u, &cached_flags));
+  service_cache.PutPaintFlags(1u, flags);
+  EXPECT_TRUE(service_cache.GetPaintFlags(1u, &cached_flags));
+  EXPECT_EQ(flags, cached_flags);
+
+  EXPECT_FALSE(service_cache.empty());
+  service_cache.PurgeAll();
+  EXPECT_TRUE(service_cache.empty());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     P,
     PaintCacheTest,
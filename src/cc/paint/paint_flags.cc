@@ -204,8 +204,9 @@ bool PaintFlags::HasDiscardableImages() const {
 }
 
 size_t PaintFlags::GetSerializedSize() const {
-  return sizeof(color_) + sizeof(width_) + sizeof(miter_limit_) +
-         sizeof(blend_mode_) + sizeof(bitfields_uint_) +
+  // The paint cache entry state and id come first.
+  return 2 * sizeof(uint32_t) + sizeof(color_) + sizeof(width_) +
+         sizeof(miter_limit_) + sizeof(blend_mode_) + sizeof(bitfields_uint_) +
          PaintOpWriter::GetFlattenableSize(path_effect_.get()) +
          PaintOpWriter::Alignment() +
          PaintOpWriter::GetFlattenableSize(mask_filter_.get()) +
@@ -220,6 +220,16 @@ class CC_PAINT_EXPORT PaintOp {
     kLastType = kMailbox
   };
 
+  // Indicates how SkM44s are serialized. Only the components that are not
+  // implied by the type are written.
+  enum class SerializedMatrixType : uint8_t {
+    kIdentity,
+    kTranslate,
+    kScaleTranslate,
+    kGeneral,
+    kLastType = kGeneral
+  };
+
   // Subclasses should provide a static Serialize() method called from here.
   // If the op can be serialized to |memory| in no more than |size| bytes,
   // then return the number of bytes written.  If it won't fit, return 0.
@@ -1872,12 +1872,18 @@ TEST_P(PaintOpSerializationTest, SerializationFailures) {
   for (PaintOpBuffer::Iterator iter(&buffer_); iter; ++iter, ++op_idx) {
     SCOPED_TRACE(base::StringPrintf(
         "%s #%zu", PaintOpTypeToString(GetParamType()).c_str(), op_idx));
-    size_t expected_bytes = bytes_written[op_idx];
-    EXPECT_GT(expected_bytes, 0u);
+    EXPECT_GT(bytes_written[op_idx], 0u);
+
+    // Flags already sent by an earlier op are only referenced by id, so
+    // measure the op with an empty paint cache.
+    options_provider.ClearPaintCache();
+    size_t expected_bytes = iter->Serialize(
+        output_.get(), output_size_, options_provider.serialize_options());
+    EXPECT_GE(expected_bytes, bytes_written[op_idx]);
 
     // Attempt to write op into a buffer of size |i|, and only expect
     // it to succeed if the buffer is large enough.
-    for (size_t i = 0; i < bytes_written[op_idx] + 2; ++i) {
+    for (size_t i = 0; i < expected_bytes + 2; ++i) {
       options_provider.ClearPaintCache();
       size_t written_bytes = iter->Serialize(
           output_.get(), i, options_provider.serialize_options());
@@ -2414,6 +2420,92 @@ TEST(PaintOpBufferSerializationTest, AlphaFoldingDuringSerialization) {
   }
 }
 
+// Flags without effects are only sent with the first op using them.
+TEST(PaintOpBufferTest, SerializeCachedPaintFlags) {
+  static constexpr size_t kSize = sizeof(LargestPaintOp) + 100;
+  static constexpr size_t kAlign = PaintOpBuffer::PaintOpAlign;
+  std::unique_ptr<char, base::AlignedFreeDeleter> input_(
+      static_cast<char*>(base::AlignedAlloc(kSize, kAlign)));
+  std::unique_ptr<char, base::AlignedFreeDeleter> output_(
+      static_cast<char*>(base::AlignedAlloc(kSize, kAlign)));
+
+  PaintFlags flags;
+  flags.setColor(SK_ColorGREEN);
+  flags.setStrokeWidth(3.f);
+  DrawRectOp op(SkRect::MakeWH(10, 10), flags);
+
+  TestOptionsProvider options_provider;
+  size_t bytes_written[3] = {};
+  for (size_t& bytes : bytes_written) {
+    bytes =
+        op.Serialize(input_.get(), kSize, options_provider.serialize_options());
+    ASSERT_GT(bytes, 0u);
+
+    size_t bytes_read = 0;
+    PaintOp* written = PaintOp::Deserialize(
+        input_.get(), bytes, output_.get(), kSize, &bytes_read,
+        options_provider.deserialize_options());
+    ASSERT_TRUE(written);
+    EXPECT_EQ(op, *written);
+    written->DestroyThis();
+  }
+  EXPECT_LT(bytes_written[1], bytes_written[0]);
+  EXPECT_EQ(bytes_written[1], bytes_written[2]);
+
+  // A reader without the cache entry fails.
+  TestOptionsProvider other_provider;
+  size_t bytes_read = 0;
+  EXPECT_FALSE(PaintOp::Deserialize(input_.get(), bytes_written[2],
+                                    output_.get(), kSize, &bytes_read,
+                                    other_provider.deserialize_options()));
+
+  // Flags with effects are always sent.
+  flags.setColorFilter(
+      SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kSrcOver));
+  DrawRectOp filter_op(SkRect::MakeWH(10, 10), flags);
+  size_t first_bytes = filter_op.Serialize(
+      input_.get(), kSize, options_provider.serialize_options());
+  size_t second_bytes = filter_op.Serialize(
+      input_.get(), kSize, options_provider.serialize_options());
+  EXPECT_EQ(first_bytes, second_bytes);
+}
+
+// 2D translations and scales only send their non-trivial components.
+TEST(PaintOpBufferTest, SerializeCompactMatrix) {
+  static constexpr size_t kSize = sizeof(LargestPaintOp) + 100;
+  static constexpr size_t kAlign = PaintOpBuffer::PaintOpAlign;
+  std::unique_ptr<char, base::AlignedFreeDeleter> input_(
+      static_cast<char*>(base::AlignedAlloc(kSize, kAlign)));
+  std::unique_ptr<char, base::AlignedFreeDeleter> output_(
+      static_cast<char*>(base::AlignedAlloc(kSize, kAlign)));
+
+  TestOptionsProvider options_provider;
+  SkM44 general = SkM44::Translate(1.f, 2.f);
+  general.setRC(0, 1, 0.5f);
+  std::vector<SkM44> matrices = {SkM44(), SkM44::Translate(1.f, 2.f),
+                                 SkM44::Scale(3.f, 4.f), general};
+  size_t previous_bytes = 0u;
+  for (const SkM44& matrix : matrices) {
+    SetMatrixOp op(matrix);
+    size_t bytes_written =
+        op.Serialize(input_.get(), kSize, options_provider.serialize_options());
+    ASSERT_GT(bytes_written, 0u);
+    EXPECT_GE(bytes_written, previous_bytes);
+    previous_bytes = bytes_written;
+
+    size_t bytes_read = 0;
+    PaintOp* written = PaintOp::Deserialize(
+        input_.get(), bytes_written, output_.get(), kSize, &bytes_read,
+        options_provider.deserialize_options());
+    ASSERT_TRUE(written);
+    EXPECT_EQ(op, *written);
+    written->DestroyThis();
+  }
+  EXPECT_LT(SetMatrixOp(SkM44()).Serialize(
+                input_.get(), kSize, options_provider.serialize_options()),
+            previous_bytes);
+}
+
 // Test generic PaintOp deserializing failure cases.
 TEST(PaintOpBufferTest, PaintOpDeserialize) {
   static constexpr size_t kSize = sizeof(LargestPaintOp) + 100;
@@ -7,10 +7,13 @@
 #include "base/test/launcher/unit_test_launcher.h"
 #include "base/test/test_suite.h"
 #include "base/timer/lap_timer.h"
+#include "cc/paint/display_item_list.h"
 #include "cc/paint/paint_op_buffer.h"
 #include "cc/paint/paint_op_buffer_serializer.h"
 #include "cc/test/test_options_provider.h"
 #include "testing/perf/perf_result_reporter.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkMaskFilter.h"
 #include "third_party/skia/include/effects/SkColorMatrixFilter.h"
 #include "third_party/skia/include/effects/SkDashPathEffect.h"
@@ -23,7 +26,7 @@ static const int kTimeLimitMillis = 2000;
 static const int kNumWarmupRuns = 20;
 static const int kTimeCheckInterval = 1;
 
-static const size_t kMaxSerializedBufferBytes = 100000;
+static const size_t kMaxSerializedBufferBytes = 1000000;
 
 class PaintOpPerfTest : public testing::Test {
  public:
@@ -38,29 +41,29 @@ class PaintOpPerfTest : public testing::Test {
             base::AlignedAlloc(sizeof(LargestPaintOp),
                                PaintOpBuffer::PaintOpAlign))) {}
 
-  void RunTest(const std::string& name, const PaintOpBuffer& buffer) {
+  // Reports serialize and deserialize speed and the serialized size of
+  // |buffer|. With |warm_paint_cache|, entries cached by an earlier
+  // serialization of the same content are reused, as when rastering further
+  // tiles of a page. Otherwise they are written every time.
+  void RunTest(const std::string& name,
+               const PaintOpBuffer& buffer,
+               bool warm_paint_cache = false) {
     TestOptionsProvider test_options_provider;
+    if (warm_paint_cache) {
+      size_t bytes_written = SerializeBuffer(buffer, &test_options_provider);
+      test_options_provider.client_paint_cache()->FinalizePendingEntries();
+      test_options_provider.PushFonts();
+      DeserializeBuffer(bytes_written, &test_options_provider);
+    }
 
     size_t bytes_written = 0u;
-    PaintOpBufferSerializer::Preamble preamble;
-
     timer_.Reset();
     do {
-      SimpleBufferSerializer serializer(
-          serialized_data_.get(), kMaxSerializedBufferBytes,
-          test_options_provider.image_provider(),
-          test_options_provider.transfer_cache_helper(),
-          test_options_provider.client_paint_cache(),
-          test_options_provider.strike_server(),
-          test_options_provider.color_space(),
-          test_options_provider.can_use_lcd_text(),
-          test_options_provider.context_supports_distance_field_text(),
-          test_options_provider.max_texture_size());
-      serializer.Serialize(&buffer, nullptr, preamble);
-      bytes_written = serializer.written();
-
-      // Force client paint cache entries to be written every time.
-      test_options_provider.client_paint_cache()->PurgeAll();
+      bytes_written = SerializeBuffer(buffer, &test_options_provider);
+      if (warm_paint_cache)
+        test_options_provider.client_paint_cache()->FinalizePendingEntries();
+      else
+        test_options_provider.ClearPaintCache();
       timer_.NextLap();
     } while (!timer_.HasTimeLimitExpired());
     CHECK_GT(bytes_written, 0u);
@@ -69,30 +72,14 @@ class PaintOpPerfTest : public testing::Test {
     reporter.RegisterImportantMetric("", "runs/s");
     reporter.AddResult("", timer_.LapsPerSecond());
 
-    size_t bytes_read = 0;
+    reporter = perf_test::PerfResultReporter(name, "serialized_size");
+    reporter.RegisterImportantMetric("", "bytes");
+    reporter.AddResult("", bytes_written);
+
     timer_.Reset();
     test_options_provider.PushFonts();
-
     do {
-      size_t remaining_read_bytes = bytes_written;
-      char* to_read = serialized_data_.get();
-
-      while (true) {
-        PaintOp* deserialized_op = PaintOp::Deserialize(
-            to_read, remaining_read_bytes, deserialized_data_.get(),
-            sizeof(LargestPaintOp), &bytes_read,
-            test_options_provider.deserialize_options());
-        CHECK(deserialized_op);
-        deserialized_op->DestroyThis();
-
-        DCHECK_GE(remaining_read_bytes, bytes_read);
-        if (remaining_read_bytes == bytes_read)
-          break;
-
-        remaining_read_bytes -= bytes_read;
-        to_read += bytes_read;
-      }
-
+      DeserializeBuffer(bytes_written, &test_options_provider);
       timer_.NextLap();
     } while (!timer_.HasTimeLimitExpired());
 
@@ -101,6 +88,47 @@ class PaintOpPerfTest : public testing::Test {
     reporter.AddResult("", timer_.LapsPerSecond());
   }
 
+ private:
+  size_t SerializeBuffer(const PaintOpBuffer& buffer,
+                         TestOptionsProvider* test_options_provider) {
+    PaintOpBufferSerializer::Preamble preamble;
+    SimpleBufferSerializer serializer(
+        serialized_data_.get(), kMaxSerializedBufferBytes,
+        test_options_provider->image_provider(),
+        test_options_provider->transfer_cache_helper(),
+        test_options_provider->client_paint_cache(),
+        test_options_provider->strike_server(),
+        test_options_provider->color_space(),
+        test_options_provider->can_use_lcd_text(),
+        test_options_provider->context_supports_distance_field_text(),
+        test_options_provider->max_texture_size());
+    serializer.Serialize(&buffer, nullptr, preamble);
+    return serializer.written();
+  }
+
+  void DeserializeBuffer(size_t bytes_written,
+                         TestOptionsProvider* test_options_provider) {
+    size_t bytes_read = 0;
+    size_t remaining_read_bytes = bytes_written;
+    char* to_read = serialized_data_.get();
+
+    while (true) {
+      PaintOp* deserialized_op = PaintOp::Deserialize(
+          to_read, remaining_read_bytes, deserialized_data_.get(),
+          sizeof(LargestPaintOp), &bytes_read,
+          test_options_provider->deserialize_options());
+      CHECK(deserialized_op);
+      deserialized_op->DestroyThis();
+
+      DCHECK_GE(remaining_read_bytes, bytes_read);
+      if (remaining_read_bytes == bytes_read)
+        break;
+
+      remaining_read_bytes -= bytes_read;
+      to_read += bytes_read;
+    }
+  }
+
  protected:
   base::LapTimer timer_;
   std::unique_ptr<char, base::AlignedFreeDeleter> serialized_data_;
@@ -178,5 +206,91 @@ TEST_F(PaintOpPerfTest, TextOps) {
   RunTest("text", buffer);
 }
 
+// A page of text and rects drawn with a few flags, as recorded for text
+// heavy content.
+void PushTextPageOps(PaintOpBuffer* buffer) {
+  SkFont font;
+  font.setTypeface(SkTypeface::MakeDefault());
+  SkTextBlobBuilder builder;
+  int glyph_count = 20;
+  const auto& run = builder.allocRun(font, glyph_count, 0.f, 12.f);
+  std::fill(run.glyphs, run.glyphs + glyph_count, 0);
+  auto blob = builder.make();
+
+  PaintFlags background_flags;
+  background_flags.setColor(SK_ColorWHITE);
+  PaintFlags text_flags;
+  text_flags.setColor(SK_ColorBLACK);
+  text_flags.setAntiAlias(true);
+  PaintFlags border_flags;
+  border_flags.setColor(SK_ColorGRAY);
+  border_flags.setStyle(PaintFlags::kStroke_Style);
+
+  for (int i = 0; i < 200; ++i) {
+    buffer->push<SaveOp>();
+    buffer->push<ConcatOp>(SkM44::Translate(0.f, i * 16.f));
+    buffer->push<DrawRectOp>(SkRect::MakeWH(800, 16), background_flags);
+    buffer->push<DrawTextBlobOp>(blob, 4.f, 0.f, text_flags);
+    buffer->push<DrawRectOp>(SkRect::MakeWH(800, 16), border_flags);
+    buffer->push<RestoreOp>();
+  }
+}
+
+TEST_F(PaintOpPerfTest, TextPageOps) {
+  PaintOpBuffer buffer;
+  PushTextPageOps(&buffer);
+  RunTest("text_page", buffer);
+}
+
+TEST_F(PaintOpPerfTest, TextPageOpsWarmPaintCache) {
+  PaintOpBuffer buffer;
+  PushTextPageOps(&buffer);
+  RunTest("text_page_warm_cache", buffer, true);
+}
+
+// Repeated raster of the same tile of a large display list, with and without
+// reusing the rtree query.
+TEST_F(PaintOpPerfTest, DisplayItemListRasterTile) {
+  auto list = base::MakeRefCounted<DisplayItemList>();
+  PaintFlags flags;
+  for (int y = 0; y < 4000; y += 20) {
+    for (int x = 0; x < 1000; x += 20) {
+      flags.setColor(SkColorSetRGB(x % 256, y % 256, 128));
+      list->StartPaint();
+      list->push<DrawRectOp>(SkRect::MakeXYWH(x, y, 16, 16), flags);
+      list->EndPaintOfUnpaired(gfx::Rect(x, y, 16, 16));
+    }
+  }
+  list->Finalize();
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(256, 256);
+  SkCanvas canvas(bitmap, SkSurfaceProps{});
+  canvas.translate(-512, -2048);
+  canvas.clipRect(SkRect::MakeXYWH(512, 2048, 256, 256));
+
+  timer_.Reset();
+  do {
+    list->Raster(&canvas);
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  perf_test::PerfResultReporter reporter("display_item_list", "raster_tile");
+  reporter.RegisterImportantMetric("", "runs/s");
+  reporter.AddResult("", timer_.LapsPerSecond());
+
+  DisplayItemList::RasterQueryCache query_cache;
+  timer_.Reset();
+  do {
+    list->Raster(&canvas, nullptr, &query_cache);
+    timer_.NextLap();
+  } while (!timer_.HasTimeLimitExpired());
+
+  reporter =
+      perf_test::PerfResultReporter("display_item_list", "raster_tile_cached");
+  reporter.RegisterImportantMetric("", "runs/s");
+  reporter.AddResult("", timer_.LapsPerSecond());
+}
+
 }  // namespace
 }  // namespace cc
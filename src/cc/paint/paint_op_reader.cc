@@ -250,6 +250,30 @@ void PaintOpReader::Read(SkPath* path) {
 }
 
 void PaintOpReader::Read(PaintFlags* flags) {
+  uint32_t entry_state_int = 0u;
+  ReadSimple(&entry_state_int);
+  if (entry_state_int > static_cast<uint32_t>(PaintCacheEntryState::kLast)) {
+    SetInvalid();
+    return;
+  }
+
+  auto entry_state = static_cast<PaintCacheEntryState>(entry_state_int);
+  PaintCacheId id = 0u;
+  if (entry_state != PaintCacheEntryState::kEmpty) {
+    if (!options_.paint_cache) {
+      SetInvalid();
+      return;
+    }
+    ReadSimple(&id);
+    if (!valid_)
+      return;
+  }
+  if (entry_state == PaintCacheEntryState::kCached) {
+    if (!options_.paint_cache->GetPaintFlags(id, flags))
+      SetInvalid();
+    return;
+  }
+
   ReadSimple(&flags->color_);
   Read(&flags->width_);
   Read(&flags->miter_limit_);
@@ -275,6 +299,16 @@ void PaintOpReader::Read(PaintFlags* flags) {
 
   Read(&flags->image_filter_);
   Read(&flags->shader_);
+
+  if (!valid_ || entry_state != PaintCacheEntryState::kInlined)
+    return;
+  // Only flags without effects are cached.
+  if (flags->path_effect_ || flags->shader_ || flags->mask_filter_ ||
+      flags->color_filter_ || flags->draw_looper_ || flags->image_filter_) {
+    SetInvalid();
+    return;
+  }
+  options_.paint_cache->PutPaintFlags(id, *flags);
 }
 
 void PaintOpReader::Read(PaintImage* image) {
@@ -624,7 +658,36 @@ void PaintOpReader::Read(SkMatrix* matrix) {
 }
 
 void PaintOpReader::Read(SkM44* matrix) {
-  ReadSimple(matrix);
+  uint8_t type_int = 0u;
+  Read(&type_int);
+  if (type_int >
+      static_cast<uint8_t>(PaintOp::SerializedMatrixType::kLastType)) {
+    SetInvalid();
+    return;
+  }
+
+  SkScalar sx = 1.f;
+  SkScalar sy = 1.f;
+  SkScalar tx = 0.f;
+  SkScalar ty = 0.f;
+  switch (static_cast<PaintOp::SerializedMatrixType>(type_int)) {
+    case PaintOp::SerializedMatrixType::kIdentity:
+      break;
+    case PaintOp::SerializedMatrixType::kScaleTranslate:
+      Read(&sx);
+      Read(&sy);
+      FALLTHROUGH;
+    case PaintOp::SerializedMatrixType::kTranslate:
+      Read(&tx);
+      Read(&ty);
+      break;
+    case PaintOp::SerializedMatrixType::kGeneral:
+      ReadSimple(matrix);
+      return;
+  }
+  *matrix = SkM44::Scale(sx, sy);
+  matrix->setRC(0, 3, tx);
+  matrix->setRC(1, 3, ty);
 }
 
 void PaintOpReader::Read(SkSamplingOptions* sampling) {
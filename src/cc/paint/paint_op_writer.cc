@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "base/bit_cast.h"
 #include "base/bits.h"
 #include "cc/paint/draw_image.h"
 #include "cc/paint/image_provider.h"
@@ -207,6 +208,24 @@ void PaintOpWriter::Write(const SkPath& path) {
 }
 
 void PaintOpWriter::Write(const PaintFlags& flags) {
+  // Flags without effects are sent once and referenced by id afterwards.
+  auto entry_state = PaintCacheEntryState::kEmpty;
+  PaintCacheId id = 0u;
+  if (options_.paint_cache && !options_.for_identifiability_study &&
+      !flags.path_effect_ && !flags.shader_ && !flags.mask_filter_ &&
+      !flags.color_filter_ && !flags.draw_looper_ && !flags.image_filter_) {
+    PaintFlagsCacheKey key = {flags.color_, bit_cast<uint32_t>(flags.width_),
+                              bit_cast<uint32_t>(flags.miter_limit_),
+                              flags.blend_mode_, flags.bitfields_uint_};
+    entry_state = options_.paint_cache->GetOrPutPaintFlags(key, &id);
+  }
+
+  Write(static_cast<uint32_t>(entry_state));
+  if (entry_state != PaintCacheEntryState::kEmpty)
+    Write(id);
+  if (entry_state == PaintCacheEntryState::kCached)
+    return;
+
   WriteSimple(flags.color_);
   Write(flags.width_);
   Write(flags.miter_limit_);
@@ -461,7 +480,37 @@ void PaintOpWriter::Write(SkMatrix matrix) {
 }
 
 void PaintOpWriter::Write(const SkM44& matrix) {
-  WriteSimple(matrix);
+  // Most matrices recorded are 2D translations and scales, so only write the
+  // components that differ from the identity for those.
+  SkScalar m[16];
+  matrix.getColMajor(m);
+  bool is_scale_translate = true;
+  for (size_t i = 0; i < 16 && is_scale_translate; ++i) {
+    if (i == 0 || i == 5 || i == 12 || i == 13)
+      continue;
+    is_scale_translate = m[i] == (i % 5 == 0 ? 1.f : 0.f);
+  }
+
+  if (!is_scale_translate) {
+    Write(static_cast<uint8_t>(PaintOp::SerializedMatrixType::kGeneral));
+    WriteSimple(matrix);
+    return;
+  }
+  if (m[0] != 1.f || m[5] != 1.f) {
+    Write(static_cast<uint8_t>(PaintOp::SerializedMatrixType::kScaleTranslate));
+    Write(m[0]);
+    Write(m[5]);
+    Write(m[12]);
+    Write(m[13]);
+    return;
+  }
+  if (m[12] != 0.f || m[13] != 0.f) {
+    Write(static_cast<uint8_t>(PaintOp::SerializedMatrixType::kTranslate));
+    Write(m[12]);
+    Write(m[13]);
+    return;
+  }
+  Write(static_cast<uint8_t>(PaintOp::SerializedMatrixType::kIdentity));
 }
 
 void PaintOpWriter::Write(const PaintShader* shader, SkFilterQuality quality) {
@@ -10,11 +10,17 @@
 #include <algorithm>
 #include <utility>
 
+#include "base/bind.h"
 #include "base/memory/shared_memory_mapping.h"
+#include "base/optional.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_event.h"
 #include "base/trace_event/traced_value.h"
+#include "cc/base/parallel_for.h"
+#include "cc/paint/image_provider.h"
 #include "cc/raster/raster_source.h"
 #include "cc/trees/layer_tree_frame_sink.h"
 #include "components/viz/common/resources/bitmap_allocation.h"
@@ -23,6 +29,124 @@
 namespace cc {
 namespace {
 
+// Bands shorter than this are not worth the scheduling overhead of playing
+// them back on a separate thread.
+constexpr int kMinPlaybackBandHeight = 64;
+
+// Forwards to an ImageProvider that is not thread-safe, such as the
+// PlaybackImageProvider of a raster task, from concurrently played back bands.
+// Both getting an image and releasing it hold a lock, so the wrapped provider
+// and the decode cache entries it hands out are never used concurrently.
+class SerializedImageProvider : public ImageProvider {
+ public:
+  explicit SerializedImageProvider(ImageProvider* image_provider)
+      : image_provider_(image_provider) {}
+  SerializedImageProvider(const SerializedImageProvider&) = delete;
+  SerializedImageProvider& operator=(const SerializedImageProvider&) = delete;
+
+  // ImageProvider implementation.
+  ScopedResult GetRasterContent(const DrawImage& draw_image) override {
+    base::AutoLock hold(lock_);
+    ScopedResult result = image_provider_->GetRasterContent(draw_image);
+    if (!result.needs_unlock())
+      return result;
+    DecodedDrawImage decoded_image = result.decoded_image();
+    return ScopedResult(
+        std::move(decoded_image),
+        base::BindOnce(&SerializedImageProvider::ReleaseResult,
+                       base::Unretained(this), std::move(result)));
+  }
+
+ private:
+  void ReleaseResult(ScopedResult result) {
+    base::AutoLock hold(lock_);
+    result = ScopedResult();
+  }
+
+  base::Lock lock_;
+  ImageProvider* const image_provider_ PT_GUARDED_BY(lock_);
+};
+
+// Splits |playback_rect| into at most |max_bands| horizontal bands, each at
+// least kMinPlaybackBandHeight tall, and rasterizes them concurrently. The
+// thread calling Run() participates in the work, so this never blocks on the
+// availability of other workers.
+class ParallelBandPlayback {
+ public:
+  ParallelBandPlayback(void* pixels,
+                       const gfx::Size& resource_size,
+                       const gfx::ColorSpace& color_space,
+                       const RasterSource* raster_source,
+                       const gfx::Rect& raster_full_rect,
+                       const gfx::Rect& playback_rect,
+                       const gfx::AxisTransform2d& transform,
+                       const RasterSource::PlaybackSettings& playback_settings,
+                       int num_bands)
+      : pixels_(pixels),
+        resource_size_(resource_size),
+        color_space_(color_space),
+        raster_source_(raster_source),
+        raster_full_rect_(raster_full_rect),
+        playback_rect_(playback_rect),
+        transform_(transform),
+        playback_settings_(playback_settings),
+        num_bands_(num_bands),
+        band_height_((playback_rect.height() + num_bands - 1) / num_bands) {}
+  ParallelBandPlayback(const ParallelBandPlayback&) = delete;
+  ParallelBandPlayback& operator=(const ParallelBandPlayback&) = delete;
+
+  static int ComputeBandCount(const gfx::Rect& playback_rect, int max_bands) {
+    int bands_by_height = playback_rect.height() / kMinPlaybackBandHeight;
+    return std::max(1, std::min(max_bands, bands_by_height));
+  }
+
+  void Run() {
+    TRACE_EVENT1("cc", "ParallelBandPlayback::Run", "num_bands", num_bands_);
+    base::Optional<SerializedImageProvider> image_provider;
+    if (playback_settings_.image_provider) {
+      image_provider.emplace(playback_settings_.image_provider);
+      playback_settings_.image_provider = &image_provider.value();
+    }
+    // Bands have different clips and run at the same time, so they can not
+    // share a query cache.
+    playback_settings_.raster_query_cache = nullptr;
+    ParallelFor(num_bands_, num_bands_,
+                base::BindRepeating(&ParallelBandPlayback::PlaybackBand,
+                                    base::Unretained(this)));
+  }
+
+ private:
+  void PlaybackBand(size_t band) const {
+    int band_top = playback_rect_.y() + static_cast<int>(band) * band_height_;
+    gfx::Rect band_rect(playback_rect_.x(), band_top, playback_rect_.width(),
+                        band_height_);
+    band_rect.Intersect(playback_rect_);
+    if (band_rect.IsEmpty())
+      return;
+
+    // Every band uses its own canvas over a disjoint set of rows of the same
+    // pixel memory, so no synchronization is needed between them.
+    size_t stride = 0u;
+    RasterBufferProvider::PlaybackToMemory(
+        pixels_, viz::RGBA_8888, resource_size_, stride, raster_source_,
+        raster_full_rect_, band_rect, transform_, color_space_,
+        /*gpu_compositing=*/false, playback_settings_);
+  }
+
+  void* const pixels_;
+  const gfx::Size resource_size_;
+  const gfx::ColorSpace color_space_;
+  const RasterSource* const raster_source_;
+  const gfx::Rect raster_full_rect_;
+  const gfx::Rect playback_rect_;
+  const gfx::AxisTransform2d transform_;
+  // Its |image_provider| is replaced by a SerializedImageProvider and its
+  // |raster_query_cache| is dropped while the bands run.
+  RasterSource::PlaybackSettings playback_settings_;
+  const int num_bands_;
+  const int band_height_;
+};
+
 class BitmapSoftwareBacking : public ResourcePool::SoftwareBacking {
  public:
   ~BitmapSoftwareBacking() override {
@@ -48,13 +172,14 @@ class BitmapRasterBufferImpl : public RasterBuffer {
                          const gfx::ColorSpace& color_space,
                          void* pixels,
                          uint64_t resource_content_id,
-                         uint64_t previous_content_id)
+                         uint64_t previous_content_id,
+                         int max_playback_bands)
       : resource_size_(size),
         color_space_(color_space),
         pixels_(pixels),
         resource_has_previous_content_(
-            resource_content_id && resource_content_id == previous_content_id) {
-  }
+            resource_content_id && resource_content_id == previous_content_id),
+        max_playback_bands_(max_playback_bands) {}
   BitmapRasterBufferImpl(const BitmapRasterBufferImpl&) = delete;
   BitmapRasterBufferImpl& operator=(const BitmapRasterBufferImpl&) = delete;
 
@@ -74,6 +199,18 @@ class BitmapRasterBufferImpl : public RasterBuffer {
     DCHECK(!playback_rect.IsEmpty())
         << "Why are we rastering a tile that's not dirty?";
 
+    int num_bands = playback_settings.allow_parallel_playback
+                        ? ParallelBandPlayback::ComputeBandCount(
+                              playback_rect, max_playback_bands_)
+                        : 1;
+    if (num_bands > 1) {
+      ParallelBandPlayback(pixels_, resource_size_, color_space_,
+                           raster_source, raster_full_rect, playback_rect,
+                           transform, playback_settings, num_bands)
+          .Run();
+      return;
+    }
+
     size_t stride = 0u;
     RasterBufferProvider::PlaybackToMemory(
         pixels_, viz::RGBA_8888, resource_size_, stride, raster_source,
@@ -88,13 +225,21 @@ class BitmapRasterBufferImpl : public RasterBuffer {
   const gfx::ColorSpace color_space_;
   void* const pixels_;
   bool resource_has_previous_content_;
+  const int max_playback_bands_;
 };
 
 }  // namespace
 
 BitmapRasterBufferProvider::BitmapRasterBufferProvider(
     LayerTreeFrameSink* frame_sink)
-    : frame_sink_(frame_sink) {}
+    : BitmapRasterBufferProvider(frame_sink, /*max_playback_bands=*/1) {}
+
+BitmapRasterBufferProvider::BitmapRasterBufferProvider(
+    LayerTreeFrameSink* frame_sink,
+    int max_playback_bands)
+    : frame_sink_(frame_sink), max_playback_bands_(max_playback_bands) {
+  DCHECK_GE(max_playback_bands_, 1);
+}
 
 BitmapRasterBufferProvider::~BitmapRasterBufferProvider() = default;
 
@@ -127,7 +272,7 @@ BitmapRasterBufferProvider::AcquireBufferForRaster(
 
   return std::make_unique<BitmapRasterBufferImpl>(
       size, color_space, backing->mapping.memory(), resource_content_id,
-      previous_content_id);
+      previous_content_id, max_playback_bands_);
 }
 
 void BitmapRasterBufferProvider::Flush() {}
@@ -31,6 +31,11 @@ class CC_EXPORT BitmapRasterBufferProvider : public RasterBufferProvider {
       delete;
 
   explicit BitmapRasterBufferProvider(LayerTreeFrameSink* frame_sink);
+  // |max_playback_bands| > 1 allows a single tile playback to be split into
+  // that many horizontal bands which are rasterized concurrently. This is
+  // intended for configurations where software raster carries the whole frame.
+  BitmapRasterBufferProvider(LayerTreeFrameSink* frame_sink,
+                             int max_playback_bands);
 
   // Overridden from RasterBufferProvider:
   std::unique_ptr<RasterBuffer> AcquireBufferForRaster(
@@ -57,6 +62,7 @@ class CC_EXPORT BitmapRasterBufferProvider : public RasterBufferProvider {
       const;
 
   LayerTreeFrameSink* const frame_sink_;
+  const int max_playback_bands_;
 };
 
 }  // namespace cc
@@ -0,0 +1,210 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/bitmap_raster_buffer_provider.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "cc/paint/image_provider.h"
+#include "cc/resources/resource_pool.h"
+#include "cc/test/fake_layer_tree_frame_sink.h"
+#include "cc/test/fake_raster_source.h"
+#include "cc/test/fake_recording_source.h"
+#include "cc/test/skia_common.h"
+#include "components/viz/client/client_resource_provider.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/axis_transform2d.h"
+#include "url/gurl.h"
+
+namespace cc {
+namespace {
+
+// Keeps a read-only mapping of every shared bitmap, so that tests can look at
+// the pixels that were rastered into it.
+class PixelReadingFrameSink : public FakeLayerTreeFrameSink {
+ public:
+  PixelReadingFrameSink() : FakeLayerTreeFrameSink(nullptr, nullptr) {}
+
+  void DidAllocateSharedBitmap(base::ReadOnlySharedMemoryRegion region,
+                               const viz::SharedBitmapId& id) override {
+    mappings_.push_back(region.Map());
+    FakeLayerTreeFrameSink::DidAllocateSharedBitmap(std::move(region), id);
+  }
+
+  const base::ReadOnlySharedMemoryMapping& last_mapping() const {
+    return mappings_.back();
+  }
+
+ private:
+  std::vector<base::ReadOnlySharedMemoryMapping> mappings_;
+};
+
+// Checks that it is never called from two threads at once, like a
+// PlaybackImageProvider expects, and that every result it hands out is
+// released.
+class ConcurrencyCheckingImageProvider : public ImageProvider {
+ public:
+  ConcurrencyCheckingImageProvider() {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    bitmap.eraseColor(SK_ColorRED);
+    image_ = SkImage::MakeFromBitmap(bitmap);
+  }
+
+  // ImageProvider implementation.
+  ScopedResult GetRasterContent(const DrawImage& draw_image) override {
+    Enter();
+    ++num_results_;
+    ++num_outstanding_results_;
+    Leave();
+    return ScopedResult(
+        DecodedDrawImage(image_, nullptr, SkSize::Make(0, 0),
+                         SkSize::Make(1, 1), kLow_SkFilterQuality, true),
+        base::BindOnce(&ConcurrencyCheckingImageProvider::ReleaseResult,
+                       base::Unretained(this)));
+  }
+
+  int max_concurrent_calls() const { return max_concurrent_calls_; }
+  int num_results() const { return num_results_; }
+  int num_outstanding_results() const { return num_outstanding_results_; }
+
+ private:
+  void ReleaseResult() {
+    Enter();
+    --num_outstanding_results_;
+    Leave();
+  }
+
+  void Enter() {
+    const int concurrent_calls = ++num_active_calls_;
+    int max_concurrent_calls = max_concurrent_calls_.load();
+    while (max_concurrent_calls < concurrent_calls &&
+           !max_concurrent_calls_.compare_exchange_weak(max_concurrent_calls,
+                                                        concurrent_calls)) {
+    }
+    // Widen the window in which another band could call in.
+    base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(1));
+  }
+  void Leave() { --num_active_calls_; }
+
+  sk_sp<SkImage> image_;
+  std::atomic<int> num_active_calls_{0};
+  std::atomic<int> max_concurrent_calls_{0};
+  std::atomic<int> num_results_{0};
+  std::atomic<int> num_outstanding_results_{0};
+};
+
+class BitmapRasterBufferProviderTest : public testing::Test {
+ protected:
+  // Records anti-aliased content that crosses the boundaries between bands at
+  // fractional positions once scaled.
+  static scoped_refptr<RasterSource> CreateRasterSource() {
+    const gfx::Size layer_size(400, 400);
+    std::unique_ptr<FakeRecordingSource> recording_source =
+        FakeRecordingSource::CreateFilledRecordingSource(layer_size);
+
+    PaintFlags flags;
+    flags.setAntiAlias(true);
+    flags.setColor(SK_ColorWHITE);
+    recording_source->add_draw_rect_with_flags(gfx::Rect(layer_size), flags);
+    for (int i = 0; i < 40; ++i) {
+      flags.setColor(SkColorSetARGB(128 + i * 3, i * 6, 255 - i * 6, i * 4));
+      recording_source->add_draw_rectf_with_flags(
+          gfx::RectF(i * 7.3f, i * 9.7f, 130.5f, 61.25f), flags);
+    }
+    recording_source->Rerecord();
+    return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+  }
+
+  // Records a column of lazily decoded images that spans all bands.
+  static scoped_refptr<RasterSource> CreateRasterSourceWithImages() {
+    const gfx::Size layer_size(400, 400);
+    std::unique_ptr<FakeRecordingSource> recording_source =
+        FakeRecordingSource::CreateFilledRecordingSource(layer_size);
+    for (int i = 0; i < 10; ++i) {
+      recording_source->add_draw_image(
+          CreateDiscardablePaintImage(gfx::Size(32, 32)),
+          gfx::Point(20, i * 40));
+    }
+    recording_source->Rerecord();
+    return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+  }
+
+  // Rasters |raster_source| into a new tile with a provider that splits
+  // playback into at most |max_playback_bands| bands, and returns the pixels.
+  std::vector<uint8_t> Raster(const RasterSource* raster_source,
+                              int max_playback_bands,
+                              ImageProvider* image_provider) {
+    PixelReadingFrameSink frame_sink;
+    viz::ClientResourceProvider resource_provider;
+    ResourcePool resource_pool(&resource_provider, nullptr,
+                               base::ThreadTaskRunnerHandle::Get(),
+                               ResourcePool::kDefaultExpirationDelay, false);
+    BitmapRasterBufferProvider raster_buffer_provider(&frame_sink,
+                                                      max_playback_bands);
+
+    const gfx::Rect tile_rect(0, 0, 256, 512);
+    ResourcePool::InUsePoolResource resource = resource_pool.AcquireResource(
+        tile_rect.size(), viz::RGBA_8888, gfx::ColorSpace::CreateSRGB());
+    std::unique_ptr<RasterBuffer> raster_buffer =
+        raster_buffer_provider.AcquireBufferForRaster(
+            resource, 0, 0, false,
+            false /* depends_on_hardware_accelerated_jpeg_candidates */,
+            false /* depends_on_hardware_accelerated_webp_candidates */);
+
+    RasterSource::PlaybackSettings settings;
+    settings.allow_parallel_playback = true;
+    settings.image_provider = image_provider;
+    raster_buffer->Playback(raster_source, tile_rect, tile_rect, 0u,
+                            gfx::AxisTransform2d(1.5f, gfx::Vector2dF()),
+                            settings, GURL());
+
+    const uint8_t* pixels =
+        frame_sink.last_mapping().GetMemoryAs<const uint8_t>();
+    std::vector<uint8_t> result(pixels,
+                                pixels + tile_rect.size().GetArea() * 4);
+
+    raster_buffer = nullptr;
+    resource_pool.ReleaseResource(std::move(resource));
+    raster_buffer_provider.Shutdown();
+    return result;
+  }
+};
+
+TEST_F(BitmapRasterBufferProviderTest, BandedPlaybackMatchesSerialPlayback) {
+  scoped_refptr<RasterSource> raster_source = CreateRasterSource();
+  std::vector<uint8_t> serial = Raster(raster_source.get(), 1, nullptr);
+
+  for (int max_playback_bands : {2, 3, 8}) {
+    std::vector<uint8_t> banded =
+        Raster(raster_source.get(), max_playback_bands, nullptr);
+    ASSERT_EQ(serial.size(), banded.size());
+    EXPECT_EQ(0, memcmp(serial.data(), banded.data(), serial.size()))
+        << "max_playback_bands=" << max_playback_bands;
+  }
+}
+
+TEST_F(BitmapRasterBufferProviderTest, BandedPlaybackSerializesImageProvider) {
+  scoped_refptr<RasterSource> raster_source = CreateRasterSourceWithImages();
+  ConcurrencyCheckingImageProvider image_provider;
+  Raster(raster_source.get(), 8, &image_provider);
+
+  EXPECT_GT(image_provider.num_results(), 1);
+  EXPECT_EQ(1, image_provider.max_concurrent_calls());
+  EXPECT_EQ(0, image_provider.num_outstanding_results());
+}
+
+}  // namespace
+}  // namespace cc
@@ -5,6 +5,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
 #include "base/test/test_simple_task_runner.h"
 #include "base/time/time.h"
 #include "base/timer/lap_timer.h"
@@ -18,6 +20,8 @@
 #include "cc/raster/zero_copy_raster_buffer_provider.h"
 #include "cc/resources/resource_pool.h"
 #include "cc/test/fake_layer_tree_frame_sink.h"
+#include "cc/test/fake_raster_source.h"
+#include "cc/test/fake_recording_source.h"
 #include "cc/tiles/tile_task_manager.h"
 #include "components/viz/client/client_resource_provider.h"
 #include "components/viz/common/gpu/context_cache_controller.h"
@@ -33,6 +37,8 @@
 #include "testing/perf/perf_result_reporter.h"
 #include "third_party/khronos/GLES2/gl2.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
+#include "ui/gfx/geometry/axis_transform2d.h"
+#include "url/gurl.h"
 
 namespace cc {
 namespace {
@@ -654,5 +660,133 @@ TEST_F(RasterBufferProviderCommonPerfTest, BuildTileTaskGraph) {
   RunBuildTileTaskGraphTest("32_4", 32, 4);
 }
 
+// Measures software raster throughput of a full viewport of tiles for a
+// varying number of concurrently rasterized playback bands per tile.
+class BitmapRasterBufferProviderPlaybackPerfTest
+    : public RasterBufferProviderPerfTestBase,
+      public testing::TestWithParam<int> {
+ public:
+  // Overridden from testing::Test:
+  void SetUp() override {
+    layer_tree_frame_sink_ = FakeLayerTreeFrameSink::CreateSoftware();
+    resource_provider_ = std::make_unique<viz::ClientResourceProvider>();
+    resource_pool_ = std::make_unique<ResourcePool>(
+        resource_provider_.get(), nullptr, task_runner_,
+        ResourcePool::kDefaultExpirationDelay, false);
+    raster_buffer_provider_ = std::make_unique<BitmapRasterBufferProvider>(
+        layer_tree_frame_sink_.get(), GetParam());
+  }
+  void TearDown() override {
+    raster_buffer_provider_->Shutdown();
+    resource_pool_.reset();
+  }
+
+  // Records content roughly resembling a text-heavy page: a background,
+  // a column of cards and many short runs standing in for glyphs.
+  scoped_refptr<RasterSource> CreatePageRasterSource(
+      const gfx::Size& layer_size) {
+    std::unique_ptr<FakeRecordingSource> recording_source =
+        FakeRecordingSource::CreateFilledRecordingSource(layer_size);
+
+    PaintFlags background_flags;
+    background_flags.setColor(SK_ColorWHITE);
+    recording_source->add_draw_rect_with_flags(gfx::Rect(layer_size),
+                                               background_flags);
+
+    PaintFlags card_flags;
+    card_flags.setColor(SkColorSetARGB(230, 240, 240, 250));
+    card_flags.setAntiAlias(true);
+    PaintFlags text_flags;
+    text_flags.setColor(SK_ColorBLACK);
+    text_flags.setAntiAlias(true);
+    for (int y = 16; y + 200 < layer_size.height(); y += 216) {
+      recording_source->add_draw_rectf_with_flags(
+          gfx::RectF(16.5f, y + 0.5f, layer_size.width() - 32.f, 200.f),
+          card_flags);
+      for (int line_y = y + 16; line_y < y + 184; line_y += 18) {
+        for (int word_x = 32; word_x + 40 < layer_size.width() - 32;
+             word_x += 48) {
+          recording_source->add_draw_rectf_with_flags(
+              gfx::RectF(word_x + 0.25f, line_y + 0.25f, 40.f, 11.5f),
+              text_flags);
+        }
+      }
+    }
+
+    recording_source->Rerecord();
+    return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+  }
+
+  void RunPlaybackTest(const std::string& test_name,
+                       const gfx::Size& tile_size) {
+    const gfx::Size layer_size(1920, 1080);
+    scoped_refptr<RasterSource> raster_source =
+        CreatePageRasterSource(layer_size);
+
+    std::vector<gfx::Rect> tile_rects;
+    for (int y = 0; y < layer_size.height(); y += tile_size.height()) {
+      for (int x = 0; x < layer_size.width(); x += tile_size.width()) {
+        gfx::Rect tile_rect(gfx::Point(x, y), tile_size);
+        tile_rect.Intersect(gfx::Rect(layer_size));
+        tile_rects.push_back(tile_rect);
+      }
+    }
+
+    ResourcePool::InUsePoolResource resource = resource_pool_->AcquireResource(
+        tile_size, viz::RGBA_8888, gfx::ColorSpace::CreateSRGB());
+    std::unique_ptr<RasterBuffer> raster_buffer =
+        raster_buffer_provider_->AcquireBufferForRaster(
+            resource, 0, 0, false,
+            false /* depends_on_hardware_accelerated_jpeg_candidates */,
+            false /* depends_on_hardware_accelerated_webp_candidates */);
+
+    RasterSource::PlaybackSettings settings;
+    settings.allow_parallel_playback = true;
+
+    // Each lap rasterizes every tile covering the viewport once.
+    timer_.Reset();
+    do {
+      for (const gfx::Rect& tile_rect : tile_rects) {
+        raster_buffer->Playback(raster_source.get(), tile_rect, tile_rect,
+                                0u, gfx::AxisTransform2d(), settings, GURL());
+      }
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    raster_buffer = nullptr;
+    resource_pool_->ReleaseResource(std::move(resource));
+
+    perf_test::PerfResultReporter reporter = SetUpReporter(test_name);
+    reporter.AddResult("_frames" + TestModifierString(),
+                       timer_.LapsPerSecond());
+  }
+
+ protected:
+  perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+    perf_test::PerfResultReporter reporter("software_raster_playback",
+                                           story_name);
+    reporter.RegisterImportantMetric("_frames" + TestModifierString(),
+                                     "frames/s");
+    return reporter;
+  }
+
+  std::string TestModifierString() const {
+    return "_" + base::NumberToString(GetParam()) + "_bands";
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<RasterBufferProvider> raster_buffer_provider_;
+};
+
+TEST_P(BitmapRasterBufferProviderPlaybackPerfTest, PlaybackViewport) {
+  RunPlaybackTest("256x256", gfx::Size(256, 256));
+  RunPlaybackTest("512x512", gfx::Size(512, 512));
+  RunPlaybackTest("1920x256", gfx::Size(1920, 256));
+}
+
+INSTANTIATE_TEST_SUITE_P(BitmapRasterBufferProviderPlaybackPerfTests,
+                         BitmapRasterBufferProviderPlaybackPerfTest,
+                         ::testing::Values(1, 2, 4, 8));
+
 }  // namespace
 }  // namespace cc
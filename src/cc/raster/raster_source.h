@@ -13,6 +13,7 @@
 #include "cc/cc_export.h"
 #include "cc/debug/rendering_stats_instrumentation.h"
 #include "cc/layers/recording_source.h"
+#include "cc/paint/display_item_list.h"
 #include "cc/paint/image_id.h"
 #include "gpu/command_buffer/client/raster_interface.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -23,7 +24,6 @@ class AxisTransform2d;
 }  // namespace gfx
 
 namespace cc {
-class DisplayItemList;
 class DrawImage;
 class ImageProvider;
 class PictureLayerTilingClient;
@@ -43,6 +43,16 @@ class CC_EXPORT RasterSource : public base::RefCountedThreadSafe<RasterSource> {
     int msaa_sample_count = 0;
 
     ImageProvider* image_provider = nullptr;
+
+    // If set, the rtree query of the playback is kept here and reused when the
+    // same display list is played back with the same clip again. Must not be
+    // used by two playbacks at once.
+    DisplayItemList::RasterQueryCache* raster_query_cache = nullptr;
+
+    // If set to true, the raster buffer may split the playback across several
+    // threads. Only set for tiles that are needed for the next frame, so that
+    // prepaint work does not take threads away from them.
+    bool allow_parallel_playback = false;
   };
 
   RasterSource(const RasterSource&) = delete;
@@ -136,8 +146,9 @@ class CC_EXPORT RasterSource : public base::RefCountedThreadSafe<RasterSource> {
   // This function will replace pixels in the clip region without blending.
   //
   // Virtual for testing.
-  virtual void PlaybackDisplayListToCanvas(SkCanvas* canvas,
-                                           ImageProvider* image_provider) const;
+  virtual void PlaybackDisplayListToCanvas(
+      SkCanvas* canvas,
+      const PlaybackSettings& settings) const;
 
   // The serialized size for the largest op in this RasterSource. This is
   // accessed only on the raster threads with the context lock acquired.
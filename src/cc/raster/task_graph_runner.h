@@ -29,6 +29,7 @@ class CC_EXPORT NamespaceToken {
 
  private:
   friend class TaskGraphWorkQueue;
+  friend class WorkStealingTaskGraphRunner;
 
   explicit NamespaceToken(int id) : id_(id) {}
 
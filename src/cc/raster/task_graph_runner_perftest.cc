@@ -6,13 +6,22 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/ptr_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "base/timer/lap_timer.h"
 #include "cc/base/completion_event.h"
 #include "cc/raster/synchronous_task_graph_runner.h"
+#include "cc/raster/task_category.h"
+#include "cc/raster/task_graph_work_queue.h"
+#include "cc/raster/work_stealing_task_graph_runner.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
 
@@ -277,6 +286,197 @@ class TaskGraphRunnerPerfTest : public testing::Test {
   base::LapTimer timer_;
 };
 
+// Task that does a small amount of work, standing in for the image decode and
+// raster tasks the tile manager schedules.
+class ThreadedPerfTaskImpl : public Task {
+ public:
+  typedef std::vector<scoped_refptr<ThreadedPerfTaskImpl>> Vector;
+
+  ThreadedPerfTaskImpl() = default;
+  ThreadedPerfTaskImpl(const ThreadedPerfTaskImpl&) = delete;
+  ThreadedPerfTaskImpl& operator=(const ThreadedPerfTaskImpl&) = delete;
+
+  // Overridden from Task:
+  void RunOnWorkerThread() override {
+    uint32_t value = 1;
+    for (int i = 0; i < 2000; ++i)
+      value = value * 1664525u + 1013904223u;
+    result_ = value;
+  }
+
+  void Reset() { state().Reset(); }
+  uint32_t result() const { return result_; }
+
+ private:
+  ~ThreadedPerfTaskImpl() override = default;
+
+  uint32_t result_ = 0;
+};
+
+// Runs tasks on worker threads that share a single TaskGraphWorkQueue under
+// one lock, like content::CategorizedWorkerPool does. Only used as the
+// baseline for WorkStealingTaskGraphRunner, so it ignores categories.
+class SharedQueueTaskGraphRunner : public TaskGraphRunner,
+                                   public base::DelegateSimpleThread::Delegate {
+ public:
+  SharedQueueTaskGraphRunner()
+      : has_ready_to_run_tasks_cv_(&lock_),
+        has_namespaces_with_finished_running_tasks_cv_(&lock_) {}
+  SharedQueueTaskGraphRunner(const SharedQueueTaskGraphRunner&) = delete;
+  ~SharedQueueTaskGraphRunner() override = default;
+
+  SharedQueueTaskGraphRunner& operator=(const SharedQueueTaskGraphRunner&) =
+      delete;
+
+  void Start(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.push_back(std::make_unique<base::DelegateSimpleThread>(
+          this, "SharedQueueTaskGraphRunnerWorker"));
+      threads_.back()->StartAsync();
+    }
+  }
+
+  void Shutdown() {
+    {
+      base::AutoLock lock(lock_);
+      shutdown_ = true;
+      has_ready_to_run_tasks_cv_.Broadcast();
+    }
+    for (auto& thread : threads_)
+      thread->Join();
+  }
+
+  // Overridden from TaskGraphRunner:
+  NamespaceToken GenerateNamespaceToken() override {
+    base::AutoLock lock(lock_);
+    return work_queue_.GenerateNamespaceToken();
+  }
+
+  void ScheduleTasks(NamespaceToken token, TaskGraph* graph) override {
+    base::AutoLock lock(lock_);
+    work_queue_.ScheduleTasks(token, graph);
+    has_ready_to_run_tasks_cv_.Broadcast();
+  }
+
+  void WaitForTasksToFinishRunning(NamespaceToken token) override {
+    base::AutoLock lock(lock_);
+    auto* task_namespace = work_queue_.GetNamespaceForToken(token);
+    if (!task_namespace)
+      return;
+    while (!TaskGraphWorkQueue::HasFinishedRunningTasksInNamespace(
+        task_namespace)) {
+      has_namespaces_with_finished_running_tasks_cv_.Wait();
+    }
+  }
+
+  void CollectCompletedTasks(NamespaceToken token,
+                             Task::Vector* completed_tasks) override {
+    base::AutoLock lock(lock_);
+    work_queue_.CollectCompletedTasks(token, completed_tasks);
+  }
+
+  // Overridden from base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    base::AutoLock lock(lock_);
+    while (true) {
+      if (!work_queue_.HasReadyToRunTasksForCategory(
+              TASK_CATEGORY_FOREGROUND)) {
+        if (shutdown_)
+          break;
+        has_ready_to_run_tasks_cv_.Wait();
+        continue;
+      }
+
+      auto prioritized_task =
+          work_queue_.GetNextTaskToRun(TASK_CATEGORY_FOREGROUND);
+      {
+        base::AutoUnlock unlock(lock_);
+        prioritized_task.task->RunOnWorkerThread();
+      }
+
+      auto* task_namespace = prioritized_task.task_namespace;
+      work_queue_.CompleteTask(std::move(prioritized_task));
+      if (work_queue_.HasReadyToRunTasks())
+        has_ready_to_run_tasks_cv_.Signal();
+      if (TaskGraphWorkQueue::HasFinishedRunningTasksInNamespace(
+              task_namespace)) {
+        has_namespaces_with_finished_running_tasks_cv_.Signal();
+      }
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads_;
+  base::Lock lock_;
+  TaskGraphWorkQueue work_queue_;
+  base::ConditionVariable has_ready_to_run_tasks_cv_;
+  base::ConditionVariable has_namespaces_with_finished_running_tasks_cv_;
+  bool shutdown_ = false;
+};
+
+class TaskGraphRunnerThreadedPerfTest : public testing::Test {
+ public:
+  TaskGraphRunnerThreadedPerfTest()
+      : timer_(kWarmupRuns,
+               base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
+               kTimeCheckInterval) {}
+
+  // Schedules |num_decode_tasks| tasks, |num_raster_tasks| tasks that each
+  // depend on one of them and a task that depends on all raster tasks, then
+  // waits for all of them to run.
+  void RunExecuteTasksTest(const std::string& test_name,
+                           TaskGraphRunner* task_graph_runner,
+                           int num_decode_tasks,
+                           int num_raster_tasks) {
+    NamespaceToken token = task_graph_runner->GenerateNamespaceToken();
+    ThreadedPerfTaskImpl::Vector decode_tasks;
+    ThreadedPerfTaskImpl::Vector raster_tasks;
+    for (int i = 0; i < num_decode_tasks; ++i)
+      decode_tasks.push_back(base::MakeRefCounted<ThreadedPerfTaskImpl>());
+    for (int i = 0; i < num_raster_tasks; ++i)
+      raster_tasks.push_back(base::MakeRefCounted<ThreadedPerfTaskImpl>());
+    auto finished_task = base::MakeRefCounted<ThreadedPerfTaskImpl>();
+
+    TaskGraph graph;
+    Task::Vector completed_tasks;
+
+    timer_.Reset();
+    do {
+      graph.Reset();
+      for (auto& task : decode_tasks) {
+        task->Reset();
+        graph.nodes.emplace_back(task, TASK_CATEGORY_FOREGROUND, 1u, 0u);
+      }
+      for (int i = 0; i < num_raster_tasks; ++i) {
+        raster_tasks[i]->Reset();
+        graph.nodes.emplace_back(raster_tasks[i], TASK_CATEGORY_FOREGROUND,
+                                 2u, 1u);
+        graph.edges.emplace_back(decode_tasks[i % num_decode_tasks].get(),
+                                 raster_tasks[i].get());
+        graph.edges.emplace_back(raster_tasks[i].get(), finished_task.get());
+      }
+      finished_task->Reset();
+      graph.nodes.emplace_back(finished_task, TASK_CATEGORY_FOREGROUND, 0u,
+                               static_cast<uint32_t>(num_raster_tasks));
+
+      task_graph_runner->ScheduleTasks(token, &graph);
+      task_graph_runner->WaitForTasksToFinishRunning(token);
+      task_graph_runner->CollectCompletedTasks(token, &completed_tasks);
+      DCHECK_EQ(static_cast<size_t>(num_decode_tasks + num_raster_tasks + 1),
+                completed_tasks.size());
+      completed_tasks.clear();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter("", test_name);
+    reporter.RegisterImportantMetric("execute_tasks_threaded", "runs/s");
+    reporter.AddResult("execute_tasks_threaded", timer_.LapsPerSecond());
+  }
+
+ private:
+  base::LapTimer timer_;
+};
+
 TEST_F(TaskGraphRunnerPerfTest, BuildTaskGraph) {
   RunBuildTaskGraphTest("0_1_0", 0, 1, 0);
   RunBuildTaskGraphTest("0_32_0", 0, 32, 0);
@@ -313,5 +513,25 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
 }
 
+TEST_F(TaskGraphRunnerThreadedPerfTest, ExecuteTasks) {
+  const int kThreadCounts[] = {1, 2, 4, 8};
+  for (int num_threads : kThreadCounts) {
+    SharedQueueTaskGraphRunner shared_queue_runner;
+    shared_queue_runner.Start(num_threads);
+    RunExecuteTasksTest(
+        base::StringPrintf("shared_queue_%d_threads_32_256", num_threads),
+        &shared_queue_runner, 32, 256);
+    shared_queue_runner.Shutdown();
+
+    WorkStealingTaskGraphRunner work_stealing_runner;
+    work_stealing_runner.Start(num_threads, "WorkStealingPerfWorker",
+                               base::SimpleThread::Options());
+    RunExecuteTasksTest(
+        base::StringPrintf("work_stealing_%d_threads_32_256", num_threads),
+        &work_stealing_runner, 32, 256);
+    work_stealing_runner.Shutdown();
+  }
+}
+
 }  // namespace
 }  // namespace cc
@@ -0,0 +1,692 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/work_stealing_task_graph_runner.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "base/containers/circular_deque.h"
+#include "base/containers/contains.h"
+#include "base/containers/span.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/trace_event/trace_event.h"
+#include "cc/raster/task_graph_work_queue.h"
+
+namespace cc {
+
+// The tasks and dependencies of one TaskGraph passed to ScheduleTasks(). The
+// graph itself does not change; only the counts of unfinished dependencies do.
+//
+// Workers enter the state while they start or complete one of its tasks. When
+// a new graph is scheduled for the namespace, the old state is retired: this
+// waits for workers to leave it and makes further attempts to enter it fail,
+// so that ScheduleTasks() sees consistent task states.
+class WorkStealingTaskGraphRunner::GraphState
+    : public base::RefCountedThreadSafe<GraphState> {
+ public:
+  struct Node {
+    scoped_refptr<Task> task;
+    uint16_t category;
+    uint16_t priority;
+    // Range of this node's dependents in |dependents_|.
+    uint32_t first_dependent = 0;
+    uint32_t num_dependents = 0;
+  };
+
+  GraphState(TaskNamespace* task_namespace, const TaskGraph& graph)
+      : task_namespace_(task_namespace),
+        remaining_dependencies_(
+            std::make_unique<std::atomic<uint32_t>[]>(graph.nodes.size())) {
+    nodes_.reserve(graph.nodes.size());
+    for (const TaskGraph::Node& node : graph.nodes) {
+      remaining_dependencies_[nodes_.size()].store(node.dependencies,
+                                                   std::memory_order_relaxed);
+      index_by_task_[node.task.get()] = static_cast<uint32_t>(nodes_.size());
+      nodes_.push_back({node.task, node.category, node.priority});
+    }
+
+    // Group the edges by the task they depend on, which need not be a node of
+    // this graph if it completed before the graph was scheduled.
+    std::vector<std::pair<const Task*, uint32_t>> edges;
+    edges.reserve(graph.edges.size());
+    for (const TaskGraph::Edge& edge : graph.edges)
+      edges.emplace_back(edge.task, index_by_task_.at(edge.dependent));
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const std::pair<const Task*, uint32_t>& a,
+                        const std::pair<const Task*, uint32_t>& b) {
+                       return std::less<const Task*>()(a.first, b.first);
+                     });
+
+    dependents_.reserve(edges.size());
+    for (size_t i = 0; i < edges.size();) {
+      const Task* task = edges[i].first;
+      uint32_t first_dependent = static_cast<uint32_t>(dependents_.size());
+      for (; i < edges.size() && edges[i].first == task; ++i)
+        dependents_.push_back(edges[i].second);
+      uint32_t num_dependents =
+          static_cast<uint32_t>(dependents_.size()) - first_dependent;
+      dependents_by_task_[task] = {first_dependent, num_dependents};
+
+      auto it = index_by_task_.find(task);
+      if (it != index_by_task_.end()) {
+        nodes_[it->second].first_dependent = first_dependent;
+        nodes_[it->second].num_dependents = num_dependents;
+      }
+    }
+  }
+  GraphState(const GraphState&) = delete;
+
+  GraphState& operator=(const GraphState&) = delete;
+
+  TaskNamespace* task_namespace() const { return task_namespace_; }
+  uint32_t size() const { return static_cast<uint32_t>(nodes_.size()); }
+  const Node& node(uint32_t index) const { return nodes_[index]; }
+
+  bool Contains(const Task* task) const {
+    return index_by_task_.find(task) != index_by_task_.end();
+  }
+
+  uint32_t RemainingDependencies(uint32_t index) const {
+    return remaining_dependencies_[index].load(std::memory_order_relaxed);
+  }
+
+  // Returns true if this was the last unfinished dependency of |index|.
+  bool DidFinishDependency(uint32_t index) {
+    uint32_t previous = remaining_dependencies_[index].fetch_sub(
+        1, std::memory_order_acq_rel);
+    DCHECK_LT(0u, previous);
+    return previous == 1;
+  }
+
+  base::span<const uint32_t> GetDependents(uint32_t index) const {
+    const Node& node = nodes_[index];
+    return base::make_span(dependents_.data() + node.first_dependent,
+                           node.num_dependents);
+  }
+
+  base::span<const uint32_t> GetDependents(const Task* task) const {
+    auto it = dependents_by_task_.find(task);
+    if (it == dependents_by_task_.end())
+      return base::span<const uint32_t>();
+    return base::make_span(dependents_.data() + it->second.first,
+                           it->second.second);
+  }
+
+  // Returns false if the state has been retired, in which case it must not be
+  // used to start or complete tasks.
+  bool Enter() {
+    if (users_.fetch_add(1, std::memory_order_acquire) & kRetired) {
+      users_.fetch_sub(1, std::memory_order_release);
+      return false;
+    }
+    return true;
+  }
+  void Leave() { users_.fetch_sub(1, std::memory_order_release); }
+
+  // Waits for all workers to leave. The time spent inside is a few atomic
+  // operations and a push to a worker deque, so spinning is fine.
+  void Retire() {
+    users_.fetch_or(kRetired, std::memory_order_acq_rel);
+    while (users_.load(std::memory_order_acquire) != kRetired)
+      base::PlatformThread::YieldCurrentThread();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<GraphState>;
+
+  static constexpr uint32_t kRetired = 1u << 31;
+
+  ~GraphState() = default;
+
+  TaskNamespace* const task_namespace_;
+  std::vector<Node> nodes_;
+  std::unique_ptr<std::atomic<uint32_t>[]> remaining_dependencies_;
+  std::vector<uint32_t> dependents_;
+  std::unordered_map<const Task*, uint32_t> index_by_task_;
+  // Maps a task to the first index and count of its dependents in
+  // |dependents_|.
+  std::unordered_map<const Task*, std::pair<uint32_t, uint32_t>>
+      dependents_by_task_;
+  std::atomic<uint32_t> users_{0};
+};
+
+struct WorkStealingTaskGraphRunner::TaskNamespace {
+  // Graph passed to the last ScheduleTasks() call.
+  scoped_refptr<GraphState> state;
+
+  // Completed tasks not yet collected by origin thread. Workers buffer their
+  // completed tasks, see FlushCompletedTasksWithLockAcquired().
+  Task::Vector completed_tasks;
+
+  // Number of tasks that are ready to run or running.
+  std::atomic<size_t> pending_tasks{0};
+};
+
+class WorkStealingTaskGraphRunner::Worker
+    : public base::DelegateSimpleThread::Delegate {
+ public:
+  using CompletedTask = std::pair<TaskNamespace*, scoped_refptr<Task>>;
+
+  Worker(WorkStealingTaskGraphRunner* runner, size_t index)
+      : runner_(runner), index_(index) {}
+  Worker(const Worker&) = delete;
+  ~Worker() override = default;
+
+  Worker& operator=(const Worker&) = delete;
+
+  size_t index() const { return index_; }
+
+  void Start(const std::string& thread_name,
+             const base::SimpleThread::Options& thread_options) {
+    thread_ = std::make_unique<base::DelegateSimpleThread>(this, thread_name,
+                                                           thread_options);
+    thread_->StartAsync();
+  }
+  void Join() { thread_->Join(); }
+
+  // Overridden from base::DelegateSimpleThread::Delegate:
+  void Run() override { runner_->RunWorker(this); }
+
+  void PushFront(uint16_t category, ReadyTask task) {
+    base::AutoLock lock(lock_);
+    ready_tasks_[category].push_front(std::move(task));
+  }
+
+  // Appends every |stride|th task starting at |first| from each of the
+  // |ready_tasks| vectors, which are indexed by category.
+  void AddReadyTasks(std::vector<ReadyTask>* ready_tasks,
+                     size_t first,
+                     size_t stride) {
+    base::AutoLock lock(lock_);
+    for (size_t category = 0; category < kNumCategories; ++category) {
+      std::vector<ReadyTask>& tasks = ready_tasks[category];
+      for (size_t i = first; i < tasks.size(); i += stride)
+        ready_tasks_[category].push_back(std::move(tasks[i]));
+    }
+  }
+
+  bool PopFront(uint16_t category, ReadyTask* task) {
+    base::AutoLock lock(lock_);
+    auto& ready_tasks = ready_tasks_[category];
+    if (ready_tasks.empty())
+      return false;
+    *task = std::move(ready_tasks.front());
+    ready_tasks.pop_front();
+    return true;
+  }
+
+  bool PopBack(uint16_t category, ReadyTask* task) {
+    base::AutoLock lock(lock_);
+    auto& ready_tasks = ready_tasks_[category];
+    if (ready_tasks.empty())
+      return false;
+    *task = std::move(ready_tasks.back());
+    ready_tasks.pop_back();
+    return true;
+  }
+
+  void AddCompletedTask(TaskNamespace* task_namespace,
+                        scoped_refptr<Task> task) {
+    base::AutoLock lock(lock_);
+    completed_tasks_.emplace_back(task_namespace, std::move(task));
+  }
+
+  // Appends the buffered completed tasks to |completed_tasks|.
+  void TakeCompletedTasks(std::vector<CompletedTask>* completed_tasks) {
+    base::AutoLock lock(lock_);
+    std::move(completed_tasks_.begin(), completed_tasks_.end(),
+              std::back_inserter(*completed_tasks));
+    completed_tasks_.clear();
+  }
+
+ private:
+  WorkStealingTaskGraphRunner* const runner_;
+  const size_t index_;
+  std::unique_ptr<base::DelegateSimpleThread> thread_;
+
+  // Only contended when another worker steals or the origin thread schedules
+  // or collects tasks.
+  base::Lock lock_;
+  base::circular_deque<ReadyTask> ready_tasks_[kNumCategories]
+      GUARDED_BY(lock_);
+  std::vector<CompletedTask> completed_tasks_ GUARDED_BY(lock_);
+};
+
+WorkStealingTaskGraphRunner::ReadyTask::ReadyTask() = default;
+WorkStealingTaskGraphRunner::ReadyTask::ReadyTask(
+    scoped_refptr<GraphState> state,
+    uint32_t node_index)
+    : state(std::move(state)), node_index(node_index) {}
+WorkStealingTaskGraphRunner::ReadyTask::ReadyTask(ReadyTask&& other) = default;
+WorkStealingTaskGraphRunner::ReadyTask::~ReadyTask() = default;
+WorkStealingTaskGraphRunner::ReadyTask&
+WorkStealingTaskGraphRunner::ReadyTask::operator=(ReadyTask&& other) = default;
+
+WorkStealingTaskGraphRunner::WorkStealingTaskGraphRunner()
+    : has_ready_to_run_tasks_cv_(&lock_),
+      has_namespaces_with_finished_running_tasks_cv_(&lock_) {
+  has_ready_to_run_tasks_cv_.declare_only_used_while_idle();
+}
+
+WorkStealingTaskGraphRunner::~WorkStealingTaskGraphRunner() = default;
+
+void WorkStealingTaskGraphRunner::Start(
+    int num_threads,
+    const std::string& thread_name_prefix,
+    const base::SimpleThread::Options& thread_options) {
+  DCHECK(workers_.empty());
+  DCHECK_GT(num_threads, 0);
+
+  // All workers must exist before any of them can try to steal.
+  for (int i = 0; i < num_threads; ++i)
+    workers_.push_back(std::make_unique<Worker>(this, i));
+  for (int i = 0; i < num_threads; ++i) {
+    workers_[i]->Start(
+        base::StringPrintf("%s%d", thread_name_prefix.c_str(), i + 1),
+        thread_options);
+  }
+}
+
+void WorkStealingTaskGraphRunner::Shutdown() {
+  {
+    base::AutoLock lock(lock_);
+
+    DCHECK(namespaces_.empty());
+
+    DCHECK(!shutdown_);
+    shutdown_ = true;
+
+    // Wake up all workers so they know they should exit.
+    has_ready_to_run_tasks_cv_.Broadcast();
+  }
+  for (auto& worker : workers_)
+    worker->Join();
+}
+
+NamespaceToken WorkStealingTaskGraphRunner::GenerateNamespaceToken() {
+  base::AutoLock lock(lock_);
+  NamespaceToken token(next_namespace_id_++);
+  DCHECK(namespaces_.find(token) == namespaces_.end());
+  return token;
+}
+
+void WorkStealingTaskGraphRunner::ScheduleTasks(NamespaceToken token,
+                                                TaskGraph* graph) {
+  TRACE_EVENT2("cc", "WorkStealingTaskGraphRunner::ScheduleTasks", "num_nodes",
+               graph->nodes.size(), "num_edges", graph->edges.size());
+
+  DCHECK(token.IsValid());
+  DCHECK(!TaskGraphWorkQueue::DependencyMismatch(graph));
+  DCHECK(!workers_.empty());
+
+  base::AutoLock lock(lock_);
+
+  DCHECK(!shutdown_);
+
+  std::unique_ptr<TaskNamespace>& task_namespace = namespaces_[token];
+  if (!task_namespace)
+    task_namespace = std::make_unique<TaskNamespace>();
+
+  // Stop workers from starting or completing tasks of the old graph, so that
+  // the states of its tasks are stable below. Tasks that are running complete
+  // against the new graph.
+  scoped_refptr<GraphState> old_state = std::move(task_namespace->state);
+  if (old_state)
+    old_state->Retire();
+  FlushCompletedTasksWithLockAcquired();
+
+  // First adjust number of dependencies to reflect completed tasks.
+  if (!task_namespace->completed_tasks.empty()) {
+    std::unordered_set<const Task*> completed_tasks;
+    for (const scoped_refptr<Task>& task : task_namespace->completed_tasks)
+      completed_tasks.insert(task.get());
+    std::unordered_map<const Task*, TaskGraph::Node*> nodes_by_task;
+    for (TaskGraph::Node& node : graph->nodes)
+      nodes_by_task[node.task.get()] = &node;
+    for (const TaskGraph::Edge& edge : graph->edges) {
+      if (!completed_tasks.count(edge.task))
+        continue;
+      TaskGraph::Node* node = nodes_by_task.at(edge.dependent);
+      DCHECK_LT(0u, node->dependencies);
+      node->dependencies--;
+    }
+  }
+
+  // If an old task is scheduled to run again and not yet started running,
+  // reset its state as it has to be scheduled in the new graph.
+  if (old_state) {
+    for (const TaskGraph::Node& node : graph->nodes) {
+      if (node.task->state().IsScheduled() &&
+          old_state->Contains(node.task.get())) {
+        node.task->state().Reset();
+        task_namespace->pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  auto state = base::MakeRefCounted<GraphState>(task_namespace.get(), *graph);
+
+  // Build the new ready to run tasks.
+  std::vector<ReadyTask> ready_tasks[kNumCategories];
+  size_t num_ready_tasks = 0;
+  for (uint32_t i = 0; i < state->size(); ++i) {
+    const GraphState::Node& node = state->node(i);
+
+    // Task is not ready to run if dependencies are not yet satisfied, has
+    // already finished or is still running.
+    if (state->RemainingDependencies(i) || node.task->state().IsFinished() ||
+        node.task->state().IsRunning()) {
+      continue;
+    }
+
+    node.task->state().DidSchedule();
+    ready_tasks[node.category].emplace_back(state, i);
+    ++num_ready_tasks;
+  }
+
+  // Cancel tasks of the old graph that are not in the new one and have not
+  // started running.
+  if (old_state) {
+    for (uint32_t i = 0; i < old_state->size(); ++i) {
+      const scoped_refptr<Task>& task = old_state->node(i).task;
+      if (state->Contains(task.get()) || task->state().IsFinished() ||
+          task->state().IsRunning()) {
+        continue;
+      }
+
+      if (task->state().IsScheduled())
+        task_namespace->pending_tasks.fetch_sub(1, std::memory_order_relaxed);
+      DCHECK(!base::Contains(task_namespace->completed_tasks, task));
+      task->state().DidCancel();
+      task_namespace->completed_tasks.push_back(task);
+    }
+  }
+
+  task_namespace->state = state;
+
+  if (num_ready_tasks) {
+    // Count the tasks before workers can see them.
+    task_namespace->pending_tasks.fetch_add(num_ready_tasks,
+                                            std::memory_order_relaxed);
+    // The total is raised before the non-concurrent count and lowered after
+    // it, so that HasTasksToTake() never sees fewer tasks than can be taken.
+    num_ready_tasks_.fetch_add(num_ready_tasks);
+    num_ready_nonconcurrent_tasks_.fetch_add(
+        ready_tasks[TASK_CATEGORY_NONCONCURRENT_FOREGROUND].size());
+
+    // Deal the tasks of each category out in order of priority, so that every
+    // worker starts with the most important tasks it can get.
+    for (auto& tasks : ready_tasks) {
+      std::stable_sort(tasks.begin(), tasks.end(),
+                       [](const ReadyTask& a, const ReadyTask& b) {
+                         // Numerically lower priority is run first.
+                         return a.state->node(a.node_index).priority <
+                                b.state->node(b.node_index).priority;
+                       });
+    }
+    for (size_t i = 0; i < workers_.size(); ++i)
+      workers_[i]->AddReadyTasks(ready_tasks, i, workers_.size());
+
+    has_ready_to_run_tasks_cv_.Broadcast();
+  }
+
+  if (!task_namespace->pending_tasks.load(std::memory_order_relaxed))
+    has_namespaces_with_finished_running_tasks_cv_.Signal();
+}
+
+void WorkStealingTaskGraphRunner::WaitForTasksToFinishRunning(
+    NamespaceToken token) {
+  TRACE_EVENT0("cc",
+               "WorkStealingTaskGraphRunner::WaitForTasksToFinishRunning");
+
+  DCHECK(token.IsValid());
+
+  {
+    base::AutoLock lock(lock_);
+
+    auto it = namespaces_.find(token);
+    if (it == namespaces_.end())
+      return;
+
+    TaskNamespace* task_namespace = it->second.get();
+    while (task_namespace->pending_tasks.load(std::memory_order_acquire))
+      has_namespaces_with_finished_running_tasks_cv_.Wait();
+
+    // There may be other namespaces that have finished running tasks, so wake
+    // up another origin thread.
+    has_namespaces_with_finished_running_tasks_cv_.Signal();
+  }
+}
+
+void WorkStealingTaskGraphRunner::CollectCompletedTasks(
+    NamespaceToken token,
+    Task::Vector* completed_tasks) {
+  TRACE_EVENT0("cc", "WorkStealingTaskGraphRunner::CollectCompletedTasks");
+
+  DCHECK(token.IsValid());
+
+  {
+    base::AutoLock lock(lock_);
+
+    auto it = namespaces_.find(token);
+    if (it == namespaces_.end())
+      return;
+
+    // A task is buffered as completed before it stops being pending, so all
+    // of them are flushed below once the namespace has finished running.
+    TaskNamespace* task_namespace = it->second.get();
+    bool finished_running =
+        !task_namespace->pending_tasks.load(std::memory_order_acquire);
+    FlushCompletedTasksWithLockAcquired();
+
+    DCHECK_EQ(0u, completed_tasks->size());
+    completed_tasks->swap(task_namespace->completed_tasks);
+    if (!finished_running)
+      return;
+
+    // Remove namespace if finished running tasks.
+    if (task_namespace->state)
+      task_namespace->state->Retire();
+    namespaces_.erase(it);
+  }
+}
+
+void WorkStealingTaskGraphRunner::RunWorker(Worker* worker) {
+  ReadyTask task;
+  while (true) {
+    if (!TakeTask(worker, &task)) {
+      // Exit when shutdown is set.
+      if (!WaitForReadyTasks())
+        break;
+      continue;
+    }
+
+    {
+      TRACE_EVENT0("toplevel", "WorkStealingTaskGraphRunner::RunTask");
+      task.state->node(task.node_index).task->RunOnWorkerThread();
+    }
+    CompleteTask(worker, std::move(task));
+  }
+}
+
+bool WorkStealingTaskGraphRunner::TakeTask(Worker* worker, ReadyTask* task) {
+  if (!num_ready_tasks_.load(std::memory_order_relaxed))
+    return false;
+
+  // This task graph runner treats categories as an additional priority.
+  for (uint16_t category = 0; category < kNumCategories; ++category) {
+    if (category != TASK_CATEGORY_NONCONCURRENT_FOREGROUND) {
+      if (TakeTaskInCategory(worker, category, task))
+        return true;
+      continue;
+    }
+
+    // Claim the right to run a non-concurrent task before looking for one.
+    if (nonconcurrent_task_running_.exchange(true, std::memory_order_acquire))
+      continue;
+    if (TakeTaskInCategory(worker, category, task))
+      return true;
+    nonconcurrent_task_running_.store(false, std::memory_order_release);
+  }
+  return false;
+}
+
+bool WorkStealingTaskGraphRunner::TakeTaskInCategory(Worker* worker,
+                                                     uint16_t category,
+                                                     ReadyTask* task) {
+  while (true) {
+    bool found = worker->PopFront(category, task);
+    for (size_t i = 1; !found && i < workers_.size(); ++i) {
+      Worker* victim = workers_[(worker->index() + i) % workers_.size()].get();
+      found = victim->PopBack(category, task);
+    }
+    if (!found)
+      return false;
+
+    if (category == TASK_CATEGORY_NONCONCURRENT_FOREGROUND)
+      num_ready_nonconcurrent_tasks_.fetch_sub(1);
+    num_ready_tasks_.fetch_sub(1, std::memory_order_relaxed);
+    if (StartTask(*task))
+      return true;
+  }
+}
+
+bool WorkStealingTaskGraphRunner::StartTask(const ReadyTask& task) {
+  // Drop tasks of graphs that have been replaced. ScheduleTasks() took care of
+  // scheduling them again or canceling them.
+  if (!task.state->Enter())
+    return false;
+  task.state->node(task.node_index).task->state().DidStart();
+  task.state->Leave();
+  return true;
+}
+
+void WorkStealingTaskGraphRunner::CompleteTask(Worker* worker,
+                                               ReadyTask ready_task) {
+  GraphState* state = ready_task.state.get();
+  const GraphState::Node& node = state->node(ready_task.node_index);
+  scoped_refptr<Task> task = node.task;
+  TaskNamespace* task_namespace = state->task_namespace();
+
+  // Workers that went idle because only non-concurrent tasks were left may
+  // take one now. This store and the load of the idle worker count in
+  // WakeUpIdleWorker() pair with the ones in WaitForReadyTasks(), so either
+  // the idle worker sees the flag cleared or it is woken up.
+  bool wake_up_idle_worker = false;
+  if (node.category == TASK_CATEGORY_NONCONCURRENT_FOREGROUND) {
+    nonconcurrent_task_running_.store(false);
+    wake_up_idle_worker = num_ready_nonconcurrent_tasks_.load() != 0;
+  }
+
+  size_t num_scheduled = 0;
+  if (state->Enter()) {
+    num_scheduled = ScheduleDependents(
+        worker, state, state->GetDependents(ready_task.node_index));
+    task->state().DidFinish();
+    worker->AddCompletedTask(task_namespace, std::move(task));
+    bool finished_running = task_namespace->pending_tasks.fetch_sub(
+                                1, std::memory_order_acq_rel) == 1;
+    state->Leave();
+
+    if (finished_running) {
+      base::AutoLock lock(lock_);
+      has_namespaces_with_finished_running_tasks_cv_.Signal();
+    }
+  } else {
+    // The graph was replaced while the task was running. Its dependents have
+    // to be found in the graph that is current now.
+    base::AutoLock lock(lock_);
+    GraphState* current_state = task_namespace->state.get();
+    if (current_state) {
+      num_scheduled = ScheduleDependents(
+          worker, current_state, current_state->GetDependents(task.get()));
+    }
+    task->state().DidFinish();
+    task_namespace->completed_tasks.push_back(std::move(task));
+    if (task_namespace->pending_tasks.fetch_sub(
+            1, std::memory_order_acq_rel) == 1) {
+      has_namespaces_with_finished_running_tasks_cv_.Signal();
+    }
+  }
+
+  // This worker runs the first of the dependents itself.
+  if (num_scheduled > 1 || wake_up_idle_worker)
+    WakeUpIdleWorker();
+}
+
+size_t WorkStealingTaskGraphRunner::ScheduleDependents(
+    Worker* worker,
+    GraphState* state,
+    base::span<const uint32_t> dependents) {
+  size_t num_scheduled = 0;
+  for (uint32_t index : dependents) {
+    if (!state->DidFinishDependency(index))
+      continue;
+
+    // Task is ready if it has no dependencies and is in the new state.
+    const GraphState::Node& dependent = state->node(index);
+    if (!dependent.task->state().IsNew())
+      continue;
+
+    dependent.task->state().DidSchedule();
+    state->task_namespace()->pending_tasks.fetch_add(1,
+                                                     std::memory_order_relaxed);
+    num_ready_tasks_.fetch_add(1);
+    if (dependent.category == TASK_CATEGORY_NONCONCURRENT_FOREGROUND)
+      num_ready_nonconcurrent_tasks_.fetch_add(1);
+    worker->PushFront(dependent.category, ReadyTask(state, index));
+    ++num_scheduled;
+  }
+  return num_scheduled;
+}
+
+void WorkStealingTaskGraphRunner::WakeUpIdleWorker() {
+  if (!num_idle_workers_.load())
+    return;
+  base::AutoLock lock(lock_);
+  has_ready_to_run_tasks_cv_.Signal();
+}
+
+bool WorkStealingTaskGraphRunner::HasTasksToTake() const {
+  // Queued non-concurrent tasks can not be taken while one is running, and
+  // counting them would keep workers that can not run them from sleeping.
+  size_t num_ready_tasks = num_ready_tasks_.load();
+  if (nonconcurrent_task_running_.load()) {
+    num_ready_tasks -=
+        std::min(num_ready_tasks, num_ready_nonconcurrent_tasks_.load());
+  }
+  return num_ready_tasks != 0;
+}
+
+bool WorkStealingTaskGraphRunner::WaitForReadyTasks() {
+  base::AutoLock lock(lock_);
+  if (shutdown_)
+    return false;
+
+  // Become idle before checking for tasks, so that a worker that pushes a task
+  // after the check sees this one as idle and wakes it up.
+  num_idle_workers_.fetch_add(1);
+  if (!HasTasksToTake())
+    has_ready_to_run_tasks_cv_.Wait();
+  num_idle_workers_.fetch_sub(1);
+  return !shutdown_;
+}
+
+void WorkStealingTaskGraphRunner::FlushCompletedTasksWithLockAcquired() {
+  std::vector<Worker::CompletedTask> completed_tasks;
+  for (auto& worker : workers_)
+    worker->TakeCompletedTasks(&completed_tasks);
+  for (auto& completed_task : completed_tasks) {
+    completed_task.first->completed_tasks.push_back(
+        std::move(completed_task.second));
+  }
+}
+
+}  // namespace cc
@@ -0,0 +1,150 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
+#define CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/simple_thread.h"
+#include "cc/raster/task_category.h"
+#include "cc/raster/task_graph_runner.h"
+
+namespace cc {
+
+// A TaskGraphRunner that runs tasks on a set of worker threads without a lock
+// shared by all workers on the task execution path.
+//
+// Each ScheduleTasks() call builds an immutable graph state holding an atomic
+// count of unfinished dependencies per node. Ready tasks are dealt out to
+// per-worker deques, one per category; a worker pops from the front of its own
+// deques and steals from the back of other workers' deques when it runs dry.
+// A worker that completes a task decrements the counters of its dependents and
+// pushes the ones that became ready to the front of its own deque. Completed
+// tasks are appended to a per-worker list that the origin thread drains in a
+// single pass from WaitForTasksToFinishRunning() and CollectCompletedTasks().
+//
+// Categories are tried in order, so a worker only starts a background task
+// when it finds no foreground task in any deque, and at most one task of
+// TASK_CATEGORY_NONCONCURRENT_FOREGROUND runs at a time. Priorities are
+// respected within a single ScheduleTasks() call per worker; across workers
+// and stolen tasks the order is approximate.
+class CC_EXPORT WorkStealingTaskGraphRunner : public TaskGraphRunner {
+ public:
+  WorkStealingTaskGraphRunner();
+  WorkStealingTaskGraphRunner(const WorkStealingTaskGraphRunner&) = delete;
+  ~WorkStealingTaskGraphRunner() override;
+
+  WorkStealingTaskGraphRunner& operator=(const WorkStealingTaskGraphRunner&) =
+      delete;
+
+  // Overridden from TaskGraphRunner:
+  NamespaceToken GenerateNamespaceToken() override;
+  void ScheduleTasks(NamespaceToken token, TaskGraph* graph) override;
+  void WaitForTasksToFinishRunning(NamespaceToken token) override;
+  void CollectCompletedTasks(NamespaceToken token,
+                             Task::Vector* completed_tasks) override;
+
+  // Spawns |num_threads| worker threads.
+  void Start(int num_threads,
+             const std::string& thread_name_prefix,
+             const base::SimpleThread::Options& thread_options);
+  void Shutdown();
+
+ private:
+  class GraphState;
+  class Worker;
+  struct TaskNamespace;
+
+  // A task in a worker deque. Entries whose graph state has since been
+  // replaced by another ScheduleTasks() call are dropped when popped.
+  struct ReadyTask {
+    ReadyTask();
+    ReadyTask(scoped_refptr<GraphState> state, uint32_t node_index);
+    ReadyTask(ReadyTask&& other);
+    ~ReadyTask();
+
+    ReadyTask& operator=(ReadyTask&& other);
+
+    scoped_refptr<GraphState> state;
+    uint32_t node_index = 0;
+  };
+
+  static constexpr size_t kNumCategories = LAST_TASK_CATEGORY + 1;
+
+  // Called on worker threads.
+  void RunWorker(Worker* worker);
+  bool TakeTask(Worker* worker, ReadyTask* task);
+  bool TakeTaskInCategory(Worker* worker, uint16_t category, ReadyTask* task);
+  bool StartTask(const ReadyTask& task);
+  void CompleteTask(Worker* worker, ReadyTask task);
+  // Returns true if a worker that looked for a task now could take one.
+  bool HasTasksToTake() const;
+  // Returns true if |worker| should look for tasks again, false on shutdown.
+  bool WaitForReadyTasks();
+
+  // Pushes the |dependents| in |state| that became ready to the front of
+  // |worker|'s deques and returns how many there were.
+  size_t ScheduleDependents(Worker* worker,
+                            GraphState* state,
+                            base::span<const uint32_t> dependents);
+  void WakeUpIdleWorker();
+
+  // Moves the completed tasks buffered by all workers to their namespaces.
+  void FlushCompletedTasksWithLockAcquired() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Lock that protects the namespaces. Workers only acquire it when a graph
+  // was replaced while they ran one of its tasks, when a namespace finishes
+  // running and when they go idle.
+  base::Lock lock_;
+
+  struct CompareToken {
+    bool operator()(const NamespaceToken& lhs,
+                    const NamespaceToken& rhs) const {
+      return lhs.id_ < rhs.id_;
+    }
+  };
+  std::map<NamespaceToken, std::unique_ptr<TaskNamespace>, CompareToken>
+      namespaces_ GUARDED_BY(lock_);
+  int next_namespace_id_ GUARDED_BY(lock_) = 1;
+
+  // Number of entries in all worker deques, including ones that will be
+  // dropped when popped.
+  std::atomic<size_t> num_ready_tasks_{0};
+  // Number of those entries that are TASK_CATEGORY_NONCONCURRENT_FOREGROUND
+  // tasks, which can not be taken while another one is running.
+  std::atomic<size_t> num_ready_nonconcurrent_tasks_{0};
+  std::atomic<int> num_idle_workers_{0};
+  // Set while a TASK_CATEGORY_NONCONCURRENT_FOREGROUND task is running.
+  std::atomic<bool> nonconcurrent_task_running_{false};
+
+  // Condition variable that is waited on by idle workers until new tasks are
+  // ready to run or shutdown starts.
+  base::ConditionVariable has_ready_to_run_tasks_cv_;
+
+  // Condition variable that is waited on by origin threads until a namespace
+  // has finished running all associated tasks.
+  base::ConditionVariable has_namespaces_with_finished_running_tasks_cv_;
+
+  // Set during shutdown. Tells workers to exit.
+  bool shutdown_ GUARDED_BY(lock_) = false;
+};
+
+}  // namespace cc
+
+#endif  // CC_RASTER_WORK_STEALING_TASK_GRAPH_RUNNER_H_
@@ -0,0 +1,55 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/raster/work_stealing_task_graph_runner.h"
+
+#include "base/threading/simple_thread.h"
+#include "cc/test/task_graph_runner_test_template.h"
+
+namespace cc {
+namespace {
+
+template <int NumThreads>
+class WorkStealingTaskGraphRunnerTestDelegate {
+ public:
+  WorkStealingTaskGraphRunnerTestDelegate() = default;
+
+  void StartTaskGraphRunner() {
+    work_stealing_task_graph_runner_.Start(
+        NumThreads, "WorkStealingTaskGraphRunnerTestWorker",
+        base::SimpleThread::Options());
+  }
+
+  TaskGraphRunner* GetTaskGraphRunner() {
+    return &work_stealing_task_graph_runner_;
+  }
+
+  void StopTaskGraphRunner() {}
+
+  ~WorkStealingTaskGraphRunnerTestDelegate() {
+    work_stealing_task_graph_runner_.Shutdown();
+  }
+
+ private:
+  WorkStealingTaskGraphRunner work_stealing_task_graph_runner_;
+};
+
+using WorkStealingTaskGraphRunnerTestDelegate1 =
+    WorkStealingTaskGraphRunnerTestDelegate<1>;
+using WorkStealingTaskGraphRunnerTestDelegate4 =
+    WorkStealingTaskGraphRunnerTestDelegate<4>;
+
+INSTANTIATE_TYPED_TEST_SUITE_P(WorkStealingTaskGraphRunner1,
+                               TaskGraphRunnerTest,
+                               WorkStealingTaskGraphRunnerTestDelegate1);
+INSTANTIATE_TYPED_TEST_SUITE_P(WorkStealingTaskGraphRunner4,
+                               TaskGraphRunnerTest,
+                               WorkStealingTaskGraphRunnerTestDelegate4);
+// With a single worker, tasks of a graph run in order of priority.
+INSTANTIATE_TYPED_TEST_SUITE_P(WorkStealingTaskGraphRunner,
+                               SingleThreadTaskGraphRunnerTest,
+                               WorkStealingTaskGraphRunnerTestDelegate1);
+
+}  // namespace
+}  // namespace cc
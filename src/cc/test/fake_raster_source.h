@@ -48,7 +48,7 @@ class FakeRasterSource : public RasterSource {
 
   void PlaybackDisplayListToCanvas(
       SkCanvas* canvas,
-      ImageProvider* image_provider) const override;
+      const PlaybackSettings& settings) const override;
 
  private:
   base::WaitableEvent* playback_allowed_event_;
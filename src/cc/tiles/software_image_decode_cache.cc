@@ -7,6 +7,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <utility>
 
@@ -144,8 +145,7 @@ SoftwareImageDecodeCache::SoftwareImageDecodeCache(
     SkColorType color_type,
     size_t locked_memory_limit_bytes,
     PaintImage::GeneratorClientId generator_client_id)
-    : decoded_images_(ImageMRUCache::NO_AUTO_EVICT),
-      locked_images_budget_(locked_memory_limit_bytes),
+    : locked_images_budget_(locked_memory_limit_bytes),
       color_type_(color_type),
       generator_client_id_(generator_client_id),
       max_items_in_cache_(kNormalMaxItemsInCacheForSoftware) {
@@ -207,20 +207,18 @@ SoftwareImageDecodeCache::GetTaskForImageAndRefInternal(
     return TaskResult(/*need_unref=*/false, /*is_at_raster_decode=*/false,
                       /*can_do_hardware_accelerated_decode=*/false);
 
-  base::AutoLock lock(lock_);
-
-  bool new_image_fits_in_memory =
-      locked_images_budget_.AvailableMemoryBytes() >= key.locked_bytes();
+  Shard* shard = GetShard(key);
+  base::AutoLock lock(shard->lock);
 
   // Get or generate the cache entry.
-  auto decoded_it = decoded_images_.Get(key);
+  auto decoded_it = shard->decoded_images.Get(key);
   CacheEntry* cache_entry = nullptr;
-  if (decoded_it == decoded_images_.end()) {
+  if (decoded_it == shard->decoded_images.end()) {
     // There is no reason to create a new entry if we know it won't fit anyway.
-    if (!new_image_fits_in_memory)
+    if (locked_images_budget_.AvailableMemoryBytes() < key.locked_bytes())
       return TaskResult(/*need_unref=*/false, /*is_at_raster_decode=*/true,
                         /*can_do_hardware_accelerated_decode=*/false);
-    cache_entry = AddCacheEntry(key);
+    cache_entry = AddCacheEntry(shard, key);
     if (task_type == DecodeTaskType::USE_OUT_OF_RASTER_TASKS)
       cache_entry->mark_out_of_raster();
   } else {
@@ -228,14 +226,14 @@ SoftwareImageDecodeCache::GetTaskForImageAndRefInternal(
   }
   DCHECK(cache_entry);
 
-  if (!cache_entry->is_budgeted) {
-    if (!new_image_fits_in_memory) {
-      // We don't need to ref anything here because this image will be at
-      // raster.
-      return TaskResult(/*need_unref=*/false, /*is_at_raster_decode=*/true,
-                        /*can_do_hardware_accelerated_decode=*/false);
-    }
-    AddBudgetForImage(key, cache_entry);
+  // The budget is shared with other shards, so the check above is only a hint
+  // and the reservation itself may still fail.
+  if (!cache_entry->is_budgeted &&
+      !TryAddBudgetForImage(shard, key, cache_entry)) {
+    // We don't need to ref anything here because this image will be at
+    // raster.
+    return TaskResult(/*need_unref=*/false, /*is_at_raster_decode=*/true,
+                      /*can_do_hardware_accelerated_decode=*/false);
   }
   DCHECK(cache_entry->is_budgeted);
 
@@ -262,19 +260,22 @@ SoftwareImageDecodeCache::GetTaskForImageAndRefInternal(
   return TaskResult(task, /*can_do_hardware_accelerated_decode=*/false);
 }
 
-void SoftwareImageDecodeCache::AddBudgetForImage(const CacheKey& key,
-                                                 CacheEntry* entry) {
+bool SoftwareImageDecodeCache::TryAddBudgetForImage(Shard* shard,
+                                                    const CacheKey& key,
+                                                    CacheEntry* entry) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug"),
-               "SoftwareImageDecodeCache::AddBudgetForImage", "key",
+               "SoftwareImageDecodeCache::TryAddBudgetForImage", "key",
                key.ToString());
 
   DCHECK(!entry->is_budgeted);
-  DCHECK_GE(locked_images_budget_.AvailableMemoryBytes(), key.locked_bytes());
-  locked_images_budget_.AddUsage(key.locked_bytes());
+  if (!locked_images_budget_.TryAddUsage(key.locked_bytes()))
+    return false;
   entry->is_budgeted = true;
+  return true;
 }
 
-void SoftwareImageDecodeCache::RemoveBudgetForImage(const CacheKey& key,
+void SoftwareImageDecodeCache::RemoveBudgetForImage(Shard* shard,
+                                                    const CacheKey& key,
                                                     CacheEntry* entry) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug"),
                "SoftwareImageDecodeCache::RemoveBudgetForImage", "key",
@@ -292,18 +293,19 @@ void SoftwareImageDecodeCache::UnrefImage(const DrawImage& image) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug"),
                "SoftwareImageDecodeCache::UnrefImage", "key", key.ToString());
 
-  base::AutoLock lock(lock_);
-  UnrefImage(key);
+  Shard* shard = GetShard(key);
+  base::AutoLock lock(shard->lock);
+  UnrefImage(shard, key);
 }
 
-void SoftwareImageDecodeCache::UnrefImage(const CacheKey& key) {
-  auto decoded_image_it = decoded_images_.Peek(key);
-  DCHECK(decoded_image_it != decoded_images_.end());
+void SoftwareImageDecodeCache::UnrefImage(Shard* shard, const CacheKey& key) {
+  auto decoded_image_it = shard->decoded_images.Peek(key);
+  DCHECK(decoded_image_it != shard->decoded_images.end());
   auto* entry = decoded_image_it->second.get();
   DCHECK_GT(entry->ref_count, 0);
   if (--entry->ref_count == 0) {
     if (entry->is_budgeted)
-      RemoveBudgetForImage(key, entry);
+      RemoveBudgetForImage(shard, key, entry);
     if (entry->is_locked)
       entry->Unlock();
   }
@@ -315,10 +317,11 @@ SoftwareImageDecodeCache::DecodeImageInTask(const CacheKey& key,
                                             DecodeTaskType task_type) {
   TRACE_EVENT1("cc,benchmark", "SoftwareImageDecodeCache::DecodeImageInTask",
                "key", key.ToString());
-  base::AutoLock lock(lock_);
+  Shard* shard = GetShard(key);
+  base::AutoLock lock(shard->lock);
 
-  auto image_it = decoded_images_.Peek(key);
-  DCHECK(image_it != decoded_images_.end());
+  auto image_it = shard->decoded_images.Peek(key);
+  DCHECK(image_it != shard->decoded_images.end());
   auto* cache_entry = image_it->second.get();
   // These two checks must be true because we're running this from a task, which
   // means that we've budgeted this entry when we got the task and the ref count
@@ -327,13 +330,14 @@ SoftwareImageDecodeCache::DecodeImageInTask(const CacheKey& key,
   DCHECK(cache_entry->is_budgeted);
 
   TaskProcessingResult result =
-      DecodeImageIfNecessary(key, paint_image, cache_entry);
+      DecodeImageIfNecessary(shard, key, paint_image, cache_entry);
   DCHECK(cache_entry->decode_failed || cache_entry->is_locked);
   return result;
 }
 
 SoftwareImageDecodeCache::TaskProcessingResult
-SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
+SoftwareImageDecodeCache::DecodeImageIfNecessary(Shard* shard,
+                                                 const CacheKey& key,
                                                  const PaintImage& paint_image,
                                                  CacheEntry* entry) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug"),
@@ -359,7 +363,7 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
   std::unique_ptr<CacheEntry> local_cache_entry;
   // If we can use the original decode, we'll definitely need a decode.
   if (key.type() == CacheKey::kOriginal) {
-    base::AutoUnlock release(lock_);
+    base::AutoUnlock release(shard->lock);
     local_cache_entry = Utils::DoDecodeImage(
         key, paint_image,
         GetColorTypeForPaintImage(key.target_color_space(), paint_image),
@@ -369,7 +373,7 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
   } else {
     // Attempt to find a cached decode to generate a scaled/subrected decode
     // from.
-    base::Optional<CacheKey> candidate_key = FindCachedCandidate(key);
+    base::Optional<CacheKey> candidate_key = FindCachedCandidate(shard, key);
 
     SkISize desired_size = gfx::SizeToSkISize(key.target_size());
     const bool should_decode_to_scale =
@@ -391,7 +395,7 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
     // requesting a subrect already vetoes decode to scale.
     DCHECK(!should_decode_to_scale || !key.is_nearest_neighbor());
     if (should_decode_to_scale) {
-      base::AutoUnlock release(lock_);
+      base::AutoUnlock release(shard->lock);
       local_cache_entry = Utils::DoDecodeImage(
           key, paint_image,
           GetColorTypeForPaintImage(key.target_color_space(), paint_image),
@@ -433,11 +437,11 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
     if (candidate_key) {
       CHECK(*candidate_key != key) << key.ToString();
       auto decoded_draw_image =
-          GetDecodedImageForDrawInternal(*candidate_key, paint_image);
+          GetDecodedImageForDrawInternal(shard, *candidate_key, paint_image);
       if (!decoded_draw_image.image()) {
         local_cache_entry = nullptr;
       } else {
-        base::AutoUnlock release(lock_);
+        base::AutoUnlock release(shard->lock);
         // IMPORTANT: More subtleties:
         // If the candidate could have used the original decode, that means we
         // need to extractSubset from it. In all other cases, this would have
@@ -449,7 +453,7 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
       }
 
       // Unref to balance the GetDecodedImageForDrawInternal() call.
-      UnrefImage(*candidate_key);
+      UnrefImage(shard, *candidate_key);
     }
   }
 
@@ -478,11 +482,12 @@ SoftwareImageDecodeCache::DecodeImageIfNecessary(const CacheKey& key,
 }
 
 base::Optional<SoftwareImageDecodeCache::CacheKey>
-SoftwareImageDecodeCache::FindCachedCandidate(const CacheKey& key) {
-  auto image_keys_it = frame_key_to_image_keys_.find(key.frame_key());
+SoftwareImageDecodeCache::FindCachedCandidate(Shard* shard,
+                                              const CacheKey& key) {
+  auto image_keys_it = shard->frame_key_to_image_keys.find(key.frame_key());
   // We know that we must have at least our own |entry| in this list, so it
   // won't be empty.
-  DCHECK(image_keys_it != frame_key_to_image_keys_.end());
+  DCHECK(image_keys_it != shard->frame_key_to_image_keys.end());
 
   auto& available_keys = image_keys_it->second;
   std::sort(available_keys.begin(), available_keys.end(),
@@ -503,8 +508,8 @@ SoftwareImageDecodeCache::FindCachedCandidate(const CacheKey& key) {
         available_key.target_size().height() < key.target_size().height()) {
       continue;
     }
-    auto image_it = decoded_images_.Peek(available_key);
-    DCHECK(image_it != decoded_images_.end());
+    auto image_it = shard->decoded_images.Peek(available_key);
+    DCHECK(image_it != shard->decoded_images.end());
     auto* available_entry = image_it->second.get();
     if (available_entry->is_locked || available_entry->Lock()) {
       return available_key;
@@ -542,25 +547,26 @@ DecodedDrawImage SoftwareImageDecodeCache::GetDecodedImageForDraw(
     const DrawImage& draw_image) {
   DCHECK(UseCacheForDrawImage(draw_image));
 
-  base::AutoLock hold(lock_);
-  return GetDecodedImageForDrawInternal(
-      CacheKey::FromDrawImage(
-          draw_image, GetColorTypeForPaintImage(draw_image.target_color_space(),
-                                                draw_image.paint_image())),
-      draw_image.paint_image());
+  CacheKey key = CacheKey::FromDrawImage(
+      draw_image, GetColorTypeForPaintImage(draw_image.target_color_space(),
+                                            draw_image.paint_image()));
+  Shard* shard = GetShard(key);
+  base::AutoLock hold(shard->lock);
+  return GetDecodedImageForDrawInternal(shard, key, draw_image.paint_image());
 }
 
 DecodedDrawImage SoftwareImageDecodeCache::GetDecodedImageForDrawInternal(
+    Shard* shard,
     const CacheKey& key,
     const PaintImage& paint_image) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("cc.debug"),
                "SoftwareImageDecodeCache::GetDecodedImageForDrawInternal",
                "key", key.ToString());
 
-  auto decoded_it = decoded_images_.Get(key);
+  auto decoded_it = shard->decoded_images.Get(key);
   CacheEntry* cache_entry = nullptr;
-  if (decoded_it == decoded_images_.end())
-    cache_entry = AddCacheEntry(key);
+  if (decoded_it == shard->decoded_images.end())
+    cache_entry = AddCacheEntry(shard, key);
   else
     cache_entry = decoded_it->second.get();
 
@@ -568,7 +574,7 @@ DecodedDrawImage SoftwareImageDecodeCache::GetDecodedImageForDrawInternal(
   ++cache_entry->ref_count;
   cache_entry->mark_used();
 
-  DecodeImageIfNecessary(key, paint_image, cache_entry);
+  DecodeImageIfNecessary(shard, key, paint_image, cache_entry);
   auto decoded_image = cache_entry->image();
   if (!decoded_image)
     return DecodedDrawImage();
@@ -596,30 +602,78 @@ void SoftwareImageDecodeCache::DrawWithImageFinished(
 void SoftwareImageDecodeCache::ReduceCacheUsageUntilWithinLimit(size_t limit) {
   TRACE_EVENT0("cc",
                "SoftwareImageDecodeCache::ReduceCacheUsageUntilWithinLimit");
-  for (auto it = decoded_images_.rbegin();
-       decoded_images_.size() > limit && it != decoded_images_.rend();) {
+  size_t shard_sizes[kNumShards];
+  size_t total_size = 0u;
+  for (size_t i = 0; i < kNumShards; ++i) {
+    base::AutoLock lock(shards_[i].lock);
+    shard_sizes[i] = shards_[i].decoded_images.size();
+    total_size += shard_sizes[i];
+  }
+
+  // There is no MRU order across shards, so evict the least recently used
+  // unlocked images of the largest shard until it is no larger than the next
+  // one, or the cache as a whole is within |limit|. Shards whose remaining
+  // images are all in use are skipped from then on.
+  bool can_evict[kNumShards];
+  std::fill(std::begin(can_evict), std::end(can_evict), true);
+  while (total_size > limit) {
+    size_t largest = kNumShards;
+    size_t next_largest_size = 0u;
+    for (size_t i = 0; i < kNumShards; ++i) {
+      if (!can_evict[i])
+        continue;
+      if (largest == kNumShards || shard_sizes[i] > shard_sizes[largest]) {
+        if (largest != kNumShards)
+          next_largest_size = shard_sizes[largest];
+        largest = i;
+      } else {
+        next_largest_size = std::max(next_largest_size, shard_sizes[i]);
+      }
+    }
+    if (largest == kNumShards || shard_sizes[largest] == 0u)
+      return;
+
+    Shard& shard = shards_[largest];
+    base::AutoLock lock(shard.lock);
+    size_t size = shard_sizes[largest];
+    size_t evict_count = std::max<size_t>(
+        1u, std::min(total_size - limit, size - next_largest_size));
+    ReduceShardUsageUntilWithinLimit(&shard, size - evict_count);
+
+    size_t new_size = shard.decoded_images.size();
+    if (new_size > size - evict_count)
+      can_evict[largest] = false;
+    total_size = total_size - size + new_size;
+    shard_sizes[largest] = new_size;
+  }
+}
+
+void SoftwareImageDecodeCache::ReduceShardUsageUntilWithinLimit(Shard* shard,
+                                                                size_t limit) {
+  ImageMRUCache& decoded_images = shard->decoded_images;
+  for (auto it = decoded_images.rbegin();
+       decoded_images.size() > limit && it != decoded_images.rend();) {
     if (it->second->ref_count != 0) {
       ++it;
       continue;
     }
 
     const CacheKey& key = it->first;
-    auto vector_it = frame_key_to_image_keys_.find(key.frame_key());
+    auto vector_it = shard->frame_key_to_image_keys.find(key.frame_key());
     auto item_it =
         std::find(vector_it->second.begin(), vector_it->second.end(), key);
     DCHECK(item_it != vector_it->second.end());
     vector_it->second.erase(item_it);
     if (vector_it->second.empty())
-      frame_key_to_image_keys_.erase(vector_it);
+      shard->frame_key_to_image_keys.erase(vector_it);
 
-    it = decoded_images_.Erase(it);
+    it = decoded_images.Erase(it);
   }
 }
 
 #if defined(USE_NEVA_APPRUNTIME)
 void SoftwareImageDecodeCache::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel level) {
-  base::AutoLock lock(lock_);
   switch (level) {
     case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
 #if !defined(OS_WEBOS)
@@ -639,12 +693,10 @@ void SoftwareImageDecodeCache::OnMemoryPressure(
 #endif // defined(USE_NEVA_APPRUNTIME)
 
 void SoftwareImageDecodeCache::ReduceCacheUsage() {
-  base::AutoLock lock(lock_);
   ReduceCacheUsageUntilWithinLimit(max_items_in_cache_);
 }
 
 void SoftwareImageDecodeCache::ClearCache() {
-  base::AutoLock lock(lock_);
   ReduceCacheUsageUntilWithinLimit(0);
 }
 
@@ -655,24 +707,23 @@ size_t SoftwareImageDecodeCache::GetMaximumMemoryLimitBytes() const {
 void SoftwareImageDecodeCache::OnImageDecodeTaskCompleted(
     const CacheKey& key,
     DecodeTaskType task_type) {
-  base::AutoLock hold(lock_);
+  Shard* shard = GetShard(key);
+  base::AutoLock hold(shard->lock);
 
-  auto image_it = decoded_images_.Peek(key);
-  DCHECK(image_it != decoded_images_.end());
+  auto image_it = shard->decoded_images.Peek(key);
+  DCHECK(image_it != shard->decoded_images.end());
   CacheEntry* cache_entry = image_it->second.get();
   auto& task = task_type == DecodeTaskType::USE_IN_RASTER_TASKS
                    ? cache_entry->in_raster_task
                    : cache_entry->out_of_raster_task;
   task = nullptr;
 
-  UnrefImage(key);
+  UnrefImage(shard, key);
 }
 
 bool SoftwareImageDecodeCache::OnMemoryDump(
     const base::trace_event::MemoryDumpArgs& args,
     base::trace_event::ProcessMemoryDump* pmd) {
-  base::AutoLock lock(lock_);
-
   if (args.level_of_detail == MemoryDumpLevelOfDetail::BACKGROUND) {
     std::string dump_name = base::StringPrintf(
         "cc/image_memory/cache_0x%" PRIXPTR, reinterpret_cast<uintptr_t>(this));
@@ -680,30 +731,33 @@ bool SoftwareImageDecodeCache::OnMemoryDump(
     dump->AddScalar("locked_size", MemoryAllocatorDump::kUnitsBytes,
                     locked_images_budget_.GetCurrentUsageSafe());
   } else {
-    for (const auto& image_pair : decoded_images_) {
-      int image_id = static_cast<int>(image_pair.first.frame_key().hash());
-      CacheEntry* entry = image_pair.second.get();
-      DCHECK(entry);
-      // We might not have memory for this cache entry, depending on where in
-      // the CacheEntry lifecycle we are. If we don't have memory, then we don't
-      // have to record it in the dump.
-      if (!entry->memory)
-        continue;
-
-      std::string dump_name = base::StringPrintf(
-          "cc/image_memory/cache_0x%" PRIXPTR "/%s/image_%" PRIu64 "_id_%d",
-          reinterpret_cast<uintptr_t>(this),
-          entry->is_budgeted ? "budgeted" : "at_raster", entry->tracing_id(),
-          image_id);
-      // CreateMemoryAllocatorDump will automatically add tracking values for
-      // the total size. We also add a "locked_size" below.
-      MemoryAllocatorDump* dump =
-          entry->memory->CreateMemoryAllocatorDump(dump_name.c_str(), pmd);
-      DCHECK(dump);
-      size_t locked_bytes =
-          entry->is_locked ? image_pair.first.locked_bytes() : 0u;
-      dump->AddScalar("locked_size", MemoryAllocatorDump::kUnitsBytes,
-                      locked_bytes);
+    for (Shard& shard : shards_) {
+      base::AutoLock lock(shard.lock);
+      for (const auto& image_pair : shard.decoded_images) {
+        int image_id = static_cast<int>(image_pair.first.frame_key().hash());
+        CacheEntry* entry = image_pair.second.get();
+        DCHECK(entry);
+        // We might not have memory for this cache entry, depending on where
+        // in the CacheEntry lifecycle we are. If we don't have memory, then we
+        // don't have to record it in the dump.
+        if (!entry->memory)
+          continue;
+
+        std::string dump_name = base::StringPrintf(
+            "cc/image_memory/cache_0x%" PRIXPTR "/%s/image_%" PRIu64 "_id_%d",
+            reinterpret_cast<uintptr_t>(this),
+            entry->is_budgeted ? "budgeted" : "at_raster", entry->tracing_id(),
+            image_id);
+        // CreateMemoryAllocatorDump will automatically add tracking values for
+        // the total size. We also add a "locked_size" below.
+        MemoryAllocatorDump* dump =
+            entry->memory->CreateMemoryAllocatorDump(dump_name.c_str(), pmd);
+        DCHECK(dump);
+        size_t locked_bytes =
+            entry->is_locked ? image_pair.first.locked_bytes() : 0u;
+        dump->AddScalar("locked_size", MemoryAllocatorDump::kUnitsBytes,
+                        locked_bytes);
+      }
     }
   }
 
@@ -712,16 +766,26 @@ bool SoftwareImageDecodeCache::OnMemoryDump(
 }
 
 SoftwareImageDecodeCache::CacheEntry* SoftwareImageDecodeCache::AddCacheEntry(
+    Shard* shard,
     const CacheKey& key) {
-  frame_key_to_image_keys_[key.frame_key()].push_back(key);
-  auto it = decoded_images_.Put(key, std::make_unique<CacheEntry>());
+  shard->frame_key_to_image_keys[key.frame_key()].push_back(key);
+  auto it = shard->decoded_images.Put(key, std::make_unique<CacheEntry>());
   it->second.get()->mark_cached();
   return it->second.get();
 }
 
 size_t SoftwareImageDecodeCache::GetNumCacheEntriesForTesting() {
-  base::AutoLock lock(lock_);
-  return decoded_images_.size();
+  size_t num_entries = 0u;
+  for (Shard& shard : shards_) {
+    base::AutoLock lock(shard.lock);
+    num_entries += shard.decoded_images.size();
+  }
+  return num_entries;
+}
+
+SoftwareImageDecodeCache::Shard* SoftwareImageDecodeCache::GetShard(
+    const CacheKey& key) {
+  return &shards_[key.frame_key().hash() % kNumShards];
 }
 
 SkColorType SoftwareImageDecodeCache::GetColorTypeForPaintImage(
@@ -739,6 +803,12 @@ SkColorType SoftwareImageDecodeCache::GetColorTypeForPaintImage(
   return color_type_;
 }
 
+// Shard -----------------------------------------------------------------------
+SoftwareImageDecodeCache::Shard::Shard()
+    : decoded_images(ImageMRUCache::NO_AUTO_EVICT) {}
+
+SoftwareImageDecodeCache::Shard::~Shard() = default;
+
 // MemoryBudget ----------------------------------------------------------------
 SoftwareImageDecodeCache::MemoryBudget::MemoryBudget(size_t limit_bytes)
     : limit_bytes_(limit_bytes), current_usage_bytes_(0u) {}
@@ -748,21 +818,24 @@ size_t SoftwareImageDecodeCache::MemoryBudget::AvailableMemoryBytes() const {
   return usage >= limit_bytes_ ? 0u : (limit_bytes_ - usage);
 }
 
-void SoftwareImageDecodeCache::MemoryBudget::AddUsage(size_t usage) {
-  current_usage_bytes_ += usage;
+bool SoftwareImageDecodeCache::MemoryBudget::TryAddUsage(size_t usage) {
+  size_t current = current_usage_bytes_.load(std::memory_order_relaxed);
+  do {
+    if (current > limit_bytes_ || usage > limit_bytes_ - current)
+      return false;
+  } while (!current_usage_bytes_.compare_exchange_weak(
+      current, current + usage, std::memory_order_relaxed));
+  return true;
 }
 
 void SoftwareImageDecodeCache::MemoryBudget::SubtractUsage(size_t usage) {
-  DCHECK_GE(current_usage_bytes_.ValueOrDefault(0u), usage);
-  current_usage_bytes_ -= usage;
-}
-
-void SoftwareImageDecodeCache::MemoryBudget::ResetUsage() {
-  current_usage_bytes_ = 0;
+  size_t previous =
+      current_usage_bytes_.fetch_sub(usage, std::memory_order_relaxed);
+  DCHECK_GE(previous, usage);
 }
 
 size_t SoftwareImageDecodeCache::MemoryBudget::GetCurrentUsageSafe() const {
-  return current_usage_bytes_.ValueOrDie();
+  return current_usage_bytes_.load(std::memory_order_relaxed);
 }
 
 }  // namespace cc
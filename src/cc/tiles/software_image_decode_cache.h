@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -14,7 +15,7 @@
 #include "base/containers/mru_cache.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
-#include "base/numerics/safe_math.h"
+#include "base/synchronization/lock.h"
 #include "base/thread_annotations.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "cc/cc_export.h"
@@ -80,37 +81,67 @@ class CC_EXPORT SoftwareImageDecodeCache
   using CacheEntry = Utils::CacheEntry;
 
   // MemoryBudget is a convenience class for memory bookkeeping and ensuring
-  // that we don't go over the limit when pre-decoding.
+  // that we don't go over the limit when pre-decoding. It is shared by all
+  // shards and is updated with atomics, so it does not need a lock.
   class MemoryBudget {
    public:
     explicit MemoryBudget(size_t limit_bytes);
 
     size_t AvailableMemoryBytes() const;
-    void AddUsage(size_t usage);
+    // Adds |usage| to the current usage if it fits within the limit. Returns
+    // false and leaves the usage unchanged otherwise.
+    bool TryAddUsage(size_t usage);
     void SubtractUsage(size_t usage);
-    void ResetUsage();
     size_t total_limit_bytes() const { return limit_bytes_; }
     size_t GetCurrentUsageSafe() const;
 
    private:
     const size_t limit_bytes_;
-    base::CheckedNumeric<size_t> current_usage_bytes_;
+    std::atomic<size_t> current_usage_bytes_;
   };
 
   using ImageMRUCache = base::
       HashingMRUCache<CacheKey, std::unique_ptr<CacheEntry>, CacheKeyHash>;
 
+  // The cache is split into shards by the hash of the image's frame key. All
+  // decodes of the same image frame, which may serve as candidates for each
+  // other, live in the same shard, while workers decoding or drawing
+  // different images rarely contend on the same lock.
+  struct Shard {
+    Shard();
+    Shard(const Shard&) = delete;
+    ~Shard();
+
+    Shard& operator=(const Shard&) = delete;
+
+    base::Lock lock;
+    // Decoded images and ref counts (predecode path).
+    ImageMRUCache decoded_images GUARDED_BY(lock);
+    // A map of PaintImage::FrameKey to the ImageKeys for cached decodes of
+    // this PaintImage.
+    std::unordered_map<PaintImage::FrameKey,
+                       std::vector<CacheKey>,
+                       PaintImage::FrameKeyHash>
+        frame_key_to_image_keys GUARDED_BY(lock);
+  };
+
+  static constexpr size_t kNumShards = 8;
+
+  Shard* GetShard(const CacheKey& key);
+
   // Get the decoded draw image for the given key and paint_image. Note that
   // when used internally, we still require that DrawWithImageFinished() is
   // called afterwards.
-  DecodedDrawImage GetDecodedImageForDrawInternal(const CacheKey& key,
+  DecodedDrawImage GetDecodedImageForDrawInternal(Shard* shard,
+                                                  const CacheKey& key,
                                                   const PaintImage& paint_image)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
-  // Removes unlocked decoded images until the number of decoded images is
-  // reduced within the given limit.
-  void ReduceCacheUsageUntilWithinLimit(size_t limit)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Removes unlocked decoded images from every shard until the number of
+  // decoded images is reduced within the given limit.
+  void ReduceCacheUsageUntilWithinLimit(size_t limit);
+  void ReduceShardUsageUntilWithinLimit(Shard* shard, size_t limit)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
 #if defined(USE_NEVA_APPRUNTIME)
   void OnMemoryPressure(
@@ -121,54 +152,48 @@ class CC_EXPORT SoftwareImageDecodeCache
   // if it was public (ie, all of the locks need to be properly acquired).
   TaskResult GetTaskForImageAndRefInternal(const DrawImage& image,
                                            const TracingInfo& tracing_info,
-                                           DecodeTaskType type)
-      LOCKS_EXCLUDED(lock_);
+                                           DecodeTaskType type);
 
-  CacheEntry* AddCacheEntry(const CacheKey& key)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  CacheEntry* AddCacheEntry(Shard* shard, const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
-  TaskProcessingResult DecodeImageIfNecessary(const CacheKey& key,
+  TaskProcessingResult DecodeImageIfNecessary(Shard* shard,
+                                              const CacheKey& key,
                                               const PaintImage& paint_image,
                                               CacheEntry* cache_entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  void AddBudgetForImage(const CacheKey& key, CacheEntry* entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  void RemoveBudgetForImage(const CacheKey& key, CacheEntry* entry)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-  base::Optional<CacheKey> FindCachedCandidate(const CacheKey& key)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
-
-  void UnrefImage(const CacheKey& key) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  bool TryAddBudgetForImage(Shard* shard,
+                            const CacheKey& key,
+                            CacheEntry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  void RemoveBudgetForImage(Shard* shard,
+                            const CacheKey& key,
+                            CacheEntry* entry)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+  base::Optional<CacheKey> FindCachedCandidate(Shard* shard,
+                                               const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
+
+  void UnrefImage(Shard* shard, const CacheKey& key)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->lock);
 
   SkColorType GetColorTypeForPaintImage(
       const gfx::ColorSpace& target_color_space,
       const PaintImage& paint_image);
 
-  base::Lock lock_;
-  // Decoded images and ref counts (predecode path).
-  ImageMRUCache decoded_images_ GUARDED_BY(lock_);
+  Shard shards_[kNumShards];
 
 #if defined(USE_NEVA_APPRUNTIME)
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 #endif // defined(USE_NEVA_APPRUNTIME)
 
-  // A map of PaintImage::FrameKey to the ImageKeys for cached decodes of this
-  // PaintImage.
-  std::unordered_map<PaintImage::FrameKey,
-                     std::vector<CacheKey>,
-                     PaintImage::FrameKeyHash>
-      frame_key_to_image_keys_ GUARDED_BY(lock_);
-
-  // Should be GUARDED_BY(lock_), except that accessing
-  // |locked_images_budget_.total_limit_bytes()| is fine without the lock, as
-  // it is const and thread safe.
   MemoryBudget locked_images_budget_;
 
   const SkColorType color_type_;
   const PaintImage::GeneratorClientId generator_client_id_;
 
 #if defined(USE_NEVA_APPRUNTIME)
-  size_t max_items_in_cache_;
+  std::atomic<size_t> max_items_in_cache_;
 #else
   const size_t max_items_in_cache_;
 #endif // defined(USE_NEVA_APPRUNTIME)
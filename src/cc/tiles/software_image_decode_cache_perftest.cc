@@ -2,12 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
 #include "base/timer/lap_timer.h"
 #include "cc/paint/draw_image.h"
 #include "cc/paint/paint_image_builder.h"
 #include "cc/raster/tile_task.h"
+#include "cc/test/skia_common.h"
 #include "cc/tiles/software_image_decode_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -92,5 +98,164 @@ TEST_F(SoftwareImageDecodeCachePerfTest, FromDrawImage) {
   RunFromImage();
 }
 
+// Draws each image in |images| from |begin| to |end| (wrapping around) through
+// the cache until |end_time|, or exactly once if |end_time| is null.
+class DrawImagesDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  DrawImagesDelegate(SoftwareImageDecodeCache* cache,
+                     const std::vector<DrawImage>* images,
+                     size_t begin,
+                     size_t end,
+                     base::TimeTicks end_time)
+      : cache_(cache),
+        images_(images),
+        begin_(begin),
+        end_(end),
+        end_time_(end_time) {}
+  DrawImagesDelegate(const DrawImagesDelegate&) = delete;
+  DrawImagesDelegate& operator=(const DrawImagesDelegate&) = delete;
+
+  void Run() override {
+    do {
+      for (size_t i = begin_; i < end_; ++i) {
+        const DrawImage& image = (*images_)[i];
+        DecodedDrawImage decoded_image = cache_->GetDecodedImageForDraw(image);
+        CHECK(decoded_image.image());
+        cache_->DrawWithImageFinished(image, decoded_image);
+        ++num_draws_;
+      }
+    } while (!end_time_.is_null() && base::TimeTicks::Now() < end_time_);
+  }
+
+  size_t num_draws() const { return num_draws_; }
+
+ private:
+  SoftwareImageDecodeCache* const cache_;
+  const std::vector<DrawImage>* const images_;
+  const size_t begin_;
+  const size_t end_;
+  const base::TimeTicks end_time_;
+  size_t num_draws_ = 0u;
+};
+
+// Measures cache throughput with several raster workers using it at once. The
+// parameter is the number of worker threads.
+class SoftwareImageDecodeCacheThreadedPerfTest
+    : public testing::TestWithParam<int> {
+ public:
+  SoftwareImageDecodeCacheThreadedPerfTest()
+      : timer_(kWarmupRuns,
+               base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
+               kTimeCheckInterval) {}
+
+  std::unique_ptr<SoftwareImageDecodeCache> CreateCache() {
+    return std::make_unique<SoftwareImageDecodeCache>(
+        kN32_SkColorType, 512 * 1024 * 1024,
+        PaintImage::GetNextGeneratorClientId());
+  }
+
+  std::vector<DrawImage> CreateImages(size_t count) {
+    std::vector<DrawImage> images;
+    images.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      PaintImage paint_image = CreateDiscardablePaintImage(gfx::Size(32, 32));
+      images.emplace_back(paint_image, false,
+                          SkIRect::MakeWH(paint_image.width(),
+                                          paint_image.height()),
+                          kNone_SkFilterQuality, SkMatrix::I(),
+                          PaintImage::kDefaultFrameIndex, gfx::ColorSpace());
+    }
+    return images;
+  }
+
+  // Runs one delegate per thread over consecutive slices of |images|, or over
+  // all of them if |share_images| is true, and returns the total draw count.
+  size_t RunThreads(SoftwareImageDecodeCache* cache,
+                    const std::vector<DrawImage>& images,
+                    bool share_images,
+                    base::TimeTicks end_time) {
+    const size_t num_threads = GetParam();
+    const size_t slice_size = images.size() / num_threads;
+    std::vector<std::unique_ptr<DrawImagesDelegate>> delegates;
+    std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      size_t begin = share_images ? 0u : i * slice_size;
+      size_t end = share_images ? images.size() : begin + slice_size;
+      delegates.push_back(std::make_unique<DrawImagesDelegate>(
+          cache, &images, begin, end, end_time));
+      threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+          delegates.back().get(), "SoftwareImageDecodeCacheWorker"));
+      threads.back()->Start();
+    }
+
+    size_t num_draws = 0u;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads[i]->Join();
+      num_draws += delegates[i]->num_draws();
+    }
+    return num_draws;
+  }
+
+  // Every worker decodes its own set of images into a fresh cache.
+  void RunDecodeTest() {
+    std::vector<DrawImage> images = CreateImages(64 * GetParam());
+
+    size_t num_decodes = 0u;
+    base::TimeDelta elapsed;
+    timer_.Reset();
+    do {
+      std::unique_ptr<SoftwareImageDecodeCache> cache = CreateCache();
+      base::TimeTicks start = base::TimeTicks::Now();
+      num_decodes += RunThreads(cache.get(), images, /*share_images=*/false,
+                                base::TimeTicks());
+      elapsed += base::TimeTicks::Now() - start;
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter = SetUpReporter("decode");
+    reporter.AddResult("", num_decodes / elapsed.InSecondsF());
+  }
+
+  // All workers repeatedly look up the same set of already decoded images.
+  void RunLookupTest() {
+    std::vector<DrawImage> images = CreateImages(256);
+    std::unique_ptr<SoftwareImageDecodeCache> cache = CreateCache();
+    for (const DrawImage& image : images)
+      cache->DrawWithImageFinished(image, cache->GetDecodedImageForDraw(image));
+
+    base::TimeDelta duration =
+        base::TimeDelta::FromMilliseconds(kTimeLimitMillis);
+    size_t num_lookups =
+        RunThreads(cache.get(), images, /*share_images=*/true,
+                   base::TimeTicks::Now() + duration);
+
+    perf_test::PerfResultReporter reporter = SetUpReporter("lookup");
+    reporter.AddResult("", num_lookups / duration.InSecondsF());
+  }
+
+ private:
+  perf_test::PerfResultReporter SetUpReporter(const std::string& metric) {
+    perf_test::PerfResultReporter reporter(
+        "software_image_decode_cache_" + metric,
+        base::NumberToString(GetParam()) + "_threads");
+    reporter.RegisterImportantMetric("", "images/s");
+    return reporter;
+  }
+
+  base::LapTimer timer_;
+};
+
+TEST_P(SoftwareImageDecodeCacheThreadedPerfTest, Decode) {
+  RunDecodeTest();
+}
+
+TEST_P(SoftwareImageDecodeCacheThreadedPerfTest, Lookup) {
+  RunLookupTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         SoftwareImageDecodeCacheThreadedPerfTest,
+                         ::testing::Values(1, 2, 4, 8));
+
 }  // namespace
 }  // namespace cc
@@ -4,6 +4,10 @@
 
 #include "cc/tiles/software_image_decode_cache.h"
 
+#include <memory>
+#include <vector>
+
+#include "base/threading/simple_thread.h"
 #include "cc/paint/draw_image.h"
 #include "cc/paint/paint_image_builder.h"
 #include "cc/test/fake_paint_image_generator.h"
@@ -2063,5 +2067,186 @@ TEST(SoftwareImageDecodeCacheTest, HdrDecodeToSdr) {
   cache.DrawWithImageFinished(draw_image, decoded_image);
 }
 
+TEST(SoftwareImageDecodeCacheTest, ReduceCacheUsageKeepsSkewedShard) {
+  TestSoftwareImageDecodeCache cache;
+  PaintImage paint_image = CreatePaintImage(512, 512);
+
+  // All decodes of an image share a shard, so this puts every entry in the
+  // same shard while the cache as a whole stays well within its limit.
+  const size_t kNumDecodes = 200;
+  for (size_t i = 0; i < kNumDecodes; ++i) {
+    DrawImage draw_image(
+        paint_image, false,
+        SkIRect::MakeXYWH(i % 16 * 16, i / 16 * 16, 256, 256),
+        kMedium_SkFilterQuality, CreateMatrix(SkSize::Make(0.5f, 0.5f), true),
+        PaintImage::kDefaultFrameIndex, DefaultColorSpace());
+    ImageDecodeCache::TaskResult result = cache.GetTaskForImageAndRef(
+        draw_image, ImageDecodeCache::TracingInfo());
+    ASSERT_TRUE(result.task);
+    TestTileTaskRunner::ProcessTask(result.task.get());
+    cache.UnrefImage(draw_image);
+  }
+  // Decoding a subrect may also cache the intermediate decode it came from.
+  size_t num_entries = cache.GetNumCacheEntriesForTesting();
+  EXPECT_GE(num_entries, kNumDecodes);
+
+  cache.ReduceCacheUsage();
+  EXPECT_EQ(num_entries, cache.GetNumCacheEntriesForTesting());
+
+  cache.ClearCache();
+  EXPECT_EQ(0u, cache.GetNumCacheEntriesForTesting());
+}
+
+TEST(SoftwareImageDecodeCacheTest, ReduceCacheUsageEvictsAcrossShards) {
+  TestSoftwareImageDecodeCache cache;
+
+  // The cache keeps at most 1000 unlocked entries, however they are spread
+  // over its shards.
+  const size_t kMaxItemsInCache = 1000;
+  const size_t kNumImages = kMaxItemsInCache + 100;
+  DrawImage locked_draw_image;
+  for (size_t i = 0; i < kNumImages; ++i) {
+    PaintImage paint_image = CreatePaintImage(10, 10);
+    DrawImage draw_image(
+        paint_image, false,
+        SkIRect::MakeWH(paint_image.width(), paint_image.height()),
+        kLow_SkFilterQuality, CreateMatrix(SkSize::Make(1.0f, 1.0f), true),
+        PaintImage::kDefaultFrameIndex, DefaultColorSpace());
+    ImageDecodeCache::TaskResult result = cache.GetTaskForImageAndRef(
+        draw_image, ImageDecodeCache::TracingInfo());
+    ASSERT_TRUE(result.task);
+    TestTileTaskRunner::ProcessTask(result.task.get());
+    // Keep the oldest image in use; it must survive the eviction.
+    if (i == 0)
+      locked_draw_image = draw_image;
+    else
+      cache.UnrefImage(draw_image);
+  }
+  EXPECT_EQ(kNumImages, cache.GetNumCacheEntriesForTesting());
+
+  cache.ReduceCacheUsage();
+  EXPECT_EQ(kMaxItemsInCache, cache.GetNumCacheEntriesForTesting());
+
+  cache.ClearCache();
+  EXPECT_EQ(1u, cache.GetNumCacheEntriesForTesting());
+  cache.UnrefImage(locked_draw_image);
+  cache.ClearCache();
+  EXPECT_EQ(0u, cache.GetNumCacheEntriesForTesting());
+}
+
+DrawImage CreateBudgetTestDrawImage() {
+  PaintImage paint_image = CreatePaintImage(100, 100);
+  return DrawImage(paint_image, false,
+                   SkIRect::MakeWH(paint_image.width(), paint_image.height()),
+                   kLow_SkFilterQuality,
+                   CreateMatrix(SkSize::Make(1.0f, 1.0f), true),
+                   PaintImage::kDefaultFrameIndex, DefaultColorSpace());
+}
+
+// Each decode of a 100x100 image locks this many bytes.
+const size_t kBudgetTestImageBytes = 100 * 100 * 4;
+
+TEST(SoftwareImageDecodeCacheTest, LockedBudgetIsSharedByAllShards) {
+  SoftwareImageDecodeCache cache(kN32_SkColorType, 3 * kBudgetTestImageBytes,
+                                 PaintImage::kDefaultGeneratorClientId);
+
+  // Different images mostly land in different shards, but they all draw from
+  // the one budget.
+  std::vector<DrawImage> draw_images;
+  for (int i = 0; i < 5; ++i) {
+    draw_images.push_back(CreateBudgetTestDrawImage());
+    ImageDecodeCache::TaskResult result = cache.GetTaskForImageAndRef(
+        draw_images.back(), ImageDecodeCache::TracingInfo());
+    EXPECT_EQ(i < 3, result.need_unref) << i;
+    EXPECT_EQ(i >= 3, result.is_at_raster_decode) << i;
+    if (result.task)
+      TestTileTaskRunner::ProcessTask(result.task.get());
+  }
+
+  // Releasing an image returns its bytes to the budget.
+  cache.UnrefImage(draw_images[0]);
+  ImageDecodeCache::TaskResult result = cache.GetTaskForImageAndRef(
+      draw_images[3], ImageDecodeCache::TracingInfo());
+  EXPECT_TRUE(result.need_unref);
+  ASSERT_TRUE(result.task);
+  TestTileTaskRunner::ProcessTask(result.task.get());
+
+  result = cache.GetTaskForImageAndRef(draw_images[4],
+                                       ImageDecodeCache::TracingInfo());
+  EXPECT_FALSE(result.need_unref);
+  EXPECT_TRUE(result.is_at_raster_decode);
+
+  for (int i = 1; i < 4; ++i)
+    cache.UnrefImage(draw_images[i]);
+}
+
+class BudgetTestThread : public base::DelegateSimpleThread::Delegate {
+ public:
+  BudgetTestThread(SoftwareImageDecodeCache* cache, size_t num_images)
+      : cache_(cache) {
+    for (size_t i = 0; i < num_images; ++i)
+      draw_images_.push_back(CreateBudgetTestDrawImage());
+  }
+
+  void Run() override {
+    for (const DrawImage& draw_image : draw_images_) {
+      ImageDecodeCache::TaskResult result = cache_->GetTaskForImageAndRef(
+          draw_image, ImageDecodeCache::TracingInfo());
+      if (result.need_unref) {
+        budgeted_images_.push_back(draw_image);
+        tasks_.push_back(std::move(result.task));
+      }
+    }
+  }
+
+  // Runs the decodes that got budget and releases them.
+  void Finish() {
+    for (const scoped_refptr<TileTask>& task : tasks_)
+      TestTileTaskRunner::ProcessTask(task.get());
+    for (const DrawImage& draw_image : budgeted_images_)
+      cache_->UnrefImage(draw_image);
+  }
+
+  size_t num_budgeted_images() const { return budgeted_images_.size(); }
+
+ private:
+  SoftwareImageDecodeCache* const cache_;
+  std::vector<DrawImage> draw_images_;
+  std::vector<DrawImage> budgeted_images_;
+  std::vector<scoped_refptr<TileTask>> tasks_;
+};
+
+TEST(SoftwareImageDecodeCacheTest, ConcurrentRefsStayWithinLockedBudget) {
+  const size_t kBudgetedImages = 5;
+  SoftwareImageDecodeCache cache(kN32_SkColorType,
+                                 kBudgetedImages * kBudgetTestImageBytes,
+                                 PaintImage::kDefaultGeneratorClientId);
+
+  // Run two rounds, so that the second one checks that the first returned
+  // exactly the bytes it took.
+  for (int round = 0; round < 2; ++round) {
+    const int kNumThreads = 4;
+    std::vector<std::unique_ptr<BudgetTestThread>> delegates;
+    std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+      delegates.push_back(std::make_unique<BudgetTestThread>(&cache, 8));
+      threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+          delegates.back().get(), "BudgetTestThread"));
+    }
+    for (auto& thread : threads)
+      thread->Start();
+    for (auto& thread : threads)
+      thread->Join();
+
+    size_t num_budgeted_images = 0u;
+    for (auto& delegate : delegates)
+      num_budgeted_images += delegate->num_budgeted_images();
+    EXPECT_EQ(kBudgetedImages, num_budgeted_images) << round;
+
+    for (auto& delegate : delegates)
+      delegate->Finish();
+  }
+}
+
 }  // namespace
 }  // namespace cc
@@ -8,13 +8,16 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "cc/paint/display_item_list.h"
 #include "cc/paint/draw_image.h"
 #include "cc/raster/tile_task.h"
 #include "cc/tiles/tile_draw_info.h"
+#include "cc/tiles/tile_raster_cache.h"
 #include "ui/gfx/geometry/axis_transform2d.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
@@ -169,6 +172,15 @@ class CC_EXPORT Tile {
 
   Id id_;
 
+  // Set while the tile is, or will be, rastered with content that can be put
+  // in the TileRasterCache when the tile is released.
+  std::unique_ptr<TileRasterCache::Key> raster_cache_key_;
+
+  // The rtree query of the last raster of this tile, so that re-rasters of the
+  // same content, e.g. after the resource was evicted, skip the search. It is
+  // handed to the raster task while one is scheduled.
+  std::unique_ptr<DisplayItemList::RasterQueryCache> raster_query_cache_;
+
   // List of Rect-Transform pairs, representing unoccluded parts of the
   // tile, to support raster culling. See Bug: 1071932
   std::vector<std::pair<const gfx::Rect, const gfx::AxisTransform2d>>
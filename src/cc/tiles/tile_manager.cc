@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <string>
 
@@ -78,6 +79,8 @@ class RasterTaskImpl : public TileTask {
                  ResourcePool::InUsePoolResource resource,
                  scoped_refptr<RasterSource> raster_source,
                  const RasterSource::PlaybackSettings& playback_settings,
+                 std::unique_ptr<DisplayItemList::RasterQueryCache>
+                     raster_query_cache,
                  TileResolution tile_resolution,
                  gfx::Rect invalidated_rect,
                  uint64_t source_prepare_tiles_id,
@@ -101,6 +104,7 @@ class RasterTaskImpl : public TileTask {
         invalid_content_rect_(invalidated_rect),
         raster_transform_(tile->raster_transform()),
         playback_settings_(playback_settings),
+        raster_query_cache_(std::move(raster_query_cache)),
         tile_resolution_(tile_resolution),
         layer_id_(tile->layer_id()),
         source_prepare_tiles_id_(source_prepare_tiles_id),
@@ -112,6 +116,7 @@ class RasterTaskImpl : public TileTask {
         url_(std::move(url)) {
     DCHECK(origin_thread_checker_.CalledOnValidThread());
     playback_settings_.image_provider = &image_provider_;
+    playback_settings_.raster_query_cache = raster_query_cache_.get();
   }
   RasterTaskImpl(const RasterTaskImpl&) = delete;
   RasterTaskImpl& operator=(const RasterTaskImpl&) = delete;
@@ -143,6 +148,7 @@ class RasterTaskImpl : public TileTask {
     // upon by task graph runner.
     raster_buffer_ = nullptr;
     tile_manager_->OnRasterTaskCompleted(tile_id_, std::move(resource_),
+                                         std::move(raster_query_cache_),
                                          state().IsCanceled());
   }
 
@@ -169,6 +175,7 @@ class RasterTaskImpl : public TileTask {
   gfx::Rect invalid_content_rect_;
   gfx::AxisTransform2d raster_transform_;
   RasterSource::PlaybackSettings playback_settings_;
+  std::unique_ptr<DisplayItemList::RasterQueryCache> raster_query_cache_;
   TileResolution tile_resolution_;
   int layer_id_;
   uint64_t source_prepare_tiles_id_;
@@ -379,7 +386,7 @@ gfx::ContentColorUsage GetContentColorUsageForPrioritizedTile(
 }  // namespace
 
 RasterTaskCompletionStats::RasterTaskCompletionStats()
-    : completed_count(0u), canceled_count(0u) {}
+    : completed_count(0u), canceled_count(0u), reused_count(0u) {}
 
 std::unique_ptr<base::trace_event::ConvertableToTraceFormat>
 RasterTaskCompletionStatsAsValue(const RasterTaskCompletionStats& stats) {
@@ -389,6 +396,8 @@ RasterTaskCompletionStatsAsValue(const RasterTaskCompletionStats& stats) {
                     base::saturated_cast<int>(stats.completed_count));
   state->SetInteger("canceled_count",
                     base::saturated_cast<int>(stats.canceled_count));
+  state->SetInteger("reused_count",
+                    base::saturated_cast<int>(stats.reused_count));
   return std::move(state);
 }
 
@@ -426,7 +435,12 @@ TileManager::TileManager(
                               base::Unretained(this))),
       has_scheduled_tile_tasks_(false),
       prepare_tiles_count_(0u),
-      next_tile_id_(0u) {}
+      next_tile_id_(0u) {
+  if (tile_manager_settings_.max_raster_cache_tiles) {
+    raster_cache_ = std::make_unique<TileRasterCache>(
+        tile_manager_settings_.max_raster_cache_tiles);
+  }
+}
 
 TileManager::~TileManager() {
   FinishTasksAndCleanUp();
@@ -446,6 +460,12 @@ void TileManager::FinishTasksAndCleanUp() {
 
   tile_task_manager_->CheckForCompletedTasks();
 
+  // The cached rasters belong to |resource_pool_|.
+  if (raster_cache_) {
+    while (!raster_cache_->empty())
+      resource_pool_->ReleaseResource(raster_cache_->TakeLeastRecentlyUsed());
+  }
+
   tile_task_manager_ = nullptr;
   resource_pool_ = nullptr;
   more_tiles_need_prepare_check_notifier_.Cancel();
@@ -487,6 +507,24 @@ void TileManager::Release(Tile* tile) {
     num_of_tiles_with_checker_images_--;
   DCHECK_GE(num_of_tiles_with_checker_images_, 0);
 
+  // Keep the raster of a tile that goes away, e.g. because its content was
+  // invalidated, for a later tile with the same content.
+  TileDrawInfo& draw_info = tile->draw_info();
+  if (raster_cache_ && tile->raster_cache_key_ && tile->tiling() &&
+      draw_info.has_resource() && draw_info.IsReadyToDraw() &&
+      !draw_info.is_checker_imaged()) {
+    // Tiles are replaced when their content is invalidated, so the current
+    // recording of the tiling has the content that the tile was rastered from.
+    scoped_refptr<const DisplayItemList> recording =
+        tile->tiling()->raster_source()->GetDisplayItemList();
+    tile->raster_cache_key_->recording_id = recording->unique_id();
+    ResourcePool::InUsePoolResource evicted =
+        raster_cache_->Put(std::move(*tile->raster_cache_key_),
+                           std::move(recording), draw_info.TakeResource());
+    if (evicted)
+      resource_pool_->ReleaseResource(std::move(evicted));
+  }
+
   FreeResourcesForTile(tile);
   tiles_.erase(tile->id());
 }
@@ -630,6 +668,7 @@ TileManager::FreeTileResourcesUntilUsageIsWithinLimit(
     std::unique_ptr<EvictionTilePriorityQueue> eviction_priority_queue,
     const MemoryUsage& limit,
     MemoryUsage* usage) {
+  FreeRasterCacheUntilUsageIsWithinLimit(limit, usage);
   while (usage->Exceeds(limit)) {
     if (!eviction_priority_queue) {
       eviction_priority_queue =
@@ -652,6 +691,8 @@ TileManager::FreeTileResourcesWithLowerPriorityUntilUsageIsWithinLimit(
     const MemoryUsage& limit,
     const TilePriority& other_priority,
     MemoryUsage* usage) {
+  // Cached rasters are not needed by any tile, so they go first.
+  FreeRasterCacheUntilUsageIsWithinLimit(limit, usage);
   while (usage->Exceeds(limit)) {
     if (!eviction_priority_queue) {
       eviction_priority_queue =
@@ -672,6 +713,22 @@ TileManager::FreeTileResourcesWithLowerPriorityUntilUsageIsWithinLimit(
   return eviction_priority_queue;
 }
 
+void TileManager::FreeRasterCacheUntilUsageIsWithinLimit(
+    const MemoryUsage& limit,
+    MemoryUsage* usage) {
+  if (!raster_cache_)
+    return;
+  while (usage->Exceeds(limit) && !raster_cache_->empty()) {
+    size_t recording_bytes = raster_cache_->retained_recording_bytes();
+    ResourcePool::InUsePoolResource resource =
+        raster_cache_->TakeLeastRecentlyUsed();
+    *usage -= MemoryUsage::FromConfig(resource.size(), resource.format());
+    *usage -= MemoryUsage(
+        recording_bytes - raster_cache_->retained_recording_bytes(), 0);
+    resource_pool_->ReleaseResource(std::move(resource));
+  }
+}
+
 bool TileManager::TilePriorityViolatesMemoryPolicy(
     const TilePriority& priority) {
   switch (global_state_.memory_limit_policy) {
@@ -707,6 +764,9 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
                                 global_state_.num_resources_limit);
   MemoryUsage memory_usage(resource_pool_->memory_usage_bytes(),
                            resource_pool_->resource_count());
+  // The recordings that the raster cache keeps alive are only there for it.
+  if (raster_cache_)
+    memory_usage += MemoryUsage(raster_cache_->retained_recording_bytes(), 0);
 
   std::unique_ptr<RasterTilePriorityQueue> raster_priority_queue(
       client_->BuildRasterQueue(global_state_.tree_priority,
@@ -770,6 +830,13 @@ TileManager::PrioritizedWorkToSchedule TileManager::AssignGpuMemoryToTiles() {
       continue;
     }
 
+    // A tile with the same content as a released tile takes its raster, whose
+    // memory is already accounted for in |memory_usage|.
+    if (raster_cache_ && !tile->HasRasterTask() &&
+        TryReuseCachedRaster(prioritized_tile, raster_color_space)) {
+      continue;
+    }
+
     // We won't be able to schedule this tile, so break out early.
     if (work_to_schedule.tiles_to_raster.size() >=
         scheduled_raster_task_limit_) {
@@ -1181,16 +1248,7 @@ scoped_refptr<TileTask> TileManager::CreateRasterTask(
   const int msaa_sample_count = client_->GetMSAASampleCountForRaster(
       prioritized_tile.raster_source()->GetDisplayItemList());
 
-  // When possible, rasterize HDR content into F16.
-  //
-  // TODO(crbug.com/1076568): Once we have access to the display's buffer format
-  // via gfx::DisplayColorSpaces, we should also do this for HBD images.
-  auto format = DetermineResourceFormat(tile);
-  if (raster_color_space.IsHDR() &&
-      GetContentColorUsageForPrioritizedTile(prioritized_tile) ==
-          gfx::ContentColorUsage::kHDR) {
-    format = viz::ResourceFormat::RGBA_F16;
-  }
+  auto format = DetermineRasterFormat(prioritized_tile, raster_color_space);
 
   // Get the resource.
   ResourcePool::InUsePoolResource resource;
@@ -1219,6 +1277,8 @@ scoped_refptr<TileTask> TileManager::CreateRasterTask(
       prioritized_tile.priority().resolution == LOW_RESOLUTION;
   playback_settings.use_lcd_text = tile->can_use_lcd_text();
   playback_settings.msaa_sample_count = msaa_sample_count;
+  playback_settings.allow_parallel_playback =
+      prioritized_tile.priority().priority_bin == TilePriority::NOW;
 
   // Create and queue all image decode tasks that this tile depends on. Note
   // that we need to store the images for decode tasks in
@@ -1255,8 +1315,15 @@ scoped_refptr<TileTask> TileManager::CreateRasterTask(
 
   const bool has_checker_images = !checkered_images.empty();
   tile->set_raster_task_scheduled_with_checker_images(has_checker_images);
-  if (has_checker_images)
+  if (has_checker_images) {
     num_of_tiles_with_checker_images_++;
+    // The raster will be replaced once the images are decoded.
+    tile->raster_cache_key_ = nullptr;
+  } else if (raster_cache_ && !tile->raster_cache_key_) {
+    // The raster goes to the cache when the tile is released.
+    tile->raster_cache_key_ =
+        CreateRasterCacheKey(prioritized_tile, raster_color_space);
+  }
 
   // Don't allow at-raster prepaint tiles, because they could be very slow
   // and block high-priority tasks.
@@ -1267,6 +1334,7 @@ scoped_refptr<TileTask> TileManager::CreateRasterTask(
     // This will unref the images, but ScheduleTasks will schedule them
     // right away anyway.
     OnRasterTaskCompleted(tile->id(), std::move(resource),
+                          nullptr /* raster_query_cache */,
                           true /* was_canceled */);
     return nullptr;
   }
@@ -1318,14 +1386,102 @@ scoped_refptr<TileTask> TileManager::CreateRasterTask(
   DispatchingImageProvider dispatching_image_provider(
       std::move(image_provider), std::move(paint_worklet_image_provider));
 
+  if (!tile->raster_query_cache_) {
+    tile->raster_query_cache_ =
+        std::make_unique<DisplayItemList::RasterQueryCache>();
+  }
+
   return base::MakeRefCounted<RasterTaskImpl>(
       this, tile, std::move(resource), prioritized_tile.raster_source(),
-      playback_settings, prioritized_tile.priority().resolution,
+      playback_settings, std::move(tile->raster_query_cache_),
+      prioritized_tile.priority().resolution,
       invalidated_rect, prepare_tiles_count_, std::move(raster_buffer),
       &decode_tasks, use_gpu_rasterization_,
       std::move(dispatching_image_provider), active_url_);
 }
 
+std::unique_ptr<TileRasterCache::Key> TileManager::CreateRasterCacheKey(
+    const PrioritizedTile& prioritized_tile,
+    const gfx::ColorSpace& raster_color_space) const {
+  Tile* tile = prioritized_tile.tile();
+  // Low resolution tiles skip images, and animated images and paint worklets
+  // change without a change of the recorded ops.
+  if (prioritized_tile.priority().resolution == LOW_RESOLUTION)
+    return nullptr;
+  const scoped_refptr<RasterSource>& raster_source =
+      prioritized_tile.raster_source();
+  const DisplayItemList* display_list =
+      raster_source->GetDisplayItemList().get();
+  const DiscardableImageMap& image_map = display_list->discardable_image_map();
+  if (!image_map.animated_images_metadata().empty() ||
+      !image_map.paint_worklet_inputs().empty()) {
+    return nullptr;
+  }
+
+  auto key = std::make_unique<TileRasterCache::Key>();
+  key->recording_id = display_list->unique_id();
+  // Skia outsets the clip of the raster by a pixel for antialiasing, which
+  // is more than one recorded pixel when rastering at a lower scale.
+  float scale = tile->raster_transform().scale() /
+                raster_source->recording_scale_factor();
+  int outset = static_cast<int>(std::ceil(1.f / scale)) + 1;
+  key->query_rect = gfx::ScaleToEnclosingRect(
+      tile->enclosing_layer_rect(), raster_source->recording_scale_factor());
+  key->query_rect.Inset(-outset, -outset);
+  key->content_hash = display_list->ContentHashInRect(key->query_rect);
+  key->layer_size = raster_source->GetSize();
+  key->background_color = raster_source->background_color();
+  key->requires_clear = raster_source->requires_clear();
+  key->recording_scale_factor = raster_source->recording_scale_factor();
+  key->content_rect = tile->content_rect();
+  key->raster_transform = tile->raster_transform();
+  key->format = DetermineRasterFormat(prioritized_tile, raster_color_space);
+  key->color_space = raster_color_space;
+  key->use_lcd_text = tile->can_use_lcd_text();
+  key->msaa_sample_count =
+      client_->GetMSAASampleCountForRaster(raster_source->GetDisplayItemList());
+  return key;
+}
+
+bool TileManager::TryReuseCachedRaster(
+    const PrioritizedTile& prioritized_tile,
+    const gfx::ColorSpace& raster_color_space) {
+  Tile* tile = prioritized_tile.tile();
+  DCHECK(!tile->HasRasterTask());
+  // Hashing the content of the tile is not free, so it waits until there is
+  // something to compare it against. CreateRasterTask() makes the key
+  // otherwise.
+  if (raster_cache_->empty()) {
+    tile->raster_cache_key_ = nullptr;
+    return false;
+  }
+  tile->raster_cache_key_ =
+      CreateRasterCacheKey(prioritized_tile, raster_color_space);
+  if (!tile->raster_cache_key_)
+    return false;
+
+  ResourcePool::InUsePoolResource resource = raster_cache_->Take(
+      *tile->raster_cache_key_,
+      *prioritized_tile.raster_source()->GetDisplayItemList());
+  if (!resource)
+    return false;
+
+  resource_pool_->OnContentReplaced(resource, tile->id());
+  if (!resource_pool_->PrepareForExport(resource)) {
+    resource_pool_->ReleaseResource(std::move(resource));
+    return false;
+  }
+  ++raster_task_completion_stats_.reused_count;
+
+  TileDrawInfo& draw_info = tile->draw_info();
+  draw_info.SetResource(std::move(resource),
+                        false /* resource_is_checker_imaged */,
+                        raster_buffer_provider_->IsResourcePremultiplied());
+  draw_info.set_resource_ready_for_draw();
+  client_->NotifyTileStateChanged(tile);
+  return true;
+}
+
 void TileManager::ResetSignalsForTesting() {
   signals_ = Signals();
 }
@@ -1333,6 +1489,7 @@ void TileManager::ResetSignalsForTesting() {
 void TileManager::OnRasterTaskCompleted(
     Tile::Id tile_id,
     ResourcePool::InUsePoolResource resource,
+    std::unique_ptr<DisplayItemList::RasterQueryCache> raster_query_cache,
     bool was_canceled) {
   auto found = tiles_.find(tile_id);
   Tile* tile = nullptr;
@@ -1340,6 +1497,8 @@ void TileManager::OnRasterTaskCompleted(
   if (found != tiles_.end()) {
     tile = found->second;
     tile->raster_task_ = nullptr;
+    if (raster_query_cache)
+      tile->raster_query_cache_ = std::move(raster_query_cache);
     raster_task_was_scheduled_with_checker_images =
         tile->set_raster_task_scheduled_with_checker_images(false);
     if (raster_task_was_scheduled_with_checker_images)
@@ -1661,6 +1820,21 @@ void TileManager::NeedsInvalidationForCheckerImagedTiles() {
   client_->RequestImplSideInvalidationForCheckerImagedTiles();
 }
 
+viz::ResourceFormat TileManager::DetermineRasterFormat(
+    const PrioritizedTile& prioritized_tile,
+    const gfx::ColorSpace& raster_color_space) const {
+  // When possible, rasterize HDR content into F16.
+  //
+  // TODO(crbug.com/1076568): Once we have access to the display's buffer format
+  // via gfx::DisplayColorSpaces, we should also do this for HBD images.
+  if (raster_color_space.IsHDR() &&
+      GetContentColorUsageForPrioritizedTile(prioritized_tile) ==
+          gfx::ContentColorUsage::kHDR) {
+    return viz::ResourceFormat::RGBA_F16;
+  }
+  return DetermineResourceFormat(prioritized_tile.tile());
+}
+
 viz::ResourceFormat TileManager::DetermineResourceFormat(
     const Tile* tile) const {
   return raster_buffer_provider_->GetResourceFormat();
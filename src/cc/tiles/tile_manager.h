@@ -31,6 +31,7 @@
 #include "cc/tiles/tile.h"
 #include "cc/tiles/tile_draw_info.h"
 #include "cc/tiles/tile_manager_settings.h"
+#include "cc/tiles/tile_raster_cache.h"
 #include "cc/tiles/tile_task_manager.h"
 #include "ui/gfx/display_color_spaces.h"
 #include "url/gurl.h"
@@ -117,6 +118,8 @@ struct RasterTaskCompletionStats {
 
   size_t completed_count;
   size_t canceled_count;
+  // Tiles that took a resource from the TileRasterCache instead of rastering.
+  size_t reused_count;
 };
 std::unique_ptr<base::trace_event::ConvertableToTraceFormat>
 RasterTaskCompletionStatsAsValue(const RasterTaskCompletionStats& stats);
@@ -292,9 +295,20 @@ class CC_EXPORT TileManager : CheckerImageTrackerClient {
     return has_scheduled_tile_tasks_;
   }
 
-  void OnRasterTaskCompleted(Tile::Id tile_id,
-                             ResourcePool::InUsePoolResource resource,
-                             bool was_canceled);
+  const RasterTaskCompletionStats& raster_task_completion_stats_for_testing()
+      const {
+    return raster_task_completion_stats_;
+  }
+
+  size_t raster_cache_size_for_testing() const {
+    return raster_cache_ ? raster_cache_->size() : 0u;
+  }
+
+  void OnRasterTaskCompleted(
+      Tile::Id tile_id,
+      ResourcePool::InUsePoolResource resource,
+      std::unique_ptr<DisplayItemList::RasterQueryCache> raster_query_cache,
+      bool was_canceled);
 
   // CheckerImageTrackerClient implementation.
   void NeedsInvalidationForCheckerImagedTiles() override;
@@ -384,6 +398,17 @@ class CC_EXPORT TileManager : CheckerImageTrackerClient {
       float sdr_white_level,
       PrioritizedWorkToSchedule* work_to_schedule);
 
+  // Returns the key under which the raster of |prioritized_tile| can be
+  // cached, or null if it can not be.
+  std::unique_ptr<TileRasterCache::Key> CreateRasterCacheKey(
+      const PrioritizedTile& prioritized_tile,
+      const gfx::ColorSpace& raster_color_space) const;
+  // Gives the tile a cached raster of its content, if there is one.
+  bool TryReuseCachedRaster(const PrioritizedTile& prioritized_tile,
+                            const gfx::ColorSpace& raster_color_space);
+  void FreeRasterCacheUntilUsageIsWithinLimit(const MemoryUsage& limit,
+                                              MemoryUsage* usage);
+
   std::unique_ptr<EvictionTilePriorityQueue>
   FreeTileResourcesUntilUsageIsWithinLimit(
       std::unique_ptr<EvictionTilePriorityQueue> eviction_priority_queue,
@@ -402,6 +427,10 @@ class CC_EXPORT TileManager : CheckerImageTrackerClient {
       std::unique_ptr<RasterTilePriorityQueue> queue) const;
 
   viz::ResourceFormat DetermineResourceFormat(const Tile* tile) const;
+  // Same as above, but rasters HDR content into F16 when possible.
+  viz::ResourceFormat DetermineRasterFormat(
+      const PrioritizedTile& prioritized_tile,
+      const gfx::ColorSpace& raster_color_space) const;
 
   void DidFinishRunningTileTasksRequiredForActivation();
   void DidFinishRunningTileTasksRequiredForDraw();
@@ -465,6 +494,10 @@ class CC_EXPORT TileManager : CheckerImageTrackerClient {
 
   RasterTaskCompletionStats raster_task_completion_stats_;
 
+  // Rasters of released tiles, null unless enabled by
+  // TileManagerSettings::max_raster_cache_tiles.
+  std::unique_ptr<TileRasterCache> raster_cache_;
+
   TaskGraph graph_;
 
   UniqueNotifier more_tiles_need_prepare_check_notifier_;
@@ -7,17 +7,21 @@
 
 #include "base/lazy_instance.h"
 #include "base/location.h"
+#include "base/run_loop.h"
 #include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
 #include "base/timer/lap_timer.h"
 #include "cc/raster/raster_buffer.h"
+#include "cc/raster/synchronous_task_graph_runner.h"
 #include "cc/test/fake_impl_task_runner_provider.h"
 #include "cc/test/fake_layer_tree_frame_sink.h"
 #include "cc/test/fake_layer_tree_frame_sink_client.h"
 #include "cc/test/fake_layer_tree_host_impl.h"
 #include "cc/test/fake_picture_layer_impl.h"
 #include "cc/test/fake_raster_source.h"
+#include "cc/test/fake_recording_source.h"
 #include "cc/test/fake_tile_manager.h"
 #include "cc/test/fake_tile_manager_client.h"
 #include "cc/test/fake_tile_task_manager.h"
@@ -344,5 +348,204 @@ TEST_F(TileManagerPerfTest, EvictionTileQueueConstructAndIterate) {
   RunEvictionQueueConstructAndIterateTest("50_128", 50, 128);
 }
 
+// Shows the slides of a carousel one after the other, replacing the content of
+// a layer each time, and rasters the tiles for real. Slides come back after
+// kCarouselSlides switches, so all but the first rasters of each slide can be
+// reused from the tile raster cache when it is enabled.
+class TileManagerCarouselPerfTest : public TestLayerTreeHostBase,
+                                    public testing::WithParamInterface<bool> {
+ public:
+  TileManagerCarouselPerfTest()
+      : timer_(kWarmupRuns,
+               base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
+               kTimeCheckInterval) {}
+
+  static constexpr int kCarouselSlides = 4;
+
+  LayerTreeSettings CreateSettings() override {
+    LayerTreeSettings settings = TestLayerTreeHostBase::CreateSettings();
+    if (GetParam())
+      settings.max_raster_cache_tiles = 64;
+    return settings;
+  }
+
+  std::unique_ptr<LayerTreeFrameSink> CreateLayerTreeFrameSink() override {
+    return FakeLayerTreeFrameSink::CreateSoftware();
+  }
+
+  std::unique_ptr<TaskGraphRunner> CreateTaskGraphRunner() override {
+    return std::make_unique<SynchronousTaskGraphRunner>();
+  }
+
+  // A grid of small squares, with colors that differ between slides.
+  scoped_refptr<RasterSource> CreateSlide(const gfx::Size& size, int slide) {
+    std::unique_ptr<FakeRecordingSource> recording_source =
+        FakeRecordingSource::CreateFilledRecordingSource(size);
+    for (int y = 0; y < size.height(); y += 8) {
+      for (int x = 0; x < size.width(); x += 8) {
+        PaintFlags flags;
+        flags.setColor(SkColorSetRGB((x + 40 * slide) % 256, y % 256, slide));
+        recording_source->add_draw_rect_with_flags(gfx::Rect(x, y, 6, 6),
+                                                   flags);
+      }
+    }
+    recording_source->Rerecord();
+    return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+  }
+
+  void RunCarouselTest() {
+    const gfx::Size layer_bounds(1024, 512);
+    const gfx::Size tile_size(256, 256);
+    SetupPendingTree(CreateSlide(layer_bounds, 0), tile_size, Region());
+    ActivateTree();
+
+    size_t rastered_tiles = 0;
+    size_t reused_tiles = 0;
+    int shown_slides = 0;
+    TileManager* tile_manager = host_impl()->tile_manager();
+    timer_.Reset();
+    do {
+      // Every switch commits a new recording of the slide, so that a reuse
+      // has to match the recorded content rather than the raster source.
+      SetupPendingTree(
+          CreateSlide(layer_bounds, ++shown_slides % kCarouselSlides),
+          tile_size, Region(gfx::Rect(layer_bounds)));
+      pending_layer()->UpdateTiles();
+      tile_manager->PrepareTiles(host_impl()->global_tile_state());
+      static_cast<SynchronousTaskGraphRunner*>(task_graph_runner())
+          ->RunUntilIdle();
+      base::RunLoop().RunUntilIdle();
+      ActivateTree();
+
+      // The first laps warm up the cache.
+      if (shown_slides > kWarmupRuns) {
+        const RasterTaskCompletionStats& stats =
+            tile_manager->raster_task_completion_stats_for_testing();
+        rastered_tiles += stats.completed_count;
+        reused_tiles += stats.reused_count;
+      }
+      tile_manager->CheckForCompletedTasks();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter(
+        "tile_manager_carousel", GetParam() ? "raster_cache" : "no_cache");
+    reporter.RegisterImportantMetric("_slide_time", "ms");
+    reporter.RegisterImportantMetric("_rastered_tiles_per_slide", "count");
+    reporter.RegisterImportantMetric("_reused_tiles_per_slide", "count");
+    reporter.AddResult("_slide_time", timer_.TimePerLap().InMillisecondsF());
+    reporter.AddResult("_rastered_tiles_per_slide",
+                       static_cast<double>(rastered_tiles) / timer_.NumLaps());
+    reporter.AddResult("_reused_tiles_per_slide",
+                       static_cast<double>(reused_tiles) / timer_.NumLaps());
+  }
+
+ protected:
+  base::LapTimer timer_;
+};
+
+TEST_P(TileManagerCarouselPerfTest, RepeatingSlides) {
+  RunCarouselTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(All, TileManagerCarouselPerfTest, testing::Bool());
+
+// Invalidates and rasters a viewport of typical page content every frame with
+// software raster, splitting each tile into up to GetParam() playback bands.
+class TileManagerSoftwareRasterPerfTest
+    : public TestLayerTreeHostBase,
+      public testing::WithParamInterface<int> {
+ public:
+  TileManagerSoftwareRasterPerfTest()
+      : timer_(kWarmupRuns,
+               base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
+               kTimeCheckInterval) {}
+
+  LayerTreeSettings CreateSettings() override {
+    LayerTreeSettings settings = TestLayerTreeHostBase::CreateSettings();
+    settings.max_software_raster_playback_bands = GetParam();
+    return settings;
+  }
+
+  std::unique_ptr<LayerTreeFrameSink> CreateLayerTreeFrameSink() override {
+    return FakeLayerTreeFrameSink::CreateSoftware();
+  }
+
+  std::unique_ptr<TaskGraphRunner> CreateTaskGraphRunner() override {
+    return std::make_unique<SynchronousTaskGraphRunner>();
+  }
+
+  // A white page with a column of cards holding lines of short runs that
+  // stand in for words.
+  scoped_refptr<RasterSource> CreatePage(const gfx::Size& size, int frame) {
+    std::unique_ptr<FakeRecordingSource> recording_source =
+        FakeRecordingSource::CreateFilledRecordingSource(size);
+    PaintFlags background_flags;
+    background_flags.setColor(SK_ColorWHITE);
+    recording_source->add_draw_rect_with_flags(gfx::Rect(size),
+                                               background_flags);
+
+    PaintFlags card_flags;
+    card_flags.setColor(SkColorSetARGB(230, 240, 240, 250));
+    card_flags.setAntiAlias(true);
+    PaintFlags text_flags;
+    text_flags.setColor(SkColorSetRGB(frame % 64, 0, 0));
+    text_flags.setAntiAlias(true);
+    for (int y = 16; y + 200 < size.height(); y += 216) {
+      recording_source->add_draw_rectf_with_flags(
+          gfx::RectF(16.5f, y + 0.5f, size.width() - 32.f, 200.f), card_flags);
+      for (int line_y = y + 16; line_y < y + 184; line_y += 18) {
+        for (int word_x = 32; word_x + 40 < size.width() - 32; word_x += 48) {
+          recording_source->add_draw_rectf_with_flags(
+              gfx::RectF(word_x + 0.25f, line_y + 0.25f, 40.f, 11.5f),
+              text_flags);
+        }
+      }
+    }
+    recording_source->Rerecord();
+    return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+  }
+
+  void RunSoftwareRasterTest() {
+    const gfx::Size layer_bounds(1024, 768);
+    const gfx::Size tile_size(256, 256);
+    int frame = 0;
+    SetupPendingTree(CreatePage(layer_bounds, frame), tile_size, Region());
+    ActivateTree();
+
+    TileManager* tile_manager = host_impl()->tile_manager();
+    timer_.Reset();
+    do {
+      SetupPendingTree(CreatePage(layer_bounds, ++frame), tile_size,
+                       Region(gfx::Rect(layer_bounds)));
+      pending_layer()->UpdateTiles();
+      tile_manager->PrepareTiles(host_impl()->global_tile_state());
+      static_cast<SynchronousTaskGraphRunner*>(task_graph_runner())
+          ->RunUntilIdle();
+      base::RunLoop().RunUntilIdle();
+      ActivateTree();
+      tile_manager->CheckForCompletedTasks();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter(
+        "tile_manager_software_raster",
+        "bands_" + base::NumberToString(GetParam()));
+    reporter.RegisterImportantMetric("_frames", "frames/s");
+    reporter.AddResult("_frames", timer_.LapsPerSecond());
+  }
+
+ protected:
+  base::LapTimer timer_;
+};
+
+TEST_P(TileManagerSoftwareRasterPerfTest, PageContent) {
+  RunSoftwareRasterTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         TileManagerSoftwareRasterPerfTest,
+                         testing::Values(1, 2, 4));
+
 }  // namespace
 }  // namespace cc
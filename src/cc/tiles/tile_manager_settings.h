@@ -5,6 +5,8 @@
 #ifndef CC_TILES_TILE_MANAGER_SETTINGS_H_
 #define CC_TILES_TILE_MANAGER_SETTINGS_H_
 
+#include <stddef.h>
+
 #include "cc/cc_export.h"
 
 namespace cc {
@@ -13,6 +15,9 @@ struct CC_EXPORT TileManagerSettings {
   bool use_partial_raster = false;
   bool enable_checker_imaging = false;
   size_t min_image_bytes_to_checker = 1 * 1024 * 1024;
+  // Number of rasters of released tiles kept for new tiles with the same
+  // content. 0 disables the cache.
+  size_t max_raster_cache_tiles = 0;
 };
 
 }  // namespace cc
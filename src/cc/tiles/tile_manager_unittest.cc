@@ -3560,5 +3560,118 @@ TEST_F(TileManagerCheckRasterQueriesTest,
   run_loop.Run();
 }
 
+// Records a slide of a carousel: a grid of squares whose colors depend on
+// |slide|, or on the next slide for the squares in |changed_rect|.
+scoped_refptr<FakeRasterSource> CreateSlideRasterSource(
+    const gfx::Size& size,
+    int slide,
+    const gfx::Rect& changed_rect = gfx::Rect()) {
+  std::unique_ptr<FakeRecordingSource> recording_source =
+      FakeRecordingSource::CreateFilledRecordingSource(size);
+  for (int y = 0; y < size.height(); y += 32) {
+    for (int x = 0; x < size.width(); x += 32) {
+      gfx::Rect square(x, y, 24, 24);
+      int color_slide = changed_rect.Contains(square) ? slide + 1 : slide;
+      PaintFlags flags;
+      flags.setColor(SkColorSetRGB((x + 64 * color_slide) % 256, y % 256, 0));
+      recording_source->add_draw_rect_with_flags(square, flags);
+    }
+  }
+  recording_source->Rerecord();
+  return FakeRasterSource::CreateFromRecordingSource(recording_source.get());
+}
+
+class RasterCacheTileManagerTest : public TileManagerTest {
+ public:
+  LayerTreeSettings CreateSettings() override {
+    auto settings = TileManagerTest::CreateSettings();
+    settings.max_raster_cache_tiles = 32;
+    return settings;
+  }
+
+  std::unique_ptr<TaskGraphRunner> CreateTaskGraphRunner() override {
+    return std::make_unique<SynchronousTaskGraphRunner>();
+  }
+
+  // Replaces the content of the layer with |raster_source|, rasters it and
+  // activates it. Returns the raster stats of the pending tree.
+  RasterTaskCompletionStats ShowContent(
+      scoped_refptr<RasterSource> raster_source) {
+    const gfx::Size layer_bounds = raster_source->GetSize();
+    SetupPendingTree(std::move(raster_source), gfx::Size(128, 128),
+                     Region(gfx::Rect(layer_bounds)));
+    PictureLayerTiling* pending_tiling =
+        pending_layer()->picture_layer_tiling_set()->tiling_at(0);
+    pending_tiling->set_resolution(HIGH_RESOLUTION);
+    pending_tiling->CreateAllTilesForTesting();
+    pending_tiling->SetTilePriorityRectsForTesting(
+        gfx::Rect(layer_bounds),   // Visible rect.
+        gfx::Rect(layer_bounds),   // Skewport rect.
+        gfx::Rect(layer_bounds),   // Soon rect.
+        gfx::Rect(layer_bounds));  // Eventually rect.
+
+    TileManager* tile_manager = host_impl()->tile_manager();
+    tile_manager->PrepareTiles(host_impl()->global_tile_state());
+    static_cast<SynchronousTaskGraphRunner*>(task_graph_runner())
+        ->RunUntilIdle();
+    base::RunLoop().RunUntilIdle();
+    RasterTaskCompletionStats stats =
+        tile_manager->raster_task_completion_stats_for_testing();
+    // Resets the stats.
+    tile_manager->CheckForCompletedTasks();
+
+    for (Tile* tile : pending_tiling->AllTilesForTesting())
+      EXPECT_TRUE(tile->draw_info().IsReadyToDraw());
+    ActivateTree();
+    return stats;
+  }
+};
+
+TEST_F(RasterCacheTileManagerTest, ReusesRasterOfRepeatedContent) {
+  const gfx::Size layer_bounds(256, 256);
+  RasterTaskCompletionStats stats =
+      ShowContent(CreateSlideRasterSource(layer_bounds, 0));
+  EXPECT_EQ(4u, stats.completed_count);
+  EXPECT_EQ(0u, stats.reused_count);
+  EXPECT_EQ(0u, host_impl()->tile_manager()->raster_cache_size_for_testing());
+
+  // New content is rastered. The tiles of the first slide are released on
+  // activation and keep their rasters.
+  stats = ShowContent(CreateSlideRasterSource(layer_bounds, 1));
+  EXPECT_EQ(4u, stats.completed_count);
+  EXPECT_EQ(0u, stats.reused_count);
+  EXPECT_EQ(4u, host_impl()->tile_manager()->raster_cache_size_for_testing());
+
+  // A new recording of the first slide takes them back.
+  stats = ShowContent(CreateSlideRasterSource(layer_bounds, 0));
+  EXPECT_EQ(0u, stats.completed_count);
+  EXPECT_EQ(4u, stats.reused_count);
+  EXPECT_EQ(4u, host_impl()->tile_manager()->raster_cache_size_for_testing());
+
+  // Content that differs in one tile only reuses the rasters of the others.
+  stats = ShowContent(
+      CreateSlideRasterSource(layer_bounds, 1, gfx::Rect(100, 100)));
+  EXPECT_EQ(1u, stats.completed_count);
+  EXPECT_EQ(3u, stats.reused_count);
+}
+
+TEST_F(RasterCacheTileManagerTest, CacheIsEvictedUnderMemoryPressure) {
+  const gfx::Size layer_bounds(256, 256);
+  ShowContent(CreateSlideRasterSource(layer_bounds, 0));
+  ShowContent(CreateSlideRasterSource(layer_bounds, 1));
+  EXPECT_EQ(4u, host_impl()->tile_manager()->raster_cache_size_for_testing());
+
+  // Leave room for the tiles of the active tree only.
+  GlobalStateThatImpactsTilePriority state = host_impl()->global_tile_state();
+  size_t tile_bytes = viz::ResourceSizes::CheckedSizeInBytes<size_t>(
+      gfx::Size(128, 128), viz::RGBA_8888);
+  state.soft_memory_limit_in_bytes = 4 * tile_bytes;
+  state.hard_memory_limit_in_bytes = 4 * tile_bytes;
+  host_impl()->tile_manager()->PrepareTiles(state);
+  EXPECT_EQ(0u, host_impl()->tile_manager()->raster_cache_size_for_testing());
+  for (Tile* tile : active_layer()->HighResTiling()->AllTilesForTesting())
+    EXPECT_TRUE(tile->draw_info().IsReadyToDraw());
+}
+
 }  // namespace
 }  // namespace cc
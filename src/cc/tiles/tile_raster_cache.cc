@@ -0,0 +1,125 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/tiles/tile_raster_cache.h"
+
+#include <utility>
+
+#include "base/bit_cast.h"
+#include "base/check_op.h"
+#include "base/hash/hash.h"
+#include "cc/paint/display_item_list.h"
+
+namespace cc {
+
+TileRasterCache::Key::Key() = default;
+TileRasterCache::Key::Key(const Key& other) = default;
+TileRasterCache::Key::~Key() = default;
+TileRasterCache::Key& TileRasterCache::Key::operator=(const Key& other) =
+    default;
+
+bool TileRasterCache::Key::Matches(const Key& other) const {
+  return content_hash == other.content_hash &&
+         query_rect == other.query_rect && layer_size == other.layer_size &&
+         background_color == other.background_color &&
+         requires_clear == other.requires_clear &&
+         recording_scale_factor == other.recording_scale_factor &&
+         content_rect == other.content_rect &&
+         raster_transform == other.raster_transform &&
+         format == other.format && color_space == other.color_space &&
+         use_lcd_text == other.use_lcd_text &&
+         msaa_sample_count == other.msaa_sample_count;
+}
+
+size_t TileRasterCache::Key::Hash() const {
+  size_t rect_hash = base::HashInts64(
+      base::HashInts32(content_rect.x(), content_rect.y()),
+      base::HashInts32(content_rect.width(), content_rect.height()));
+  return base::HashInts64(
+      base::HashInts64(content_hash, rect_hash),
+      base::bit_cast<uint32_t>(raster_transform.scale()));
+}
+
+TileRasterCache::Entry::Entry(Key key,
+                              scoped_refptr<const DisplayItemList> recording,
+                              ResourcePool::InUsePoolResource resource)
+    : key(std::move(key)),
+      recording(std::move(recording)),
+      resource(std::move(resource)) {}
+TileRasterCache::Entry::Entry(Entry&& other) = default;
+TileRasterCache::Entry::~Entry() = default;
+TileRasterCache::Entry& TileRasterCache::Entry::operator=(Entry&& other) =
+    default;
+
+TileRasterCache::TileRasterCache(size_t max_entries)
+    : max_entries_(max_entries), entries_(EntryCache::NO_AUTO_EVICT) {
+  DCHECK_GT(max_entries_, 0u);
+}
+
+TileRasterCache::~TileRasterCache() {
+  // The resources have to go back to the pool they came from.
+  DCHECK(entries_.empty());
+}
+
+ResourcePool::InUsePoolResource TileRasterCache::Take(
+    const Key& key,
+    const DisplayItemList& recording) {
+  DCHECK_EQ(key.recording_id, recording.unique_id());
+  auto it = entries_.Peek(key.Hash());
+  if (it == entries_.end() || !it->second.key.Matches(key))
+    return ResourcePool::InUsePoolResource();
+  if (it->second.key.recording_id != key.recording_id &&
+      !it->second.recording->ContentInRectEquals(key.query_rect, recording)) {
+    return ResourcePool::InUsePoolResource();
+  }
+
+  ResourcePool::InUsePoolResource resource = ReleaseEntry(&it->second);
+  entries_.Erase(it);
+  return resource;
+}
+
+ResourcePool::InUsePoolResource TileRasterCache::Put(
+    Key key,
+    scoped_refptr<const DisplayItemList> recording,
+    ResourcePool::InUsePoolResource resource) {
+  DCHECK(resource);
+  DCHECK_EQ(key.recording_id, recording->unique_id());
+  size_t hash = key.Hash();
+  ResourcePool::InUsePoolResource evicted;
+  auto it = entries_.Peek(hash);
+  if (it != entries_.end()) {
+    evicted = ReleaseEntry(&it->second);
+    entries_.Erase(it);
+  } else if (entries_.size() >= max_entries_) {
+    evicted = TakeLeastRecentlyUsed();
+  }
+
+  if (recording_refs_[key.recording_id]++ == 0)
+    retained_recording_bytes_ += recording->BytesUsed();
+  entries_.Put(hash, Entry(std::move(key), std::move(recording),
+                           std::move(resource)));
+  return evicted;
+}
+
+ResourcePool::InUsePoolResource TileRasterCache::TakeLeastRecentlyUsed() {
+  DCHECK(!entries_.empty());
+  auto it = entries_.rbegin();
+  ResourcePool::InUsePoolResource resource = ReleaseEntry(&it->second);
+  entries_.Erase(it);
+  return resource;
+}
+
+ResourcePool::InUsePoolResource TileRasterCache::ReleaseEntry(Entry* entry) {
+  auto refs = recording_refs_.find(entry->key.recording_id);
+  DCHECK(refs != recording_refs_.end());
+  if (--refs->second == 0) {
+    recording_refs_.erase(refs);
+    DCHECK_GE(retained_recording_bytes_, entry->recording->BytesUsed());
+    retained_recording_bytes_ -= entry->recording->BytesUsed();
+  }
+  entry->recording = nullptr;
+  return std::move(entry->resource);
+}
+
+}  // namespace cc
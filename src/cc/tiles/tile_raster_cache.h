@@ -0,0 +1,137 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_TILES_TILE_RASTER_CACHE_H_
+#define CC_TILES_TILE_RASTER_CACHE_H_
+
+#include <stddef.h>
+
+#include "base/containers/flat_map.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/scoped_refptr.h"
+#include "cc/cc_export.h"
+#include "cc/resources/resource_pool.h"
+#include "components/viz/common/resources/resource_format.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "ui/gfx/color_space.h"
+#include "ui/gfx/geometry/axis_transform2d.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace cc {
+class DisplayItemList;
+
+// A bounded cache of tile rasters, addressed by the recorded content they were
+// rastered from. TileManager puts the resource of a released tile here, and a
+// new tile that would raster the same ops with the same settings takes it
+// instead of rastering again, e.g. when a carousel comes back to a slide that
+// it showed before.
+//
+// The cache holds the resources in use, so they count towards the memory of
+// the ResourcePool. It is up to the caller to release the resources that are
+// evicted and to empty the cache before it goes away.
+//
+// Every entry also keeps the recording it was rastered from, so that a hit
+// from another recording can be checked op by op. The caller has to account
+// for retained_recording_bytes() on top of the resources.
+class CC_EXPORT TileRasterCache {
+ public:
+  // Everything the pixels of a tile raster depend on. Only holds values, so
+  // tiles can keep one without keeping their recording alive.
+  struct CC_EXPORT Key {
+    Key();
+    Key(const Key& other);
+    ~Key();
+
+    Key& operator=(const Key& other);
+
+    // Returns true if everything but the recording matches |other|. Rasters of
+    // two matching keys of the same recording produce the same pixels.
+    // Content hashes can collide, so rasters of different recordings are only
+    // the same if their ops are.
+    bool Matches(const Key& other) const;
+    size_t Hash() const;
+
+    // DisplayItemList::unique_id() of the recording.
+    int recording_id = 0;
+    // The rect of the display item list that the raster plays back, in
+    // recording space, and the hash of its content.
+    gfx::Rect query_rect;
+    size_t content_hash = 0;
+
+    // The raster source clears the parts of the tile that the ops do not cover
+    // depending on these.
+    gfx::Size layer_size;
+    SkColor background_color = SK_ColorTRANSPARENT;
+    bool requires_clear = false;
+    float recording_scale_factor = 1.f;
+
+    gfx::Rect content_rect;
+    gfx::AxisTransform2d raster_transform;
+    viz::ResourceFormat format = viz::RGBA_8888;
+    gfx::ColorSpace color_space;
+    bool use_lcd_text = false;
+    int msaa_sample_count = 0;
+  };
+
+  explicit TileRasterCache(size_t max_entries);
+  TileRasterCache(const TileRasterCache&) = delete;
+  ~TileRasterCache();
+
+  TileRasterCache& operator=(const TileRasterCache&) = delete;
+
+  // Removes and returns the resource cached for a key that matches |key| of
+  // |recording|, or returns an empty resource if there is none.
+  ResourcePool::InUsePoolResource Take(const Key& key,
+                                       const DisplayItemList& recording);
+
+  // Caches |resource|, rastered for |key| from |recording|. Returns the
+  // resource evicted to make room for it, if any.
+  ResourcePool::InUsePoolResource Put(
+      Key key,
+      scoped_refptr<const DisplayItemList> recording,
+      ResourcePool::InUsePoolResource resource);
+
+  // Removes and returns the least recently cached resource. Must not be called
+  // when the cache is empty.
+  ResourcePool::InUsePoolResource TakeLeastRecentlyUsed();
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // The memory used by the recordings that the entries keep, counting each
+  // recording once.
+  size_t retained_recording_bytes() const { return retained_recording_bytes_; }
+
+ private:
+  struct Entry {
+    Entry(Key key,
+          scoped_refptr<const DisplayItemList> recording,
+          ResourcePool::InUsePoolResource resource);
+    Entry(Entry&& other);
+    ~Entry();
+
+    Entry& operator=(Entry&& other);
+
+    Key key;
+    scoped_refptr<const DisplayItemList> recording;
+    ResourcePool::InUsePoolResource resource;
+  };
+  // Keyed by Key::Hash(). Entries whose hashes collide replace each other.
+  using EntryCache = base::HashingMRUCache<size_t, Entry>;
+
+  // Takes the resource of |entry| and drops its recording, before the entry
+  // is erased.
+  ResourcePool::InUsePoolResource ReleaseEntry(Entry* entry);
+
+  const size_t max_entries_;
+  EntryCache entries_;
+  // The number of entries that keep each recording, by recording id.
+  base::flat_map<int, size_t> recording_refs_;
+  size_t retained_recording_bytes_ = 0;
+};
+
+}  // namespace cc
+
+#endif  // CC_TILES_TILE_RASTER_CACHE_H_
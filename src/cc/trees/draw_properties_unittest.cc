@@ -7505,6 +7505,76 @@ TEST_F(DrawPropertiesTest, LargeTransformTest) {
   EXPECT_TRUE(base::Contains(GetRenderSurfaceList(), GetRenderSurface(root)));
 }
 
+class DrawPropertiesTestParallelWorkers : public DrawPropertiesTestBase,
+                                          public testing::Test {
+ public:
+  DrawPropertiesTestParallelWorkers()
+      : DrawPropertiesTestBase(GetTestLayerTreeSettings()) {}
+
+ private:
+  static LayerTreeSettings GetTestLayerTreeSettings() {
+    LayerTreeSettings s;
+    s.max_draw_properties_workers = 4;
+    return s;
+  }
+};
+
+TEST_F(DrawPropertiesTestParallelWorkers, ManyLayers) {
+  // Enough layers for the parallel passes to split them into several chunks,
+  // half of them drawing into a render surface other than the root one.
+  const int kNumLayers = 300;
+  auto root = Layer::Create();
+  auto surface = Layer::Create();
+  root->SetBounds(gfx::Size(1000, 1000));
+  surface->SetBounds(gfx::Size(500, 500));
+  gfx::Transform translate;
+  translate.Translate(20.f, 20.f);
+  surface->SetTransform(translate);
+  surface->SetOpacity(0.5f);
+  surface->SetForceRenderSurfaceForTesting(true);
+  root->AddChild(surface);
+  host()->SetRootLayer(root);
+
+  std::vector<scoped_refptr<Layer>> root_children;
+  std::vector<scoped_refptr<Layer>> surface_children;
+  for (int i = 0; i < kNumLayers; ++i) {
+    for (auto* parent : {root.get(), surface.get()}) {
+      auto layer = Layer::Create();
+      layer->SetIsDrawable(true);
+      layer->SetBounds(gfx::Size(10, 10));
+      layer->SetPosition(gfx::PointF((i % 30) * 10, (i / 30) * 10));
+      parent->AddChild(layer);
+      if (parent == root.get())
+        root_children.push_back(layer);
+      else
+        surface_children.push_back(layer);
+    }
+  }
+
+  CommitAndActivate();
+
+  for (int i = 0; i < kNumLayers; ++i) {
+    gfx::Transform position;
+    position.Translate((i % 30) * 10, (i / 30) * 10);
+    gfx::Rect content_rect((i % 30) * 10, (i / 30) * 10, 10, 10);
+
+    LayerImpl* root_child = ImplOf(root_children[i]);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(position, root_child->DrawTransform());
+    EXPECT_TRANSFORMATION_MATRIX_EQ(position,
+                                    root_child->ScreenSpaceTransform());
+    EXPECT_EQ(1.f, root_child->draw_opacity());
+    EXPECT_EQ(content_rect, root_child->visible_drawable_content_rect());
+
+    LayerImpl* surface_child = ImplOf(surface_children[i]);
+    EXPECT_TRANSFORMATION_MATRIX_EQ(position, surface_child->DrawTransform());
+    EXPECT_TRANSFORMATION_MATRIX_EQ(translate * position,
+                                    surface_child->ScreenSpaceTransform());
+    EXPECT_EQ(1.f, surface_child->draw_opacity());
+    EXPECT_EQ(content_rect, surface_child->visible_drawable_content_rect());
+  }
+  EXPECT_EQ(0.5f, GetRenderSurfaceImpl(surface)->draw_opacity());
+}
+
 #if DCHECK_IS_ON()
 class DrawPropertiesTestDoubleBlurCheck : public DrawPropertiesTestBase,
                                           public testing::Test {
@@ -9,10 +9,13 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/callback.h"
 #include "base/containers/adapters.h"
 #include "base/containers/stack.h"
 #include "base/logging.h"
 #include "cc/base/math_util.h"
+#include "cc/base/parallel_for.h"
 #include "cc/layers/draw_properties.h"
 #include "cc/layers/layer.h"
 #include "cc/layers/layer_impl.h"
@@ -812,19 +815,108 @@ void UpdateRenderTarget(EffectTree* effect_tree) {
   }
 }
 
-void ComputeClips(PropertyTrees* property_trees) {
+// Returns, for every node of |tree|, whether the pending update has to visit
+// it. That is every node for a full update, and otherwise the roots of the
+// dirty subtrees, the nodes for which |depends_on_update| returns true and all
+// of their descendants. Parents precede their children in the node list, so
+// one pass is enough to reach the descendants.
+template <typename TreeType, typename Predicate>
+std::vector<bool> NodesToUpdate(const TreeType& tree,
+                                int first_node_id,
+                                Predicate depends_on_update) {
+  const int size = static_cast<int>(tree.size());
+  if (tree.needs_full_update())
+    return std::vector<bool>(size, true);
+
+  std::vector<bool> nodes_to_update(size, false);
+  for (int id : tree.dirty_subtree_roots())
+    nodes_to_update[id] = true;
+  for (int i = first_node_id; i < size; ++i) {
+    if (nodes_to_update[i])
+      continue;
+    const auto* node = tree.Node(i);
+    DCHECK_LT(node->parent_id, i);
+    nodes_to_update[i] =
+        nodes_to_update[node->parent_id] || depends_on_update(*node);
+  }
+  return nodes_to_update;
+}
+
+// Updates the nodes of |transform_tree| that need it. Returns which nodes were
+// updated, or an empty vector if the tree did not need an update.
+std::vector<bool> UpdateTransformNodes(TransformTree* transform_tree) {
+  if (!transform_tree->needs_update()) {
+#if DCHECK_IS_ON()
+    // If the transform tree does not need an update, no TransformNode should
+    // need a local transform update.
+    for (int i = TransformTree::kContentsRootNodeId;
+         i < static_cast<int>(transform_tree->size()); ++i) {
+      DCHECK(!transform_tree->Node(i)->needs_local_transform_update);
+    }
+#endif
+    return std::vector<bool>();
+  }
+
+  // Sticky position offsets depend on the scroll offsets of nodes outside of
+  // their ancestor chain, so sticky nodes are always updated.
+  std::vector<bool> nodes_to_update = NodesToUpdate(
+      *transform_tree, TransformTree::kContentsRootNodeId,
+      [](const TransformNode& node) {
+        return node.needs_local_transform_update ||
+               node.sticky_position_constraint_id >= 0;
+      });
+  for (int i = TransformTree::kContentsRootNodeId;
+       i < static_cast<int>(transform_tree->size()); ++i) {
+    if (nodes_to_update[i])
+      transform_tree->UpdateTransforms(i);
+  }
+  transform_tree->set_needs_update(false);
+  return nodes_to_update;
+}
+
+// Updates the nodes of |effect_tree| that need it, including the ones whose
+// transform node is in |updated_transforms|.
+void UpdateEffectNodes(EffectTree* effect_tree,
+                       const std::vector<bool>& updated_transforms) {
+  if (!effect_tree->needs_update() && updated_transforms.empty())
+    return;
+  std::vector<bool> nodes_to_update = NodesToUpdate(
+      *effect_tree, EffectTree::kContentsRootNodeId,
+      [&updated_transforms](const EffectNode& node) {
+        return !updated_transforms.empty() &&
+               updated_transforms[node.transform_id];
+      });
+  for (int i = EffectTree::kContentsRootNodeId;
+       i < static_cast<int>(effect_tree->size()); ++i) {
+    if (nodes_to_update[i])
+      effect_tree->UpdateEffects(i);
+  }
+  effect_tree->set_needs_update(false);
+}
+
+void ComputeClips(PropertyTrees* property_trees,
+                  const std::vector<bool>& updated_transforms) {
   DCHECK(!property_trees->transform_tree.needs_update());
   ClipTree* clip_tree = &property_trees->clip_tree;
-  if (!clip_tree->needs_update())
+  if (!clip_tree->needs_update() && updated_transforms.empty())
     return;
   const int target_effect_id = EffectTree::kContentsRootNodeId;
   const int target_transform_id = TransformTree::kRootNodeId;
   const bool include_expanding_clips = true;
+  std::vector<bool> nodes_to_update = NodesToUpdate(
+      *clip_tree, ClipTree::kViewportNodeId,
+      [&updated_transforms](const ClipNode& node) {
+        return !updated_transforms.empty() &&
+               updated_transforms[node.transform_id];
+      });
   for (int i = ClipTree::kViewportNodeId;
        i < static_cast<int>(clip_tree->size()); ++i) {
     ClipNode* clip_node = clip_tree->Node(i);
-    // Clear the clip rect cache
+    // Clear the clip rect cache. The cached rects are in the space of other
+    // nodes, so they are cleared even for nodes that are not updated.
     clip_node->cached_clip_rects->clear();
+    if (!nodes_to_update[i])
+      continue;
     if (clip_node->id == ClipTree::kViewportNodeId) {
       clip_node->cached_accumulated_rect_in_screen_space = clip_node->clip;
       continue;
@@ -1134,35 +1226,103 @@ void UpdateElasticOverscroll(
   overscroll_elasticity_transform_node->scroll_offset =
       gfx::ScrollOffset(elastic_overscroll);
   overscroll_elasticity_transform_node->needs_local_transform_update = true;
-  property_trees->transform_tree.set_needs_update(true);
+  property_trees->transform_tree.SetSubtreeNeedsUpdate(
+      overscroll_elasticity_transform_node->id);
 }
 
-void ComputeDrawPropertiesOfVisibleLayers(const LayerImplList* layer_list,
-                                          PropertyTrees* property_trees) {
-  // Compute transforms
-  for (LayerImpl* layer : *layer_list) {
-    const TransformNode* transform_node =
-        property_trees->transform_tree.Node(layer->transform_tree_index());
+// Layers are handed out to the workers of a parallel pass in chunks of this
+// size, so that claiming a chunk costs little compared to the work in it.
+constexpr size_t kLayersPerParallelChunk = 128;
+
+using PerLayerCallback = base::RepeatingCallback<void(LayerImpl*)>;
+
+void RunLayerChunk(const LayerImplList* layer_list,
+                   const PerLayerCallback* per_layer,
+                   size_t chunk) {
+  size_t begin = chunk * kLayersPerParallelChunk;
+  size_t end = std::min(begin + kLayersPerParallelChunk, layer_list->size());
+  for (size_t i = begin; i < end; ++i)
+    per_layer->Run((*layer_list)[i]);
+}
 
-    layer->draw_properties().screen_space_transform =
-        ScreenSpaceTransformInternal(layer, property_trees->transform_tree);
+// Runs |per_layer| on every layer of |layer_list|, splitting the list into
+// chunks that are processed by up to |max_workers| threads including the
+// calling one. |per_layer| may only write to the layer it is given, and may
+// only read the property trees without going through their caches, so the
+// results do not depend on how the layers were distributed.
+void RunParallelLayerPass(const LayerImplList& layer_list,
+                          int max_workers,
+                          const PerLayerCallback& per_layer) {
+  size_t num_chunks = (layer_list.size() + kLayersPerParallelChunk - 1) /
+                      kLayersPerParallelChunk;
+  ParallelFor(num_chunks, max_workers,
+              base::BindRepeating(&RunLayerChunk, base::Unretained(&layer_list),
+                                  base::Unretained(&per_layer)));
+}
+
+// The parts of the draw properties of |layer| that only depend on the
+// transform and effect trees. The draw transform of layers drawing into a
+// render surface other than the root one goes through the draw transform
+// cache, so it is computed later on the calling thread.
+void ComputeLayerTransformsAndOpacity(const PropertyTrees* property_trees,
+                                      LayerImpl* layer) {
+  const TransformNode* transform_node =
+      property_trees->transform_tree.Node(layer->transform_tree_index());
+
+  layer->draw_properties().screen_space_transform =
+      ScreenSpaceTransformInternal(layer, property_trees->transform_tree);
+  if (layer->render_target_effect_tree_index() ==
+      EffectTree::kContentsRootNodeId) {
     layer->draw_properties().target_space_transform = DrawTransform(
         layer, property_trees->transform_tree, property_trees->effect_tree);
-    layer->draw_properties().screen_space_transform_is_animating =
-        transform_node->to_screen_is_potentially_animated;
+  }
+  layer->draw_properties().screen_space_transform_is_animating =
+      transform_node->to_screen_is_potentially_animated;
+  layer->draw_properties().opacity =
+      LayerDrawOpacity(layer, property_trees->effect_tree);
+}
+
+void ComputeLayerDrawableContentRect(const PropertyTrees* property_trees,
+                                     LayerImpl* layer) {
+  bool only_draws_visible_content =
+      property_trees->effect_tree.Node(layer->effect_tree_index())
+          ->only_draws_visible_content;
+  gfx::Rect drawable_bounds = gfx::Rect(layer->visible_layer_rect());
+  if (!only_draws_visible_content) {
+    drawable_bounds = gfx::Rect(layer->bounds());
+  }
+  gfx::Rect visible_bounds_in_target_space =
+      MathUtil::MapEnclosingClippedRect(
+          layer->draw_properties().target_space_transform, drawable_bounds);
+  layer->draw_properties().visible_drawable_content_rect =
+      LayerDrawableContentRect(layer, visible_bounds_in_target_space,
+                               layer->draw_properties().clip_rect);
+}
+
+void ComputeDrawPropertiesOfVisibleLayers(const LayerImplList* layer_list,
+                                          PropertyTrees* property_trees,
+                                          int max_workers) {
+  // Compute transforms and opacities. Layers are independent here, so this
+  // can be spread over several threads.
+  RunParallelLayerPass(*layer_list, max_workers,
+                       base::BindRepeating(&ComputeLayerTransformsAndOpacity,
+                                           base::Unretained(property_trees)));
+
+  // Compute the draw transforms that go through the cache, and determine if
+  // render surfaces have contributing layers that escape clip.
+  for (LayerImpl* layer : *layer_list) {
+    if (layer->render_target_effect_tree_index() !=
+        EffectTree::kContentsRootNodeId) {
+      layer->draw_properties().target_space_transform = DrawTransform(
+          layer, property_trees->transform_tree, property_trees->effect_tree);
+    }
     auto mask_filter_info_pair =
         GetMaskFilterInfoPair(property_trees, layer->effect_tree_index(),
                               /*from_render_surface=*/false);
     layer->draw_properties().mask_filter_info = mask_filter_info_pair.first;
     layer->draw_properties().is_fast_rounded_corner =
         mask_filter_info_pair.second;
-  }
 
-  // Compute effects and determine if render surfaces have contributing layers
-  // that escape clip.
-  for (LayerImpl* layer : *layer_list) {
-    layer->draw_properties().opacity =
-        LayerDrawOpacity(layer, property_trees->effect_tree);
     RenderSurfaceImpl* render_target = layer->render_target();
     int lca_clip_id = LowestCommonAncestor(layer->clip_tree_index(),
                                            render_target->ClipTreeIndex(),
@@ -1174,7 +1334,8 @@ void ComputeDrawPropertiesOfVisibleLayers(const LayerImplList* layer_list,
     }
   }
 
-  // Compute clips and visible rects
+  // Compute clips and visible rects. These fill the clip and draw transform
+  // caches, so they stay on the calling thread.
   for (LayerImpl* layer : *layer_list) {
     ConditionalClip clip = LayerClipRect(property_trees, layer);
     // is_clipped should be set before visible rect computation as it is used
@@ -1186,21 +1347,9 @@ void ComputeDrawPropertiesOfVisibleLayers(const LayerImplList* layer_list,
   }
 
   // Compute drawable content rects
-  for (LayerImpl* layer : *layer_list) {
-    bool only_draws_visible_content =
-        property_trees->effect_tree.Node(layer->effect_tree_index())
-            ->only_draws_visible_content;
-    gfx::Rect drawable_bounds = gfx::Rect(layer->visible_layer_rect());
-    if (!only_draws_visible_content) {
-      drawable_bounds = gfx::Rect(layer->bounds());
-    }
-    gfx::Rect visible_bounds_in_target_space =
-        MathUtil::MapEnclosingClippedRect(
-            layer->draw_properties().target_space_transform, drawable_bounds);
-    layer->draw_properties().visible_drawable_content_rect =
-        LayerDrawableContentRect(layer, visible_bounds_in_target_space,
-                                 layer->draw_properties().clip_rect);
-  }
+  RunParallelLayerPass(*layer_list, max_workers,
+                       base::BindRepeating(&ComputeLayerDrawableContentRect,
+                                           base::Unretained(property_trees)));
 }
 
 #if DCHECK_IS_ON()
@@ -1330,60 +1479,45 @@ void FindLayersThatNeedUpdates(LayerTreeImpl* layer_tree_impl,
 }
 
 void ComputeTransforms(TransformTree* transform_tree) {
-  if (!transform_tree->needs_update()) {
-#if DCHECK_IS_ON()
-    // If the transform tree does not need an update, no TransformNode should
-    // need a local transform update.
-    for (int i = TransformTree::kContentsRootNodeId;
-         i < static_cast<int>(transform_tree->size()); ++i) {
-      DCHECK(!transform_tree->Node(i)->needs_local_transform_update);
-    }
-#endif
-    return;
-  }
-  for (int i = TransformTree::kContentsRootNodeId;
-       i < static_cast<int>(transform_tree->size()); ++i)
-    transform_tree->UpdateTransforms(i);
-  transform_tree->set_needs_update(false);
+  UpdateTransformNodes(transform_tree);
 }
 
 void ComputeEffects(EffectTree* effect_tree) {
-  if (!effect_tree->needs_update())
-    return;
-  for (int i = EffectTree::kContentsRootNodeId;
-       i < static_cast<int>(effect_tree->size()); ++i)
-    effect_tree->UpdateEffects(i);
-  effect_tree->set_needs_update(false);
+  UpdateEffectNodes(effect_tree, std::vector<bool>());
 }
 
 void UpdatePropertyTrees(LayerTreeHost* layer_tree_host) {
   DCHECK(layer_tree_host);
   auto* property_trees = layer_tree_host->property_trees();
   DCHECK(property_trees);
-  if (property_trees->transform_tree.needs_update()) {
+  // When only some transform subtrees changed, only the clip and effect nodes
+  // that refer to them are updated.
+  if (property_trees->transform_tree.needs_full_update()) {
     property_trees->clip_tree.set_needs_update(true);
     property_trees->effect_tree.set_needs_update(true);
   }
-  ComputeTransforms(&property_trees->transform_tree);
-  ComputeEffects(&property_trees->effect_tree);
+  std::vector<bool> updated_transforms =
+      UpdateTransformNodes(&property_trees->transform_tree);
+  UpdateEffectNodes(&property_trees->effect_tree, updated_transforms);
   // Computation of clips uses ToScreen which is updated while computing
   // transforms. So, ComputeTransforms should be before ComputeClips.
-  ComputeClips(property_trees);
+  ComputeClips(property_trees, updated_transforms);
 }
 
 void UpdatePropertyTreesAndRenderSurfaces(LayerImpl* root_layer,
                                           PropertyTrees* property_trees) {
-  if (property_trees->transform_tree.needs_update()) {
+  if (property_trees->transform_tree.needs_full_update()) {
     property_trees->clip_tree.set_needs_update(true);
     property_trees->effect_tree.set_needs_update(true);
   }
   UpdateRenderTarget(&property_trees->effect_tree);
 
-  ComputeTransforms(&property_trees->transform_tree);
-  ComputeEffects(&property_trees->effect_tree);
+  std::vector<bool> updated_transforms =
+      UpdateTransformNodes(&property_trees->transform_tree);
+  UpdateEffectNodes(&property_trees->effect_tree, updated_transforms);
   // Computation of clips uses ToScreen which is updated while computing
   // transforms. So, ComputeTransforms should be before ComputeClips.
-  ComputeClips(property_trees);
+  ComputeClips(property_trees, updated_transforms);
 }
 
 gfx::Transform DrawTransform(const LayerImpl* layer,
@@ -1467,7 +1601,9 @@ void CalculateDrawProperties(
     TRACE_EVENT1("cc",
                  "draw_property_utils::ComputeDrawPropertiesOfVisibleLayers",
                  "visible_layers", visible_layer_list.size());
-    ComputeDrawPropertiesOfVisibleLayers(&visible_layer_list, property_trees);
+    ComputeDrawPropertiesOfVisibleLayers(
+        &visible_layer_list, property_trees,
+        layer_tree_impl->settings().max_draw_properties_workers);
   }
 
   {
@@ -19,9 +19,11 @@
 #include "cc/layers/layer.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/fake_layer_tree_host_client.h"
+#include "cc/test/fake_picture_layer.h"
 #include "cc/test/layer_tree_json_parser.h"
 #include "cc/test/layer_tree_test.h"
 #include "cc/trees/layer_tree_impl.h"
+#include "cc/trees/property_tree.h"
 #include "cc/trees/transform_node.h"
 #include "components/viz/test/paths.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -121,5 +123,89 @@ TEST_F(CalcDrawPropsTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+// A page of many independently transformed layers of which one is animating.
+// Every lap changes the transform of the animated layer the way a compositor
+// animation does and recomputes draw properties, either by updating only the
+// animated subtree or, as a baseline, the whole property tree.
+class AnimatedLayerCalcDrawPropsTest : public DrawPropertyUtilsPerfTest {
+ public:
+  void RunCalcDrawProps(bool update_subtree) {
+    update_subtree_ = update_subtree;
+    RunTest(CompositorMode::SINGLE_THREADED);
+  }
+
+  void SetupTree() override {
+    static const int kNumContainers = 100;
+    static const int kLayersPerContainer = 50;
+    gfx::Size viewport = gfx::Size(720, 1038);
+    layer_tree_host()->SetViewportRectAndScale(gfx::Rect(viewport), 1.f,
+                                               viz::LocalSurfaceId());
+    scoped_refptr<Layer> root = Layer::Create();
+    root->SetBounds(viewport);
+    gfx::Transform rotation;
+    rotation.Rotate(1);
+    for (int i = 0; i < kNumContainers; ++i) {
+      scoped_refptr<Layer> container = Layer::Create();
+      container->SetBounds(gfx::Size(64, 64));
+      container->SetTransform(rotation);
+      for (int j = 0; j < kLayersPerContainer; ++j) {
+        scoped_refptr<FakePictureLayer> layer =
+            FakePictureLayer::Create(&content_layer_client_);
+        layer->SetBounds(gfx::Size(8, 8));
+        layer->SetIsDrawable(true);
+        layer->SetTransform(rotation);
+        container->AddChild(layer);
+      }
+      root->AddChild(container);
+      if (i == kNumContainers / 2)
+        animated_layer_id_ = container->id();
+    }
+    layer_tree_host()->SetRootLayer(root);
+    content_layer_client_.set_bounds(viewport);
+  }
+
+  void BeginTest() override { PostSetNeedsCommitToMainThread(); }
+
+  void DrawLayersOnThread(LayerTreeHostImpl* host_impl) override {
+    LayerTreeImpl* tree = host_impl->active_tree();
+    TransformTree& transform_tree = tree->property_trees()->transform_tree;
+    int node_id = tree->LayerById(animated_layer_id_)->transform_tree_index();
+    timer_.Reset();
+
+    int frame = 0;
+    do {
+      TransformNode* node = transform_tree.Node(node_id);
+      node->local.MakeIdentity();
+      node->local.Rotate(++frame % 360);
+      node->needs_local_transform_update = true;
+      node->transform_changed = true;
+      if (update_subtree_)
+        transform_tree.SetSubtreeNeedsUpdate(node_id);
+      else
+        transform_tree.set_needs_update(true);
+
+      RenderSurfaceList render_surface_list;
+      draw_property_utils::CalculateDrawProperties(tree, &render_surface_list);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EndTest();
+  }
+
+ private:
+  int animated_layer_id_ = Layer::INVALID_ID;
+  bool update_subtree_ = false;
+};
+
+TEST_F(AnimatedLayerCalcDrawPropsTest, FullUpdate) {
+  SetUpReporter("animated_layer_5k_full_update");
+  RunCalcDrawProps(false);
+}
+
+TEST_F(AnimatedLayerCalcDrawPropsTest, SubtreeUpdate) {
+  SetUpReporter("animated_layer_5k_subtree_update");
+  RunCalcDrawProps(true);
+}
+
 }  // namespace
 }  // namespace cc
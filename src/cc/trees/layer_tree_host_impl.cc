@@ -3577,7 +3577,8 @@ LayerTreeHostImpl::CreateRasterBufferProvider() {
   viz::ContextProvider* compositor_context_provider =
       layer_tree_frame_sink_->context_provider();
   if (!compositor_context_provider)
-    return std::make_unique<BitmapRasterBufferProvider>(layer_tree_frame_sink_);
+    return std::make_unique<BitmapRasterBufferProvider>(
+        layer_tree_frame_sink_, settings_.max_software_raster_playback_bands);
 
   const gpu::Capabilities& caps =
       compositor_context_provider->ContextCapabilities();
@@ -7,12 +7,14 @@
 #include <stdint.h>
 
 #include <sstream>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/path_service.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "base/timer/lap_timer.h"
 #include "cc/layers/nine_patch_layer.h"
@@ -43,6 +45,7 @@ class LayerTreeHostPerfTest : public LayerTreeTest {
                     base::TimeDelta::FromMilliseconds(kTimeLimitMillis),
                     kTimeCheckInterval),
         commit_timer_(0, base::TimeDelta(), 1),
+        activate_timer_(0, base::TimeDelta(), 1),
         full_damage_each_frame_(false),
         begin_frame_driven_drawing_(false),
         measure_commit_cost_(false) {
@@ -86,6 +89,16 @@ class LayerTreeHostPerfTest : public LayerTreeTest {
     }
   }
 
+  void WillActivateTreeOnThread(LayerTreeHostImpl* host_impl) override {
+    if (measure_commit_cost_)
+      activate_timer_.Start();
+  }
+
+  void DidActivateTreeOnThread(LayerTreeHostImpl* host_impl) override {
+    if (measure_commit_cost_ && draw_timer_.IsWarmedUp())
+      activate_timer_.NextLap();
+  }
+
   void DrawLayersOnThread(LayerTreeHostImpl* host_impl) override {
     if (TestEnded() || CleanUpStarted())
       return;
@@ -105,6 +118,7 @@ class LayerTreeHostPerfTest : public LayerTreeTest {
         "layer_tree_host", story_name);
     reporter_->RegisterImportantMetric("_frame_time", "us");
     reporter_->RegisterImportantMetric("_commit_time", "us");
+    reporter_->RegisterImportantMetric("_activate_time", "us");
   }
 
   virtual void CleanUpAndEndTest() { EndTest(); }
@@ -120,12 +134,15 @@ class LayerTreeHostPerfTest : public LayerTreeTest {
     if (measure_commit_cost_) {
       reporter_->AddResult("_commit_time",
                            commit_timer_.TimePerLap().InMicrosecondsF());
+      reporter_->AddResult("_activate_time",
+                           activate_timer_.TimePerLap().InMicrosecondsF());
     }
   }
 
  protected:
   base::LapTimer draw_timer_;
   base::LapTimer commit_timer_;
+  base::LapTimer activate_timer_;
 
   std::unique_ptr<perf_test::PerfResultReporter> reporter_;
   FakeContentLayerClient fake_content_layer_client_;
@@ -405,5 +422,77 @@ TEST_F(LayerTreeHostPerfTestJsonReader, MAYBE_HeavyPageThreaded) {
   RunTest(CompositorMode::THREADED);
 }
 
+// A page of many small layers, all of which change a property every commit so
+// that every layer pushes its properties on commit and activation. The
+// parameter is the number of layers.
+class LayerTreeHostPerfTestManyLayers
+    : public LayerTreeHostPerfTest,
+      public testing::WithParamInterface<int> {
+ public:
+  void InitializeSettings(LayerTreeSettings* settings) override {
+    settings->max_draw_properties_workers = draw_properties_workers_;
+  }
+
+  void BuildTree() override {
+    static const int kLayersPerContainer = 50;
+    gfx::Size viewport = gfx::Size(720, 1038);
+    layer_tree_host()->SetViewportRectAndScale(gfx::Rect(viewport), 1.f,
+                                               viz::LocalSurfaceId());
+    scoped_refptr<Layer> root = Layer::Create();
+    root->SetBounds(viewport);
+    gfx::Transform rotation;
+    rotation.Rotate(1);
+    scoped_refptr<Layer> container;
+    for (int i = 0; i < GetParam(); ++i) {
+      if (i % kLayersPerContainer == 0) {
+        container = Layer::Create();
+        container->SetBounds(gfx::Size(100, 100));
+        container->SetTransform(rotation);
+        root->AddChild(container);
+      }
+      scoped_refptr<SolidColorLayer> layer = SolidColorLayer::Create();
+      layer->SetBounds(gfx::Size(8, 8));
+      layer->SetIsDrawable(true);
+      layer->SetBackgroundColor(SK_ColorRED);
+      container->AddChild(layer);
+      layers_.push_back(layer);
+    }
+    layer_tree_host()->SetRootLayer(root);
+  }
+
+  void DidCommitAndDrawFrame() override {
+    if (TestEnded())
+      return;
+    color_ = color_ == SK_ColorRED ? SK_ColorBLUE : SK_ColorRED;
+    for (auto& layer : layers_)
+      layer->SetBackgroundColor(color_);
+  }
+
+  void RunManyLayersTest(int draw_properties_workers) {
+    draw_properties_workers_ = draw_properties_workers;
+    measure_commit_cost_ = true;
+    SetUpReporter(base::StringPrintf("%d_layers_%d_draw_properties_workers",
+                                     GetParam(), draw_properties_workers));
+    RunTest(CompositorMode::THREADED);
+  }
+
+ private:
+  int draw_properties_workers_ = 1;
+  SkColor color_ = SK_ColorRED;
+  std::vector<scoped_refptr<Layer>> layers_;
+};
+
+TEST_P(LayerTreeHostPerfTestManyLayers, OneDrawPropertiesWorker) {
+  RunManyLayersTest(1);
+}
+
+TEST_P(LayerTreeHostPerfTestManyLayers, FourDrawPropertiesWorkers) {
+  RunManyLayersTest(4);
+}
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         LayerTreeHostPerfTestManyLayers,
+                         testing::Values(1000, 5000, 10000, 20000));
+
 }  // namespace
 }  // namespace cc
@@ -240,7 +240,7 @@ void LayerTreeImpl::DidUpdateScrollOffset(ElementId id) {
         scroll_tree.current_scroll_offset(id)) {
       transform_node->scroll_offset = scroll_tree.current_scroll_offset(id);
       transform_node->needs_local_transform_update = true;
-      transform_tree.set_needs_update(true);
+      transform_tree.SetSubtreeNeedsUpdate(transform_node->id);
     }
     transform_node->transform_changed = true;
     property_trees()->changed = true;
@@ -899,7 +899,7 @@ void LayerTreeImpl::UpdatePropertyTreeAnimationFromMainThread() {
       continue;
     }
     node->opacity = element_id_to_opacity->second;
-    property_trees_.effect_tree.set_needs_update(true);
+    property_trees_.effect_tree.SetSubtreeNeedsUpdate(node->id);
     ++element_id_to_opacity;
   }
 
@@ -913,7 +913,7 @@ void LayerTreeImpl::UpdatePropertyTreeAnimationFromMainThread() {
       continue;
     }
     node->filters = element_id_to_filter->second;
-    property_trees_.effect_tree.set_needs_update(true);
+    property_trees_.effect_tree.SetSubtreeNeedsUpdate(node->id);
     ++element_id_to_filter;
   }
 
@@ -930,7 +930,7 @@ void LayerTreeImpl::UpdatePropertyTreeAnimationFromMainThread() {
       continue;
     }
     node->backdrop_filters = element_id_to_backdrop_filter->second;
-    property_trees_.effect_tree.set_needs_update(true);
+    property_trees_.effect_tree.SetSubtreeNeedsUpdate(node->id);
     ++element_id_to_backdrop_filter;
   }
 
@@ -946,7 +946,7 @@ void LayerTreeImpl::UpdatePropertyTreeAnimationFromMainThread() {
     }
     node->local = element_id_to_transform->second;
     node->needs_local_transform_update = true;
-    property_trees_.transform_tree.set_needs_update(true);
+    property_trees_.transform_tree.SetSubtreeNeedsUpdate(node->id);
     ++element_id_to_transform;
   }
 
@@ -86,6 +86,14 @@ class CC_EXPORT LayerTreeSettings {
   size_t max_memory_for_prepaint_percentage = 100;
   bool use_zero_copy = false;
   bool use_partial_raster = false;
+  // Maximum number of bands a software raster tile is split into for
+  // concurrent playback. 1 disables band-parallel playback. Defaults to the
+  // value of the ParallelSoftwareRaster feature.
+  int max_software_raster_playback_bands;
+  // Maximum number of threads computing the draw properties of visible layers
+  // on large trees, including the compositor thread. 1 disables the parallel
+  // passes. Defaults to the value of the ParallelDrawProperties feature.
+  int max_draw_properties_workers;
   bool enable_elastic_overscroll = false;
   size_t scheduled_raster_task_limit = 32;
   bool use_occlusion_for_tile_prioritization = false;
@@ -111,6 +119,11 @@ class CC_EXPORT LayerTreeSettings {
   // deferred path.
   size_t min_image_bytes_to_checker = 1 * 1024 * 1024;  // 1MB.
 
+  // The number of rasters of released tiles kept to be reused by new tiles
+  // with the same recorded content. 0 disables the cache. Defaults to the
+  // value of the TileRasterCache feature.
+  size_t max_raster_cache_tiles;
+
   // Disables checkering of images when not using gpu rasterization.
   bool only_checker_images_with_gpu_raster = false;
 
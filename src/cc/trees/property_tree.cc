@@ -71,9 +71,26 @@ int PropertyTree<T>::Insert(const T& tree_node, int parent_id) {
   return node.id;
 }
 
+template <typename T>
+void PropertyTree<T>::SetSubtreeNeedsUpdate(int id) {
+  DCHECK_GE(id, kRootNodeId);
+  DCHECK_LT(id, static_cast<int>(nodes_.size()));
+  if (needs_full_update())
+    return;
+  if (!needs_update_)
+    set_needs_update(true);
+  // Past this many roots a full update is as cheap as tracking them.
+  if (dirty_subtree_roots_.size() >= nodes_.size() / 2) {
+    dirty_subtree_roots_.clear();
+    return;
+  }
+  dirty_subtree_roots_.push_back(id);
+}
+
 template <typename T>
 void PropertyTree<T>::clear() {
   needs_update_ = false;
+  dirty_subtree_roots_.clear();
   nodes_.clear();
   nodes_.push_back(T());
   back()->id = kRootNodeId;
@@ -88,7 +105,8 @@ void PropertyTree<T>::clear() {
 #if DCHECK_IS_ON()
 template <typename T>
 bool PropertyTree<T>::operator==(const PropertyTree<T>& other) const {
-  return nodes_ == other.nodes() && needs_update_ == other.needs_update();
+  return nodes_ == other.nodes() && needs_update_ == other.needs_update() &&
+         dirty_subtree_roots_ == other.dirty_subtree_roots();
 }
 #endif
 
@@ -156,7 +174,7 @@ bool TransformTree::OnTransformAnimated(ElementId element_id,
   node->needs_local_transform_update = true;
   node->transform_changed = true;
   property_trees()->changed = true;
-  set_needs_update(true);
+  SetSubtreeNeedsUpdate(node->id);
   return true;
 }
 
@@ -845,7 +863,7 @@ bool EffectTree::OnOpacityAnimated(ElementId id, float opacity) {
   node->opacity = opacity;
   node->effect_changed = true;
   property_trees()->changed = true;
-  property_trees()->effect_tree.set_needs_update(true);
+  SetSubtreeNeedsUpdate(node->id);
   return true;
 }
 
@@ -858,7 +876,7 @@ bool EffectTree::OnFilterAnimated(ElementId id,
   node->filters = filters;
   node->effect_changed = true;
   property_trees()->changed = true;
-  property_trees()->effect_tree.set_needs_update(true);
+  SetSubtreeNeedsUpdate(node->id);
   return true;
 }
 
@@ -872,7 +890,7 @@ bool EffectTree::OnBackdropFilterAnimated(
   node->backdrop_filters = backdrop_filters;
   node->effect_changed = true;
   property_trees()->changed = true;
-  property_trees()->effect_tree.set_needs_update(true);
+  SetSubtreeNeedsUpdate(node->id);
   return true;
 }
 
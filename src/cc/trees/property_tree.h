@@ -95,11 +95,26 @@ class CC_EXPORT PropertyTree {
   void clear();
   size_t size() const { return nodes_.size(); }
 
+  // Requests (or clears) an update of every node of the tree.
   virtual void set_needs_update(bool needs_update) {
     needs_update_ = needs_update;
+    dirty_subtree_roots_.clear();
   }
   bool needs_update() const { return needs_update_; }
 
+  // Requests an update of the subtree rooted at |id| only. Nodes outside of
+  // the dirty subtrees keep the values computed by the previous update unless
+  // they depend on a node that changes in another tree.
+  void SetSubtreeNeedsUpdate(int id);
+  // True if the pending update has to visit every node of the tree, false if
+  // no update is pending or only the dirty subtrees need to be visited.
+  bool needs_full_update() const {
+    return needs_update_ && dirty_subtree_roots_.empty();
+  }
+  const std::vector<int>& dirty_subtree_roots() const {
+    return dirty_subtree_roots_;
+  }
+
   std::vector<T>& nodes() { return nodes_; }
   const std::vector<T>& nodes() const { return nodes_; }
 
@@ -115,6 +130,9 @@ class CC_EXPORT PropertyTree {
  protected:
   std::vector<T> nodes_;
   bool needs_update_;
+  // Roots of the subtrees that need an update. Empty when |needs_update_| is
+  // false or when the whole tree needs an update.
+  std::vector<int> dirty_subtree_roots_;
   PropertyTrees* property_trees_;
 };
 
@@ -425,6 +425,83 @@ TEST(PropertyTreeTest, ScreenSpaceOpacityUpdateTest) {
   EXPECT_EQ(tree.Node(child)->screen_space_opacity, 0.25f);
 }
 
+TEST(PropertyTreeTest, TransformSubtreeUpdateTest) {
+  // This tests that marking a subtree as needing an update updates the
+  // subtree and leaves the rest of the tree alone.
+  PropertyTrees property_trees;
+  TransformTree& tree = property_trees.transform_tree;
+
+  gfx::Transform translation;
+  translation.Translate(10, 20);
+
+  int left = tree.Insert(TransformNode(), 0);
+  int left_child = tree.Insert(TransformNode(), left);
+  int right = tree.Insert(TransformNode(), 0);
+  int right_child = tree.Insert(TransformNode(), right);
+  tree.Node(left)->local = translation;
+  tree.Node(right)->local = translation;
+  for (int id : {left, left_child, right, right_child})
+    tree.Node(id)->needs_local_transform_update = true;
+  tree.set_needs_update(true);
+  EXPECT_TRUE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+  EXPECT_FALSE(tree.needs_update());
+  EXPECT_TRANSFORMATION_MATRIX_EQ(translation, tree.ToScreen(left_child));
+  EXPECT_TRANSFORMATION_MATRIX_EQ(translation, tree.ToScreen(right_child));
+
+  // Change the to_parent transform of |right| without marking it. Only a full
+  // update would pick this up.
+  gfx::Transform scale;
+  scale.Scale(2, 2);
+  tree.Node(right)->set_to_parent(scale);
+
+  gfx::Transform rotation;
+  rotation.Rotate(90);
+  tree.Node(left)->local = rotation;
+  tree.Node(left)->needs_local_transform_update = true;
+  tree.SetSubtreeNeedsUpdate(left);
+  EXPECT_TRUE(tree.needs_update());
+  EXPECT_FALSE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+  EXPECT_FALSE(tree.needs_update());
+  EXPECT_TRANSFORMATION_MATRIX_EQ(rotation, tree.ToScreen(left_child));
+  EXPECT_TRANSFORMATION_MATRIX_EQ(translation, tree.ToScreen(right_child));
+
+  // A full update request takes over pending subtree updates.
+  tree.SetSubtreeNeedsUpdate(left);
+  tree.set_needs_update(true);
+  EXPECT_TRUE(tree.needs_full_update());
+  tree.SetSubtreeNeedsUpdate(right);
+  EXPECT_TRUE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+  EXPECT_TRANSFORMATION_MATRIX_EQ(scale, tree.ToScreen(right_child));
+}
+
+TEST(PropertyTreeTest, EffectSubtreeUpdateTest) {
+  // This tests that screen space opacity is updated for the subtree of an
+  // animated node only.
+  PropertyTrees property_trees;
+  EffectTree& tree = property_trees.effect_tree;
+
+  int left = tree.Insert(EffectNode(), 0);
+  int left_child = tree.Insert(EffectNode(), left);
+  int right = tree.Insert(EffectNode(), 0);
+  int right_child = tree.Insert(EffectNode(), right);
+  tree.set_needs_update(true);
+  draw_property_utils::ComputeEffects(&tree);
+
+  tree.Node(right)->opacity = 0.5f;
+  tree.Node(left)->opacity = 0.5f;
+  tree.SetSubtreeNeedsUpdate(left);
+  draw_property_utils::ComputeEffects(&tree);
+  EXPECT_EQ(0.5f, tree.Node(left_child)->screen_space_opacity);
+  EXPECT_EQ(1.f, tree.Node(right_child)->screen_space_opacity);
+
+  tree.SetSubtreeNeedsUpdate(right);
+  draw_property_utils::ComputeEffects(&tree);
+  EXPECT_EQ(0.5f, tree.Node(right_child)->screen_space_opacity);
+}
+
 TEST(PropertyTreeTest, SingularTransformSnapTest) {
   // This tests that to_target transform is not snapped when it has a singular
   // transform.
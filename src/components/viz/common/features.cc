@@ -61,6 +61,43 @@ const base::Feature kDynamicColorGamut{"DynamicColorGamut",
 const base::Feature kFastSolidColorDraw{"FastSolidColorDraw",
                                         base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Keeps the quads that SurfaceAggregator emits for embedded surfaces, and
+// reuses them in later frames while the surfaces do not change.
+const base::Feature kIncrementalSurfaceAggregation{
+    "IncrementalSurfaceAggregation", base::FEATURE_DISABLED_BY_DEFAULT};
+
+// The most threads, including the display compositor thread, that copy reused
+// render passes into the aggregated frame.
+const base::FeatureParam<int> kIncrementalSurfaceAggregationMaxCopyWorkers{
+    &kIncrementalSurfaceAggregation, "max_copy_workers", 1};
+
+// Makes OverlayProcessorOzone remember the platform's answer for each overlay
+// configuration it has tested, and test new configurations asynchronously once
+// they have been seen in a few frames.
+const base::Feature kOverlayPromotionCache{"OverlayPromotionCache",
+                                           base::FEATURE_DISABLED_BY_DEFAULT};
+
+// The number of times a configuration is seen before the platform is asked
+// whether it can be displayed with overlays.
+const base::FeatureParam<int> kOverlayPromotionCacheThrottleFrames{
+    &kOverlayPromotionCache, "throttle_frames", 3};
+
+// Lets SoftwareRenderer draw solid color, tile and texture quads that map to
+// whole device pixels with the SIMD kernels of ui/gfx/blit.h instead of Skia.
+const base::Feature kSoftwareCompositingKernels{
+    "SoftwareCompositingKernels", base::FEATURE_DISABLED_BY_DEFAULT};
+
+// Records the root render pass of SoftwareRenderer and plays it back into
+// horizontal bands of the output on several threads when a large part of the
+// output is damaged.
+const base::Feature kSoftwareRendererParallelDraw{
+    "SoftwareRendererParallelDraw", base::FEATURE_DISABLED_BY_DEFAULT};
+
+// The most threads, including the display compositor thread, that play back
+// the bands.
+const base::FeatureParam<int> kSoftwareRendererParallelDrawMaxThreads{
+    &kSoftwareRendererParallelDraw, "max_threads", 4};
+
 // Viz for WebView architecture.
 const base::Feature kVizForWebView{"VizForWebView",
                                    base::FEATURE_DISABLED_BY_DEFAULT};
@@ -141,10 +178,26 @@ bool IsAdpfEnabled() {
   return base::FeatureList::IsEnabled(kAdpf);
 }
 
+bool IsIncrementalSurfaceAggregationEnabled() {
+  return base::FeatureList::IsEnabled(kIncrementalSurfaceAggregation);
+}
+
 bool IsOverlayPrioritizationEnabled() {
   return base::FeatureList::IsEnabled(kEnableOverlayPrioritization);
 }
 
+bool IsOverlayPromotionCacheEnabled() {
+  return base::FeatureList::IsEnabled(kOverlayPromotionCache);
+}
+
+bool IsSoftwareCompositingKernelsEnabled() {
+  return base::FeatureList::IsEnabled(kSoftwareCompositingKernels);
+}
+
+bool IsSoftwareRendererParallelDrawEnabled() {
+  return base::FeatureList::IsEnabled(kSoftwareRendererParallelDraw);
+}
+
 // If a synchronous IPC should used when destroying windows. This exists to test
 // the impact of removing the sync IPC.
 bool IsSyncWindowDestructionEnabled() {
@@ -23,6 +23,16 @@ VIZ_COMMON_EXPORT extern const base::Feature kDisableDeJelly;
 VIZ_COMMON_EXPORT extern const base::Feature kDynamicColorGamut;
 #endif
 VIZ_COMMON_EXPORT extern const base::Feature kFastSolidColorDraw;
+VIZ_COMMON_EXPORT extern const base::Feature kIncrementalSurfaceAggregation;
+VIZ_COMMON_EXPORT extern const base::FeatureParam<int>
+    kIncrementalSurfaceAggregationMaxCopyWorkers;
+VIZ_COMMON_EXPORT extern const base::Feature kOverlayPromotionCache;
+VIZ_COMMON_EXPORT extern const base::FeatureParam<int>
+    kOverlayPromotionCacheThrottleFrames;
+VIZ_COMMON_EXPORT extern const base::Feature kSoftwareCompositingKernels;
+VIZ_COMMON_EXPORT extern const base::Feature kSoftwareRendererParallelDraw;
+VIZ_COMMON_EXPORT extern const base::FeatureParam<int>
+    kSoftwareRendererParallelDrawMaxThreads;
 VIZ_COMMON_EXPORT extern const base::Feature kVizForWebViewDefault;
 VIZ_COMMON_EXPORT extern const base::Feature kVizFrameSubmissionForWebView;
 VIZ_COMMON_EXPORT extern const base::Feature kUsePreferredIntervalForVideo;
@@ -47,7 +57,11 @@ VIZ_COMMON_EXPORT bool IsAdpfEnabled();
 #if defined(OS_ANDROID)
 VIZ_COMMON_EXPORT bool IsDynamicColorGamutEnabled();
 #endif
+VIZ_COMMON_EXPORT bool IsIncrementalSurfaceAggregationEnabled();
 VIZ_COMMON_EXPORT bool IsOverlayPrioritizationEnabled();
+VIZ_COMMON_EXPORT bool IsOverlayPromotionCacheEnabled();
+VIZ_COMMON_EXPORT bool IsSoftwareCompositingKernelsEnabled();
+VIZ_COMMON_EXPORT bool IsSoftwareRendererParallelDrawEnabled();
 VIZ_COMMON_EXPORT bool IsSyncWindowDestructionEnabled();
 VIZ_COMMON_EXPORT bool IsUsingFastPathForSolidColorQuad();
 VIZ_COMMON_EXPORT bool IsUsingSkiaRenderer();
@@ -584,6 +584,10 @@ void Display::InitializeRenderer(bool enable_shared_images) {
   aggregator_->SetDisplayColorSpaces(display_color_spaces_);
   aggregator_->SetMaxRenderTargetSize(
       output_surface_->capabilities().max_render_target_size);
+  aggregator_->SetIncrementalAggregation(
+      features::IsIncrementalSurfaceAggregationEnabled(),
+      std::max(1,
+               features::kIncrementalSurfaceAggregationMaxCopyWorkers.Get()));
 }
 
 bool Display::IsRootFrameMissing() const {
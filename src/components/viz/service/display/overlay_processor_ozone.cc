@@ -131,6 +131,12 @@ OverlayProcessorOzone::OverlayProcessorOzone(
         NOTREACHED();
     }
   }
+
+  if (features::IsOverlayPromotionCacheEnabled()) {
+    promotion_cache_ = std::make_unique<OverlayPromotionCache>(
+        overlay_candidates_.get(),
+        features::kOverlayPromotionCacheThrottleFrames.Get());
+  }
 }
 
 OverlayProcessorOzone::~OverlayProcessorOzone() = default;
@@ -222,7 +228,10 @@ void OverlayProcessorOzone::CheckOverlaySupport(
       }
     }
   }
-  overlay_candidates_->CheckOverlaySupport(&ozone_surface_list);
+  if (promotion_cache_)
+    promotion_cache_->CheckOverlaySupport(&ozone_surface_list);
+  else
+    overlay_candidates_->CheckOverlaySupport(&ozone_surface_list);
 
   // Copy information from OzoneSurfaceCandidatelist back to
   // OverlayCandidateList.
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "components/viz/service/display/overlay_processor_using_strategy.h"
+#include "components/viz/service/display/overlay_promotion_cache.h"
 #include "ui/gfx/native_widget_types.h"
 #include "ui/ozone/public/overlay_candidates_ozone.h"
 
@@ -50,6 +51,10 @@ class VIZ_SERVICE_EXPORT OverlayProcessorOzone
                                    bool is_primary);
 
   std::unique_ptr<ui::OverlayCandidatesOzone> overlay_candidates_;
+  // Answers for |overlay_candidates_| when features::kOverlayPromotionCache is
+  // enabled. Only the platform test is cached; the strategies still look for
+  // candidates in the quads of every frame.
+  std::unique_ptr<OverlayPromotionCache> promotion_cache_;
   const std::vector<OverlayStrategy> available_strategies_;
   gpu::SharedImageInterface* const shared_image_interface_;
 };
@@ -0,0 +1,169 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread.h"
+#include "components/viz/common/features.h"
+#include "components/viz/service/display/overlay_processor_ozone.h"
+#include "components/viz/service/display/viz_perf_test.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "ui/gfx/geometry/rect_conversions.h"
+
+namespace viz {
+namespace {
+
+constexpr char kMetricPrefixOverlayProcessorOzone[] = "OverlayProcessorOzone.";
+constexpr char kMetricFramesPerS[] = "frames_per_second";
+constexpr char kMetricPlatformTests[] = "platform_tests";
+
+// The configurations that strategies propose for one video each frame: on
+// top, as an underlay and fullscreen.
+constexpr int kPlaneZOrders[] = {1, -1, 0};
+
+perf_test::PerfResultReporter SetUpOverlayProcessorOzoneReporter(
+    const std::string& story) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixOverlayProcessorOzone,
+                                         story);
+  reporter.RegisterImportantMetric(kMetricFramesPerS, "runs/s");
+  reporter.RegisterImportantMetric(kMetricPlatformTests, "count");
+  return reporter;
+}
+
+// Tests overlay configurations on another thread, the way Ozone platforms
+// that validate overlays in the GPU host or with the display hardware do.
+// Every candidate is handled and snapped to whole pixels.
+class FakeOverlayCandidatesOzone : public ui::OverlayCandidatesOzone {
+ public:
+  FakeOverlayCandidatesOzone() : platform_thread_("FakeOverlayPlatform") {
+    CHECK(platform_thread_.Start());
+  }
+  ~FakeOverlayCandidatesOzone() override = default;
+
+  void CheckOverlaySupport(OverlaySurfaceCandidateList* surfaces) override {
+    ++test_count_;
+    base::WaitableEvent done;
+    platform_thread_.task_runner()->PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](OverlaySurfaceCandidateList* surfaces,
+                          base::WaitableEvent* done) {
+                         TestOnPlatformThread(surfaces);
+                         done->Signal();
+                       },
+                       surfaces, &done));
+    done.Wait();
+  }
+
+  void CheckOverlaySupportAsync(OverlaySurfaceCandidateList surfaces,
+                                CheckOverlaySupportCallback callback) override {
+    ++test_count_;
+    platform_thread_.task_runner()->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](OverlaySurfaceCandidateList surfaces,
+               CheckOverlaySupportCallback callback,
+               scoped_refptr<base::SequencedTaskRunner> reply_task_runner) {
+              TestOnPlatformThread(&surfaces);
+              reply_task_runner->PostTask(
+                  FROM_HERE,
+                  base::BindOnce(std::move(callback), std::move(surfaces)));
+            },
+            std::move(surfaces), std::move(callback),
+            base::SequencedTaskRunnerHandle::Get()));
+  }
+
+  size_t test_count() const { return test_count_; }
+
+ private:
+  static void TestOnPlatformThread(OverlaySurfaceCandidateList* surfaces) {
+    for (auto& surface : *surfaces) {
+      surface.overlay_handled = true;
+      surface.display_rect =
+          gfx::RectF(gfx::ToNearestRect(surface.display_rect));
+    }
+  }
+
+  base::Thread platform_thread_;
+  size_t test_count_ = 0;
+};
+
+class OverlayProcessorOzonePerfTest : public VizPerfTest {
+ public:
+  void RunTest(bool use_promotion_cache, const std::string& story) {
+    base::test::ScopedFeatureList feature_list;
+    if (use_promotion_cache)
+      feature_list.InitAndEnableFeature(features::kOverlayPromotionCache);
+    else
+      feature_list.InitAndDisableFeature(features::kOverlayPromotionCache);
+
+    auto overlay_candidates = std::make_unique<FakeOverlayCandidatesOzone>();
+    FakeOverlayCandidatesOzone* fake_overlay_candidates =
+        overlay_candidates.get();
+    OverlayProcessorOzone processor(std::move(overlay_candidates),
+#if defined(USE_NEVA_MEDIA)
+                                    gpu::kNullSurfaceHandle,
+#endif
+                                    {}, nullptr);
+
+    OverlayProcessorInterface::OutputSurfaceOverlayPlane primary_plane;
+    primary_plane.resource_size = gfx::Size(1920, 1080);
+    primary_plane.format = gfx::BufferFormat::BGRX_8888;
+    primary_plane.display_rect = gfx::RectF(1920.f, 1080.f);
+    primary_plane.uv_rect = gfx::RectF(1.f, 1.f);
+
+    OverlayCandidate video;
+    video.format = gfx::BufferFormat::YUV_420_BIPLANAR;
+    video.resource_size_in_pixels = gfx::Size(1280, 720);
+    video.display_rect = gfx::RectF(320.5f, 180.25f, 1280.f, 720.f);
+    video.uv_rect = gfx::RectF(1.f, 1.f);
+    video.clip_rect = gfx::Rect(1920, 1080);
+    video.is_opaque = true;
+
+    int promoted_frames = 0;
+    timer_.Reset();
+    do {
+      bool promoted = false;
+      for (int plane_z_order : kPlaneZOrders) {
+        OverlayCandidateList candidates = {video};
+        candidates[0].plane_z_order = plane_z_order;
+        processor.CheckOverlaySupport(
+            plane_z_order ? &primary_plane : nullptr, &candidates);
+        promoted |= candidates[0].overlay_handled;
+      }
+      if (promoted)
+        ++promoted_frames;
+      // Delivers asynchronous test results.
+      base::RunLoop().RunUntilIdle();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EXPECT_GT(promoted_frames, 0);
+    auto reporter = SetUpOverlayProcessorOzoneReporter(story);
+    reporter.AddResult(kMetricFramesPerS, timer_.LapsPerSecond());
+    reporter.AddResult(kMetricPlatformTests,
+                       fake_overlay_candidates->test_count());
+  }
+
+ private:
+  base::test::SingleThreadTaskEnvironment task_environment_;
+};
+
+TEST_F(OverlayProcessorOzonePerfTest, StableVideo) {
+  RunTest(/*use_promotion_cache=*/false, "stable_video");
+}
+
+TEST_F(OverlayProcessorOzonePerfTest, StableVideoPromotionCache) {
+  RunTest(/*use_promotion_cache=*/true, "stable_video_promotion_cache");
+}
+
+}  // namespace
+}  // namespace viz
@@ -0,0 +1,127 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/viz/service/display/overlay_promotion_cache.h"
+
+#include <tuple>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check_op.h"
+
+namespace viz {
+
+namespace {
+
+// The most configurations that are remembered. Strategies propose a handful of
+// configurations each frame, so this keeps those of a stable page while
+// bounding the cache when the page changes.
+constexpr size_t kMaxCacheSize = 10;
+
+}  // namespace
+
+OverlayPromotionCache::CandidateKey::CandidateKey(
+    const ui::OverlaySurfaceCandidate& candidate)
+    : transform(candidate.transform),
+      format(candidate.format),
+      plane_z_order(candidate.plane_z_order),
+      buffer_size(candidate.buffer_size),
+      display_rect(candidate.display_rect),
+      crop_rect(candidate.crop_rect),
+      clip_rect(candidate.clip_rect),
+      is_clipped(candidate.is_clipped),
+      is_opaque(candidate.is_opaque),
+      requires_overlay(candidate.requires_overlay) {}
+
+bool OverlayPromotionCache::CandidateKey::operator<(
+    const CandidateKey& other) const {
+  int lwidth = buffer_size.width();
+  int lheight = buffer_size.height();
+  int rwidth = other.buffer_size.width();
+  int rheight = other.buffer_size.height();
+
+  return std::tie(plane_z_order, format, lwidth, lheight, transform,
+                  display_rect, crop_rect, clip_rect, is_clipped, is_opaque,
+                  requires_overlay) <
+         std::tie(other.plane_z_order, other.format, rwidth, rheight,
+                  other.transform, other.display_rect, other.crop_rect,
+                  other.clip_rect, other.is_clipped, other.is_opaque,
+                  other.requires_overlay);
+}
+
+OverlayPromotionCache::Entry::Entry() = default;
+OverlayPromotionCache::Entry::Entry(Entry&& other) = default;
+OverlayPromotionCache::Entry::~Entry() = default;
+OverlayPromotionCache::Entry& OverlayPromotionCache::Entry::operator=(
+    Entry&& other) = default;
+
+OverlayPromotionCache::OverlayPromotionCache(
+    ui::OverlayCandidatesOzone* overlay_candidates,
+    int throttle_request_count)
+    : overlay_candidates_(overlay_candidates),
+      throttle_request_count_(throttle_request_count),
+      cache_(kMaxCacheSize) {
+  DCHECK(overlay_candidates_);
+}
+
+OverlayPromotionCache::~OverlayPromotionCache() = default;
+
+void OverlayPromotionCache::CheckOverlaySupport(
+    OverlaySurfaceCandidateList* surfaces) {
+  ConfigurationKey key(surfaces->begin(), surfaces->end());
+  auto it = cache_.Get(key);
+  if (it == cache_.end())
+    it = cache_.Put(key, Entry());
+  Entry& entry = it->second;
+
+  if (!entry.test_requested) {
+    bool requires_overlay = false;
+    for (const auto& surface : *surfaces)
+      requires_overlay |= surface.requires_overlay;
+    if (requires_overlay || ++entry.seen_count >= throttle_request_count_) {
+      entry.test_requested = true;
+      // Synchronous platforms fill in |entry.results| before this returns.
+      RequestTest(key, *surfaces);
+    }
+  }
+
+  if (entry.results.empty()) {
+    for (auto& surface : *surfaces)
+      surface.overlay_handled = false;
+    return;
+  }
+
+  DCHECK_EQ(entry.results.size(), surfaces->size());
+  for (size_t i = 0; i < surfaces->size(); ++i) {
+    (*surfaces)[i].overlay_handled = entry.results[i].overlay_handled;
+    (*surfaces)[i].display_rect = entry.results[i].display_rect;
+  }
+}
+
+void OverlayPromotionCache::RequestTest(
+    const ConfigurationKey& key,
+    const OverlaySurfaceCandidateList& surfaces) {
+  ++platform_test_count_;
+  overlay_candidates_->CheckOverlaySupportAsync(
+      surfaces, base::BindOnce(&OverlayPromotionCache::OnTestResult,
+                               weak_ptr_factory_.GetWeakPtr(), key));
+}
+
+void OverlayPromotionCache::OnTestResult(const ConfigurationKey& key,
+                                         OverlaySurfaceCandidateList surfaces) {
+  // The configuration may have been evicted while the platform was testing it.
+  auto it = cache_.Peek(key);
+  if (it == cache_.end())
+    return;
+
+  DCHECK_EQ(key.size(), surfaces.size());
+  std::vector<CandidateResult>& results = it->second.results;
+  results.resize(surfaces.size());
+  for (size_t i = 0; i < surfaces.size(); ++i) {
+    results[i].overlay_handled = surfaces[i].overlay_handled;
+    results[i].display_rect = surfaces[i].display_rect;
+  }
+}
+
+}  // namespace viz
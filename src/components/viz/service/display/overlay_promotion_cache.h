@@ -0,0 +1,106 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_VIZ_SERVICE_DISPLAY_OVERLAY_PROMOTION_CACHE_H_
+#define COMPONENTS_VIZ_SERVICE_DISPLAY_OVERLAY_PROMOTION_CACHE_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "components/viz/service/viz_service_export.h"
+#include "ui/gfx/buffer_types.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/rect_f.h"
+#include "ui/gfx/geometry/size.h"
+#include "ui/gfx/overlay_transform.h"
+#include "ui/ozone/public/overlay_candidates_ozone.h"
+
+namespace viz {
+
+// Remembers which overlay configurations the platform could display, so that
+// it is only asked again when the buffer format, buffer size or geometry of a
+// candidate, or the set of candidates, changes. A configuration is only tested
+// once it has been seen |throttle_request_count| times, which keeps transient
+// configurations (e.g. during animations) away from the platform, and the test
+// runs through CheckOverlaySupportAsync(). Until a result has arrived, the
+// candidates of a configuration are not promoted and get composited.
+class VIZ_SERVICE_EXPORT OverlayPromotionCache {
+ public:
+  using OverlaySurfaceCandidateList =
+      ui::OverlayCandidatesOzone::OverlaySurfaceCandidateList;
+
+  // |overlay_candidates| must outlive this object.
+  OverlayPromotionCache(ui::OverlayCandidatesOzone* overlay_candidates,
+                        int throttle_request_count);
+  ~OverlayPromotionCache();
+
+  // Sets |overlay_handled| and |display_rect| of each of |surfaces| from the
+  // result of testing their configuration, or marks them as not handled if
+  // there is no result yet. Candidates that require an overlay are tested the
+  // first time their configuration is seen.
+  void CheckOverlaySupport(OverlaySurfaceCandidateList* surfaces);
+
+  // Returns the number of configurations tested by the platform so far.
+  size_t platform_test_count() const { return platform_test_count_; }
+
+ private:
+  // The parts of a ui::OverlaySurfaceCandidate that its test result depends
+  // on. Unlike ui::OverlaySurfaceCandidate::operator<, this ignores the buffer
+  // itself, which changes every frame for video.
+  struct CandidateKey {
+    explicit CandidateKey(const ui::OverlaySurfaceCandidate& candidate);
+    bool operator<(const CandidateKey& other) const;
+
+    gfx::OverlayTransform transform;
+    gfx::BufferFormat format;
+    int plane_z_order;
+    gfx::Size buffer_size;
+    gfx::RectF display_rect;
+    gfx::RectF crop_rect;
+    gfx::Rect clip_rect;
+    bool is_clipped;
+    bool is_opaque;
+    bool requires_overlay;
+  };
+  using ConfigurationKey = std::vector<CandidateKey>;
+
+  struct CandidateResult {
+    bool overlay_handled = false;
+    gfx::RectF display_rect;
+  };
+
+  struct Entry {
+    Entry();
+    Entry(Entry&& other);
+    ~Entry();
+    Entry& operator=(Entry&& other);
+
+    int seen_count = 0;
+    bool test_requested = false;
+    // Empty until the platform has answered.
+    std::vector<CandidateResult> results;
+  };
+
+  void RequestTest(const ConfigurationKey& key,
+                   const OverlaySurfaceCandidateList& surfaces);
+  void OnTestResult(const ConfigurationKey& key,
+                    OverlaySurfaceCandidateList surfaces);
+
+  ui::OverlayCandidatesOzone* const overlay_candidates_;
+  const int throttle_request_count_;
+  base::MRUCache<ConfigurationKey, Entry> cache_;
+  size_t platform_test_count_ = 0;
+
+  base::WeakPtrFactory<OverlayPromotionCache> weak_ptr_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(OverlayPromotionCache);
+};
+
+}  // namespace viz
+
+#endif  // COMPONENTS_VIZ_SERVICE_DISPLAY_OVERLAY_PROMOTION_CACHE_H_
@@ -0,0 +1,194 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/viz/service/display/overlay_promotion_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/geometry/rect_conversions.h"
+
+namespace viz {
+namespace {
+
+// Answers overlay tests when told to, like a platform that tests overlay
+// configurations in another process. Candidates wider than |max_width_| are
+// not handled, and the display rect of handled ones is snapped.
+class FakeAsyncOverlayCandidatesOzone : public ui::OverlayCandidatesOzone {
+ public:
+  explicit FakeAsyncOverlayCandidatesOzone(int max_width)
+      : max_width_(max_width) {}
+  ~FakeAsyncOverlayCandidatesOzone() override = default;
+
+  void CheckOverlaySupport(OverlaySurfaceCandidateList* surfaces) override {
+    for (auto& surface : *surfaces) {
+      surface.overlay_handled = surface.buffer_size.width() <= max_width_;
+      if (surface.overlay_handled)
+        surface.display_rect =
+            gfx::RectF(gfx::ToNearestRect(surface.display_rect));
+    }
+  }
+
+  void CheckOverlaySupportAsync(OverlaySurfaceCandidateList surfaces,
+                                CheckOverlaySupportCallback callback) override {
+    pending_.emplace_back(std::move(surfaces), std::move(callback));
+  }
+
+  // Answers all the tests requested so far.
+  void RunPendingTests() {
+    auto pending = std::move(pending_);
+    for (auto& request : pending) {
+      CheckOverlaySupport(&request.first);
+      std::move(request.second).Run(std::move(request.first));
+    }
+  }
+
+  size_t pending_test_count() const { return pending_.size(); }
+
+ private:
+  const int max_width_;
+  std::vector<std::pair<OverlaySurfaceCandidateList,
+                        CheckOverlaySupportCallback>>
+      pending_;
+};
+
+ui::OverlaySurfaceCandidate MakeCandidate(const gfx::Size& buffer_size,
+                                          const gfx::RectF& display_rect) {
+  ui::OverlaySurfaceCandidate candidate;
+  candidate.format = gfx::BufferFormat::YUV_420_BIPLANAR;
+  candidate.buffer_size = buffer_size;
+  candidate.display_rect = display_rect;
+  candidate.crop_rect = gfx::RectF(1.f, 1.f);
+  candidate.plane_z_order = -1;
+  candidate.is_opaque = true;
+  return candidate;
+}
+
+TEST(OverlayPromotionCacheTest, ThrottlesAndCachesTests) {
+  FakeAsyncOverlayCandidatesOzone overlay_candidates(1920);
+  OverlayPromotionCache cache(&overlay_candidates, 3);
+  const gfx::RectF display_rect(10.4f, 20.6f, 640.f, 360.f);
+
+  // The first frames with the configuration composite the candidate, and the
+  // platform is only asked once the configuration has been seen three times.
+  for (int i = 0; i < 3; ++i) {
+    OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+        MakeCandidate(gfx::Size(1280, 720), display_rect)};
+    surfaces[0].overlay_handled = true;
+    cache.CheckOverlaySupport(&surfaces);
+    EXPECT_FALSE(surfaces[0].overlay_handled);
+    EXPECT_EQ(i < 2 ? 0u : 1u, cache.platform_test_count());
+  }
+  EXPECT_EQ(1u, overlay_candidates.pending_test_count());
+
+  // Frames seen while the test is pending still composite.
+  OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+      MakeCandidate(gfx::Size(1280, 720), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_FALSE(surfaces[0].overlay_handled);
+
+  // Once the platform has answered, the candidate is promoted with the snapped
+  // display rect, without asking the platform again.
+  overlay_candidates.RunPendingTests();
+  for (int i = 0; i < 5; ++i) {
+    surfaces = {MakeCandidate(gfx::Size(1280, 720), display_rect)};
+    cache.CheckOverlaySupport(&surfaces);
+    EXPECT_TRUE(surfaces[0].overlay_handled);
+    EXPECT_EQ(gfx::RectF(10.f, 21.f, 640.f, 360.f), surfaces[0].display_rect);
+  }
+  EXPECT_EQ(1u, cache.platform_test_count());
+  EXPECT_EQ(0u, overlay_candidates.pending_test_count());
+}
+
+TEST(OverlayPromotionCacheTest, RetestsWhenConfigurationChanges) {
+  FakeAsyncOverlayCandidatesOzone overlay_candidates(1920);
+  OverlayPromotionCache cache(&overlay_candidates, 1);
+  const gfx::RectF display_rect(0.f, 0.f, 640.f, 360.f);
+
+  OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+      MakeCandidate(gfx::Size(1280, 720), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  overlay_candidates.RunPendingTests();
+  EXPECT_EQ(1u, cache.platform_test_count());
+
+  // Moving the candidate, changing its buffer size or format, or adding a
+  // candidate all make a new configuration.
+  surfaces = {MakeCandidate(gfx::Size(1280, 720),
+                            gfx::RectF(10.f, 0.f, 640.f, 360.f))};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_FALSE(surfaces[0].overlay_handled);
+  EXPECT_EQ(2u, cache.platform_test_count());
+
+  surfaces = {MakeCandidate(gfx::Size(3840, 2160), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_EQ(3u, cache.platform_test_count());
+
+  surfaces = {MakeCandidate(gfx::Size(1280, 720), display_rect)};
+  surfaces[0].format = gfx::BufferFormat::BGRA_8888;
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_EQ(4u, cache.platform_test_count());
+
+  surfaces = {MakeCandidate(gfx::Size(1280, 720), display_rect),
+              MakeCandidate(gfx::Size(1280, 720), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_EQ(5u, cache.platform_test_count());
+
+  // The platform rejects the 4K buffer, which is remembered too.
+  overlay_candidates.RunPendingTests();
+  surfaces = {MakeCandidate(gfx::Size(3840, 2160), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_FALSE(surfaces[0].overlay_handled);
+
+  // The original configuration is still cached.
+  surfaces = {MakeCandidate(gfx::Size(1280, 720), display_rect)};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_TRUE(surfaces[0].overlay_handled);
+  EXPECT_EQ(5u, cache.platform_test_count());
+}
+
+TEST(OverlayPromotionCacheTest, RequiredOverlaysAreNotThrottled) {
+  FakeAsyncOverlayCandidatesOzone overlay_candidates(1920);
+  OverlayPromotionCache cache(&overlay_candidates, 3);
+
+  OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+      MakeCandidate(gfx::Size(1280, 720), gfx::RectF(640.f, 360.f))};
+  surfaces[0].requires_overlay = true;
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_EQ(1u, cache.platform_test_count());
+}
+
+TEST(OverlayPromotionCacheTest, SynchronousPlatform) {
+  // The default CheckOverlaySupportAsync() answers right away, so the result
+  // applies to the frame that requested the test.
+  class SyncOverlayCandidatesOzone : public ui::OverlayCandidatesOzone {
+   public:
+    void CheckOverlaySupport(OverlaySurfaceCandidateList* surfaces) override {
+      for (auto& surface : *surfaces)
+        surface.overlay_handled = true;
+    }
+  } overlay_candidates;
+  OverlayPromotionCache cache(&overlay_candidates, 1);
+
+  OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+      MakeCandidate(gfx::Size(1280, 720), gfx::RectF(640.f, 360.f))};
+  cache.CheckOverlaySupport(&surfaces);
+  EXPECT_TRUE(surfaces[0].overlay_handled);
+  EXPECT_EQ(1u, cache.platform_test_count());
+}
+
+TEST(OverlayPromotionCacheTest, IgnoresResultsOfDestroyedCache) {
+  FakeAsyncOverlayCandidatesOzone overlay_candidates(1920);
+  {
+    OverlayPromotionCache cache(&overlay_candidates, 1);
+    OverlayPromotionCache::OverlaySurfaceCandidateList surfaces = {
+        MakeCandidate(gfx::Size(1280, 720), gfx::RectF(640.f, 360.f))};
+    cache.CheckOverlaySupport(&surfaces);
+  }
+  EXPECT_EQ(1u, overlay_candidates.pending_test_count());
+  overlay_candidates.RunPendingTests();
+}
+
+}  // namespace
+}  // namespace viz
@@ -5,7 +5,8 @@
 // This perf test measures the time from when the display compositor starts
 // drawing on the compositor thread to when a swap buffers occurs on the
 // GPU main thread. It tests both GLRenderer and SkiaRenderer under
-// simple work loads.
+// simple work loads. SoftwareRenderer is tested separately, along with the
+// number of bytes that its output device copies to the platform per frame.
 //
 // Example usage:
 //
@@ -21,6 +22,7 @@
 #include "base/metrics/histogram_base.h"
 #include "base/metrics/histogram_samples.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/optional.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
@@ -30,19 +32,26 @@
 #include "components/viz/client/client_resource_provider.h"
 #include "components/viz/common/display/renderer_settings.h"
 #include "components/viz/common/quads/render_pass_io.h"
+#include "components/viz/common/quads/solid_color_draw_quad.h"
 #include "components/viz/common/quads/texture_draw_quad.h"
+#include "components/viz/common/quads/tile_draw_quad.h"
+#include "components/viz/common/resources/bitmap_allocation.h"
+#include "components/viz/common/resources/shared_bitmap.h"
 #include "components/viz/common/surfaces/parent_local_surface_id_allocator.h"
 #include "components/viz/service/display/display.h"
 #include "components/viz/service/display/gl_renderer.h"
 #include "components/viz/service/display/output_surface_client.h"
 #include "components/viz/service/display/overlay_processor_stub.h"
 #include "components/viz/service/display/skia_renderer.h"
+#include "components/viz/service/display/software_output_device.h"
+#include "components/viz/service/display/software_renderer.h"
 #include "components/viz/service/display/viz_perf_test.h"
 #include "components/viz/service/display_embedder/gl_output_surface_offscreen.h"
 #include "components/viz/service/display_embedder/in_process_gpu_memory_buffer_manager.h"
 #include "components/viz/service/display_embedder/server_shared_bitmap_manager.h"
 #include "components/viz/service/display_embedder/skia_output_surface_dependency_impl.h"
 #include "components/viz/service/display_embedder/skia_output_surface_impl.h"
+#include "components/viz/service/display_embedder/software_output_surface.h"
 #include "components/viz/service/display_embedder/viz_process_context_provider.h"
 #include "components/viz/service/frame_sinks/compositor_frame_sink_support.h"
 #include "components/viz/service/frame_sinks/frame_sink_manager_impl.h"
@@ -54,10 +63,12 @@
 #include "gpu/command_buffer/common/shared_image_usage.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkColorPriv.h"
 #include "ui/gfx/color_space.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
+#include "ui/gfx/geometry/vector2d.h"
 #include "ui/gl/gl_implementation.h"
 
 namespace viz {
@@ -67,13 +78,19 @@ namespace {
 static constexpr FrameSinkId kArbitraryFrameSinkId(3, 3);
 static constexpr gfx::Size kSurfaceSize(1000, 1000);
 static constexpr gfx::Rect kSurfaceRect(kSurfaceSize);
+// SoftwareRendererPerfTest draws a grid of kGridSize x kGridSize quads.
+static constexpr int kGridSize = 10;
+static constexpr gfx::Size kGridQuadSize(kSurfaceSize.width() / kGridSize,
+                                         kSurfaceSize.height() / kGridSize);
 
 constexpr char kMetricPrefixRenderer[] = "Renderer.";
 constexpr char kMetricFps[] = "frames_per_second";
+constexpr char kMetricBytesCopiedPerFrame[] = "bytes_copied_per_frame";
 
 perf_test::PerfResultReporter SetUpRendererReporter(const std::string& story) {
   perf_test::PerfResultReporter reporter(kMetricPrefixRenderer, story);
   reporter.RegisterImportantMetric(kMetricFps, "fps");
+  reporter.RegisterImportantMetric(kMetricBytesCopiedPerFrame, "bytes");
   return reporter;
 }
 
@@ -113,6 +130,33 @@ class WaitForSwapDisplayClient : public DisplayClient {
   DISALLOW_COPY_AND_ASSIGN(WaitForSwapDisplayClient);
 };
 
+// A SoftwareOutputDevice that counts the pixels that it would copy to the
+// platform, which only takes the damage of each frame like
+// SoftwareOutputDeviceOzone does.
+class DamageCountingSoftwareOutputDevice : public SoftwareOutputDevice {
+ public:
+  DamageCountingSoftwareOutputDevice() = default;
+
+  void set_buffer_age(int buffer_age) { buffer_age_ = buffer_age; }
+  int64_t presented_pixels() const { return presented_pixels_; }
+  int presented_frames() const { return presented_frames_; }
+
+  // SoftwareOutputDevice implementation.
+  void EndPaint() override {
+    SoftwareOutputDevice::EndPaint();
+    presented_pixels_ += damage_rect_.size().GetArea();
+    ++presented_frames_;
+  }
+  int GetBufferAge() const override { return buffer_age_; }
+
+ private:
+  int buffer_age_ = 1;
+  int64_t presented_pixels_ = 0;
+  int presented_frames_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DamageCountingSoftwareOutputDevice);
+};
+
 std::unique_ptr<CompositorRenderPass> CreateTestRootRenderPass() {
   const CompositorRenderPassId id{1};
   const gfx::Rect output_rect = kSurfaceRect;
@@ -790,4 +834,228 @@ TOP_REAL_WORLD_DESKTOP_RENDERER_PERF_TEST(yahoo_sports, 269)
 
 #undef TOP_REAL_WORLD_DESKTOP_RENDERER_PERF_TEST
 
+class SoftwareRendererPerfTest : public VizPerfTest {
+ public:
+  SoftwareRendererPerfTest()
+      : manager_(&shared_bitmap_manager_),
+        support_(
+            std::make_unique<CompositorFrameSinkSupport>(nullptr,
+                                                         &manager_,
+                                                         kArbitraryFrameSinkId,
+                                                         true /* is_root */)) {}
+
+  void SetUp() override {
+    renderer_settings_.partial_swap_enabled = true;
+
+    auto device = std::make_unique<DamageCountingSoftwareOutputDevice>();
+    device_ = device.get();
+    auto output_surface =
+        std::make_unique<SoftwareOutputSurface>(std::move(device));
+    // WaitForSwapDisplayClient depends on this.
+    output_surface->SetNeedsSwapSizeNotifications(true);
+    auto overlay_processor = std::make_unique<OverlayProcessorStub>();
+    display_ = std::make_unique<Display>(
+        &shared_bitmap_manager_, renderer_settings_, &debug_settings_,
+        kArbitraryFrameSinkId, /*gpu_dependency=*/nullptr,
+        std::move(output_surface), std::move(overlay_processor),
+        /*display_scheduler=*/nullptr, base::ThreadTaskRunnerHandle::Get());
+    display_->SetVisible(true);
+    display_->Initialize(&client_, manager_.surface_manager());
+    display_->Resize(kSurfaceSize);
+
+    id_allocator_.GenerateId();
+    display_->SetLocalSurfaceId(id_allocator_.GetCurrentLocalSurfaceId(), 1.f);
+  }
+
+  void TearDown() override {
+    std::string story = "SoftwareRenderer_";
+    story += ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    auto reporter = SetUpRendererReporter(story);
+    reporter.AddResult(kMetricFps, timer_.LapsPerSecond());
+    if (device_->presented_frames()) {
+      reporter.AddResult(kMetricBytesCopiedPerFrame,
+                         static_cast<size_t>(device_->presented_pixels() * 4 /
+                                             device_->presented_frames()));
+    }
+
+    display_.reset();
+  }
+
+  SoftwareRenderer* renderer() const {
+    return static_cast<SoftwareRenderer*>(display_->renderer_for_testing());
+  }
+
+  // Makes the grid quads opaque.
+  void set_opaque_quads(bool opaque_quads) { opaque_quads_ = opaque_quads; }
+
+  // Makes the grid draw tile quads of a shared bitmap filled with |color|
+  // instead of solid color quads. The opacity of the tiles changes instead of
+  // their color.
+  void UseTileResource(SkColor color) {
+    base::MappedReadOnlyRegion shm =
+        bitmap_allocation::AllocateSharedBitmap(kGridQuadSize, RGBA_8888);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kGridQuadSize.width(),
+                                                  kGridQuadSize.height());
+    SkBitmap bitmap;
+    bitmap.installPixels(info, shm.mapping.memory(), info.minRowBytes());
+    bitmap.eraseColor(color);
+
+    SharedBitmapId shared_bitmap_id = SharedBitmap::GenerateId();
+    shared_bitmap_manager_.ChildAllocatedSharedBitmap(shm.region.Map(),
+                                                      shared_bitmap_id);
+    tile_resource_ = TransferableResource::MakeSoftware(
+        shared_bitmap_id, kGridQuadSize, RGBA_8888);
+    tile_resource_->id = ResourceId(1u);
+  }
+
+  // Draws a grid of translucent quads over an opaque background, with the
+  // alphas of the quads in the damage changing every frame unless the quads
+  // are opaque. The damage is |damage_rect|, moved by |damage_step| on every
+  // frame and back every third frame.
+  void RunQuadGrid(const gfx::Rect& damage_rect,
+                   const gfx::Vector2d& damage_step) {
+    // The first frame damages the whole output.
+    DrawQuadGrid(kSurfaceRect, 0);
+    client_.WaitForSwap();
+
+    int frame_index = 1;
+    timer_.Reset();
+    do {
+      gfx::Vector2d damage_offset(damage_step.x() * (frame_index % 3),
+                                  damage_step.y() * (frame_index % 3));
+      DrawQuadGrid(damage_rect + damage_offset, frame_index++);
+      client_.WaitForSwap();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+  }
+
+ protected:
+  void DrawQuadGrid(const gfx::Rect& damage_rect, int frame_index) {
+    std::unique_ptr<CompositorRenderPass> pass = CreateTestRootRenderPass();
+    pass->damage_rect = damage_rect;
+    for (int i = 0; i < kGridSize; ++i) {
+      for (int j = 0; j < kGridSize; ++j) {
+        gfx::Rect quad_rect(gfx::Point(i * kGridQuadSize.width(),
+                                       j * kGridQuadSize.height()),
+                            kGridQuadSize);
+        int alpha = 64;
+        if (opaque_quads_)
+          alpha = 255;
+        else if (quad_rect.Intersects(damage_rect))
+          alpha += frame_index % 128;
+        if (tile_resource_) {
+          gfx::Transform quad_to_target_transform;
+          quad_to_target_transform.Translate(quad_rect.x(), quad_rect.y());
+          gfx::Rect rect(kGridQuadSize);
+          SharedQuadState* shared_state = CreateTestSharedQuadState(
+              quad_to_target_transform, rect, pass.get(),
+              gfx::MaskFilterInfo());
+          shared_state->opacity = alpha / 255.f;
+          auto* quad = pass->CreateAndAppendDrawQuad<TileDrawQuad>();
+          quad->SetNew(shared_state, rect, rect,
+                       /*needs_blending=*/!opaque_quads_, tile_resource_->id,
+                       gfx::RectF(rect), kGridQuadSize,
+                       /*is_premultiplied=*/true, /*nearest_neighbor=*/false,
+                       /*force_anti_aliasing_off=*/false);
+          continue;
+        }
+        SharedQuadState* shared_state = CreateTestSharedQuadState(
+            gfx::Transform(), quad_rect, pass.get(), gfx::MaskFilterInfo());
+        auto* quad = pass->CreateAndAppendDrawQuad<SolidColorDrawQuad>();
+        quad->SetNew(shared_state, quad_rect, quad_rect,
+                     SkColorSetARGB(alpha, i * 25, j * 25, 128),
+                     /*force_anti_aliasing_off=*/false);
+      }
+    }
+    SharedQuadState* shared_state = CreateTestSharedQuadState(
+        gfx::Transform(), kSurfaceRect, pass.get(), gfx::MaskFilterInfo());
+    auto* background = pass->CreateAndAppendDrawQuad<SolidColorDrawQuad>();
+    background->SetNew(shared_state, kSurfaceRect, kSurfaceRect, SK_ColorWHITE,
+                       /*force_anti_aliasing_off=*/false);
+
+    CompositorRenderPassList pass_list;
+    pass_list.push_back(std::move(pass));
+    CompositorFrameBuilder frame_builder;
+    frame_builder.SetRenderPassList(std::move(pass_list));
+    if (tile_resource_)
+      frame_builder.AddTransferableResource(*tile_resource_);
+    support_->SubmitCompositorFrame(id_allocator_.GetCurrentLocalSurfaceId(),
+                                    frame_builder.Build());
+    ASSERT_TRUE(display_->DrawAndSwap(base::TimeTicks::Now()));
+  }
+
+  bool opaque_quads_ = false;
+  base::Optional<TransferableResource> tile_resource_;
+
+  WaitForSwapDisplayClient client_;
+  ParentLocalSurfaceIdAllocator id_allocator_;
+  ServerSharedBitmapManager shared_bitmap_manager_;
+  FrameSinkManagerImpl manager_;
+  std::unique_ptr<CompositorFrameSinkSupport> support_;
+  RendererSettings renderer_settings_;
+  DebugRendererSettings debug_settings_;
+  std::unique_ptr<Display> display_;
+  DamageCountingSoftwareOutputDevice* device_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(SoftwareRendererPerfTest);
+};
+
+TEST_F(SoftwareRendererPerfTest, FullDamage) {
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+TEST_F(SoftwareRendererPerfTest, FullDamageParallel) {
+  renderer()->SetMaxDrawThreads(4);
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+TEST_F(SoftwareRendererPerfTest, PartialDamage) {
+  RunQuadGrid(gfx::Rect(200, 400, 200, 200), gfx::Vector2d(200, 0));
+}
+
+// The output device presents from three buffers, so each frame redraws the
+// damage of the two frames before it as well.
+TEST_F(SoftwareRendererPerfTest, PartialDamageBufferAge3) {
+  device_->set_buffer_age(3);
+  RunQuadGrid(gfx::Rect(200, 400, 200, 200), gfx::Vector2d(200, 0));
+}
+
+// The compositing kernels fill the opaque quads.
+TEST_F(SoftwareRendererPerfTest, OpaqueFullDamage) {
+  set_opaque_quads(true);
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+TEST_F(SoftwareRendererPerfTest, OpaqueFullDamageKernels) {
+  renderer()->SetUseCompositingKernels(true);
+  set_opaque_quads(true);
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+// The compositing kernels copy the opaque tiles.
+TEST_F(SoftwareRendererPerfTest, OpaqueTilesFullDamage) {
+  set_opaque_quads(true);
+  UseTileResource(SK_ColorBLUE);
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+TEST_F(SoftwareRendererPerfTest, OpaqueTilesFullDamageKernels) {
+  renderer()->SetUseCompositingKernels(true);
+  set_opaque_quads(true);
+  UseTileResource(SK_ColorBLUE);
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+// The compositing kernels blend the translucent tiles.
+TEST_F(SoftwareRendererPerfTest, TilesFullDamage) {
+  UseTileResource(SkColorSetARGB(128, 0, 255, 0));
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
+TEST_F(SoftwareRendererPerfTest, TilesFullDamageKernels) {
+  renderer()->SetUseCompositingKernels(true);
+  UseTileResource(SkColorSetARGB(128, 0, 255, 0));
+  RunQuadGrid(kSurfaceRect, gfx::Vector2d());
+}
+
 }  // namespace viz
@@ -4167,6 +4167,210 @@ TEST_F(SoftwareRendererPixelTest, TextureDrawQuadLinear) {
       cc::FuzzyPixelComparator(false, 100.f, 0.f, 16.f, 16.f, 0.f)));
 }
 
+// Returns |a| * |b| / 255 rounded to the nearest integer, which is how the
+// compositing kernels multiply.
+uint32_t MulDiv255(uint32_t a, uint32_t b) {
+  return (a * b + 127) / 255;
+}
+
+// Blends |src| scaled by |alpha| over |dst| like the compositing kernels.
+SkPMColor BlendPMColor(SkPMColor src, uint8_t alpha, SkPMColor dst) {
+  uint32_t inverse_alpha = 255 - MulDiv255(SkGetPackedA32(src), alpha);
+  SkPMColor result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t channel = MulDiv255((src >> shift) & 0xff, alpha) +
+                       MulDiv255((dst >> shift) & 0xff, inverse_alpha);
+    result |= std::min(channel, 255u) << shift;
+  }
+  return result;
+}
+
+// A bitmap whose pixels vary with their position. Their alphas cover every
+// value over a few rows unless |opaque| is set.
+SkBitmap MakeKernelTestBitmap(const gfx::Size& size, bool opaque) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(size.width(), size.height());
+  for (int y = 0; y < size.height(); ++y) {
+    for (int x = 0; x < size.width(); ++x) {
+      U8CPU alpha = opaque ? 255 : (x * 37 + y * 11) & 0xff;
+      *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(
+          alpha, (x * 3) & 0xff, (y * 5) & 0xff, (x + y) & 0xff);
+    }
+  }
+  return bitmap;
+}
+
+// Draws tile, texture and solid color quads that the compositing kernels
+// handle, first with Skia and then with the kernels.
+class SoftwareRendererCompositingKernelsPixelTest
+    : public SoftwareRendererPixelTest {
+ public:
+  SoftwareRendererCompositingKernelsPixelTest()
+      : expected_pixels_(device_viewport_size_.GetArea(),
+                         SkPreMultiplyColor(kBackgroundColor)) {}
+
+ protected:
+  // The quads are drawn over an opaque green background.
+  static constexpr SkColor kBackgroundColor = SK_ColorGREEN;
+
+  ResourceId MapResource(const SkBitmap& bitmap) {
+    ResourceId resource = this->AllocateAndFillSoftwareResource(
+        gfx::Size(bitmap.width(), bitmap.height()), bitmap);
+    std::unordered_map<ResourceId, ResourceId, ResourceIdHasher> resource_map =
+        cc::SendResourceAndGetChildToParentMap(
+            {resource}, this->resource_provider_.get(),
+            this->child_resource_provider_.get(),
+            this->child_context_provider_.get());
+    return resource_map[resource];
+  }
+
+  std::unique_ptr<AggregatedRenderPass> CreatePass() {
+    return CreateTestRenderPass(AggregatedRenderPassId{1},
+                                gfx::Rect(device_viewport_size_),
+                                gfx::Transform());
+  }
+
+  // Appends a tile quad that draws |visible_rect| of |bitmap| at |origin|.
+  void AppendTileQuad(AggregatedRenderPass* pass,
+                      const SkBitmap& bitmap,
+                      ResourceId resource,
+                      const gfx::Point& origin,
+                      const gfx::Rect& visible_rect,
+                      float opacity) {
+    gfx::Rect rect(bitmap.width(), bitmap.height());
+    auto* quad = pass->CreateAndAppendDrawQuad<TileDrawQuad>();
+    quad->SetNew(CreateSharedState(pass, origin, rect.size(), opacity), rect,
+                 visible_rect, /*needs_blending=*/true, resource,
+                 gfx::RectF(rect), rect.size(),
+                 /*contents_premultiplied=*/true, /*nearest_neighbor=*/false,
+                 /*force_anti_aliasing_off=*/false);
+    AppendExpectedPixels(bitmap, origin, visible_rect, opacity);
+  }
+
+  void AppendTextureQuad(AggregatedRenderPass* pass,
+                         const SkBitmap& bitmap,
+                         ResourceId resource,
+                         const gfx::Point& origin,
+                         float opacity) {
+    gfx::Rect rect(bitmap.width(), bitmap.height());
+    float vertex_opacity[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    auto* quad = pass->CreateAndAppendDrawQuad<TextureDrawQuad>();
+    quad->SetNew(CreateSharedState(pass, origin, rect.size(), opacity), rect,
+                 rect, /*needs_blending=*/true, resource,
+                 /*premultiplied_alpha=*/true, gfx::PointF(0, 0),
+                 gfx::PointF(1, 1), SK_ColorTRANSPARENT, vertex_opacity,
+                 /*y_flipped=*/false, /*nearest_neighbor=*/false,
+                 /*secure_output_only=*/false,
+                 gfx::ProtectedVideoType::kClear);
+    AppendExpectedPixels(bitmap, origin, rect, opacity);
+  }
+
+  void AppendSolidColorQuad(AggregatedRenderPass* pass,
+                            const gfx::Rect& target_rect,
+                            SkColor color) {
+    gfx::Rect rect(target_rect.size());
+    auto* quad = pass->CreateAndAppendDrawQuad<SolidColorDrawQuad>();
+    quad->SetNew(
+        CreateSharedState(pass, target_rect.origin(), rect.size(), 1.f), rect,
+        rect, color, /*force_anti_aliasing_off=*/false);
+    for (int y = target_rect.y(); y < target_rect.bottom(); ++y) {
+      for (int x = target_rect.x(); x < target_rect.right(); ++x)
+        ExpectedPixel(x, y) = SkPreMultiplyColor(color);
+    }
+  }
+
+  // Appends the background, which is drawn before the other quads.
+  void AppendBackgroundQuad(AggregatedRenderPass* pass) {
+    gfx::Rect rect(device_viewport_size_);
+    auto* quad = pass->CreateAndAppendDrawQuad<SolidColorDrawQuad>();
+    quad->SetNew(CreateSharedState(pass, gfx::Point(), rect.size(), 1.f), rect,
+                 rect, kBackgroundColor, /*force_anti_aliasing_off=*/false);
+  }
+
+  // Draws |pass| with Skia and with the kernels, and compares both outputs to
+  // the pixels expected from the kernels.
+  void DrawAndCompare(const AggregatedRenderPass& pass,
+                      const cc::PixelComparator& skia_comparator) {
+    AggregatedRenderPassList pass_list;
+    pass_list.push_back(pass.DeepCopy());
+    software_renderer_->SetUseCompositingKernels(false);
+    EXPECT_TRUE(
+        this->RunPixelTest(&pass_list, &expected_pixels_, skia_comparator));
+
+    pass_list.clear();
+    pass_list.push_back(pass.DeepCopy());
+    software_renderer_->SetUseCompositingKernels(true);
+    EXPECT_TRUE(this->RunPixelTest(&pass_list, &expected_pixels_,
+                                   cc::ExactPixelComparator(true)));
+  }
+
+ private:
+  SharedQuadState* CreateSharedState(AggregatedRenderPass* pass,
+                                     const gfx::Point& origin,
+                                     const gfx::Size& size,
+                                     float opacity) {
+    gfx::Transform quad_to_target_transform;
+    quad_to_target_transform.Translate(origin.x(), origin.y());
+    SharedQuadState* shared_state = CreateTestSharedQuadState(
+        quad_to_target_transform, gfx::Rect(size), pass, gfx::RRectF());
+    shared_state->opacity = opacity;
+    return shared_state;
+  }
+
+  SkColor& ExpectedPixel(int x, int y) {
+    return expected_pixels_[y * device_viewport_size_.width() + x];
+  }
+
+  // The quads do not overlap, so each one is blended over the background.
+  void AppendExpectedPixels(const SkBitmap& bitmap,
+                            const gfx::Point& origin,
+                            const gfx::Rect& visible_rect,
+                            float opacity) {
+    // The renderer truncates the alpha of the paint.
+    uint8_t alpha = opacity * 255;
+    for (int y = visible_rect.y(); y < visible_rect.bottom(); ++y) {
+      for (int x = visible_rect.x(); x < visible_rect.right(); ++x) {
+        SkColor& pixel = ExpectedPixel(origin.x() + x, origin.y() + y);
+        pixel = BlendPMColor(*bitmap.getAddr32(x, y), alpha, pixel);
+      }
+    }
+  }
+
+  // Premultiplied N32 pixels, as RunPixelTest() reads them.
+  std::vector<SkColor> expected_pixels_;
+};
+
+// Opaque quads are filled and copied, which gives the same pixels as Skia.
+TEST_F(SoftwareRendererCompositingKernelsPixelTest, OpaqueQuads) {
+  // Odd sizes leave pixels for the tails of the vector loops.
+  SkBitmap bitmap = MakeKernelTestBitmap(gfx::Size(67, 45), /*opaque=*/true);
+  ResourceId resource = MapResource(bitmap);
+
+  auto pass = CreatePass();
+  AppendTileQuad(pass.get(), bitmap, resource, gfx::Point(21, 13),
+                 gfx::Rect(3, 2, 61, 41), 1.f);
+  AppendTextureQuad(pass.get(), bitmap, resource, gfx::Point(110, 90), 1.f);
+  AppendSolidColorQuad(pass.get(), gfx::Rect(40, 141, 51, 37), SK_ColorRED);
+  AppendBackgroundQuad(pass.get());
+
+  DrawAndCompare(*pass, cc::ExactPixelComparator(true));
+}
+
+// Translucent quads are blended. Skia rounds some of the products differently,
+// so its output may differ by one.
+TEST_F(SoftwareRendererCompositingKernelsPixelTest, TranslucentQuads) {
+  SkBitmap bitmap = MakeKernelTestBitmap(gfx::Size(67, 45), /*opaque=*/false);
+  ResourceId resource = MapResource(bitmap);
+
+  auto pass = CreatePass();
+  AppendTileQuad(pass.get(), bitmap, resource, gfx::Point(21, 13),
+                 gfx::Rect(3, 2, 61, 41), 0.5f);
+  AppendTextureQuad(pass.get(), bitmap, resource, gfx::Point(110, 90), 1.f);
+  AppendBackgroundQuad(pass.get());
+
+  DrawAndCompare(*pass, cc::FuzzyPixelComparator(true, 100.f, 0.f, 1.f, 1, 0));
+}
+
 TEST_F(SoftwareRendererPixelTest, PictureDrawQuadNonIdentityScale) {
   gfx::Rect viewport(this->device_viewport_size_);
   // TODO(enne): the renderer should figure this out on its own.
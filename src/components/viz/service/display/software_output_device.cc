@@ -15,6 +15,13 @@
 
 namespace viz {
 
+namespace {
+
+// Buffers older than this are treated as if their contents were undefined.
+constexpr size_t kMaxDamageHistorySize = 4;
+
+}  // namespace
+
 SoftwareOutputDevice::SoftwareOutputDevice()
     : SoftwareOutputDevice(base::SequencedTaskRunnerHandle::Get()) {}
 
@@ -48,7 +55,11 @@ SkCanvas* SoftwareOutputDevice::BeginPaint(const gfx::Rect& damage_rect) {
   return surface_ ? surface_->getCanvas() : nullptr;
 }
 
-void SoftwareOutputDevice::EndPaint() {}
+void SoftwareOutputDevice::EndPaint() {
+  damage_history_.push_front(damage_rect_);
+  if (damage_history_.size() > kMaxDamageHistorySize)
+    damage_history_.pop_back();
+}
 
 gfx::VSyncProvider* SoftwareOutputDevice::GetVSyncProvider() {
   return vsync_provider_.get();
@@ -64,4 +75,24 @@ int SoftwareOutputDevice::MaxFramesPending() const {
   return 1;
 }
 
+int SoftwareOutputDevice::GetBufferAge() const {
+  return 1;
+}
+
+gfx::Rect SoftwareOutputDevice::GetCurrentFramebufferDamage() const {
+  gfx::Rect viewport_rect(viewport_pixel_size_);
+  int buffer_age = GetBufferAge();
+  if (buffer_age <= 0 ||
+      static_cast<size_t>(buffer_age - 1) > damage_history_.size()) {
+    return viewport_rect;
+  }
+
+  // The buffer misses the damage of every frame presented after it.
+  gfx::Rect damage;
+  for (int i = 0; i < buffer_age - 1; ++i)
+    damage.Union(damage_history_[i]);
+  damage.Intersect(viewport_rect);
+  return damage;
+}
+
 }  // namespace viz
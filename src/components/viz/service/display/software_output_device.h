@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "base/callback.h"
+#include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "base/sequenced_task_runner.h"
 #include "components/viz/service/display/software_output_device_client.h"
@@ -75,6 +76,17 @@ class VIZ_SERVICE_EXPORT SoftwareOutputDevice {
 
   virtual int MaxFramesPending() const;
 
+  // Returns the number of frames since the contents of the buffer that
+  // BeginPaint() returns for the current frame were presented, or 0 if they
+  // are undefined. The default implementation draws into a single retained
+  // buffer, which always holds the previous frame.
+  virtual int GetBufferAge() const;
+
+  // Returns the part of the buffer of the current frame that is out of date,
+  // from GetBufferAge() and the damage of the frames presented since. It has
+  // to be redrawn along with |damage_rect| of BeginPaint().
+  gfx::Rect GetCurrentFramebufferDamage() const;
+
  protected:
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   SoftwareOutputDeviceClient* client_ = nullptr;
@@ -84,6 +96,9 @@ class VIZ_SERVICE_EXPORT SoftwareOutputDevice {
   std::unique_ptr<gfx::VSyncProvider> vsync_provider_;
 
  private:
+  // The damage of the most recently presented frames, newest first.
+  base::circular_deque<gfx::Rect> damage_history_;
+
   DISALLOW_COPY_AND_ASSIGN(SoftwareOutputDevice);
 };
 
@@ -4,16 +4,20 @@
 
 #include "components/viz/service/display/software_renderer.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/process/memory.h"
 #include "base/trace_event/trace_event.h"
 #include "cc/base/math_util.h"
+#include "cc/base/parallel_for.h"
 #include "cc/paint/image_provider.h"
 #include "cc/paint/render_surface_filters.h"
 #include "components/viz/common/display/renderer_settings.h"
+#include "components/viz/common/features.h"
 #include "components/viz/common/frame_sinks/copy_output_request.h"
 #include "components/viz/common/frame_sinks/copy_output_util.h"
 #include "components/viz/common/quads/aggregated_render_pass_draw_quad.h"
@@ -34,12 +38,16 @@
 #include "skia/ext/opacity_filter_canvas.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/core/SkPoint.h"
 #include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/effects/SkShaderMaskFilter.h"
+#include "ui/gfx/blit.h"
 #include "ui/gfx/geometry/axis_transform2d.h"
 #include "ui/gfx/geometry/rect_conversions.h"
 #include "ui/gfx/skia_util.h"
@@ -47,6 +55,14 @@
 
 namespace viz {
 namespace {
+
+// The root render pass is only drawn in parallel when this many pixels of the
+// output are damaged, as recording it costs more than the playback saves on
+// smaller damage.
+constexpr int kMinParallelDrawArea = 256 * 256;
+// The fewest rows of pixels that a band of the parallel playback covers.
+constexpr int kMinParallelDrawBandHeight = 64;
+
 class AnimatedImagesProvider : public cc::ImageProvider {
  public:
   AnimatedImagesProvider(
@@ -74,6 +90,47 @@ class AnimatedImagesProvider : public cc::ImageProvider {
   const PictureDrawQuad::ImageAnimationMap* image_animation_map_;
 };
 
+// Plays a picture back into horizontal bands of a rect of a pixmap, on several
+// threads at once. The bands cover disjoint rows of pixels, so no two threads
+// write the same pixels.
+class BandedPicturePlayback {
+ public:
+  BandedPicturePlayback(const SkPicture* picture,
+                        const SkPixmap& pixmap,
+                        const gfx::Rect& rect,
+                        int band_count)
+      : picture_(picture),
+        pixmap_(pixmap),
+        rect_(rect),
+        band_count_(band_count) {}
+  BandedPicturePlayback(const BandedPicturePlayback&) = delete;
+  BandedPicturePlayback& operator=(const BandedPicturePlayback&) = delete;
+
+  void Run(int max_threads) {
+    cc::ParallelFor(band_count_, max_threads,
+                    base::BindRepeating(&BandedPicturePlayback::PlaybackBand,
+                                        base::Unretained(this)));
+  }
+
+ private:
+  void PlaybackBand(size_t band) const {
+    TRACE_EVENT0("viz", "SoftwareRenderer::PlaybackBand");
+    int top = rect_.y() + rect_.height() * static_cast<int>(band) / band_count_;
+    int bottom =
+        rect_.y() + rect_.height() * static_cast<int>(band + 1) / band_count_;
+    SkSurfaceProps props = skia::LegacyDisplayGlobals::GetSkSurfaceProps();
+    std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+        pixmap_.info(), pixmap_.writable_addr(), pixmap_.rowBytes(), &props);
+    canvas->clipRect(SkRect::MakeLTRB(rect_.x(), top, rect_.right(), bottom));
+    canvas->drawPicture(picture_);
+  }
+
+  const SkPicture* const picture_;
+  const SkPixmap pixmap_;
+  const gfx::Rect rect_;
+  const int band_count_;
+};
+
 }  // namespace
 
 SoftwareRenderer::SoftwareRenderer(
@@ -87,7 +144,11 @@ SoftwareRenderer::SoftwareRenderer(
                      output_surface,
                      resource_provider,
                      overlay_processor),
-      output_device_(output_surface->software_device()) {}
+      output_device_(output_surface->software_device()) {
+  if (features::IsSoftwareRendererParallelDrawEnabled())
+    max_draw_threads_ = features::kSoftwareRendererParallelDrawMaxThreads.Get();
+  use_compositing_kernels_ = features::IsSoftwareCompositingKernelsEnabled();
+}
 
 SoftwareRenderer::~SoftwareRenderer() {}
 
@@ -104,6 +165,8 @@ void SoftwareRenderer::FinishDrawingFrame() {
   current_framebuffer_canvas_.reset();
   current_canvas_ = nullptr;
 
+  if (root_recorder_)
+    PlaybackRootRenderPass();
   if (root_canvas_)
     output_device_->EndPaint();
   root_canvas_ = nullptr;
@@ -140,6 +203,60 @@ void SoftwareRenderer::BindFramebufferToOutputSurface() {
   if (!root_canvas_)
     output_device_->EndPaint();
   current_canvas_ = root_canvas_;
+
+  if (root_canvas_ && ShouldRecordRootRenderPass()) {
+    // The recording canvas has the size of the output, so that the quads are
+    // clipped the same as when they are drawn into |root_canvas_|.
+    root_recorder_ = std::make_unique<SkPictureRecorder>();
+    current_canvas_ = root_recorder_->beginRecording(
+        SkRect::MakeIWH(root_canvas_->imageInfo().width(),
+                        root_canvas_->imageInfo().height()));
+  }
+}
+
+bool SoftwareRenderer::ShouldRecordRootRenderPass() {
+  if (max_draw_threads_ <= 1)
+    return false;
+
+  // Copy requests and backdrop filters read the output back while it is
+  // drawn, which a recording can not provide.
+  if (!current_frame()->root_render_pass->copy_requests.empty() ||
+      !render_pass_backdrop_filters_.empty()) {
+    return false;
+  }
+
+  // The playback draws into the pixels of |root_canvas_| directly, so it must
+  // not be transformed or clipped by the output device.
+  SkPixmap pixmap;
+  if (!root_canvas_->peekPixels(&pixmap) ||
+      !root_canvas_->getTotalMatrix().isIdentity() ||
+      root_canvas_->getDeviceClipBounds() !=
+          SkIRect::MakeWH(pixmap.width(), pixmap.height())) {
+    return false;
+  }
+
+  // Besides the damage of this frame, the pixels that the buffer of the output
+  // misses from the previous frames are drawn.
+  root_draw_rect_ = current_frame()->root_damage_rect;
+  root_draw_rect_.Union(output_surface_->GetCurrentFramebufferDamage());
+  root_draw_rect_.Intersect(gfx::Rect(pixmap.width(), pixmap.height()));
+  return root_draw_rect_.height() >= 2 * kMinParallelDrawBandHeight &&
+         root_draw_rect_.size().GetArea() >= kMinParallelDrawArea;
+}
+
+void SoftwareRenderer::PlaybackRootRenderPass() {
+  TRACE_EVENT0("viz", "SoftwareRenderer::PlaybackRootRenderPass");
+  sk_sp<SkPicture> picture = root_recorder_->finishRecordingAsPicture();
+  root_recorder_.reset();
+
+  SkPixmap pixmap;
+  bool has_pixels = root_canvas_->peekPixels(&pixmap);
+  DCHECK(has_pixels);
+
+  int band_count = std::min(
+      max_draw_threads_, root_draw_rect_.height() / kMinParallelDrawBandHeight);
+  BandedPicturePlayback(picture.get(), pixmap, root_draw_rect_, band_count)
+      .Run(max_draw_threads_);
 }
 
 void SoftwareRenderer::BindFramebufferToTexture(
@@ -363,6 +480,81 @@ void SoftwareRenderer::DoDrawQuad(const DrawQuad* quad,
   current_canvas_->resetMatrix();
 }
 
+bool SoftwareRenderer::GetCompositingKernelTarget(const gfx::RectF& rect,
+                                                  SkPixmap* pixmap,
+                                                  gfx::Rect* device_rect,
+                                                  gfx::Rect* clipped_rect) {
+  if (!use_compositing_kernels_)
+    return false;
+  SkMatrix matrix = current_canvas_->getTotalMatrix();
+  if (!matrix.isScaleTranslate() || matrix.getScaleX() < 0 ||
+      matrix.getScaleY() < 0) {
+    return false;
+  }
+  // Rounded corners and draw regions leave a clip that is not a rect. The
+  // canvas of the recorded root render pass has no pixels.
+  if (!current_canvas_->isClipRect() || !current_canvas_->peekPixels(pixmap))
+    return false;
+  if (pixmap->colorType() != kN32_SkColorType ||
+      pixmap->alphaType() == kUnpremul_SkAlphaType) {
+    return false;
+  }
+
+  SkRect mapped_rect = matrix.mapRect(gfx::RectFToSkRect(rect));
+  SkIRect pixel_rect = mapped_rect.round();
+  if (SkRect::Make(pixel_rect) != mapped_rect)
+    return false;
+  *device_rect = gfx::SkIRectToRect(pixel_rect);
+  *clipped_rect = gfx::IntersectRects(
+      *device_rect, gfx::SkIRectToRect(current_canvas_->getDeviceClipBounds()));
+  return true;
+}
+
+bool SoftwareRenderer::DrawImageWithCompositingKernel(
+    const SkImage* image,
+    const gfx::RectF& visible_uv_rect,
+    const gfx::RectF& visible_quad_vertex_rect) {
+  const U8CPU alpha = current_paint_.getAlpha();
+  const SkBlendMode blend_mode = current_paint_.getBlendMode();
+  // Copying gives the same pixels as blending an opaque image at full alpha.
+  const bool copy = alpha == 0xFF && (blend_mode == SkBlendMode::kSrc ||
+                                      (blend_mode == SkBlendMode::kSrcOver &&
+                                       image->isOpaque()));
+  if (!copy && blend_mode != SkBlendMode::kSrcOver)
+    return false;
+
+  SkPixmap src;
+  if (!image->peekPixels(&src) || src.colorType() != kN32_SkColorType ||
+      src.alphaType() == kUnpremul_SkAlphaType) {
+    return false;
+  }
+  // The image is only sampled at whole pixels when it maps 1:1 to the device.
+  gfx::Rect uv_rect = gfx::ToEnclosingRect(visible_uv_rect);
+  if (gfx::RectF(uv_rect) != visible_uv_rect ||
+      !gfx::Rect(src.width(), src.height()).Contains(uv_rect)) {
+    return false;
+  }
+
+  SkPixmap dst;
+  gfx::Rect device_rect;
+  gfx::Rect clipped_rect;
+  if (!GetCompositingKernelTarget(visible_quad_vertex_rect, &dst, &device_rect,
+                                  &clipped_rect) ||
+      device_rect.size() != uv_rect.size() ||
+      !SkColorSpace::Equals(src.colorSpace(), dst.colorSpace())) {
+    return false;
+  }
+
+  gfx::Point src_origin =
+      uv_rect.origin() + (clipped_rect.origin() - device_rect.origin());
+  if (copy) {
+    gfx::CopyPixels(src, src_origin, &dst, clipped_rect);
+  } else {
+    gfx::BlendPixels(src, src_origin, alpha, &dst, clipped_rect);
+  }
+  return true;
+}
+
 void SoftwareRenderer::DrawDebugBorderQuad(const DebugBorderDrawQuad* quad) {
   // We need to apply the matrix manually to have pixel-sized stroke width.
   SkPoint vertices[4];
@@ -428,6 +620,21 @@ void SoftwareRenderer::DrawSolidColorQuad(const SolidColorDrawQuad* quad) {
   current_paint_.setColor(quad->color);
   current_paint_.setAlpha(quad->shared_quad_state->opacity *
                           SkColorGetA(quad->color));
+
+  // An opaque color replaces the pixels under both blend modes.
+  SkPixmap pixmap;
+  gfx::Rect device_rect;
+  gfx::Rect clipped_rect;
+  if (current_paint_.getAlpha() == 0xFF &&
+      (current_paint_.getBlendMode() == SkBlendMode::kSrc ||
+       current_paint_.getBlendMode() == SkBlendMode::kSrcOver) &&
+      GetCompositingKernelTarget(visible_quad_vertex_rect, &pixmap,
+                                 &device_rect, &clipped_rect) &&
+      (!pixmap.colorSpace() || pixmap.colorSpace()->isSRGB())) {
+    gfx::FillPixels(&pixmap, clipped_rect,
+                    SkPreMultiplyColor(current_paint_.getColor()));
+    return;
+  }
   current_canvas_->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect),
                             current_paint_);
 }
@@ -454,11 +661,17 @@ void SoftwareRenderer::DrawTextureQuad(const TextureDrawQuad* quad) {
       QuadVertexRect(), gfx::RectF(quad->rect), gfx::RectF(quad->visible_rect));
   SkRect quad_rect = gfx::RectFToSkRect(visible_quad_vertex_rect);
 
+  bool blend_background =
+      quad->background_color != SK_ColorTRANSPARENT && !image->isOpaque();
+  if (!quad->y_flipped && !blend_background &&
+      DrawImageWithCompositingKernel(image, visible_uv_rect,
+                                     visible_quad_vertex_rect)) {
+    return;
+  }
+
   if (quad->y_flipped)
     current_canvas_->scale(1, -1);
 
-  bool blend_background =
-      quad->background_color != SK_ColorTRANSPARENT && !image->isOpaque();
   bool needs_layer = blend_background && (current_paint_.getAlpha() != 0xFF);
   if (needs_layer) {
     current_canvas_->saveLayerAlpha(&quad_rect, current_paint_.getAlpha());
@@ -494,6 +707,10 @@ void SoftwareRenderer::DrawTileQuad(const TileDrawQuad* quad) {
       gfx::RectF(quad->visible_rect));
   gfx::RectF visible_quad_vertex_rect = cc::MathUtil::ScaleRectProportional(
       QuadVertexRect(), gfx::RectF(quad->rect), gfx::RectF(quad->visible_rect));
+  if (DrawImageWithCompositingKernel(lock.sk_image(), visible_tex_coord_rect,
+                                     visible_quad_vertex_rect)) {
+    return;
+  }
 
   SkRect uv_rect = gfx::RectFToSkRect(visible_tex_coord_rect);
   SkSamplingOptions sampling(quad->nearest_neighbor ? SkFilterMode::kNearest
@@ -14,8 +14,11 @@
 #include "components/viz/service/display/direct_renderer.h"
 #include "components/viz/service/display/display_resource_provider_software.h"
 #include "components/viz/service/viz_service_export.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "ui/latency/latency_info.h"
 
+class SkPixmap;
+
 namespace viz {
 class DebugBorderDrawQuad;
 class OutputSurface;
@@ -42,6 +45,20 @@ class VIZ_SERVICE_EXPORT SoftwareRenderer : public DirectRenderer {
     disable_picture_quad_image_filtering_ = disable;
   }
 
+  // Sets the most threads, including the calling thread, that draw the root
+  // render pass when a large part of the output is damaged. The root render
+  // pass is then recorded and played back into horizontal bands of the output
+  // in parallel. With 1, it is drawn directly into the output.
+  void SetMaxDrawThreads(int max_draw_threads) {
+    max_draw_threads_ = max_draw_threads;
+  }
+
+  // Sets whether solid color, tile and texture quads that map to whole device
+  // pixels are drawn with the compositing kernels of ui/gfx/blit.h.
+  void SetUseCompositingKernels(bool use_compositing_kernels) {
+    use_compositing_kernels_ = use_compositing_kernels;
+  }
+
  protected:
   bool CanPartialSwap() override;
   void UpdateRenderPassTextures(
@@ -79,6 +96,26 @@ class VIZ_SERVICE_EXPORT SoftwareRenderer : public DirectRenderer {
   void SetClipRRect(const gfx::RRectF& rrect);
   bool IsSoftwareResource(ResourceId resource_id);
 
+  // Returns true if the root render pass should be recorded for parallel
+  // playback into |root_canvas_|, and sets |root_draw_rect_|.
+  bool ShouldRecordRootRenderPass();
+  void PlaybackRootRenderPass();
+
+  // Returns true if |rect|, in the space of the quad being drawn, maps to whole
+  // pixels of |current_canvas_| that the compositing kernels can draw to. Sets
+  // |pixmap| to the pixels, |device_rect| to the rect that |rect| maps to and
+  // |clipped_rect| to the part of it within the clip.
+  bool GetCompositingKernelTarget(const gfx::RectF& rect,
+                                  SkPixmap* pixmap,
+                                  gfx::Rect* device_rect,
+                                  gfx::Rect* clipped_rect);
+  // Draws |visible_uv_rect| of |image| into |visible_quad_vertex_rect| with
+  // |current_paint_| if the compositing kernels can. Returns false otherwise.
+  bool DrawImageWithCompositingKernel(
+      const SkImage* image,
+      const gfx::RectF& visible_uv_rect,
+      const gfx::RectF& visible_quad_vertex_rect);
+
   void DrawDebugBorderQuad(const DebugBorderDrawQuad* quad);
   void DrawPictureQuad(const PictureDrawQuad* quad);
   void DrawRenderPassQuad(const AggregatedRenderPassDrawQuad* quad);
@@ -116,12 +153,18 @@ class VIZ_SERVICE_EXPORT SoftwareRenderer : public DirectRenderer {
   base::flat_map<AggregatedRenderPassId, SkBitmap> render_pass_bitmaps_;
 
   bool disable_picture_quad_image_filtering_ = false;
+  int max_draw_threads_ = 1;
+  bool use_compositing_kernels_ = false;
 
   bool is_scissor_enabled_ = false;
   gfx::Rect scissor_rect_;
 
   SoftwareOutputDevice* output_device_;
   SkCanvas* root_canvas_ = nullptr;
+  // Records the root render pass while it is drawn for parallel playback into
+  // |root_draw_rect_| of |root_canvas_|.
+  std::unique_ptr<SkPictureRecorder> root_recorder_;
+  gfx::Rect root_draw_rect_;
   SkCanvas* current_canvas_ = nullptr;
   SkPaint current_paint_;
   std::unique_ptr<SkCanvas> current_framebuffer_canvas_;
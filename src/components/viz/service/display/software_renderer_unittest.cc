@@ -572,5 +572,63 @@ TEST_F(SoftwareRendererTest, PartialSwap) {
   }
 }
 
+class ReadbackSoftwareOutputDevice : public SoftwareOutputDevice {
+ public:
+  // SoftwareOutputDevice overrides.
+  void EndPaint() override {
+    SoftwareOutputDevice::EndPaint();
+    output_.allocN32Pixels(viewport_pixel_size_.width(),
+                           viewport_pixel_size_.height());
+    surface_->readPixels(output_, 0, 0);
+  }
+
+  const SkBitmap& output() const { return output_; }
+
+ private:
+  SkBitmap output_;
+};
+
+TEST_F(SoftwareRendererTest, ParallelDraw) {
+  float device_scale_factor = 1.f;
+  gfx::Size viewport_size(300, 300);
+
+  auto device_owned = std::make_unique<ReadbackSoftwareOutputDevice>();
+  auto* device = device_owned.get();
+  InitializeRenderer(std::move(device_owned));
+  renderer()->SetMaxDrawThreads(4);
+
+  // The damage is large enough for the root render pass to be played back in
+  // four bands, which the inner quad crosses.
+  AggregatedRenderPassList list;
+  AggregatedRenderPassId root_pass_id{1};
+  SurfaceDamageRectList surface_damage_rect_list;
+  auto* root_pass =
+      cc::AddRenderPass(&list, root_pass_id, gfx::Rect(viewport_size),
+                        gfx::Transform(), cc::FilterOperations());
+  gfx::Rect inner_rect(50, 50, 200, 200);
+  cc::AddQuad(root_pass, inner_rect, SK_ColorCYAN);
+  cc::AddQuad(root_pass, gfx::Rect(viewport_size), SK_ColorYELLOW);
+
+  renderer()->DecideRenderPassAllocationsForFrame(list);
+  renderer()->DrawFrame(&list, device_scale_factor, viewport_size,
+                        gfx::DisplayColorSpaces(),
+                        std::move(surface_damage_rect_list));
+
+  const SkBitmap& output = device->output();
+  ASSERT_EQ(viewport_size.width(), output.width());
+  ASSERT_EQ(viewport_size.height(), output.height());
+  for (int y = 0; y < viewport_size.height(); ++y) {
+    SkColor expected_color =
+        inner_rect.Contains(150, y) ? SK_ColorCYAN : SK_ColorYELLOW;
+    EXPECT_EQ(expected_color, output.getColor(150, y)) << y;
+  }
+  EXPECT_EQ(SK_ColorYELLOW, output.getColor(0, 0));
+  EXPECT_EQ(SK_ColorYELLOW, output.getColor(viewport_size.width() - 1,
+                                            viewport_size.height() - 1));
+  EXPECT_EQ(SK_ColorCYAN, output.getColor(inner_rect.x(), inner_rect.y()));
+  EXPECT_EQ(SK_ColorCYAN,
+            output.getColor(inner_rect.right() - 1, inner_rect.bottom() - 1));
+}
+
 }  // namespace
 }  // namespace viz
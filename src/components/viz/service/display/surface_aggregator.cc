@@ -20,6 +20,7 @@
 #include "base/timer/elapsed_timer.h"
 #include "base/trace_event/trace_event.h"
 #include "cc/base/math_util.h"
+#include "cc/base/parallel_for.h"
 #include "components/viz/common/display/de_jelly.h"
 #include "components/viz/common/quads/aggregated_render_pass.h"
 #include "components/viz/common/quads/aggregated_render_pass_draw_quad.h"
@@ -95,6 +96,90 @@ gfx::Rect GetExpandedRectWithPixelMovingForegroundFilter(
       shared_quad_state->quad_to_target_transform, expanded_rect);
 }
 
+// The fewest quads to copy for the copies to be split between threads.
+constexpr size_t kMinQuadsForParallelCopy = 256;
+
+bool SharedQuadStatesMatch(const SharedQuadState& a, const SharedQuadState& b) {
+  return a.quad_to_target_transform == b.quad_to_target_transform &&
+         a.quad_layer_rect == b.quad_layer_rect &&
+         a.visible_quad_layer_rect == b.visible_quad_layer_rect &&
+         a.mask_filter_info == b.mask_filter_info &&
+         a.clip_rect == b.clip_rect && a.is_clipped == b.is_clipped &&
+         a.are_contents_opaque == b.are_contents_opaque &&
+         a.opacity == b.opacity && a.blend_mode == b.blend_mode &&
+         a.sorting_context_id == b.sorting_context_id &&
+         a.is_fast_rounded_corner == b.is_fast_rounded_corner &&
+         a.de_jelly_delta_y == b.de_jelly_delta_y;
+}
+
+// Appends copies of |quads| and of the shared quad states they use to
+// |dest_pass|. The quads must be in the order of their shared quad states.
+// Overlay damage indices are moved from |from_damage_index| to
+// |to_damage_index|. If |cull_rect| is set, quads other than render pass quads
+// that do not intersect it are left out, like CopyQuadsToPass() does with the
+// root damage rect.
+template <typename QuadRange>
+void CopyQuadsAndSharedQuadStates(const QuadRange& quads,
+                                  size_t from_damage_index,
+                                  size_t to_damage_index,
+                                  const base::Optional<gfx::Rect>& cull_rect,
+                                  AggregatedRenderPass* dest_pass) {
+  const SharedQuadState* last_source_sqs = nullptr;
+  gfx::Rect damage_rect_in_quad_space;
+  bool damage_rect_in_quad_space_valid = false;
+  for (const DrawQuad* quad : quads) {
+    if (quad->shared_quad_state != last_source_sqs) {
+      last_source_sqs = quad->shared_quad_state;
+      SharedQuadState* sqs = dest_pass->CreateAndAppendSharedQuadState();
+      *sqs = *last_source_sqs;
+      if (sqs->overlay_damage_index) {
+        DCHECK_GE(*sqs->overlay_damage_index, from_damage_index);
+        sqs->overlay_damage_index =
+            *sqs->overlay_damage_index - from_damage_index + to_damage_index;
+      }
+      if (cull_rect) {
+        damage_rect_in_quad_space_valid = CalculateQuadSpaceDamageRect(
+            sqs->quad_to_target_transform, dest_pass->transform_to_root_target,
+            *cull_rect, &damage_rect_in_quad_space);
+      }
+    }
+
+    if (quad->material == DrawQuad::Material::kAggregatedRenderPass) {
+      dest_pass->CopyFromAndAppendRenderPassDrawQuad(
+          AggregatedRenderPassDrawQuad::MaterialCast(quad));
+      continue;
+    }
+    if (cull_rect && damage_rect_in_quad_space_valid &&
+        !damage_rect_in_quad_space.Intersects(quad->visible_rect)) {
+      continue;
+    }
+    dest_pass->CopyFromAndAppendDrawQuad(quad);
+  }
+}
+
+// Fills |dest_pass|, made by |source_pass|->Copy(), with the content of
+// |source_pass|.
+void CopyRenderPassContent(const AggregatedRenderPass* source_pass,
+                           size_t damage_index,
+                           base::Optional<gfx::Rect> cull_rect,
+                           AggregatedRenderPass* dest_pass) {
+  CopyQuadsAndSharedQuadStates(source_pass->quad_list, 0, damage_index,
+                               cull_rect, dest_pass);
+}
+
+void RunPendingTask(std::vector<base::OnceClosure>* tasks, size_t index) {
+  if ((*tasks)[index])
+    std::move((*tasks)[index]).Run();
+}
+
+// Runs the tasks of a list that have not run yet on up to |max_workers|
+// threads, including the calling one, and returns once they all have.
+void RunPendingTasks(std::vector<base::OnceClosure>* tasks, int max_workers) {
+  cc::ParallelFor(
+      tasks->size(), max_workers,
+      base::BindRepeating(&RunPendingTask, base::Unretained(tasks)));
+}
+
 }  // namespace
 
 struct SurfaceAggregator::PrewalkResult {
@@ -137,6 +222,92 @@ struct SurfaceAggregator::RenderPassMapEntry {
   bool is_visited = false;
 };
 
+// What the content emitted for an embedded surface depends on, other than the
+// surfaces that it comes from.
+struct SurfaceAggregator::SurfaceEmitContext {
+  bool operator==(const SurfaceEmitContext& other) const {
+    return quad_rect == other.quad_rect &&
+           quad_visible_rect == other.quad_visible_rect &&
+           stretch_content_to_fill_bounds ==
+               other.stretch_content_to_fill_bounds &&
+           is_reflection == other.is_reflection &&
+           allow_merge == other.allow_merge &&
+           SharedQuadStatesMatch(quad_state, other.quad_state) &&
+           parent_device_scale_factor == other.parent_device_scale_factor &&
+           target_transform == other.target_transform &&
+           clip_rect == other.clip_rect &&
+           dest_transform_to_root_target ==
+               other.dest_transform_to_root_target &&
+           mask_filter_info == other.mask_filter_info &&
+           is_fast_rounded_corner == other.is_fast_rounded_corner &&
+           content_color_usage == other.content_color_usage &&
+           max_render_target_size == other.max_render_target_size &&
+           output_is_secure == other.output_is_secure;
+  }
+
+  // The SurfaceDrawQuad.
+  gfx::Rect quad_rect;
+  gfx::Rect quad_visible_rect;
+  bool stretch_content_to_fill_bounds = false;
+  bool is_reflection = false;
+  bool allow_merge = false;
+  SharedQuadState quad_state;
+
+  // Where the SurfaceDrawQuad is drawn.
+  float parent_device_scale_factor = 1.f;
+  gfx::Transform target_transform;
+  base::Optional<gfx::Rect> clip_rect;
+  gfx::Transform dest_transform_to_root_target;
+  gfx::MaskFilterInfo mask_filter_info;
+  bool is_fast_rounded_corner = false;
+
+  // The aggregator settings.
+  gfx::ContentColorUsage content_color_usage = gfx::ContentColorUsage::kSRGB;
+  int max_render_target_size = 0;
+  bool output_is_secure = false;
+};
+
+// The content emitted for an embedded surface, kept for reuse.
+struct SurfaceAggregator::CachedSurfaceContent {
+  SurfaceEmitContext context;
+  // The surfaces whose content was emitted, with their active frame index.
+  std::vector<std::pair<SurfaceId, uint64_t>> surfaces;
+  // The surface that the surface range of each SurfaceDrawQuad resolved to, or
+  // an invalid id if there was none with an active frame.
+  std::vector<std::pair<SurfaceRange, SurfaceId>> resolved_ranges;
+  // The render passes whose ids were remapped.
+  std::vector<std::pair<SurfaceId, CompositorRenderPassId>> remapped_passes;
+
+  // The render passes added to the frame.
+  AggregatedRenderPassList passes;
+  // The shared quad states and quads added to the render pass that the surface
+  // was emitted into.
+  std::unique_ptr<AggregatedRenderPass> dest_content;
+  // The rects added to the surface damage rect list. Overlay damage indices in
+  // |passes| and |dest_content| are relative to the first one.
+  std::vector<gfx::Rect> damage_rects;
+  bool zero_damage_rect_is_not_recorded = false;
+  bool has_damage_from_contributing_content = false;
+};
+
+struct SurfaceAggregator::SurfaceContentRecording {
+  SurfaceId surface_id;
+  std::unique_ptr<CachedSurfaceContent> content;
+  // Where the content starts.
+  AggregatedRenderPass* dest_pass = nullptr;
+  size_t first_pass_index = 0;
+  size_t first_shared_quad_state_index = 0;
+  size_t first_quad_index = 0;
+  size_t first_damage_rect_index = 0;
+  // Where the content recorded for the surfaces it embeds starts.
+  size_t first_recorded_content_index = 0;
+  size_t first_pending_copy_quad_count = 0;
+  // The flag of |dest_pass| before the content was emitted. It is cleared
+  // while recording to find out whether the content sets it.
+  bool dest_pass_had_damage_from_contributing_content = false;
+  bool cacheable = true;
+};
+
 SurfaceAggregator::SurfaceAggregator(SurfaceManager* manager,
                                      DisplayResourceProvider* provider,
                                      bool aggregate_only_damaged,
@@ -437,6 +608,33 @@ bool SurfaceAggregator::CanPotentiallyMergePass(
          sqs->de_jelly_delta_y == 0;
 }
 
+bool SurfaceAggregator::ShouldIgnoreUndamaged(
+    const AggregatedRenderPass& dest_pass) const {
+  // If the current frame has copy requests or cached render passes, then
+  // aggregate the entire thing, as otherwise parts of the copy requests may be
+  // ignored and we could cache partially drawn render pass.
+  // If there are pixel-moving backdrop filters then the damage rect might be
+  // expanded later, so we can't drop quads that are outside the current damage
+  // rect safely.
+  // If overlay/underlay is enabled then the underlay rect might be added to the
+  // damage rect later. We are not able to predict right here which draw quad
+  // candidate will be promoted to overlay/underlay. Also, we might drop quads
+  // which are on top of an underlay and cause the overlay processor to
+  // present the quad as an overlay instead of an underlay.
+  return aggregate_only_damaged_ && !has_copy_requests_ &&
+         !has_cached_render_passes_ && !has_pixel_moving_backdrop_filter_ &&
+         !moved_pixel_passes_.count(dest_pass.id);
+}
+
+AggregatedRenderPassId SurfaceAggregator::RemapPassId(
+    CompositorRenderPassId pass_id,
+    const SurfaceId& surface_id) {
+  // Reused content keeps the remapped ids, so they must stay in use.
+  if (SurfaceContentRecording* recording = current_recording())
+    recording->content->remapped_passes.emplace_back(surface_id, pass_id);
+  return pass_id_remapper_.Remap(pass_id, surface_id);
+}
+
 void SurfaceAggregator::HandleSurfaceQuad(
     const SurfaceDrawQuad* surface_quad,
     float parent_device_scale_factor,
@@ -450,6 +648,13 @@ void SurfaceAggregator::HandleSurfaceQuad(
   SurfaceId primary_surface_id = surface_quad->surface_range.end();
   Surface* latest_surface =
       manager_->GetLatestInFlightSurface(surface_quad->surface_range);
+  if (SurfaceContentRecording* recording = current_recording()) {
+    recording->content->resolved_ranges.emplace_back(
+        surface_quad->surface_range,
+        latest_surface && latest_surface->HasActiveFrame()
+            ? latest_surface->surface_id()
+            : SurfaceId());
+  }
 
   // If a new surface is going to be emitted, add the surface_quad rect to
   // |surface_damage_rect_list_| for overlays. The whole quad is considered
@@ -516,8 +721,10 @@ void SurfaceAggregator::EmitSurfaceContent(
   // If this surface's id is already in our referenced set then it creates
   // a cycle in the graph and should be dropped.
   SurfaceId surface_id = surface->surface_id();
-  if (referenced_surfaces_.count(surface_id))
+  if (referenced_surfaces_.count(surface_id)) {
+    MarkSurfaceContentUncacheable();
     return;
+  }
 
   ++stats_->copied_surface_count;
 
@@ -563,6 +770,7 @@ void SurfaceAggregator::EmitSurfaceContent(
         root_damage_rect_, damage_rect_in_quad_space);
     if (*damage_rect_in_quad_space_valid &&
         !damage_rect_in_quad_space->Intersects(source_visible_rect)) {
+      MarkSurfaceContentUncacheable();
       return;
     }
   }
@@ -575,9 +783,31 @@ void SurfaceAggregator::EmitSurfaceContent(
   if (!valid_surfaces_.count(surface_id)) {
     // As |copy_requests| goes out-of-scope, all copy requests in that container
     // will auto-send an empty result upon destruction.
+    MarkSurfaceContentUncacheable();
     return;
   }
 
+  // The content of a surface that did not change since the last aggregation
+  // is kept, and reused while nothing that it depends on changes.
+  bool record_content = false;
+  if (incremental_aggregation_) {
+    if (!IsSurfaceFrameIndexSameAsPrevious(surface) ||
+        surface->HasSurfaceAnimationDamage() || !copy_requests.empty() ||
+        !CanCacheSurfaceContent()) {
+      if (cached_surface_contents_.count(surface_id))
+        stale_surface_contents_.insert(surface_id);
+      MarkSurfaceContentUncacheable();
+    } else {
+      SurfaceEmitContext context = GetSurfaceEmitContext(
+          surface_quad, parent_device_scale_factor, target_transform,
+          clip_rect, dest_pass, mask_filter_info);
+      if (ReuseCachedSurfaceContent(surface_id, context, dest_pass))
+        return;
+      BeginSurfaceContentRecording(surface, context, dest_pass);
+      record_content = true;
+    }
+  }
+
   referenced_surfaces_.insert(surface_id);
   // TODO(vmpstr): provider check is a hack for unittests that don't set up a
   // resource provider.
@@ -624,6 +854,7 @@ void SurfaceAggregator::EmitSurfaceContent(
   }
 
   if (frame.metadata.delegated_ink_metadata) {
+    MarkSurfaceContentUncacheable();
     // The metadata must be taken off of the surface, rather than a copy being
     // made, in order to ensure that the delegated ink metadata is used for
     // exactly one frame. Otherwise, it could potentially end up being used to
@@ -645,7 +876,7 @@ void SurfaceAggregator::EmitSurfaceContent(
     size_t dq_size = source.quad_list.size();
     auto copy_pass = std::make_unique<AggregatedRenderPass>(sqs_size, dq_size);
 
-    auto remapped_pass_id = pass_id_remapper_.Remap(source.id, surface_id);
+    auto remapped_pass_id = RemapPassId(source.id, surface_id);
 
     gfx::Rect output_rect = source.output_rect;
     if (max_render_target_size_ > 0) {
@@ -749,8 +980,13 @@ void SurfaceAggregator::EmitSurfaceContent(
     // We can't produce content outside of |quad_rect|, so clip the visible
     // rect if necessary.
     quad_visible_rect.Intersect(quad_rect);
-    auto remapped_pass_id = pass_id_remapper_.Remap(last_pass.id, surface_id);
+    auto remapped_pass_id = RemapPassId(last_pass.id, surface_id);
     if (quad_visible_rect.IsEmpty()) {
+      // Pending copies may read from or write to the passes being removed,
+      // and the content being recorded loses them.
+      RunPendingSurfaceContentCopies();
+      for (auto& recording : surface_content_recordings_)
+        recording->cacheable = false;
       dest_pass_list_->erase(
           std::remove_if(
               dest_pass_list_->begin(), dest_pass_list_->end(),
@@ -772,6 +1008,323 @@ void SurfaceAggregator::EmitSurfaceContent(
 
   referenced_surfaces_.erase(surface_id);
   surface->DidAggregate();
+  if (record_content)
+    EndSurfaceContentRecording();
+}
+
+bool SurfaceAggregator::CanCacheSurfaceContent() const {
+  return !has_copy_requests_ && !has_cached_render_passes_ &&
+         !has_pixel_moving_backdrop_filter_ && moved_pixel_passes_.empty() &&
+         !de_jelly_enabled_;
+}
+
+SurfaceAggregator::SurfaceEmitContext SurfaceAggregator::GetSurfaceEmitContext(
+    const SurfaceDrawQuad* surface_quad,
+    float parent_device_scale_factor,
+    const gfx::Transform& target_transform,
+    const base::Optional<gfx::Rect>& clip_rect,
+    const AggregatedRenderPass* dest_pass,
+    const MaskFilterInfoExt& mask_filter_info) const {
+  SurfaceEmitContext context;
+  context.quad_rect = surface_quad->rect;
+  context.quad_visible_rect = surface_quad->visible_rect;
+  context.stretch_content_to_fill_bounds =
+      surface_quad->stretch_content_to_fill_bounds;
+  context.is_reflection = surface_quad->is_reflection;
+  context.allow_merge = surface_quad->allow_merge;
+  context.quad_state = *surface_quad->shared_quad_state;
+  context.parent_device_scale_factor = parent_device_scale_factor;
+  context.target_transform = target_transform;
+  context.clip_rect = clip_rect;
+  context.dest_transform_to_root_target = dest_pass->transform_to_root_target;
+  context.mask_filter_info = mask_filter_info.mask_filter_info;
+  context.is_fast_rounded_corner = mask_filter_info.is_fast_rounded_corner;
+  context.content_color_usage = root_content_color_usage_;
+  context.max_render_target_size = max_render_target_size_;
+  context.output_is_secure = output_is_secure_;
+  return context;
+}
+
+bool SurfaceAggregator::IsCachedSurfaceContentValid(
+    const CachedSurfaceContent& content,
+    const SurfaceEmitContext& context) const {
+  if (!(content.context == context))
+    return false;
+
+  for (const auto& entry : content.surfaces) {
+    Surface* surface = manager_->GetSurfaceForId(entry.first);
+    if (!surface || !surface->HasActiveFrame() ||
+        surface->GetActiveFrameIndex() != entry.second ||
+        !IsSurfaceFrameIndexSameAsPrevious(surface) ||
+        surface->HasSurfaceAnimationDamage() ||
+        surface->HasCopyOutputRequests() ||
+        !valid_surfaces_.count(entry.first) ||
+        referenced_surfaces_.count(entry.first)) {
+      return false;
+    }
+  }
+
+  for (const auto& entry : content.resolved_ranges) {
+    Surface* surface = manager_->GetLatestInFlightSurface(entry.first);
+    SurfaceId surface_id = surface && surface->HasActiveFrame()
+                               ? surface->surface_id()
+                               : SurfaceId();
+    if (surface_id != entry.second)
+      return false;
+  }
+  return true;
+}
+
+bool SurfaceAggregator::ReuseCachedSurfaceContent(
+    const SurfaceId& surface_id,
+    const SurfaceEmitContext& context,
+    AggregatedRenderPass* dest_pass) {
+  auto it = cached_surface_contents_.find(surface_id);
+  if (it == cached_surface_contents_.end())
+    return false;
+  const CachedSurfaceContent& content = *it->second;
+  if (!IsCachedSurfaceContentValid(content, context)) {
+    stale_surface_contents_.insert(surface_id);
+    return false;
+  }
+
+  for (const auto& entry : content.remapped_passes)
+    pass_id_remapper_.Remap(entry.second, entry.first);
+
+  size_t damage_index = 0;
+  if (needs_surface_damage_rect_list_) {
+    damage_index = surface_damage_rect_list_->size();
+    surface_damage_rect_list_->insert(surface_damage_rect_list_->end(),
+                                      content.damage_rects.begin(),
+                                      content.damage_rects.end());
+    current_zero_damage_rect_is_not_recorded_ =
+        content.zero_damage_rect_is_not_recorded;
+  }
+
+  // The render passes are added right away, and filled in once all surfaces
+  // have been emitted. Like the passes copied by EmitSurfaceContent(), they
+  // are only damaged where the root render pass is.
+  bool culled = false;
+  for (const auto& cached_pass : content.passes) {
+    auto copy_pass = cached_pass->Copy(cached_pass->id);
+    copy_pass->damage_rect = copy_pass->output_rect;
+    gfx::Transform inverse_transform(gfx::Transform::kSkipInitialization);
+    if (copy_pass->transform_to_root_target.GetInverse(&inverse_transform)) {
+      copy_pass->damage_rect.Intersect(
+          cc::MathUtil::ProjectEnclosingClippedRect(inverse_transform,
+                                                    root_damage_rect_));
+    }
+
+    base::Optional<gfx::Rect> cull_rect;
+    if (ShouldIgnoreUndamaged(*copy_pass)) {
+      cull_rect = root_damage_rect_;
+      culled = true;
+    }
+    pending_pass_copies_.push_back(base::BindOnce(
+        &CopyRenderPassContent, base::Unretained(cached_pass.get()),
+        damage_index, cull_rect, base::Unretained(copy_pass.get())));
+    pending_copy_quad_count_ += cached_pass->quad_list.size();
+
+    if (copy_pass->has_damage_from_contributing_content)
+      contributing_content_damaged_passes_.insert(copy_pass->id);
+    dest_pass_list_->push_back(std::move(copy_pass));
+  }
+
+  base::Optional<gfx::Rect> cull_rect;
+  if (ShouldIgnoreUndamaged(*dest_pass)) {
+    cull_rect = root_damage_rect_;
+    culled = true;
+  }
+  CopyQuadsAndSharedQuadStates(content.dest_content->quad_list, 0,
+                               damage_index, cull_rect, dest_pass);
+  dest_pass->has_damage_from_contributing_content |=
+      content.has_damage_from_contributing_content;
+
+  // The surface itself was counted by EmitSurfaceContent().
+  stats_->copied_surface_count +=
+      static_cast<int>(content.surfaces.size()) - 1;
+  for (const auto& entry : content.surfaces)
+    manager_->GetSurfaceForId(entry.first)->DidAggregate();
+
+  if (SurfaceContentRecording* recording = current_recording()) {
+    // Culled quads could not be told apart from the others.
+    if (culled)
+      recording->cacheable = false;
+    CachedSurfaceContent* parent = recording->content.get();
+    parent->surfaces.insert(parent->surfaces.end(), content.surfaces.begin(),
+                            content.surfaces.end());
+    parent->resolved_ranges.insert(parent->resolved_ranges.end(),
+                                   content.resolved_ranges.begin(),
+                                   content.resolved_ranges.end());
+    parent->remapped_passes.insert(parent->remapped_passes.end(),
+                                   content.remapped_passes.begin(),
+                                   content.remapped_passes.end());
+  }
+  return true;
+}
+
+void SurfaceAggregator::BeginSurfaceContentRecording(
+    Surface* surface,
+    const SurfaceEmitContext& context,
+    AggregatedRenderPass* dest_pass) {
+  auto recording = std::make_unique<SurfaceContentRecording>();
+  recording->surface_id = surface->surface_id();
+  recording->content = std::make_unique<CachedSurfaceContent>();
+  recording->content->context = context;
+  recording->content->surfaces.emplace_back(surface->surface_id(),
+                                            surface->GetActiveFrameIndex());
+  recording->dest_pass = dest_pass;
+  recording->first_pass_index = dest_pass_list_->size();
+  recording->first_shared_quad_state_index =
+      dest_pass->shared_quad_state_list.size();
+  recording->first_quad_index = dest_pass->quad_list.size();
+  if (needs_surface_damage_rect_list_)
+    recording->first_damage_rect_index = surface_damage_rect_list_->size();
+  recording->first_recorded_content_index = recorded_surface_contents_.size();
+  recording->first_pending_copy_quad_count = pending_copy_quad_count_;
+  recording->dest_pass_had_damage_from_contributing_content =
+      dest_pass->has_damage_from_contributing_content;
+  dest_pass->has_damage_from_contributing_content = false;
+  surface_content_recordings_.push_back(std::move(recording));
+}
+
+void SurfaceAggregator::EndSurfaceContentRecording() {
+  std::unique_ptr<SurfaceContentRecording> recording =
+      std::move(surface_content_recordings_.back());
+  surface_content_recordings_.pop_back();
+  CachedSurfaceContent* content = recording->content.get();
+  AggregatedRenderPass* dest_pass = recording->dest_pass;
+
+  content->has_damage_from_contributing_content =
+      dest_pass->has_damage_from_contributing_content;
+  dest_pass->has_damage_from_contributing_content |=
+      recording->dest_pass_had_damage_from_contributing_content;
+
+  // The content of the embedding surface depends on everything this content
+  // depends on.
+  if (SurfaceContentRecording* parent = current_recording()) {
+    parent->cacheable &= recording->cacheable;
+    CachedSurfaceContent* parent_content = parent->content.get();
+    parent_content->surfaces.insert(parent_content->surfaces.end(),
+                                    content->surfaces.begin(),
+                                    content->surfaces.end());
+    parent_content->resolved_ranges.insert(
+        parent_content->resolved_ranges.end(),
+        content->resolved_ranges.begin(), content->resolved_ranges.end());
+    parent_content->remapped_passes.insert(
+        parent_content->remapped_passes.end(),
+        content->remapped_passes.begin(), content->remapped_passes.end());
+  }
+
+  if (!recording->cacheable)
+    return;
+
+  // Overlay damage indices must point into the damage rects of the content.
+  size_t first_damage_rect_index = recording->first_damage_rect_index;
+  auto has_outside_damage_index = [first_damage_rect_index](
+                                      const SharedQuadState* sqs) {
+    return sqs->overlay_damage_index &&
+           *sqs->overlay_damage_index < first_damage_rect_index;
+  };
+  std::vector<const AggregatedRenderPass*> passes;
+  for (size_t i = recording->first_pass_index; i < dest_pass_list_->size();
+       ++i) {
+    const AggregatedRenderPass* pass = (*dest_pass_list_)[i].get();
+    for (const SharedQuadState* sqs : pass->shared_quad_state_list) {
+      if (has_outside_damage_index(sqs))
+        return;
+    }
+    passes.push_back(pass);
+  }
+  const SharedQuadStateList& sqs_list = dest_pass->shared_quad_state_list;
+  auto sqs_it = sqs_list.rbegin();
+  for (size_t i = recording->first_shared_quad_state_index;
+       i < sqs_list.size(); ++i, ++sqs_it) {
+    if (has_outside_damage_index(*sqs_it))
+      return;
+  }
+
+  const QuadList& quad_list = dest_pass->quad_list;
+  std::vector<const DrawQuad*> quads(quad_list.size() -
+                                     recording->first_quad_index);
+  auto quad_it = quad_list.rbegin();
+  for (size_t i = quads.size(); i > 0; --i, ++quad_it)
+    quads[i - 1] = *quad_it;
+
+  if (needs_surface_damage_rect_list_) {
+    content->damage_rects.assign(
+        surface_damage_rect_list_->begin() + first_damage_rect_index,
+        surface_damage_rect_list_->end());
+    content->zero_damage_rect_is_not_recorded =
+        current_zero_damage_rect_is_not_recorded_;
+  }
+
+  // The content of the embedded surfaces is part of this content, so it does
+  // not need to be kept twice. It is recorded again if this surface changes.
+  DCHECK_EQ(recorded_surface_contents_.size(),
+            pending_recording_copies_.size());
+  recorded_surface_contents_.resize(recording->first_recorded_content_index);
+  pending_recording_copies_.resize(recording->first_recorded_content_index);
+  pending_copy_quad_count_ = std::max(pending_copy_quad_count_,
+                                      recording->first_pending_copy_quad_count);
+
+  for (const AggregatedRenderPass* pass : passes)
+    pending_copy_quad_count_ += pass->quad_list.size();
+  pending_copy_quad_count_ += quads.size();
+  pending_recording_copies_.push_back(base::BindOnce(
+      &SurfaceAggregator::CopyRecordedSurfaceContent, std::move(passes),
+      std::move(quads), first_damage_rect_index, base::Unretained(content)));
+  recorded_surface_contents_.emplace_back(recording->surface_id,
+                                          std::move(recording->content));
+}
+
+void SurfaceAggregator::MarkSurfaceContentUncacheable() {
+  if (SurfaceContentRecording* recording = current_recording())
+    recording->cacheable = false;
+}
+
+// static
+void SurfaceAggregator::CopyRecordedSurfaceContent(
+    std::vector<const AggregatedRenderPass*> passes,
+    std::vector<const DrawQuad*> quads,
+    size_t first_damage_rect_index,
+    CachedSurfaceContent* content) {
+  content->passes.reserve(passes.size());
+  for (const AggregatedRenderPass* pass : passes) {
+    auto copy_pass = pass->Copy(pass->id);
+    CopyQuadsAndSharedQuadStates(pass->quad_list, first_damage_rect_index, 0,
+                                 base::nullopt, copy_pass.get());
+    content->passes.push_back(std::move(copy_pass));
+  }
+  content->dest_content = std::make_unique<AggregatedRenderPass>();
+  CopyQuadsAndSharedQuadStates(quads, first_damage_rect_index, 0,
+                               base::nullopt, content->dest_content.get());
+}
+
+void SurfaceAggregator::RunPendingSurfaceContentCopies() {
+  int max_workers = pending_copy_quad_count_ >= kMinQuadsForParallelCopy
+                        ? max_copy_workers_
+                        : 1;
+  // The reused render passes go first, as recorded content may include them.
+  // The recording copies are kept, so that they stay in line with
+  // |recorded_surface_contents_|.
+  RunPendingTasks(&pending_pass_copies_, max_workers);
+  RunPendingTasks(&pending_recording_copies_, max_workers);
+  pending_pass_copies_.clear();
+  pending_copy_quad_count_ = 0;
+}
+
+void SurfaceAggregator::FinishSurfaceContentCopies() {
+  DCHECK(surface_content_recordings_.empty());
+  RunPendingSurfaceContentCopies();
+
+  for (const SurfaceId& surface_id : stale_surface_contents_)
+    cached_surface_contents_.erase(surface_id);
+  stale_surface_contents_.clear();
+  for (auto& entry : recorded_surface_contents_)
+    cached_surface_contents_[entry.first] = std::move(entry.second);
+  recorded_surface_contents_.clear();
+  pending_recording_copies_.clear();
 }
 
 void SurfaceAggregator::EmitDefaultBackgroundColorQuad(
@@ -1027,21 +1580,7 @@ void SurfaceAggregator::CopyQuadsToPass(
   const QuadList& source_quad_list = source_pass.quad_list;
   const SharedQuadState* last_copied_source_shared_quad_state = nullptr;
 
-  // If the current frame has copy requests or cached render passes, then
-  // aggregate the entire thing, as otherwise parts of the copy requests may be
-  // ignored and we could cache partially drawn render pass.
-  // If there are pixel-moving backdrop filters then the damage rect might be
-  // expanded later, so we can't drop quads that are outside the current damage
-  // rect safely.
-  // If overlay/underlay is enabled then the underlay rect might be added to the
-  // damage rect later. We are not able to predict right here which draw quad
-  // candidate will be promoted to overlay/underlay. Also, we might drop quads
-  // which are on top of an underlay and cause the overlay processor to
-  // present the quad as an overlay instead of an underlay.
-  const bool ignore_undamaged =
-      aggregate_only_damaged_ && !has_copy_requests_ &&
-      !has_cached_render_passes_ && !has_pixel_moving_backdrop_filter_ &&
-      !moved_pixel_passes_.count(dest_pass->id);
+  const bool ignore_undamaged = ShouldIgnoreUndamaged(*dest_pass);
   // Damage rect in the quad space of the current shared quad state.
   // TODO(jbauman): This rect may contain unnecessary area if
   // transform isn't axis-aligned.
@@ -1133,8 +1672,10 @@ void SurfaceAggregator::CopyQuadsToPass(
 
       if (ignore_undamaged) {
         if (damage_rect_in_quad_space_valid &&
-            !damage_rect_in_quad_space.Intersects(quad->visible_rect))
+            !damage_rect_in_quad_space.Intersects(quad->visible_rect)) {
+          MarkSurfaceContentUncacheable();
           continue;
+        }
       }
 
       DrawQuad* dest_quad;
@@ -1143,7 +1684,7 @@ void SurfaceAggregator::CopyQuadsToPass(
             CompositorRenderPassDrawQuad::MaterialCast(quad);
         CompositorRenderPassId original_pass_id = pass_quad->render_pass_id;
         AggregatedRenderPassId remapped_pass_id =
-            pass_id_remapper_.Remap(original_pass_id, surface->surface_id());
+            RemapPassId(original_pass_id, surface->surface_id());
 
         // If the CompositorRenderPassDrawQuad is referring to other render pass
         // with the |has_damage_from_contributing_content| set on it, then the
@@ -1883,6 +2424,7 @@ AggregatedFrame SurfaceAggregator::Aggregate(
   CopyPasses(root_surface_frame, surface);
   referenced_surfaces_.erase(surface_id);
   DCHECK(referenced_surfaces_.empty());
+  FinishSurfaceContentCopies();
   stats_->copy_time = copy_timer.Elapsed();
 
   RecordStatHistograms();
@@ -1918,6 +2460,11 @@ AggregatedFrame SurfaceAggregator::Aggregate(
   contained_surfaces_.swap(previous_contained_surfaces_);
   contained_frame_sinks_.swap(previous_contained_frame_sinks_);
 
+  // Content cached for surfaces that are no longer embedded is dropped.
+  base::EraseIf(cached_surface_contents_, [this](const auto& entry) {
+    return !previous_contained_surfaces_.count(entry.first);
+  });
+
   ResetAfterAggregate();
 
   for (auto it : previous_contained_surfaces_) {
@@ -1983,6 +2530,12 @@ void SurfaceAggregator::ResetAfterAggregate() {
   contained_frame_sinks_.clear();
   display_trace_id_ = -1;
   video_capture_enabled_ = false;
+  surface_content_recordings_.clear();
+  recorded_surface_contents_.clear();
+  stale_surface_contents_.clear();
+  pending_pass_copies_.clear();
+  pending_recording_copies_.clear();
+  pending_copy_quad_count_ = 0;
 }
 
 void SurfaceAggregator::ReleaseResources(const SurfaceId& surface_id) {
@@ -1991,6 +2544,7 @@ void SurfaceAggregator::ReleaseResources(const SurfaceId& surface_id) {
     provider_->DestroyChild(it->second);
     surface_id_to_resource_child_id_.erase(it);
   }
+  cached_surface_contents_.erase(surface_id);
 }
 
 void SurfaceAggregator::SetFullDamageForSurface(const SurfaceId& surface_id) {
@@ -2006,6 +2560,20 @@ void SurfaceAggregator::SetDisplayColorSpaces(
   display_color_spaces_ = display_color_spaces;
 }
 
+void SurfaceAggregator::SetIncrementalAggregation(bool enabled,
+                                                  int max_copy_workers) {
+  DCHECK_GE(max_copy_workers, 1);
+  incremental_aggregation_ = enabled;
+  max_copy_workers_ = max_copy_workers;
+  if (!incremental_aggregation_)
+    cached_surface_contents_.clear();
+}
+
+bool SurfaceAggregator::HasCachedSurfaceContentForTesting(
+    const SurfaceId& surface_id) const {
+  return cached_surface_contents_.count(surface_id);
+}
+
 void SurfaceAggregator::SetMaxRenderTargetSize(int max_size) {
   DCHECK_GE(max_size, 0);
   max_render_target_size_ = max_size;
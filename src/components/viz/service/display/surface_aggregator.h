@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/macros.h"
@@ -90,11 +91,23 @@ class VIZ_SERVICE_EXPORT SurfaceAggregator {
   void SetFrameAnnotator(std::unique_ptr<FrameAnnotator> frame_annotator);
   void DestroyFrameAnnotator();
 
+  // Enables incremental aggregation. The content emitted for an embedded
+  // surface is then kept, and reused in later frames for as long as the
+  // surface, every surface it embeds and the way it is embedded stay the same.
+  // The render passes of reused content are copied into the frame by up to
+  // |max_copy_workers| threads, including the calling one.
+  void SetIncrementalAggregation(bool enabled, int max_copy_workers);
+
+  bool HasCachedSurfaceContentForTesting(const SurfaceId& surface_id) const;
+
  private:
   struct PrewalkResult;
   struct ChildSurfaceInfo;
   struct RenderPassMapEntry;
   struct MaskFilterInfoExt;
+  struct SurfaceEmitContext;
+  struct CachedSurfaceContent;
+  struct SurfaceContentRecording;
 
   struct AggregateStatistics {
     int prewalked_surface_count = 0;
@@ -299,6 +312,57 @@ class VIZ_SERVICE_EXPORT SurfaceAggregator {
 
   bool IsRootSurface(const Surface* surface) const;
 
+  // Returns true if quads that do not intersect |root_damage_rect_| can be
+  // left out of |dest_pass|.
+  bool ShouldIgnoreUndamaged(const AggregatedRenderPass& dest_pass) const;
+
+  AggregatedRenderPassId RemapPassId(CompositorRenderPassId pass_id,
+                                     const SurfaceId& surface_id);
+
+  // Incremental aggregation:
+  // Returns true if the content emitted for surfaces in the current frame can
+  // be kept. Copy requests, cached render passes and pixel-moving filters make
+  // the content depend on the damage of the whole frame.
+  bool CanCacheSurfaceContent() const;
+  SurfaceEmitContext GetSurfaceEmitContext(
+      const SurfaceDrawQuad* surface_quad,
+      float parent_device_scale_factor,
+      const gfx::Transform& target_transform,
+      const base::Optional<gfx::Rect>& clip_rect,
+      const AggregatedRenderPass* dest_pass,
+      const MaskFilterInfoExt& mask_filter_info) const;
+  bool IsCachedSurfaceContentValid(const CachedSurfaceContent& content,
+                                   const SurfaceEmitContext& context) const;
+  // Emits the cached content of |surface_id| into |dest_pass| and returns true
+  // if it can be reused in |context|.
+  bool ReuseCachedSurfaceContent(const SurfaceId& surface_id,
+                                 const SurfaceEmitContext& context,
+                                 AggregatedRenderPass* dest_pass);
+  // Records what is emitted for |surface| until the matching
+  // EndSurfaceContentRecording() call. Recordings nest like the surfaces.
+  void BeginSurfaceContentRecording(Surface* surface,
+                                    const SurfaceEmitContext& context,
+                                    AggregatedRenderPass* dest_pass);
+  void EndSurfaceContentRecording();
+  // Called when the content being recorded depends on more than the emitted
+  // surfaces and their context, e.g. on the damage of the frame.
+  void MarkSurfaceContentUncacheable();
+  SurfaceContentRecording* current_recording() {
+    return surface_content_recordings_.empty()
+               ? nullptr
+               : surface_content_recordings_.back().get();
+  }
+  // Fills in the passes of reused content and copies the recorded content, in
+  // parallel if there is enough to copy.
+  void RunPendingSurfaceContentCopies();
+  // Runs the pending copies and updates the cache.
+  void FinishSurfaceContentCopies();
+  static void CopyRecordedSurfaceContent(
+      std::vector<const AggregatedRenderPass*> passes,
+      std::vector<const DrawQuad*> quads,
+      size_t first_damage_rect_index,
+      CachedSurfaceContent* content);
+
   static void UnrefResources(base::WeakPtr<SurfaceClient> surface_client,
                              const std::vector<ReturnedResource>& resources);
 
@@ -503,6 +567,28 @@ class VIZ_SERVICE_EXPORT SurfaceAggregator {
   // a common space, to avoid collisions.
   RenderPassIdRemapper pass_id_remapper_;
 
+  // Incremental aggregation state. The content cached for a surface is only
+  // replaced or dropped once the pending copies of a frame are done, since
+  // they may still read from it.
+  bool incremental_aggregation_ = false;
+  int max_copy_workers_ = 1;
+  base::flat_map<SurfaceId, std::unique_ptr<CachedSurfaceContent>>
+      cached_surface_contents_;
+  // Cached content that could not be reused in the current frame.
+  base::flat_set<SurfaceId> stale_surface_contents_;
+  // The surfaces whose content is being recorded, innermost last.
+  std::vector<std::unique_ptr<SurfaceContentRecording>>
+      surface_content_recordings_;
+  // Content recorded in the current frame, filled in by
+  // |pending_recording_copies_|.
+  std::vector<std::pair<SurfaceId, std::unique_ptr<CachedSurfaceContent>>>
+      recorded_surface_contents_;
+  // Copies of the quads of reused render passes, which have been added to the
+  // frame without them, and of recorded content.
+  std::vector<base::OnceClosure> pending_pass_copies_;
+  std::vector<base::OnceClosure> pending_recording_copies_;
+  size_t pending_copy_quad_count_ = 0;
+
   base::WeakPtrFactory<SurfaceAggregator> weak_factory_{this};
 
   DISALLOW_COPY_AND_ASSIGN(SurfaceAggregator);
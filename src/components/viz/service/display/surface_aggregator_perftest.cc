@@ -77,11 +77,16 @@ class SurfaceAggregatorPerfTest : public VizPerfTest {
     aggregator_ = std::make_unique<SurfaceAggregator>(
         manager_.surface_manager(), resource_provider_.get(), optimize_damage,
         true);
-    for (int i = 0; i < num_surfaces; i++) {
+    if (incremental_copy_workers_ > 0) {
+      aggregator_->SetIncrementalAggregation(true, incremental_copy_workers_);
+    }
+    // Submits a frame of the same content to the child surface at index |i|.
+    auto submit_child_frame = [&](int i, const gfx::Rect& damage_rect) {
       LocalSurfaceId local_surface_id(i + 1, child_tokens[i]);
 
       auto pass = CompositorRenderPass::Create();
       pass->output_rect = gfx::Rect(0, 0, 1, 2);
+      pass->damage_rect = damage_rect;
 
       CompositorFrameBuilder frame_builder;
 
@@ -128,7 +133,9 @@ class SurfaceAggregatorPerfTest : public VizPerfTest {
       frame_builder.AddRenderPass(std::move(pass));
       child_supports[i]->SubmitCompositorFrame(local_surface_id,
                                                frame_builder.Build());
-    }
+    };
+    for (int i = 0; i < num_surfaces; i++)
+      submit_child_frame(i, gfx::Rect());
 
     auto root_support = std::make_unique<CompositorFrameSinkSupport>(
         nullptr, &manager_, FrameSinkId(1, num_surfaces + 1), /*is_root=*/true);
@@ -137,8 +144,14 @@ class SurfaceAggregatorPerfTest : public VizPerfTest {
         base::TimeTicks() + base::TimeDelta::FromSeconds(1);
 
     bool first_lap = true;
+    int next_damaged_child = 0;
     timer_.Reset();
     do {
+      if (damage_one_child_per_lap_) {
+        submit_child_frame(next_damaged_child, gfx::Rect(0, 0, 1, 2));
+        next_damaged_child = (next_damaged_child + 1) % num_surfaces;
+      }
+
       auto pass = CompositorRenderPass::Create();
 
       auto* sqs = pass->CreateAndAppendSharedQuadState();
@@ -195,6 +208,11 @@ class SurfaceAggregatorPerfTest : public VizPerfTest {
   FrameSinkManagerImpl manager_;
   std::unique_ptr<DisplayResourceProvider> resource_provider_;
   std::unique_ptr<SurfaceAggregator> aggregator_;
+  // Enables incremental aggregation with this many copy workers if set.
+  int incremental_copy_workers_ = 0;
+  // Submits a new frame to one of the child surfaces, in turn, before every
+  // aggregation if set.
+  bool damage_one_child_per_lap_ = false;
 };
 
 TEST_F(SurfaceAggregatorPerfTest, ManySurfacesOpaque) {
@@ -227,6 +245,46 @@ TEST_F(SurfaceAggregatorPerfTest, ManySurfacesTransparent) {
           ExpectedOutput(20, 2019));
 }
 
+// Only the root surface changes, so the content of the child surfaces is
+// reused.
+TEST_F(SurfaceAggregatorPerfTest, ManySurfacesOpaqueIncremental) {
+  incremental_copy_workers_ = 1;
+  RunTest(20, 100, 1.f, false, true, "many_surfaces_opaque_incremental",
+          ExpectedOutput(1, 2000));
+}
+
+TEST_F(SurfaceAggregatorPerfTest, ManySurfacesTransparentIncremental) {
+  incremental_copy_workers_ = 1;
+  RunTest(20, 100, .5f, false, true, "many_surfaces_transparent_incremental",
+          ExpectedOutput(20, 2019));
+}
+
+TEST_F(SurfaceAggregatorPerfTest, ManySurfacesTransparentIncrementalParallel) {
+  incremental_copy_workers_ = 4;
+  RunTest(20, 100, .5f, false, true,
+          "many_surfaces_transparent_incremental_parallel",
+          ExpectedOutput(20, 2019));
+}
+
+// One child surface changes per frame, so the content of the surfaces that
+// embed it has to be aggregated again while the others are reused.
+TEST_F(SurfaceAggregatorPerfTest, ManySurfacesOpaqueIncrementalChildDamage) {
+  incremental_copy_workers_ = 1;
+  damage_one_child_per_lap_ = true;
+  RunTest(20, 100, 1.f, false, true,
+          "many_surfaces_opaque_incremental_child_damage",
+          ExpectedOutput(1, 2000));
+}
+
+TEST_F(SurfaceAggregatorPerfTest,
+       ManySurfacesTransparentIncrementalChildDamage) {
+  incremental_copy_workers_ = 1;
+  damage_one_child_per_lap_ = true;
+  RunTest(20, 100, .5f, false, true,
+          "many_surfaces_transparent_incremental_child_damage",
+          ExpectedOutput(20, 2019));
+}
+
 TEST_F(SurfaceAggregatorPerfTest, FewSurfaces) {
   RunTest(3, 20, 1.f, false, true, "few_surfaces", ExpectedOutput(1, 60));
 }
@@ -706,6 +706,116 @@ TEST_F(SurfaceAggregatorValidSurfaceTest, OpacityCopied) {
   }
 }
 
+// Tests that with incremental aggregation the content of unchanged surfaces is
+// reused, and replaced once a surface changes.
+TEST_F(SurfaceAggregatorValidSurfaceTest, IncrementalAggregation) {
+  aggregator_.SetIncrementalAggregation(true, /*max_copy_workers=*/2);
+
+  auto merged_support = std::make_unique<CompositorFrameSinkSupport>(
+      nullptr, &manager_, kArbitraryFrameSinkId1, kRootIsRoot);
+  ParentLocalSurfaceIdAllocator merged_allocator;
+  merged_allocator.GenerateId();
+  LocalSurfaceId merged_local_surface_id =
+      merged_allocator.GetCurrentLocalSurfaceId();
+  SurfaceId merged_surface_id(merged_support->frame_sink_id(),
+                              merged_local_surface_id);
+
+  auto transparent_support = std::make_unique<CompositorFrameSinkSupport>(
+      nullptr, &manager_, kArbitraryFrameSinkId2, kRootIsRoot);
+  ParentLocalSurfaceIdAllocator transparent_allocator;
+  transparent_allocator.GenerateId();
+  LocalSurfaceId transparent_local_surface_id =
+      transparent_allocator.GetCurrentLocalSurfaceId();
+  SurfaceId transparent_surface_id(transparent_support->frame_sink_id(),
+                                   transparent_local_surface_id);
+
+  constexpr float device_scale_factor = 1.0f;
+  {
+    std::vector<Quad> quads = {
+        Quad::SolidColorQuad(SK_ColorGREEN, gfx::Rect(5, 5))};
+    std::vector<Pass> passes = {Pass(quads, SurfaceSize())};
+    SubmitCompositorFrame(merged_support.get(), passes,
+                          merged_local_surface_id, device_scale_factor);
+  }
+  {
+    std::vector<Quad> quads = {
+        Quad::SolidColorQuad(SK_ColorBLUE, gfx::Rect(5, 5))};
+    std::vector<Pass> passes = {Pass(quads, SurfaceSize())};
+    SubmitCompositorFrame(transparent_support.get(), passes,
+                          transparent_local_surface_id, device_scale_factor);
+  }
+  {
+    std::vector<Quad> quads = {
+        Quad::SurfaceQuad(SurfaceRange(base::nullopt, merged_surface_id),
+                          SK_ColorWHITE, gfx::Rect(5, 5),
+                          /*stretch_content_to_fill_bounds=*/false),
+        Quad::SurfaceQuad(SurfaceRange(base::nullopt, transparent_surface_id),
+                          SK_ColorWHITE, gfx::Rect(5, 5), .5f,
+                          gfx::Transform(),
+                          /*stretch_content_to_fill_bounds=*/false,
+                          gfx::MaskFilterInfo(),
+                          /*is_fast_rounded_corner=*/false)};
+    std::vector<Pass> passes = {Pass(quads, SurfaceSize())};
+    SubmitCompositorFrame(root_sink_.get(), passes, root_local_surface_id_,
+                          device_scale_factor);
+  }
+  SurfaceId root_surface_id(root_sink_->frame_sink_id(),
+                            root_local_surface_id_);
+
+  auto expect_frame = [](const AggregatedFrame& frame, SkColor merged_color) {
+    const auto& render_pass_list = frame.render_pass_list;
+    ASSERT_EQ(2u, render_pass_list.size());
+    const QuadList& transparent_quads = render_pass_list[0]->quad_list;
+    ASSERT_EQ(1u, transparent_quads.size());
+    EXPECT_EQ(SK_ColorBLUE,
+              SolidColorDrawQuad::MaterialCast(transparent_quads.front())
+                  ->color);
+
+    const QuadList& root_quads = render_pass_list[1]->quad_list;
+    ASSERT_EQ(2u, root_quads.size());
+    EXPECT_EQ(merged_color,
+              SolidColorDrawQuad::MaterialCast(root_quads.ElementAt(0))->color);
+    ASSERT_EQ(DrawQuad::Material::kAggregatedRenderPass,
+              root_quads.ElementAt(1)->material);
+    const auto* pass_quad =
+        AggregatedRenderPassDrawQuad::MaterialCast(root_quads.ElementAt(1));
+    EXPECT_EQ(render_pass_list[0]->id, pass_quad->render_pass_id);
+    EXPECT_EQ(.5f, pass_quad->shared_quad_state->opacity);
+  };
+
+  // New surfaces are not cached.
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorGREEN);
+  EXPECT_FALSE(
+      aggregator_.HasCachedSurfaceContentForTesting(merged_surface_id));
+  EXPECT_FALSE(
+      aggregator_.HasCachedSurfaceContentForTesting(transparent_surface_id));
+
+  // Unchanged surfaces are cached, and their content is reused.
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorGREEN);
+  EXPECT_TRUE(
+      aggregator_.HasCachedSurfaceContentForTesting(merged_surface_id));
+  EXPECT_TRUE(
+      aggregator_.HasCachedSurfaceContentForTesting(transparent_surface_id));
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorGREEN);
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorGREEN);
+
+  // A new frame replaces the cached content.
+  {
+    std::vector<Quad> quads = {
+        Quad::SolidColorQuad(SK_ColorRED, gfx::Rect(5, 5))};
+    std::vector<Pass> passes = {Pass(quads, SurfaceSize())};
+    SubmitCompositorFrame(merged_support.get(), passes,
+                          merged_local_surface_id, device_scale_factor);
+  }
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorRED);
+  EXPECT_FALSE(
+      aggregator_.HasCachedSurfaceContentForTesting(merged_surface_id));
+  EXPECT_TRUE(
+      aggregator_.HasCachedSurfaceContentForTesting(transparent_surface_id));
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorRED);
+  expect_frame(AggregateFrame(root_surface_id), SK_ColorRED);
+}
+
 // Test that when surface is rotated and we need the render surface to apply the
 // clip, we would keep the render surface.
 TEST_F(SurfaceAggregatorValidSurfaceTest, RotatedClip) {
@@ -60,4 +60,8 @@ int SoftwareOutputDeviceOzone::MaxFramesPending() const {
   return surface_ozone_->MaxFramesPending();
 }
 
+int SoftwareOutputDeviceOzone::GetBufferAge() const {
+  return surface_ozone_->GetBufferAge();
+}
+
 }  // namespace viz
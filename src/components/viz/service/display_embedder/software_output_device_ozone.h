@@ -36,6 +36,7 @@ class VIZ_SERVICE_EXPORT SoftwareOutputDeviceOzone
   void EndPaint() override;
   void OnSwapBuffers(SwapBuffersCallback swap_ack_callback) override;
   int MaxFramesPending() const override;
+  int GetBufferAge() const override;
 
  private:
   // This object should outlive |surface_ozone_|. Ending its lifetime may
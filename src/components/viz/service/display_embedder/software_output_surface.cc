@@ -82,6 +82,10 @@ void SoftwareOutputSurface::SwapBuffers(OutputSurfaceFrame frame) {
   }
 }
 
+gfx::Rect SoftwareOutputSurface::GetCurrentFramebufferDamage() const {
+  return software_device()->GetCurrentFramebufferDamage();
+}
+
 bool SoftwareOutputSurface::IsDisplayedAsOverlayPlane() const {
   return false;
 }
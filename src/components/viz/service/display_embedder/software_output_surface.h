@@ -39,6 +39,7 @@ class VIZ_SERVICE_EXPORT SoftwareOutputSurface : public OutputSurface {
                gfx::BufferFormat format,
                bool use_stencil) override;
   void SwapBuffers(OutputSurfaceFrame frame) override;
+  gfx::Rect GetCurrentFramebufferDamage() const override;
   bool IsDisplayedAsOverlayPlane() const override;
   unsigned GetOverlayTextureId() const override;
   bool HasExternalStencilTest() const override;
@@ -12,6 +12,7 @@
 #include "cc/test/fake_output_surface_client.h"
 #include "components/viz/service/display/output_surface_frame.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/vsync_provider.h"
 
 namespace viz {
@@ -58,6 +59,22 @@ class VSyncSoftwareOutputDevice : public SoftwareOutputDevice {
   DISALLOW_COPY_AND_ASSIGN(VSyncSoftwareOutputDevice);
 };
 
+class BufferAgeSoftwareOutputDevice : public SoftwareOutputDevice {
+ public:
+  BufferAgeSoftwareOutputDevice() = default;
+  ~BufferAgeSoftwareOutputDevice() override = default;
+
+  void set_buffer_age(int buffer_age) { buffer_age_ = buffer_age; }
+
+  // SoftwareOutputDevice implementation.
+  int GetBufferAge() const override { return buffer_age_; }
+
+ private:
+  int buffer_age_ = 1;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferAgeSoftwareOutputDevice);
+};
+
 }  // namespace
 
 TEST(SoftwareOutputSurfaceTest, NoVSyncProvider) {
@@ -100,4 +117,43 @@ TEST(SoftwareOutputSurfaceTest, VSyncProviderUpdates) {
   EXPECT_EQ(1, update_vsync_parameters_call_count);
 }
 
+TEST(SoftwareOutputSurfaceTest, FramebufferDamageFromBufferAge) {
+  auto device_owned = std::make_unique<BufferAgeSoftwareOutputDevice>();
+  auto* device = device_owned.get();
+  auto output_surface =
+      std::make_unique<SoftwareOutputSurface>(std::move(device_owned));
+  device->Resize(gfx::Size(100, 100), 1.f);
+
+  const gfx::Rect damage_rects[] = {gfx::Rect(0, 0, 100, 100),
+                                    gfx::Rect(2, 2, 3, 3),
+                                    gfx::Rect(10, 10, 3, 3)};
+  for (const gfx::Rect& damage_rect : damage_rects) {
+    device->BeginPaint(damage_rect);
+    device->EndPaint();
+  }
+
+  // A buffer that holds the previous frame is up to date.
+  EXPECT_EQ(gfx::Rect(), output_surface->GetCurrentFramebufferDamage());
+
+  // Older buffers miss the damage of the frames presented since.
+  device->set_buffer_age(2);
+  EXPECT_EQ(gfx::Rect(10, 10, 3, 3),
+            output_surface->GetCurrentFramebufferDamage());
+  device->set_buffer_age(3);
+  EXPECT_EQ(gfx::Rect(2, 2, 11, 11),
+            output_surface->GetCurrentFramebufferDamage());
+  device->set_buffer_age(4);
+  EXPECT_EQ(gfx::Rect(0, 0, 100, 100),
+            output_surface->GetCurrentFramebufferDamage());
+
+  // Buffers with undefined contents or older than the damage history are
+  // redrawn entirely.
+  device->set_buffer_age(0);
+  EXPECT_EQ(gfx::Rect(0, 0, 100, 100),
+            output_surface->GetCurrentFramebufferDamage());
+  device->set_buffer_age(5);
+  EXPECT_EQ(gfx::Rect(0, 0, 100, 100),
+            output_surface->GetCurrentFramebufferDamage());
+}
+
 }  // namespace viz
@@ -10,9 +10,11 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/feature_list.h"
 #include "base/no_destructor.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
@@ -42,6 +44,7 @@
 #include "gpu/ipc/service/gpu_memory_buffer_factory.h"
 #include "gpu/ipc/service/gpu_watchdog_thread.h"
 #include "gpu/ipc/service/image_decode_accelerator_worker.h"
+#include "gpu/ipc/service/shader_disk_store.h"
 #include "gpu/vulkan/buildflags.h"
 #include "ipc/ipc_channel_handle.h"
 #include "ipc/ipc_sync_channel.h"
@@ -451,6 +454,8 @@ GpuServiceImpl::~GpuServiceImpl() {
     watchdog_thread_->OnGpuProcessTearDown();
 
   media_gpu_channel_manager_.reset();
+  // Loaded shaders are handed to |gpu_channel_manager_|.
+  shader_disk_store_.reset();
   gpu_channel_manager_.reset();
 
   // Destroy |gpu_memory_buffer_factory_| on the IO thread since its weakptrs
@@ -585,6 +590,56 @@ void GpuServiceImpl::InitializeWithHost(
       gpu_channel_manager_.get());
   if (watchdog_thread())
     watchdog_thread()->AddPowerObserver();
+
+  InitializeShaderDiskStore();
+}
+
+void GpuServiceImpl::InitializeShaderDiskStore() {
+  DCHECK(main_runner_->BelongsToCurrentThread());
+  const base::CommandLine* command_line =
+      base::CommandLine::ForCurrentProcess();
+  if (gpu_preferences_.disable_gpu_shader_disk_cache ||
+      !command_line->HasSwitch(switches::kGpuShaderStorePath)) {
+    return;
+  }
+
+  // The store is read and written from here on, after the sandbox has been
+  // engaged, so the sandbox policy of the platform has to allow creating,
+  // writing and renaming files in the directory of the path. Otherwise the
+  // store finds no file and its writes fail, and shaders are not kept.
+
+  // Program binaries and Skia shaders are only valid for the driver that built
+  // them.
+  const std::string fingerprint = base::StringPrintf(
+      "%04x:%04x|%s|%s|%s|%s", gpu_info_.gpu.vendor_id,
+      gpu_info_.gpu.device_id, gpu_info_.gpu.driver_version.c_str(),
+      gpu_info_.gl_vendor.c_str(), gpu_info_.gl_renderer.c_str(),
+      gpu_info_.gl_version.c_str());
+
+  // The program cache and the GrShaderCache are each limited to
+  // |gpu_program_cache_size|.
+  shader_disk_store_ = std::make_unique<gpu::ShaderDiskStore>(
+      command_line->GetSwitchValuePath(switches::kGpuShaderStorePath),
+      fingerprint, 2 * gpu_preferences_.gpu_program_cache_size,
+      base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+           base::TaskShutdownBehavior::BLOCK_SHUTDOWN}));
+  shader_disk_store_client_ids_.insert(gpu::kGrShaderCacheClientId);
+  shader_disk_store_client_ids_.insert(gpu::kDisplayCompositorClientId);
+  shader_disk_store_client_ids_.insert(gpu::kTranslatedShaderCacheClientId);
+
+  // Translated shaders only depend on the translator options, which are part
+  // of their keys, but share the fingerprint so they are dropped on updates.
+  gpu_channel_manager_->shader_translator_cache()
+      ->translated_shader_cache()
+      ->SetPersistCallback(base::BindRepeating(
+          &GpuServiceImpl::StoreShaderToDisk, base::Unretained(this),
+          gpu::kTranslatedShaderCacheClientId));
+
+  shader_disk_store_->Load(
+      base::BindRepeating(&gpu::GpuChannelManager::PopulateShaderCache,
+                          base::Unretained(gpu_channel_manager_.get())),
+      base::DoNothing());
 }
 
 void GpuServiceImpl::Bind(
@@ -906,9 +961,20 @@ void GpuServiceImpl::StoreShaderToDisk(int client_id,
                                        const std::string& key,
                                        const std::string& shader) {
   DCHECK(main_runner_->BelongsToCurrentThread());
+  if (shader_disk_store_ && shader_disk_store_client_ids_.contains(client_id)) {
+    shader_disk_store_->Store(client_id, key, shader);
+    return;
+  }
   gpu_host_->StoreShaderToDisk(client_id, key, shader);
 }
 
+void GpuServiceImpl::DidUseShader(int32_t client_id, const std::string& key) {
+  DCHECK(main_runner_->BelongsToCurrentThread());
+  // The browser's shader disk cache does not track use.
+  if (shader_disk_store_ && shader_disk_store_client_ids_.contains(client_id))
+    shader_disk_store_->Touch(key);
+}
+
 void GpuServiceImpl::MaybeExitOnContextLost() {
   MaybeExit(true);
 }
@@ -971,6 +1037,9 @@ void GpuServiceImpl::EstablishGpuChannel(int32_t client_id,
     std::move(callback).Run(mojo::ScopedMessagePipeHandle());
     return;
   }
+  if (shader_disk_store_ && cache_shaders_on_disk)
+    shader_disk_store_client_ids_.insert(client_id);
+
   mojo::MessagePipe pipe;
   gpu_channel->Init(pipe.handle0.release(), shutdown_event_);
 
@@ -986,6 +1055,7 @@ void GpuServiceImpl::CloseChannel(int32_t client_id) {
         base::BindOnce(&GpuServiceImpl::CloseChannel, weak_ptr_, client_id));
     return;
   }
+  shader_disk_store_client_ids_.erase(client_id);
   gpu_channel_manager_->RemoveChannel(client_id);
 }
 
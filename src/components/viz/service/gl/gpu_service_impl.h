@@ -11,6 +11,7 @@
 #include "base/callback.h"
 #include "base/clang_profiling_buildflags.h"
 #include "base/compiler_specific.h"
+#include "base/containers/flat_set.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/observer_list.h"
 #include "base/single_thread_task_runner.h"
@@ -57,6 +58,7 @@ class ImageDecodeAcceleratorWorker;
 class Scheduler;
 class SyncPointManager;
 class SharedImageManager;
+class ShaderDiskStore;
 class VulkanImplementation;
 }  // namespace gpu
 
@@ -221,6 +223,7 @@ class VIZ_SERVICE_EXPORT GpuServiceImpl : public gpu::GpuChannelManagerDelegate,
   void StoreShaderToDisk(int client_id,
                          const std::string& key,
                          const std::string& shader) override;
+  void DidUseShader(int32_t client_id, const std::string& key) override;
   void MaybeExitOnContextLost() override;
   bool IsExiting() const override;
   gpu::Scheduler* GetGpuScheduler() override;
@@ -340,6 +343,10 @@ class VIZ_SERVICE_EXPORT GpuServiceImpl : public gpu::GpuChannelManagerDelegate,
 
   void RequestHDRStatusOnMainThread(RequestHDRStatusCallback callback);
 
+  // Creates |shader_disk_store_| if --gpu-shader-store-path is set, and loads
+  // it into the shader caches of |gpu_channel_manager_|.
+  void InitializeShaderDiskStore();
+
   void OnBackgroundedOnMainThread();
   void OnForegroundedOnMainThread();
 
@@ -389,6 +396,12 @@ class VIZ_SERVICE_EXPORT GpuServiceImpl : public gpu::GpuChannelManagerDelegate,
   std::unique_ptr<gpu::GpuChannelManager> gpu_channel_manager_;
   std::unique_ptr<media::MediaGpuChannelManager> media_gpu_channel_manager_;
 
+  // Keeps shaders on disk in place of the browser's shader disk cache. Only
+  // shaders of |shader_disk_store_client_ids_| are stored, the other clients
+  // must not have their shaders written to disk.
+  std::unique_ptr<gpu::ShaderDiskStore> shader_disk_store_;
+  base::flat_set<int32_t> shader_disk_store_client_ids_;
+
   // On some platforms (e.g. android webview), the SyncPointManager and
   // SharedImageManager comes from external sources.
   std::unique_ptr<gpu::SyncPointManager> owned_sync_point_manager_;
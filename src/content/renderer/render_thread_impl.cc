@@ -1843,6 +1843,10 @@ RenderThreadImpl::SharedCompositorWorkerContextProvider(
   auto shared_memory_limits =
       support_oop_rasterization ? gpu::SharedMemoryLimits::ForOOPRasterContext()
                                 : gpu::SharedMemoryLimits();
+  if (support_oop_rasterization) {
+    shared_memory_limits.max_transfer_buffer_segments =
+        features::GetMaxOopRasterTransferBufferSegments();
+  }
   shared_worker_context_provider_ = CreateOffscreenContext(
       std::move(gpu_channel_host), GetGpuMemoryBufferManager(),
       shared_memory_limits, support_locking, support_gles2_interface,
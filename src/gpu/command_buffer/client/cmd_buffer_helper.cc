@@ -176,7 +176,13 @@ void CommandBufferHelper::Flush() {
     put_ = 0;
 
   if (HaveRingBuffer()) {
+    TRACE_COUNTER_ID1(
+        "gpu", "CommandBufferHelper::FlushedEntries", this,
+        (put_ - last_flush_put_ + total_entry_count_) % total_entry_count_);
     last_flush_time_ = base::TimeTicks::Now();
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+    last_flush_latency_measured_ = false;
+#endif
     last_flush_put_ = put_;
     last_ordering_barrier_put_ = put_;
     command_buffer_->Flush(put_);
@@ -207,10 +213,35 @@ void CommandBufferHelper::OrderingBarrier() {
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
 void CommandBufferHelper::PeriodicFlushCheck() {
   base::TimeTicks current_time = base::TimeTicks::Now();
-  if (current_time - last_flush_time_ >
+  base::TimeDelta time_since_flush = current_time - last_flush_time_;
+  if (time_since_flush <=
       base::TimeDelta::FromMicroseconds(kPeriodicFlushDelayInMicroseconds)) {
-    Flush();
+    return;
   }
+
+  // Flushing while the service is still processing the previous flush only
+  // splits the work into more, smaller chunks, so keep batching commands until
+  // it catches up, or for as long as it usually takes to.
+  UpdateCachedState(command_buffer_->GetLastState());
+  bool service_idle =
+      !service_on_old_buffer_ && cached_get_offset_ == last_flush_put_;
+  if (service_idle && !last_flush_latency_measured_) {
+    last_flush_latency_measured_ = true;
+    service_latency_ = service_latency_.is_zero()
+                           ? time_since_flush
+                           : (service_latency_ * 7 + time_since_flush) / 8;
+    TRACE_COUNTER_ID1("gpu", "CommandBufferHelper::ServiceLatencyUs", this,
+                      service_latency_.InMicroseconds());
+  }
+  if (service_idle || time_since_flush > GetBusyServiceFlushDelay())
+    Flush();
+}
+
+base::TimeDelta CommandBufferHelper::GetBusyServiceFlushDelay() const {
+  return std::min(
+      std::max(service_latency_, base::TimeDelta::FromMicroseconds(
+                                     kPeriodicFlushDelayInMicroseconds)),
+      base::TimeDelta::FromMicroseconds(kMaxPeriodicFlushDelayInMicroseconds));
 }
 #endif
 
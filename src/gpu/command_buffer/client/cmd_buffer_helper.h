@@ -30,6 +30,9 @@ class Buffer;
 #define CMD_HELPER_PERIODIC_FLUSH_CHECK
 const int kCommandsPerFlushCheck = 100;
 const int kPeriodicFlushDelayInMicroseconds = 500;
+// While the service is still processing the previous flush, periodic flushes
+// are postponed by up to its measured latency, but no more than this.
+const int kMaxPeriodicFlushDelayInMicroseconds = 4000;
 #endif
 
 const int kAutoFlushSmall = 16;  // 1/16 of the buffer
@@ -298,6 +301,10 @@ class GPU_EXPORT CommandBufferHelper {
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
   // Calls Flush if automatic flush conditions are met.
   void PeriodicFlushCheck();
+
+  // Returns how long to wait after the last flush before flushing again while
+  // the service is still processing it.
+  base::TimeDelta GetBusyServiceFlushDelay() const;
 #endif
 
   int32_t GetTotalFreeEntriesNoWaiting() const;
@@ -322,6 +329,11 @@ class GPU_EXPORT CommandBufferHelper {
 
 #if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
   int commands_issued_ = 0;
+
+  // Moving average of the time the service takes to process a flush, as seen
+  // by periodic flush checks. Zero until the first one has been measured.
+  base::TimeDelta service_latency_;
+  bool last_flush_latency_measured_ = true;
 #endif
 
   bool usable_ = true;
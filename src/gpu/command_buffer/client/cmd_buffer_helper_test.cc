@@ -197,6 +197,15 @@ class CommandBufferHelperTest : public testing::Test {
     helper_->WaitForGetOffsetInRange(start, end);
   }
 
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+  void PeriodicFlushCheckAfter(base::TimeDelta time_since_flush) {
+    helper_->last_flush_time_ = base::TimeTicks::Now() - time_since_flush;
+    helper_->PeriodicFlushCheck();
+  }
+
+  base::TimeDelta GetServiceLatency() { return helper_->service_latency_; }
+#endif
+
   std::unique_ptr<CommandBufferDirectLocked> command_buffer_;
   std::unique_ptr<AsyncAPIMock> api_mock_;
   std::unique_ptr<CommandBufferHelper> helper_;
@@ -789,4 +798,42 @@ TEST_F(CommandBufferHelperTest, TestWrapAroundAfterOrderingBarrier) {
   Mock::VerifyAndClearExpectations(api_mock_.get());
 }
 
+#if defined(CMD_HELPER_PERIODIC_FLUSH_CHECK)
+// Checks that periodic flushes are postponed while the service is still
+// processing the previous flush.
+TEST_F(CommandBufferHelperTest, PeriodicFlushWaitsForBusyService) {
+  const base::TimeDelta kFlushDelay =
+      base::TimeDelta::FromMicroseconds(kPeriodicFlushDelayInMicroseconds);
+  const base::TimeDelta kMaxFlushDelay =
+      base::TimeDelta::FromMicroseconds(kMaxPeriodicFlushDelayInMicroseconds);
+  command_buffer_->LockFlush();
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  helper_->Flush();
+  int flush_count = command_buffer_->FlushCount();
+
+  // The service hasn't processed the flush yet, so there is no periodic flush
+  // until the maximum delay has passed.
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  PeriodicFlushCheckAfter(kFlushDelay * 2);
+  EXPECT_EQ(flush_count, command_buffer_->FlushCount());
+  PeriodicFlushCheckAfter(kMaxFlushDelay * 2);
+  EXPECT_EQ(flush_count + 1, command_buffer_->FlushCount());
+
+  // Once the service has caught up, a periodic check flushes, and measures how
+  // long the service took.
+  command_buffer_->UnlockFlush();
+  helper_->Finish();
+  flush_count = command_buffer_->FlushCount();
+  EXPECT_TRUE(GetServiceLatency().is_zero());
+  AddUniqueCommandWithExpect(error::kNoError, 2);
+  PeriodicFlushCheckAfter(kFlushDelay * 2);
+  EXPECT_EQ(flush_count + 1, command_buffer_->FlushCount());
+  EXPECT_GE(GetServiceLatency(), kFlushDelay * 2);
+
+  helper_->Finish();
+  Mock::VerifyAndClearExpectations(api_mock_.get());
+  EXPECT_EQ(error::kNoError, GetError());
+}
+#endif
+
 }  // namespace gpu
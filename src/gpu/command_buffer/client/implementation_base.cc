@@ -237,6 +237,7 @@ gpu::ContextResult ImplementationBase::Initialize(
 
   gpu_control_->SetGpuControlClient(this);
 
+  transfer_buffer_->SetMaxSegments(limits.max_transfer_buffer_segments);
   if (!transfer_buffer_->Initialize(
           limits.start_transfer_buffer_size, kStartingOffset,
           limits.min_transfer_buffer_size, limits.max_transfer_buffer_size,
@@ -13,6 +13,31 @@ uint32_t SharedImageInterface::UsageForMailbox(const Mailbox& mailbox) {
 void SharedImageInterface::NotifyMailboxAdded(const Mailbox& /*mailbox*/,
                                               uint32_t /*usage*/) {}
 
+std::vector<Mailbox> SharedImageInterface::CreateSharedImages(
+    size_t count,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage) {
+  std::vector<Mailbox> mailboxes;
+  mailboxes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    mailboxes.push_back(CreateSharedImage(format, size, color_space,
+                                          surface_origin, alpha_type, usage,
+                                          kNullSurfaceHandle));
+  }
+  return mailboxes;
+}
+
+void SharedImageInterface::DestroySharedImages(
+    const SyncToken& sync_token,
+    const std::vector<Mailbox>& mailboxes) {
+  for (const auto& mailbox : mailboxes)
+    DestroySharedImage(sync_token, mailbox);
+}
+
 Mailbox SharedImageInterface::CreateSharedImageWithAHB(
     const Mailbox& mailbox,
     uint32_t usage,
@@ -5,6 +5,8 @@
 #ifndef GPU_COMMAND_BUFFER_CLIENT_SHARED_IMAGE_INTERFACE_H_
 #define GPU_COMMAND_BUFFER_CLIENT_SHARED_IMAGE_INTERFACE_H_
 
+#include <vector>
+
 #include "base/compiler_specific.h"
 #include "base/containers/span.h"
 #include "base/memory/scoped_refptr.h"
@@ -77,6 +79,18 @@ class GPU_EXPORT SharedImageInterface {
                                     uint32_t usage,
                                     base::span<const uint8_t> pixel_data) = 0;
 
+  // Creates |count| shared images with the same properties, like as many calls
+  // to the first CreateSharedImage() above with no surface. Implementations
+  // that talk to the service send them in a single request.
+  virtual std::vector<Mailbox> CreateSharedImages(
+      size_t count,
+      viz::ResourceFormat format,
+      const gfx::Size& size,
+      const gfx::ColorSpace& color_space,
+      GrSurfaceOrigin surface_origin,
+      SkAlphaType alpha_type,
+      uint32_t usage);
+
   // Creates a shared image out of a GpuMemoryBuffer, using |color_space|.
   // |usage| is a combination of |SharedImageUsage| bits that describes which
   // API(s) the image will be used with. Format and size are derived from the
@@ -135,6 +149,12 @@ class GPU_EXPORT SharedImageInterface {
   virtual void DestroySharedImage(const SyncToken& sync_token,
                                   const Mailbox& mailbox) = 0;
 
+  // Destroys all of |mailboxes| after |sync_token| has been released, like as
+  // many calls to DestroySharedImage(). Implementations that talk to the
+  // service send them in a single request.
+  virtual void DestroySharedImages(const SyncToken& sync_token,
+                                   const std::vector<Mailbox>& mailboxes);
+
   struct SwapChainMailboxes {
     Mailbox front_buffer;
     Mailbox back_buffer;
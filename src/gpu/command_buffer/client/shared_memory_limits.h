@@ -40,6 +40,9 @@ struct SharedMemoryLimits {
   uint32_t start_transfer_buffer_size = 64 * 1024;
   uint32_t min_transfer_buffer_size = 64 * 1024;
   uint32_t max_transfer_buffer_size = 16 * 1024 * 1024;
+  // Number of transfer buffers of the current size that may be allocated from
+  // in turn, instead of waiting for the service once one is full.
+  uint32_t max_transfer_buffer_segments = 1;
 
   static constexpr uint32_t kNoLimit = 0;
   uint32_t mapped_memory_reclaim_limit = kNoLimit;
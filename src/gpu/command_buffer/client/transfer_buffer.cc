@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <algorithm>
 #include <climits>
 
 #include "base/bits.h"
@@ -33,6 +34,18 @@ TransferBuffer::~TransferBuffer() {
   Free();
 }
 
+TransferBuffer::Segment::Segment(scoped_refptr<gpu::Buffer> buffer,
+                                 int32_t id,
+                                 std::unique_ptr<RingBuffer> ring_buffer)
+    : buffer(std::move(buffer)), id(id), ring_buffer(std::move(ring_buffer)) {}
+
+TransferBuffer::Segment::Segment(Segment&& other) = default;
+
+TransferBuffer::Segment::~Segment() = default;
+
+TransferBuffer::Segment& TransferBuffer::Segment::operator=(Segment&& other) =
+    default;
+
 base::UnguessableToken TransferBuffer::shared_memory_guid() const {
   if (!HaveBuffer())
     return base::UnguessableToken();
@@ -72,6 +85,7 @@ void TransferBuffer::Free() {
     result_shm_offset_ = 0;
     DCHECK_EQ(ring_buffer_->NumUsedBlocks(), 0u);
     previous_ring_buffers_.push_back(std::move(ring_buffer_));
+    DestroySpareSegments();
     last_allocated_size_ = 0;
     high_water_mark_ = GetPreviousRingBufferUsedBytes();
     bytes_since_last_shrink_ = 0;
@@ -115,6 +129,11 @@ unsigned int TransferBuffer::GetMaxSize() const {
   return max_buffer_size_ - result_size_;
 }
 
+void TransferBuffer::SetMaxSegments(unsigned int max_segments) {
+  DCHECK_GE(max_segments, 1u);
+  max_segments_ = max_segments;
+}
+
 void TransferBuffer::AllocateRingBuffer(unsigned int size) {
   for (;size >= min_buffer_size_; size /= 2) {
     int32_t id = -1;
@@ -176,6 +195,62 @@ void TransferBuffer::ReallocateRingBuffer(unsigned int size, bool shrink) {
   }
 }
 
+bool TransferBuffer::SwitchToSegmentWithFreeSize(unsigned int size) {
+  if (max_segments_ <= 1 || !HaveBuffer())
+    return false;
+  DCHECK_EQ(ring_buffer_->NumUsedBlocks(), 0u);
+  size = std::min(size, ring_buffer_->GetLargestFreeOrPendingSize());
+
+  // Prefer the least recently used segment, which the service is most likely
+  // to be done with.
+  auto it = std::find_if(spare_segments_.begin(), spare_segments_.end(),
+                         [size](Segment& segment) {
+                           return segment.ring_buffer
+                                      ->GetLargestFreeSizeNoWaiting() >= size;
+                         });
+  Segment next_segment(nullptr, -1, nullptr);
+  if (it != spare_segments_.end()) {
+    next_segment = std::move(*it);
+    spare_segments_.erase(it);
+  } else if (spare_segments_.size() + 1 < max_segments_) {
+    // Segments are only an optimization, so don't lose the context if there
+    // is no memory for one.
+    int32_t id = -1;
+    scoped_refptr<gpu::Buffer> buffer =
+        helper_->command_buffer()->CreateTransferBuffer(
+            buffer_->size(), &id,
+            TransferBufferAllocationOption::kReturnNullOnOOM);
+    if (id == -1)
+      return false;
+    auto ring_buffer = std::make_unique<RingBuffer>(
+        alignment_, result_size_, buffer->size() - result_size_, helper_,
+        static_cast<char*>(buffer->memory()) + result_size_);
+    next_segment = Segment(std::move(buffer), id, std::move(ring_buffer));
+  } else {
+    return false;
+  }
+
+  TRACE_EVENT0("gpu", "TransferBuffer::SwitchToSegmentWithFreeSize");
+  spare_segments_.emplace_back(std::move(buffer_), buffer_id_,
+                               std::move(ring_buffer_));
+  buffer_ = std::move(next_segment.buffer);
+  buffer_id_ = next_segment.id;
+  ring_buffer_ = std::move(next_segment.ring_buffer);
+  result_buffer_ = buffer_->memory();
+  TRACE_COUNTER_ID1("gpu", "TransferBuffer::Segments", this,
+                    spare_segments_.size() + 1);
+  return true;
+}
+
+void TransferBuffer::DestroySpareSegments() {
+  for (Segment& segment : spare_segments_) {
+    helper_->command_buffer()->DestroyTransferBuffer(segment.id);
+    DCHECK_EQ(segment.ring_buffer->NumUsedBlocks(), 0u);
+    previous_ring_buffers_.push_back(std::move(segment.ring_buffer));
+  }
+  spare_segments_.clear();
+}
+
 unsigned int TransferBuffer::GetPreviousRingBufferUsedBytes() {
   while (!previous_ring_buffers_.empty() &&
          previous_ring_buffers_.front()->GetUsedSize() == 0) {
@@ -206,6 +281,10 @@ void TransferBuffer::ShrinkOrExpandRingBufferIfNecessary(
   if (size_to_allocate > available_size) {
     // Try to expand the ring buffer.
     ReallocateRingBuffer(high_water_mark_);
+    // If it couldn't grow enough, allocate from another segment rather than
+    // wait for the service to free up this one.
+    if (size_to_allocate > GetFreeSize())
+      SwitchToSegmentWithFreeSize(size_to_allocate);
   } else if (bytes_since_last_shrink_ > high_water_mark_ * kShrinkThreshold) {
     // The intent of the above check is to limit the frequency of buffer shrink
     // attempts. Unfortunately if an application uploads a large amount of data
@@ -216,6 +295,15 @@ void TransferBuffer::ShrinkOrExpandRingBufferIfNecessary(
     // instead, and consider shrinking at the end of each frame (for clients
     // that have a notion of frames).
     bytes_since_last_shrink_ = 0;
+    // The spare segments only help while uploads outpace the service, so give
+    // them back whenever the buffer gets a chance to shrink. They are
+    // allocated again if the demand comes back.
+    if (!spare_segments_.empty()) {
+      TRACE_EVENT0("gpu", "TransferBuffer::DestroySpareSegments");
+      helper_->OrderingBarrier();
+      DestroySpareSegments();
+      TRACE_COUNTER_ID1("gpu", "TransferBuffer::Segments", this, 1);
+    }
     ReallocateRingBuffer(high_water_mark_ + high_water_mark_ / 4,
                          true /* shrink */);
     high_water_mark_ = size_to_allocate + GetPreviousRingBufferUsedBytes();
@@ -69,6 +69,11 @@ class GPU_EXPORT TransferBufferInterface {
 
   virtual unsigned int GetMaxSize() const = 0;
 
+  // Allows allocating from up to |max_segments| buffers of the current size,
+  // instead of waiting for the service when the current one is full. Ignored
+  // by implementations that only use one buffer.
+  virtual void SetMaxSegments(unsigned int max_segments) {}
+
  protected:
   template <typename>
   friend class ScopedResultPtr;
@@ -110,9 +115,13 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
   unsigned int GetFragmentedFreeSize() const override;
   void ShrinkLastBlock(unsigned int new_size) override;
   unsigned int GetMaxSize() const override;
+  void SetMaxSegments(unsigned int max_segments) override;
 
   // These are for testing.
   unsigned int GetCurrentMaxAllocationWithoutRealloc() const;
+  size_t GetNumSegmentsForTesting() const {
+    return HaveBuffer() ? spare_segments_.size() + 1 : 0;
+  }
 
   // We will attempt to shrink the ring buffer once the number of bytes
   // allocated reaches this threshold times the high water mark.
@@ -126,14 +135,43 @@ class GPU_EXPORT TransferBuffer : public TransferBufferInterface {
 
   void ShrinkOrExpandRingBufferIfNecessary(unsigned int size);
 
+  // Switches to a spare segment with |size| bytes free, or to a new segment if
+  // none has and there are fewer than |max_segments_|. Returns false if the
+  // current segment is still the one to allocate from.
+  bool SwitchToSegmentWithFreeSize(unsigned int size);
+
+  // Destroys the spare segments. Their ring buffers are kept in
+  // |previous_ring_buffers_| until the service is done with them.
+  void DestroySpareSegments();
+
   // Returns the number of bytes that are still in use in ring buffers that we
   // previously freed.
   unsigned int GetPreviousRingBufferUsedBytes();
 
+  // A buffer that is not being allocated from, waiting for the service to
+  // process the commands that use it.
+  struct Segment {
+    Segment(scoped_refptr<gpu::Buffer> buffer,
+            int32_t id,
+            std::unique_ptr<RingBuffer> ring_buffer);
+    Segment(Segment&& other);
+    ~Segment();
+    Segment& operator=(Segment&& other);
+
+    scoped_refptr<gpu::Buffer> buffer;
+    int32_t id;
+    std::unique_ptr<RingBuffer> ring_buffer;
+  };
+
   CommandBufferHelper* helper_;
   std::unique_ptr<RingBuffer> ring_buffer_;
   base::circular_deque<std::unique_ptr<RingBuffer>> previous_ring_buffers_;
 
+  // Segments of the current size besides |ring_buffer_|, least recently used
+  // first.
+  base::circular_deque<Segment> spare_segments_;
+  unsigned int max_segments_ = 1;
+
   // size reserved for results
   unsigned int result_size_;
 
@@ -476,6 +476,102 @@ TEST_F(TransferBufferExpandContractTest, ExpandWithLargeAllocations) {
             transfer_buffer_->GetCurrentMaxAllocationWithoutRealloc());
 }
 
+// Verify that once the buffer can't grow, another segment is allocated from
+// instead of waiting for the service.
+TEST_F(TransferBufferExpandContractTest, AllocatesSegmentAtMaxSize) {
+  transfer_buffer_->SetMaxSegments(2);
+  int32_t token = helper_->InsertToken();
+  EXPECT_FALSE(helper_->HasTokenPassed(token));
+
+  // Expand to the maximum size and fill it.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(), OrderingBarrier(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kMaxTransferBufferSize, _, _))
+      .WillOnce(
+          Invoke(command_buffer(),
+                 &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  uint32_t size_allocated = 0;
+  void* ptr = transfer_buffer_->AllocUpTo(
+      kMaxTransferBufferSize - kStartingOffset, &size_allocated);
+  ASSERT_TRUE(ptr != nullptr);
+  EXPECT_EQ(kMaxTransferBufferSize - kStartingOffset, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, token);
+  int32_t first_segment_id = transfer_buffer_->GetShmId();
+  EXPECT_EQ(1u, transfer_buffer_->GetNumSegmentsForTesting());
+
+  // The buffer is full until the token passes, so the next allocation comes
+  // from a new segment, without flushing or waiting.
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kMaxTransferBufferSize, _, _))
+      .WillOnce(
+          Invoke(command_buffer(),
+                 &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  ptr = transfer_buffer_->AllocUpTo(1, &size_allocated);
+  ASSERT_TRUE(ptr != nullptr);
+  EXPECT_EQ(1u, size_allocated);
+  transfer_buffer_->FreePendingToken(ptr, token);
+  EXPECT_NE(first_segment_id, transfer_buffer_->GetShmId());
+  EXPECT_EQ(2u, transfer_buffer_->GetNumSegmentsForTesting());
+
+  // Both segments are destroyed when the transfer buffer is freed.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+}
+
+// Verify that the spare segments are destroyed once the demand that created
+// them is gone, without reallocating the current segment.
+TEST_F(TransferBufferExpandContractTest, DestroysSpareSegmentsOnShrink) {
+  transfer_buffer_->SetMaxSegments(2);
+  int32_t token = helper_->InsertToken();
+  EXPECT_FALSE(helper_->HasTokenPassed(token));
+
+  // Expand to the maximum size, fill it and spill into a second segment.
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(), OrderingBarrier(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(),
+              CreateTransferBuffer(kMaxTransferBufferSize, _, _))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke(command_buffer(),
+                 &MockClientCommandBufferCanFail::RealCreateTransferBuffer))
+      .RetiresOnSaturation();
+  void* ptr = transfer_buffer_->Alloc(kMaxTransferBufferSize - kStartingOffset);
+  ASSERT_TRUE(ptr != nullptr);
+  transfer_buffer_->FreePendingToken(ptr, token);
+  ptr = transfer_buffer_->Alloc(1);
+  ASSERT_TRUE(ptr != nullptr);
+  transfer_buffer_->FreePendingToken(ptr, token);
+  EXPECT_EQ(2u, transfer_buffer_->GetNumSegmentsForTesting());
+
+  // Once the service catches up, the next shrink attempt destroys the spare
+  // segment. The allocations keep the current one at the maximum size.
+  command_buffer_->SetToken(token);
+  EXPECT_CALL(*command_buffer(), DestroyTransferBuffer(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*command_buffer(), OrderingBarrier(_))
+      .Times(1)
+      .RetiresOnSaturation();
+  for (int i = 0; i < TransferBuffer::kShrinkThreshold * 4; ++i) {
+    ptr = transfer_buffer_->Alloc(kStartTransferBufferSize * 2);
+    ASSERT_TRUE(ptr != nullptr);
+    transfer_buffer_->FreePendingToken(ptr, token);
+  }
+  EXPECT_EQ(1u, transfer_buffer_->GetNumSegmentsForTesting());
+}
+
 TEST_F(TransferBufferExpandContractTest, ShrinkRingBuffer) {
   int32_t token = helper_->InsertToken();
   // For this test we want all allocations to be freed immediately.
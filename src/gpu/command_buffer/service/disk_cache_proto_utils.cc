@@ -0,0 +1,194 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/disk_cache_proto_utils.h"
+
+#include "gpu/command_buffer/service/disk_cache_proto.pb.h"
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+void FillShaderVariableProto(
+    ShaderVariableProto* proto, const sh::ShaderVariable& variable) {
+  proto->set_type(variable.type);
+  proto->set_precision(variable.precision);
+  proto->set_name(variable.name);
+  proto->set_mapped_name(variable.mappedName);
+  proto->set_array_size(variable.getOutermostArraySize());
+  proto->set_static_use(variable.staticUse);
+  for (size_t ii = 0; ii < variable.fields.size(); ++ii) {
+    ShaderVariableProto* field = proto->add_fields();
+    FillShaderVariableProto(field, variable.fields[ii]);
+  }
+  proto->set_struct_name(variable.getStructName());
+}
+
+void FillShaderAttributeProto(
+    ShaderAttributeProto* proto, const sh::Attribute& attrib) {
+  FillShaderVariableProto(proto->mutable_basic(), attrib);
+  proto->set_location(attrib.location);
+}
+
+void FillShaderUniformProto(
+    ShaderUniformProto* proto, const sh::Uniform& uniform) {
+  FillShaderVariableProto(proto->mutable_basic(), uniform);
+}
+
+void FillShaderVaryingProto(
+    ShaderVaryingProto* proto, const sh::Varying& varying) {
+  FillShaderVariableProto(proto->mutable_basic(), varying);
+  proto->set_interpolation(varying.interpolation);
+  proto->set_is_invariant(varying.isInvariant);
+}
+
+void FillShaderOutputVariableProto(ShaderOutputVariableProto* proto,
+                                   const sh::OutputVariable& attrib) {
+  FillShaderVariableProto(proto->mutable_basic(), attrib);
+  proto->set_location(attrib.location);
+}
+
+void FillShaderInterfaceBlockFieldProto(
+    ShaderInterfaceBlockFieldProto* proto,
+    const sh::InterfaceBlockField& interfaceBlockField) {
+  FillShaderVariableProto(proto->mutable_basic(), interfaceBlockField);
+  proto->set_is_row_major_layout(interfaceBlockField.isRowMajorLayout);
+}
+
+void FillShaderInterfaceBlockProto(ShaderInterfaceBlockProto* proto,
+    const sh::InterfaceBlock& interfaceBlock) {
+  proto->set_name(interfaceBlock.name);
+  proto->set_mapped_name(interfaceBlock.mappedName);
+  proto->set_instance_name(interfaceBlock.instanceName);
+  proto->set_array_size(interfaceBlock.arraySize);
+  proto->set_layout(interfaceBlock.layout);
+  proto->set_is_row_major_layout(interfaceBlock.isRowMajorLayout);
+  proto->set_static_use(interfaceBlock.staticUse);
+  for (size_t ii = 0; ii < interfaceBlock.fields.size(); ++ii) {
+    ShaderInterfaceBlockFieldProto* field = proto->add_fields();
+    FillShaderInterfaceBlockFieldProto(field, interfaceBlock.fields[ii]);
+  }
+}
+
+void RetrieveShaderVariableInfo(
+    const ShaderVariableProto& proto, sh::ShaderVariable* variable) {
+  variable->type = proto.type();
+  variable->precision = proto.precision();
+  variable->name = proto.name();
+  variable->mappedName = proto.mapped_name();
+  variable->setArraySize(proto.array_size());
+  variable->staticUse = proto.static_use();
+  variable->fields.resize(proto.fields_size());
+  for (int ii = 0; ii < proto.fields_size(); ++ii)
+    RetrieveShaderVariableInfo(proto.fields(ii), &(variable->fields[ii]));
+  variable->setStructName(proto.struct_name());
+}
+
+void RetrieveShaderAttributeInfo(
+    const ShaderAttributeProto& proto, AttributeMap* map) {
+  sh::Attribute attrib;
+  RetrieveShaderVariableInfo(proto.basic(), &attrib);
+  attrib.location = proto.location();
+  (*map)[proto.basic().mapped_name()] = attrib;
+}
+
+void RetrieveShaderUniformInfo(
+    const ShaderUniformProto& proto, UniformMap* map) {
+  sh::Uniform uniform;
+  RetrieveShaderVariableInfo(proto.basic(), &uniform);
+  (*map)[proto.basic().mapped_name()] = uniform;
+}
+
+void RetrieveShaderVaryingInfo(
+    const ShaderVaryingProto& proto, VaryingMap* map) {
+  sh::Varying varying;
+  RetrieveShaderVariableInfo(proto.basic(), &varying);
+  varying.interpolation = static_cast<sh::InterpolationType>(
+      proto.interpolation());
+  varying.isInvariant = proto.is_invariant();
+  (*map)[proto.basic().mapped_name()] = varying;
+}
+
+void RetrieveShaderOutputVariableInfo(const ShaderOutputVariableProto& proto,
+                                      OutputVariableList* list) {
+  sh::OutputVariable output_variable;
+  RetrieveShaderVariableInfo(proto.basic(), &output_variable);
+  output_variable.location = proto.location();
+  list->push_back(output_variable);
+}
+
+void RetrieveShaderInterfaceBlockFieldInfo(
+    const ShaderInterfaceBlockFieldProto& proto,
+    sh::InterfaceBlockField* interface_block_field) {
+  RetrieveShaderVariableInfo(proto.basic(), interface_block_field);
+  interface_block_field->isRowMajorLayout = proto.is_row_major_layout();
+}
+
+void RetrieveShaderInterfaceBlockInfo(const ShaderInterfaceBlockProto& proto,
+                                      InterfaceBlockMap* map) {
+  sh::InterfaceBlock interface_block;
+  interface_block.name = proto.name();
+  interface_block.mappedName = proto.mapped_name();
+  interface_block.instanceName = proto.instance_name();
+  interface_block.arraySize = proto.array_size();
+  interface_block.layout = static_cast<sh::BlockLayoutType>(proto.layout());
+  interface_block.isRowMajorLayout = proto.is_row_major_layout();
+  interface_block.staticUse = proto.static_use();
+  interface_block.fields.resize(proto.fields_size());
+  for (int ii = 0; ii < proto.fields_size(); ++ii) {
+    RetrieveShaderInterfaceBlockFieldInfo(proto.fields(ii),
+        &(interface_block.fields[ii]));
+  }
+  (*map)[proto.mapped_name()] = interface_block;
+}
+
+}  // namespace
+
+void FillShaderVariablesProto(ShaderProto* proto,
+                              const AttributeMap& attrib_map,
+                              const UniformMap& uniform_map,
+                              const VaryingMap& varying_map,
+                              const OutputVariableList& output_variable_list,
+                              const InterfaceBlockMap& interface_block_map) {
+  for (const auto& attrib : attrib_map)
+    FillShaderAttributeProto(proto->add_attribs(), attrib.second);
+  for (const auto& uniform : uniform_map)
+    FillShaderUniformProto(proto->add_uniforms(), uniform.second);
+  for (const auto& varying : varying_map)
+    FillShaderVaryingProto(proto->add_varyings(), varying.second);
+  for (const auto& output_variable : output_variable_list) {
+    FillShaderOutputVariableProto(proto->add_output_variables(),
+                                  output_variable);
+  }
+  for (const auto& interface_block : interface_block_map) {
+    FillShaderInterfaceBlockProto(proto->add_interface_blocks(),
+                                  interface_block.second);
+  }
+}
+
+void RetrieveShaderVariables(const ShaderProto& proto,
+                             AttributeMap* attrib_map,
+                             UniformMap* uniform_map,
+                             VaryingMap* varying_map,
+                             OutputVariableList* output_variable_list,
+                             InterfaceBlockMap* interface_block_map) {
+  for (int i = 0; i < proto.attribs_size(); i++)
+    RetrieveShaderAttributeInfo(proto.attribs(i), attrib_map);
+  for (int i = 0; i < proto.uniforms_size(); i++)
+    RetrieveShaderUniformInfo(proto.uniforms(i), uniform_map);
+  for (int i = 0; i < proto.varyings_size(); i++)
+    RetrieveShaderVaryingInfo(proto.varyings(i), varying_map);
+  for (int i = 0; i < proto.output_variables_size(); i++) {
+    RetrieveShaderOutputVariableInfo(proto.output_variables(i),
+                                     output_variable_list);
+  }
+  for (int i = 0; i < proto.interface_blocks_size(); i++) {
+    RetrieveShaderInterfaceBlockInfo(proto.interface_blocks(i),
+                                     interface_block_map);
+  }
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -0,0 +1,34 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_DISK_CACHE_PROTO_UTILS_H_
+#define GPU_COMMAND_BUFFER_SERVICE_DISK_CACHE_PROTO_UTILS_H_
+
+#include "gpu/command_buffer/service/shader_translator.h"
+
+class ShaderProto;
+
+namespace gpu {
+namespace gles2 {
+
+// Stores the variables found by the shader translator in |proto|.
+void FillShaderVariablesProto(ShaderProto* proto,
+                              const AttributeMap& attrib_map,
+                              const UniformMap& uniform_map,
+                              const VaryingMap& varying_map,
+                              const OutputVariableList& output_variable_list,
+                              const InterfaceBlockMap& interface_block_map);
+
+// Adds the variables stored in |proto| to the given maps and list.
+void RetrieveShaderVariables(const ShaderProto& proto,
+                             AttributeMap* attrib_map,
+                             UniformMap* uniform_map,
+                             VaryingMap* varying_map,
+                             OutputVariableList* output_variable_list,
+                             InterfaceBlockMap* interface_block_map);
+
+}  // namespace gles2
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_DISK_CACHE_PROTO_UTILS_H_
@@ -56,6 +56,11 @@ const char kGpuProgramCacheSizeKb[]         = "gpu-program-cache-size-kb";
 // Disables the GPU shader on disk cache.
 const char kDisableGpuShaderDiskCache[]     = "disable-gpu-shader-disk-cache";
 
+// Keeps program binaries and Skia shaders in the given file, owned by the GPU
+// process, instead of the browser's shader disk cache. The GPU process accesses
+// the file from within its sandbox, which has to allow it.
+const char kGpuShaderStorePath[]            = "gpu-shader-store-path";
+
 // Simulates shared textures when share groups are not available. Not available
 // everywhere.
 const char kEnableThreadedTextureMailboxes[] =
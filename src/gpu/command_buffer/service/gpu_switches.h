@@ -27,6 +27,7 @@ GPU_EXPORT extern const char kForceGpuMemDiscardableLimitMb[];
 GPU_EXPORT extern const char kForceMaxTextureSize[];
 GPU_EXPORT extern const char kGpuProgramCacheSizeKb[];
 GPU_EXPORT extern const char kDisableGpuShaderDiskCache[];
+GPU_EXPORT extern const char kGpuShaderStorePath[];
 GPU_EXPORT extern const char kEnableThreadedTextureMailboxes[];
 GPU_EXPORT extern const char kGLShaderIntermOutput[];
 GPU_EXPORT extern const char kEmulateShaderPrecision[];
@@ -97,7 +97,13 @@ sk_sp<SkData> GrShaderCache::load(const SkData& key) {
     // creation.
     need_store_pipeline_cache_ = true;
   }
-  WriteToDisk(it->first, &it->second);
+  if (it->second.pending_disk_write) {
+    WriteToDisk(it->first, &it->second);
+  } else if (client_ids_to_cache_on_disk_.count(current_client_id_)) {
+    std::string encoded_key;
+    base::Base64Encode(MakeString(it->first.data.get()), &encoded_key);
+    client_->ShaderUsed(encoded_key);
+  }
   return it->second.data;
 }
 
@@ -28,6 +28,11 @@ class GPU_GLES2_EXPORT GrShaderCache
 
     virtual void StoreShader(const std::string& key,
                              const std::string& shader) = 0;
+
+    // Called when Skia loads the shader for |key|, which is encoded as for
+    // StoreShader(), from the cache, for clients whose shaders are cached on
+    // disk.
+    virtual void ShaderUsed(const std::string& key) {}
   };
 
   class GPU_GLES2_EXPORT ScopedCacheUse {
@@ -4,6 +4,9 @@
 
 #include "gpu/command_buffer/service/gr_shader_cache.h"
 
+#include <string>
+#include <vector>
+
 #include "base/base64.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -24,8 +27,13 @@ class GrShaderCacheTest : public GrShaderCache::Client, public testing::Test {
     disk_cache_[key] = shader;
   }
 
+  void ShaderUsed(const std::string& key) override {
+    used_keys_.push_back(key);
+  }
+
   GrShaderCache cache_;
   std::unordered_map<std::string, std::string> disk_cache_;
+  std::vector<std::string> used_keys_;
 };
 
 TEST_F(GrShaderCacheTest, DoesNotCacheForIncognito) {
@@ -77,6 +85,7 @@ TEST_F(GrShaderCacheTest, LoadedFromDisk) {
     EXPECT_TRUE(cached_shader->equals(shader.get()));
   }
   EXPECT_EQ(disk_cache_.size(), 0u);
+  EXPECT_EQ(used_keys_, std::vector<std::string>({encoded_key}));
 }
 
 TEST_F(GrShaderCacheTest, EnforcesLimits) {
@@ -19,6 +19,7 @@
 #include "gpu/command_buffer/common/activity_flags.h"
 #include "gpu/command_buffer/common/constants.h"
 #include "gpu/command_buffer/service/disk_cache_proto.pb.h"
+#include "gpu/command_buffer/service/disk_cache_proto_utils.h"
 #include "gpu/command_buffer/service/gl_utils.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
 #include "gpu/command_buffer/service/shader_manager.h"
@@ -31,168 +32,13 @@ namespace gles2 {
 
 namespace {
 
-void FillShaderVariableProto(
-    ShaderVariableProto* proto, const sh::ShaderVariable& variable) {
-  proto->set_type(variable.type);
-  proto->set_precision(variable.precision);
-  proto->set_name(variable.name);
-  proto->set_mapped_name(variable.mappedName);
-  proto->set_array_size(variable.getOutermostArraySize());
-  proto->set_static_use(variable.staticUse);
-  for (size_t ii = 0; ii < variable.fields.size(); ++ii) {
-    ShaderVariableProto* field = proto->add_fields();
-    FillShaderVariableProto(field, variable.fields[ii]);
-  }
-  proto->set_struct_name(variable.getStructName());
-}
-
-void FillShaderAttributeProto(
-    ShaderAttributeProto* proto, const sh::Attribute& attrib) {
-  FillShaderVariableProto(proto->mutable_basic(), attrib);
-  proto->set_location(attrib.location);
-}
-
-void FillShaderUniformProto(
-    ShaderUniformProto* proto, const sh::Uniform& uniform) {
-  FillShaderVariableProto(proto->mutable_basic(), uniform);
-}
-
-void FillShaderVaryingProto(
-    ShaderVaryingProto* proto, const sh::Varying& varying) {
-  FillShaderVariableProto(proto->mutable_basic(), varying);
-  proto->set_interpolation(varying.interpolation);
-  proto->set_is_invariant(varying.isInvariant);
-}
-
-void FillShaderOutputVariableProto(ShaderOutputVariableProto* proto,
-                                   const sh::OutputVariable& attrib) {
-  FillShaderVariableProto(proto->mutable_basic(), attrib);
-  proto->set_location(attrib.location);
-}
-
-void FillShaderInterfaceBlockFieldProto(
-    ShaderInterfaceBlockFieldProto* proto,
-    const sh::InterfaceBlockField& interfaceBlockField) {
-  FillShaderVariableProto(proto->mutable_basic(), interfaceBlockField);
-  proto->set_is_row_major_layout(interfaceBlockField.isRowMajorLayout);
-}
-
-void FillShaderInterfaceBlockProto(ShaderInterfaceBlockProto* proto,
-    const sh::InterfaceBlock& interfaceBlock) {
-  proto->set_name(interfaceBlock.name);
-  proto->set_mapped_name(interfaceBlock.mappedName);
-  proto->set_instance_name(interfaceBlock.instanceName);
-  proto->set_array_size(interfaceBlock.arraySize);
-  proto->set_layout(interfaceBlock.layout);
-  proto->set_is_row_major_layout(interfaceBlock.isRowMajorLayout);
-  proto->set_static_use(interfaceBlock.staticUse);
-  for (size_t ii = 0; ii < interfaceBlock.fields.size(); ++ii) {
-    ShaderInterfaceBlockFieldProto* field = proto->add_fields();
-    FillShaderInterfaceBlockFieldProto(field, interfaceBlock.fields[ii]);
-  }
-}
-
 void FillShaderProto(ShaderProto* proto, const char* sha,
                      const Shader* shader) {
   proto->set_sha(sha, gpu::gles2::ProgramCache::kHashLength);
-  for (AttributeMap::const_iterator iter = shader->attrib_map().begin();
-       iter != shader->attrib_map().end(); ++iter) {
-    ShaderAttributeProto* info = proto->add_attribs();
-    FillShaderAttributeProto(info, iter->second);
-  }
-  for (UniformMap::const_iterator iter = shader->uniform_map().begin();
-       iter != shader->uniform_map().end(); ++iter) {
-    ShaderUniformProto* info = proto->add_uniforms();
-    FillShaderUniformProto(info, iter->second);
-  }
-  for (VaryingMap::const_iterator iter = shader->varying_map().begin();
-       iter != shader->varying_map().end(); ++iter) {
-    ShaderVaryingProto* info = proto->add_varyings();
-    FillShaderVaryingProto(info, iter->second);
-  }
-  for (auto iter = shader->output_variable_list().begin();
-       iter != shader->output_variable_list().end(); ++iter) {
-    ShaderOutputVariableProto* info = proto->add_output_variables();
-    FillShaderOutputVariableProto(info, *iter);
-  }
-  for (InterfaceBlockMap::const_iterator iter =
-       shader->interface_block_map().begin();
-       iter != shader->interface_block_map().end(); ++iter) {
-    ShaderInterfaceBlockProto* info = proto->add_interface_blocks();
-    FillShaderInterfaceBlockProto(info, iter->second);
-  }
-}
-
-void RetrieveShaderVariableInfo(
-    const ShaderVariableProto& proto, sh::ShaderVariable* variable) {
-  variable->type = proto.type();
-  variable->precision = proto.precision();
-  variable->name = proto.name();
-  variable->mappedName = proto.mapped_name();
-  variable->setArraySize(proto.array_size());
-  variable->staticUse = proto.static_use();
-  variable->fields.resize(proto.fields_size());
-  for (int ii = 0; ii < proto.fields_size(); ++ii)
-    RetrieveShaderVariableInfo(proto.fields(ii), &(variable->fields[ii]));
-  variable->setStructName(proto.struct_name());
-}
-
-void RetrieveShaderAttributeInfo(
-    const ShaderAttributeProto& proto, AttributeMap* map) {
-  sh::Attribute attrib;
-  RetrieveShaderVariableInfo(proto.basic(), &attrib);
-  attrib.location = proto.location();
-  (*map)[proto.basic().mapped_name()] = attrib;
-}
-
-void RetrieveShaderUniformInfo(
-    const ShaderUniformProto& proto, UniformMap* map) {
-  sh::Uniform uniform;
-  RetrieveShaderVariableInfo(proto.basic(), &uniform);
-  (*map)[proto.basic().mapped_name()] = uniform;
-}
-
-void RetrieveShaderVaryingInfo(
-    const ShaderVaryingProto& proto, VaryingMap* map) {
-  sh::Varying varying;
-  RetrieveShaderVariableInfo(proto.basic(), &varying);
-  varying.interpolation = static_cast<sh::InterpolationType>(
-      proto.interpolation());
-  varying.isInvariant = proto.is_invariant();
-  (*map)[proto.basic().mapped_name()] = varying;
-}
-
-void RetrieveShaderOutputVariableInfo(const ShaderOutputVariableProto& proto,
-                                      OutputVariableList* list) {
-  sh::OutputVariable output_variable;
-  RetrieveShaderVariableInfo(proto.basic(), &output_variable);
-  output_variable.location = proto.location();
-  list->push_back(output_variable);
-}
-
-void RetrieveShaderInterfaceBlockFieldInfo(
-    const ShaderInterfaceBlockFieldProto& proto,
-    sh::InterfaceBlockField* interface_block_field) {
-  RetrieveShaderVariableInfo(proto.basic(), interface_block_field);
-  interface_block_field->isRowMajorLayout = proto.is_row_major_layout();
-}
-
-void RetrieveShaderInterfaceBlockInfo(const ShaderInterfaceBlockProto& proto,
-                                      InterfaceBlockMap* map) {
-  sh::InterfaceBlock interface_block;
-  interface_block.name = proto.name();
-  interface_block.mappedName = proto.mapped_name();
-  interface_block.instanceName = proto.instance_name();
-  interface_block.arraySize = proto.array_size();
-  interface_block.layout = static_cast<sh::BlockLayoutType>(proto.layout());
-  interface_block.isRowMajorLayout = proto.is_row_major_layout();
-  interface_block.staticUse = proto.static_use();
-  interface_block.fields.resize(proto.fields_size());
-  for (int ii = 0; ii < proto.fields_size(); ++ii) {
-    RetrieveShaderInterfaceBlockFieldInfo(proto.fields(ii),
-        &(interface_block.fields[ii]));
-  }
-  (*map)[proto.mapped_name()] = interface_block;
+  FillShaderVariablesProto(proto, shader->attrib_map(), shader->uniform_map(),
+                           shader->varying_map(),
+                           shader->output_variable_list(),
+                           shader->interface_block_map());
 }
 
 void RunShaderCallback(DecoderClient* client,
@@ -470,54 +316,19 @@ void MemoryProgramCache::LoadProgram(const std::string& key,
     VaryingMap vertex_varyings;
     OutputVariableList vertex_output_variables;
     InterfaceBlockMap vertex_interface_blocks;
-    for (int i = 0; i < proto->vertex_shader().attribs_size(); i++) {
-      RetrieveShaderAttributeInfo(proto->vertex_shader().attribs(i),
-                                  &vertex_attribs);
-    }
-    for (int i = 0; i < proto->vertex_shader().uniforms_size(); i++) {
-      RetrieveShaderUniformInfo(proto->vertex_shader().uniforms(i),
-                                &vertex_uniforms);
-    }
-    for (int i = 0; i < proto->vertex_shader().varyings_size(); i++) {
-      RetrieveShaderVaryingInfo(proto->vertex_shader().varyings(i),
-                                &vertex_varyings);
-    }
-    for (int i = 0; i < proto->vertex_shader().output_variables_size(); i++) {
-      RetrieveShaderOutputVariableInfo(
-          proto->vertex_shader().output_variables(i), &vertex_output_variables);
-    }
-    for (int i = 0; i < proto->vertex_shader().interface_blocks_size(); i++) {
-      RetrieveShaderInterfaceBlockInfo(
-          proto->vertex_shader().interface_blocks(i), &vertex_interface_blocks);
-    }
+    RetrieveShaderVariables(proto->vertex_shader(), &vertex_attribs,
+                            &vertex_uniforms, &vertex_varyings,
+                            &vertex_output_variables, &vertex_interface_blocks);
 
     AttributeMap fragment_attribs;
     UniformMap fragment_uniforms;
     VaryingMap fragment_varyings;
     OutputVariableList fragment_output_variables;
     InterfaceBlockMap fragment_interface_blocks;
-    for (int i = 0; i < proto->fragment_shader().attribs_size(); i++) {
-      RetrieveShaderAttributeInfo(proto->fragment_shader().attribs(i),
-                                  &fragment_attribs);
-    }
-    for (int i = 0; i < proto->fragment_shader().uniforms_size(); i++) {
-      RetrieveShaderUniformInfo(proto->fragment_shader().uniforms(i),
-                                &fragment_uniforms);
-    }
-    for (int i = 0; i < proto->fragment_shader().varyings_size(); i++) {
-      RetrieveShaderVaryingInfo(proto->fragment_shader().varyings(i),
-                                &fragment_varyings);
-    }
-    for (int i = 0; i < proto->fragment_shader().output_variables_size(); i++) {
-      RetrieveShaderOutputVariableInfo(
-          proto->fragment_shader().output_variables(i),
-          &fragment_output_variables);
-    }
-    for (int i = 0; i < proto->fragment_shader().interface_blocks_size(); i++) {
-      RetrieveShaderInterfaceBlockInfo(
-          proto->fragment_shader().interface_blocks(i),
-          &fragment_interface_blocks);
-    }
+    RetrieveShaderVariables(proto->fragment_shader(), &fragment_attribs,
+                            &fragment_uniforms, &fragment_varyings,
+                            &fragment_output_variables,
+                            &fragment_interface_blocks);
 
     std::vector<uint8_t> binary(proto->program().length());
     memcpy(binary.data(), proto->program().c_str(), proto->program().length());
@@ -88,12 +88,15 @@ Scheduler::Sequence::WaitFence::~WaitFence() = default;
 Scheduler::Sequence::WaitFence& Scheduler::Sequence::WaitFence::operator=(
     WaitFence&& other) = default;
 
-Scheduler::Sequence::Sequence(Scheduler* scheduler,
-                              SequenceId sequence_id,
-                              SchedulingPriority priority,
-                              scoped_refptr<SyncPointOrderData> order_data)
+Scheduler::Sequence::Sequence(
+    Scheduler* scheduler,
+    SequenceId sequence_id,
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    SchedulingPriority priority,
+    scoped_refptr<SyncPointOrderData> order_data)
     : scheduler_(scheduler),
       sequence_id_(sequence_id),
+      task_runner_(std::move(task_runner)),
       default_priority_(priority),
       current_priority_(priority),
       order_data_(std::move(order_data)) {}
@@ -361,6 +364,12 @@ void Scheduler::Sequence::RemoveClientWait(CommandBufferId command_buffer_id) {
   UpdateSchedulingPriority();
 }
 
+Scheduler::PerThreadState::PerThreadState() = default;
+Scheduler::PerThreadState::PerThreadState(PerThreadState&& other) = default;
+Scheduler::PerThreadState::~PerThreadState() = default;
+Scheduler::PerThreadState& Scheduler::PerThreadState::operator=(
+    PerThreadState&& other) = default;
+
 Scheduler::Scheduler(scoped_refptr<base::SingleThreadTaskRunner> task_runner,
                      SyncPointManager* sync_point_manager,
                      const GpuPreferences& gpu_preferences)
@@ -382,12 +391,21 @@ Scheduler::~Scheduler() {
 }
 
 SequenceId Scheduler::CreateSequence(SchedulingPriority priority) {
+  return CreateSequence(priority, task_runner_);
+}
+
+SequenceId Scheduler::CreateSequence(
+    SchedulingPriority priority,
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner) {
+  DCHECK(task_runner);
   base::AutoLock auto_lock(lock_);
   scoped_refptr<SyncPointOrderData> order_data =
       sync_point_manager_->CreateSyncPointOrderData();
   SequenceId sequence_id = order_data->sequence_id();
-  auto sequence = std::make_unique<Sequence>(this, sequence_id, priority,
-                                             std::move(order_data));
+  auto sequence =
+      std::make_unique<Sequence>(this, sequence_id, std::move(task_runner),
+                                 priority, std::move(order_data));
+  ++GetPerThreadState(sequence->task_runner()).num_sequences;
   sequences_.emplace(sequence_id, std::move(sequence));
   return sequence_id;
 }
@@ -399,11 +417,19 @@ void Scheduler::DestroySequence(SequenceId sequence_id) {
 
     Sequence* sequence = GetSequence(sequence_id);
     DCHECK(sequence);
+    base::SingleThreadTaskRunner* task_runner = sequence->task_runner();
+    PerThreadState& thread_state = GetPerThreadState(task_runner);
     if (sequence->scheduled())
-      rebuild_scheduling_queue_ = true;
+      thread_state.rebuild_scheduling_queue = true;
 
     tasks_to_be_destroyed = std::move(sequence->tasks_);
     sequences_.erase(sequence_id);
+
+    // A task to run the next task may still be pending on |task_runner|. It
+    // finds an empty queue and removes the state it looked up again.
+    DCHECK_GT(thread_state.num_sequences, 0);
+    if (!--thread_state.num_sequences)
+      per_thread_state_map_.erase(task_runner);
   }
 }
 
@@ -415,6 +441,12 @@ Scheduler::Sequence* Scheduler::GetSequence(SequenceId sequence_id) {
   return nullptr;
 }
 
+Scheduler::PerThreadState& Scheduler::GetPerThreadState(
+    base::SingleThreadTaskRunner* task_runner) {
+  lock_.AssertAcquired();
+  return per_thread_state_map_[task_runner];
+}
+
 void Scheduler::EnableSequence(SequenceId sequence_id) {
   base::AutoLock auto_lock(lock_);
   Sequence* sequence = GetSequence(sequence_id);
@@ -467,14 +499,24 @@ void Scheduler::ScheduleTaskHelper(Task task) {
   uint32_t order_num = sequence->ScheduleTask(std::move(task.closure),
                                               std::move(task.report_callback));
 
+  // Releases are handled on the thread of the waiting sequence, which the
+  // weak pointer can only be used on for the GPU thread.
+  scoped_refptr<base::SingleThreadTaskRunner> release_task_runner =
+      sequence->task_runner();
   for (const SyncToken& sync_token : task.sync_token_fences) {
     SequenceId release_sequence_id =
         sync_point_manager_->GetSyncTokenReleaseSequenceId(sync_token);
+    base::OnceClosure release_callback =
+        release_task_runner == task_runner_
+            ? base::BindOnce(&Scheduler::SyncTokenFenceReleased, weak_ptr_,
+                             sync_token, order_num, release_sequence_id,
+                             sequence_id)
+            : base::BindOnce(&Scheduler::SyncTokenFenceReleased,
+                             base::Unretained(this), sync_token, order_num,
+                             release_sequence_id, sequence_id);
     if (sync_point_manager_->WaitNonThreadSafe(
-            sync_token, sequence_id, order_num, task_runner_,
-            base::BindOnce(&Scheduler::SyncTokenFenceReleased, weak_ptr_,
-                           sync_token, order_num, release_sequence_id,
-                           sequence_id))) {
+            sync_token, sequence_id, order_num, release_task_runner,
+            std::move(release_callback))) {
       sequence->AddWaitFence(sync_token, order_num, release_sequence_id);
       sequence->SetLastTaskFirstDependencyTimeIfNeeded();
     }
@@ -485,27 +527,29 @@ void Scheduler::ScheduleTaskHelper(Task task) {
 
 void Scheduler::ContinueTask(SequenceId sequence_id,
                              base::OnceClosure closure) {
-  DCHECK(thread_checker_.CalledOnValidThread());
   base::AutoLock auto_lock(lock_);
   Sequence* sequence = GetSequence(sequence_id);
   DCHECK(sequence);
+  DCHECK(sequence->task_runner()->BelongsToCurrentThread());
   sequence->ContinueTask(std::move(closure));
 }
 
 bool Scheduler::ShouldYield(SequenceId sequence_id) {
-  DCHECK(thread_checker_.CalledOnValidThread());
   base::AutoLock auto_lock(lock_);
 
-  RebuildSchedulingQueue();
-
-  if (scheduling_queue_.empty())
-    return false;
-
   Sequence* running_sequence = GetSequence(sequence_id);
   DCHECK(running_sequence);
   DCHECK(running_sequence->running());
+  DCHECK(running_sequence->task_runner()->BelongsToCurrentThread());
 
-  Sequence* next_sequence = GetSequence(scheduling_queue_.front().sequence_id);
+  // Only sequences on the same thread compete for it.
+  RebuildSchedulingQueue(running_sequence->task_runner());
+  const std::vector<SchedulingState>& scheduling_queue =
+      GetPerThreadState(running_sequence->task_runner()).scheduling_queue;
+  if (scheduling_queue.empty())
+    return false;
+
+  Sequence* next_sequence = GetSequence(scheduling_queue.front().sequence_id);
   DCHECK(next_sequence);
   DCHECK(next_sequence->scheduled());
 
@@ -529,74 +573,99 @@ void Scheduler::SyncTokenFenceReleased(const SyncToken& sync_token,
 
 void Scheduler::TryScheduleSequence(Sequence* sequence) {
   lock_.AssertAcquired();
+  PerThreadState& thread_state = GetPerThreadState(sequence->task_runner());
 
   if (sequence->running()) {
     // Update priority of running sequence because of sync token releases.
-    DCHECK(running_);
+    DCHECK(thread_state.running);
     sequence->UpdateRunningPriority();
   } else if (sequence->NeedsRescheduling()) {
     // Rebuild scheduling queue if priority changed for a scheduled sequence.
-    DCHECK(running_);
+    DCHECK(thread_state.running);
     DCHECK(sequence->IsRunnable());
-    rebuild_scheduling_queue_ = true;
+    thread_state.rebuild_scheduling_queue = true;
   } else if (!sequence->scheduled() && sequence->IsRunnable()) {
     // Insert into scheduling queue if sequence isn't already scheduled.
     SchedulingState scheduling_state = sequence->SetScheduled();
-    scheduling_queue_.push_back(scheduling_state);
-    std::push_heap(scheduling_queue_.begin(), scheduling_queue_.end(),
+    thread_state.scheduling_queue.push_back(scheduling_state);
+    std::push_heap(thread_state.scheduling_queue.begin(),
+                   thread_state.scheduling_queue.end(),
                    &SchedulingState::Comparator);
-    if (!running_) {
-      TRACE_EVENT_ASYNC_BEGIN0("gpu", "Scheduler::Running", this);
-      running_ = true;
-      run_next_task_scheduled_ = base::TimeTicks::Now();
-      task_runner_->PostTask(
-          FROM_HERE, base::BindOnce(&Scheduler::RunNextTask, weak_ptr_));
+    if (!thread_state.running) {
+      TRACE_EVENT_ASYNC_BEGIN0("gpu", "Scheduler::Running",
+                               sequence->task_runner());
+      thread_state.running = true;
+      thread_state.run_next_task_scheduled = base::TimeTicks::Now();
+      sequence->task_runner()->PostTask(
+          FROM_HERE, BindRunNextTask(sequence->task_runner()));
     }
   }
 }
 
-void Scheduler::RebuildSchedulingQueue() {
-  DCHECK(thread_checker_.CalledOnValidThread());
+void Scheduler::RebuildSchedulingQueue(
+    base::SingleThreadTaskRunner* task_runner) {
+  DCHECK(task_runner->BelongsToCurrentThread());
   lock_.AssertAcquired();
 
-  if (!rebuild_scheduling_queue_)
+  PerThreadState& thread_state = GetPerThreadState(task_runner);
+  if (!thread_state.rebuild_scheduling_queue)
     return;
-  rebuild_scheduling_queue_ = false;
+  thread_state.rebuild_scheduling_queue = false;
 
-  scheduling_queue_.clear();
+  std::vector<SchedulingState>& scheduling_queue =
+      thread_state.scheduling_queue;
+  scheduling_queue.clear();
   for (const auto& kv : sequences_) {
     Sequence* sequence = kv.second.get();
-    if (!sequence->IsRunnable() || sequence->running())
+    if (sequence->task_runner() != task_runner || !sequence->IsRunnable() ||
+        sequence->running()) {
       continue;
+    }
     SchedulingState scheduling_state = sequence->SetScheduled();
-    scheduling_queue_.push_back(scheduling_state);
+    scheduling_queue.push_back(scheduling_state);
   }
 
-  std::make_heap(scheduling_queue_.begin(), scheduling_queue_.end(),
+  std::make_heap(scheduling_queue.begin(), scheduling_queue.end(),
                  &SchedulingState::Comparator);
 }
 
-void Scheduler::RunNextTask() {
-  DCHECK(thread_checker_.CalledOnValidThread());
+base::OnceClosure Scheduler::BindRunNextTask(
+    base::SingleThreadTaskRunner* task_runner) {
+  // The weak pointer can only be used on the GPU thread. Other task runners
+  // stop before the scheduler is destroyed.
+  if (task_runner == task_runner_.get())
+    return base::BindOnce(&Scheduler::RunNextTask, weak_ptr_,
+                          base::Unretained(task_runner));
+  return base::BindOnce(&Scheduler::RunNextTask, base::Unretained(this),
+                        base::Unretained(task_runner));
+}
+
+void Scheduler::RunNextTask(base::SingleThreadTaskRunner* task_runner) {
+  DCHECK(task_runner->BelongsToCurrentThread());
   base::AutoLock auto_lock(lock_);
+  PerThreadState* thread_state = &GetPerThreadState(task_runner);
   UMA_HISTOGRAM_CUSTOM_MICROSECONDS_TIMES(
       "GPU.Scheduler.ThreadSuspendedTime",
-      base::TimeTicks::Now() - run_next_task_scheduled_,
+      base::TimeTicks::Now() - thread_state->run_next_task_scheduled,
       base::TimeDelta::FromMicroseconds(10), base::TimeDelta::FromSeconds(30),
       100);
 
-  RebuildSchedulingQueue();
+  RebuildSchedulingQueue(task_runner);
 
-  if (scheduling_queue_.empty()) {
-    TRACE_EVENT_ASYNC_END0("gpu", "Scheduler::Running", this);
-    running_ = false;
+  std::vector<SchedulingState>* scheduling_queue =
+      &thread_state->scheduling_queue;
+  if (scheduling_queue->empty()) {
+    TRACE_EVENT_ASYNC_END0("gpu", "Scheduler::Running", task_runner);
+    thread_state->running = false;
+    if (!thread_state->num_sequences)
+      per_thread_state_map_.erase(task_runner);
     return;
   }
 
-  std::pop_heap(scheduling_queue_.begin(), scheduling_queue_.end(),
+  std::pop_heap(scheduling_queue->begin(), scheduling_queue->end(),
                 &SchedulingState::Comparator);
-  SchedulingState state = scheduling_queue_.back();
-  scheduling_queue_.pop_back();
+  SchedulingState state = scheduling_queue->back();
+  scheduling_queue->pop_back();
 
   base::ElapsedTimer task_timer;
 
@@ -630,7 +699,9 @@ void Scheduler::RunNextTask() {
     base::AutoUnlock auto_unlock(lock_);
     order_data->BeginProcessingOrderNumber(order_num);
 
-    if (blocked_time_collection_enabled_ && base::ThreadTicks::IsSupported()) {
+    // Blocked time is only collected for the GPU thread.
+    if (blocked_time_collection_enabled_ && task_runner == task_runner_.get() &&
+        base::ThreadTicks::IsSupported()) {
       // We can't call base::ThreadTicks::Now() if it's not supported
       base::ThreadTicks thread_time_start = base::ThreadTicks::Now();
       base::TimeTicks wall_time_start = base::TimeTicks::Now();
@@ -652,14 +723,19 @@ void Scheduler::RunNextTask() {
       order_data->FinishProcessingOrderNumber(order_num);
   }
 
+  // The state of the thread may have moved while the lock was released, if
+  // sequences were created on other task runners.
+  thread_state = &GetPerThreadState(task_runner);
+  scheduling_queue = &thread_state->scheduling_queue;
+
   // Check if sequence hasn't been destroyed.
   sequence = GetSequence(state.sequence_id);
   if (sequence) {
     sequence->FinishTask();
     if (sequence->IsRunnable()) {
       SchedulingState scheduling_state = sequence->SetScheduled();
-      scheduling_queue_.push_back(scheduling_state);
-      std::push_heap(scheduling_queue_.begin(), scheduling_queue_.end(),
+      scheduling_queue->push_back(scheduling_state);
+      std::push_heap(scheduling_queue->begin(), scheduling_queue->end(),
                      &SchedulingState::Comparator);
     }
   }
@@ -669,9 +745,8 @@ void Scheduler::RunNextTask() {
       base::TimeDelta::FromMicroseconds(10), base::TimeDelta::FromSeconds(30),
       100);
 
-  run_next_task_scheduled_ = base::TimeTicks::Now();
-  task_runner_->PostTask(FROM_HERE,
-                         base::BindOnce(&Scheduler::RunNextTask, weak_ptr_));
+  thread_state->run_next_task_scheduled = base::TimeTicks::Now();
+  task_runner->PostTask(FROM_HERE, BindRunNextTask(task_runner));
 }
 
 base::TimeDelta Scheduler::TakeTotalBlockingTime() {
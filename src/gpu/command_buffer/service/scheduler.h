@@ -69,6 +69,16 @@ class GPU_EXPORT Scheduler {
   // Sequence could be created outside of GPU thread.
   SequenceId CreateSequence(SchedulingPriority priority);
 
+  // Create a sequence whose tasks run on |task_runner| instead of the GPU
+  // thread. Sequences on different task runners run concurrently, so this is
+  // only for sequences that share no state with ones on other task runners
+  // besides what they synchronize with sync tokens. Tasks are scheduled in
+  // priority order among the sequences of the same task runner. |task_runner|
+  // must stop running tasks before the scheduler is destroyed.
+  SequenceId CreateSequence(
+      SchedulingPriority priority,
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner);
+
   // Destroy the sequence and run any scheduled tasks immediately. Sequence
   // could be destroyed outside of GPU thread.
   void DestroySequence(SequenceId sequence_id);
@@ -138,6 +148,7 @@ class GPU_EXPORT Scheduler {
    public:
     Sequence(Scheduler* scheduler,
              SequenceId sequence_id,
+             scoped_refptr<base::SingleThreadTaskRunner> task_runner,
              SchedulingPriority priority,
              scoped_refptr<SyncPointOrderData> order_data);
 
@@ -145,6 +156,10 @@ class GPU_EXPORT Scheduler {
 
     SequenceId sequence_id() const { return sequence_id_; }
 
+    base::SingleThreadTaskRunner* task_runner() const {
+      return task_runner_.get();
+    }
+
     const scoped_refptr<SyncPointOrderData>& order_data() const {
       return order_data_;
     }
@@ -312,6 +327,7 @@ class GPU_EXPORT Scheduler {
 
     Scheduler* const scheduler_;
     const SequenceId sequence_id_;
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
 
     const SchedulingPriority default_priority_;
     SchedulingPriority current_priority_;
@@ -343,15 +359,48 @@ class GPU_EXPORT Scheduler {
                               SequenceId release_sequence_id,
                               SequenceId waiting_sequence_id);
 
+  // Scheduling state of the sequences that run on one task runner.
+  struct PerThreadState {
+    PerThreadState();
+    PerThreadState(PerThreadState&& other);
+    ~PerThreadState();
+    PerThreadState& operator=(PerThreadState&& other);
+
+    // Number of sequences that run on the task runner. The state is removed
+    // with the last of them, since a task runner created later may reuse the
+    // address of this one.
+    int num_sequences = 0;
+
+    // If a task is running or a task to run the next one has been posted.
+    bool running = false;
+
+    // Used as a priority queue for scheduling sequences. Min heap of
+    // SchedulingState with highest priority (lowest order) in front.
+    std::vector<SchedulingState> scheduling_queue;
+
+    // If the scheduling queue needs to be rebuild because a sequence changed
+    // priority.
+    bool rebuild_scheduling_queue = false;
+
+    // Indicate when the next task run was scheduled
+    base::TimeTicks run_next_task_scheduled;
+  };
+
   void ScheduleTaskHelper(Task task);
 
   void TryScheduleSequence(Sequence* sequence);
 
-  void RebuildSchedulingQueue();
+  void RebuildSchedulingQueue(base::SingleThreadTaskRunner* task_runner);
 
   Sequence* GetSequence(SequenceId sequence_id);
 
-  void RunNextTask();
+  PerThreadState& GetPerThreadState(base::SingleThreadTaskRunner* task_runner);
+
+  // Returns a closure that runs the next task of the sequences on
+  // |task_runner|.
+  base::OnceClosure BindRunNextTask(base::SingleThreadTaskRunner* task_runner);
+
+  void RunNextTask(base::SingleThreadTaskRunner* task_runner);
 
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
 
@@ -360,17 +409,10 @@ class GPU_EXPORT Scheduler {
   mutable base::Lock lock_;
 
   // The following are protected by |lock_|.
-  bool running_ = false;
-
   base::flat_map<SequenceId, std::unique_ptr<Sequence>> sequences_;
 
-  // Used as a priority queue for scheduling sequences. Min heap of
-  // SchedulingState with highest priority (lowest order) in front.
-  std::vector<SchedulingState> scheduling_queue_;
-
-  // If the scheduling queue needs to be rebuild because a sequence changed
-  // priority.
-  bool rebuild_scheduling_queue_ = false;
+  base::flat_map<base::SingleThreadTaskRunner*, PerThreadState>
+      per_thread_state_map_;
 
   // Accumulated time the thread was blocked during running task
   base::TimeDelta total_blocked_time_;
@@ -378,9 +420,6 @@ class GPU_EXPORT Scheduler {
 
   base::ThreadChecker thread_checker_;
 
-  // Indicate when the next task run was scheduled
-  base::TimeTicks run_next_task_scheduled_;
-
   // Invalidated on main thread.
   base::WeakPtr<Scheduler> weak_ptr_;
   base::WeakPtrFactory<Scheduler> weak_factory_{this};
@@ -0,0 +1,167 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/hash/hash.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/common/sync_token.h"
+#include "gpu/command_buffer/service/scheduler.h"
+#include "gpu/command_buffer/service/sync_point_manager.h"
+#include "gpu/config/gpu_preferences.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace gpu {
+namespace {
+
+constexpr char kMetricPrefixScheduler[] = "Scheduler.";
+constexpr char kMetricFramesPerS[] = "frames_per_second";
+
+constexpr int kNumRenderers = 4;
+constexpr int kNumFrames = 200;
+constexpr size_t kRasterWorkSize = 256 * 1024;
+
+// Stands in for the decoder work of one renderer frame.
+void RasterFrame(const std::vector<uint8_t>* data, uint32_t* result) {
+  *result += base::PersistentHash(data->data(), data->size());
+}
+
+void RunOnThreadAndWait(base::Thread* thread, base::OnceClosure closure) {
+  base::WaitableEvent done;
+  thread->task_runner()->PostTask(FROM_HERE, std::move(closure));
+  thread->task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&base::WaitableEvent::Signal, base::Unretained(&done)));
+  done.Wait();
+}
+
+// Runs the frames of several renderers, each released with a sync token that
+// a display compositor sequence on the GPU thread waits on, the way renderer
+// raster and viz display compositing are ordered.
+class SchedulerPerfTest : public testing::Test {
+ public:
+  static void CreateScheduler(
+      std::unique_ptr<Scheduler>* scheduler,
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+      SyncPointManager* sync_point_manager) {
+    *scheduler = std::make_unique<Scheduler>(
+        std::move(task_runner), sync_point_manager, GpuPreferences());
+  }
+
+  void RunTest(bool use_worker_threads, const std::string& story) {
+    base::Thread gpu_thread("GpuThread");
+    ASSERT_TRUE(gpu_thread.Start());
+    std::vector<std::unique_ptr<base::Thread>> worker_threads;
+    if (use_worker_threads) {
+      for (int i = 0; i < kNumRenderers; ++i) {
+        worker_threads.push_back(std::make_unique<base::Thread>(
+            "RasterWorker" + base::NumberToString(i)));
+        ASSERT_TRUE(worker_threads.back()->Start());
+      }
+    }
+
+    SyncPointManager sync_point_manager;
+    std::unique_ptr<Scheduler> scheduler;
+    // The scheduler is bound to the thread it is created on.
+    RunOnThreadAndWait(
+        &gpu_thread,
+        base::BindOnce(&SchedulerPerfTest::CreateScheduler, &scheduler,
+                       gpu_thread.task_runner(), &sync_point_manager));
+
+    const CommandBufferNamespace namespace_id = CommandBufferNamespace::GPU_IO;
+    std::vector<SequenceId> sequence_ids;
+    std::vector<scoped_refptr<SyncPointClientState>> release_states;
+    for (int i = 0; i < kNumRenderers; ++i) {
+      SequenceId sequence_id =
+          use_worker_threads
+              ? scheduler->CreateSequence(SchedulingPriority::kNormal,
+                                          worker_threads[i]->task_runner())
+              : scheduler->CreateSequence(SchedulingPriority::kNormal);
+      sequence_ids.push_back(sequence_id);
+      release_states.push_back(sync_point_manager.CreateSyncPointClientState(
+          namespace_id, CommandBufferId::FromUnsafeValue(i + 1), sequence_id));
+    }
+    SequenceId display_sequence_id =
+        scheduler->CreateSequence(SchedulingPriority::kHigh);
+
+    const std::vector<uint8_t> raster_data(kRasterWorkSize, 1);
+    std::vector<uint32_t> results(kNumRenderers);
+    base::WaitableEvent done;
+    int displayed_frames = 0;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    // The release sequences need unprocessed order numbers before waits on
+    // them are valid, so the renderer frames are scheduled first.
+    for (int frame = 1; frame <= kNumFrames; ++frame) {
+      for (int i = 0; i < kNumRenderers; ++i) {
+        scheduler->ScheduleTask(Scheduler::Task(
+            sequence_ids[i],
+            base::BindOnce(
+                [](const std::vector<uint8_t>* data, uint32_t* result,
+                   SyncPointClientState* release_state, uint64_t release) {
+                  RasterFrame(data, result);
+                  release_state->ReleaseFenceSync(release);
+                },
+                &raster_data, &results[i], release_states[i].get(),
+                static_cast<uint64_t>(frame)),
+            std::vector<SyncToken>()));
+      }
+    }
+    for (int frame = 1; frame <= kNumFrames; ++frame) {
+      std::vector<SyncToken> sync_tokens;
+      for (int i = 0; i < kNumRenderers; ++i) {
+        sync_tokens.emplace_back(namespace_id,
+                                 CommandBufferId::FromUnsafeValue(i + 1),
+                                 frame);
+      }
+      scheduler->ScheduleTask(Scheduler::Task(
+          display_sequence_id,
+          base::BindOnce(
+              [](int* displayed_frames, base::WaitableEvent* done) {
+                if (++*displayed_frames == kNumFrames)
+                  done->Signal();
+              },
+              &displayed_frames, &done),
+          std::move(sync_tokens)));
+    }
+    done.Wait();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    for (auto& release_state : release_states)
+      release_state->Destroy();
+    for (SequenceId sequence_id : sequence_ids)
+      scheduler->DestroySequence(sequence_id);
+    scheduler->DestroySequence(display_sequence_id);
+    // The worker threads must stop before the scheduler is destroyed.
+    worker_threads.clear();
+    RunOnThreadAndWait(
+        &gpu_thread,
+        base::BindOnce(
+            [](std::unique_ptr<Scheduler> scheduler) { scheduler.reset(); },
+            std::move(scheduler)));
+
+    perf_test::PerfResultReporter reporter(kMetricPrefixScheduler, story);
+    reporter.RegisterImportantMetric(kMetricFramesPerS, "runs/s");
+    reporter.AddResult(kMetricFramesPerS, kNumFrames / elapsed.InSecondsF());
+  }
+};
+
+TEST_F(SchedulerPerfTest, RenderersOnGpuThread) {
+  RunTest(/*use_worker_threads=*/false, "renderers_on_gpu_thread");
+}
+
+TEST_F(SchedulerPerfTest, RenderersOnWorkerThreads) {
+  RunTest(/*use_worker_threads=*/true, "renderers_on_worker_threads");
+}
+
+}  // namespace
+}  // namespace gpu
@@ -122,6 +122,95 @@ TEST_F(SchedulerTest, ContinuedTasksRunFirst) {
   EXPECT_TRUE(ran2);
 }
 
+TEST_F(SchedulerTest, SequencesRunOnTheirTaskRunner) {
+  auto worker_task_runner = base::MakeRefCounted<base::TestSimpleTaskRunner>();
+
+  SequenceId sequence_id1 =
+      scheduler()->CreateSequence(SchedulingPriority::kNormal);
+  CommandBufferNamespace namespace_id = CommandBufferNamespace::GPU_IO;
+  CommandBufferId command_buffer_id = CommandBufferId::FromUnsafeValue(1);
+  scoped_refptr<SyncPointClientState> release_state =
+      sync_point_manager()->CreateSyncPointClientState(
+          namespace_id, command_buffer_id, sequence_id1);
+
+  SequenceId sequence_id2 = scheduler()->CreateSequence(
+      SchedulingPriority::kNormal, worker_task_runner);
+  SequenceId sequence_id3 = scheduler()->CreateSequence(
+      SchedulingPriority::kNormal, worker_task_runner);
+
+  uint64_t release = 1;
+  bool ran1 = false;
+  scheduler()->ScheduleTask(Scheduler::Task(sequence_id1, GetClosure([&] {
+                                              release_state->ReleaseFenceSync(
+                                                  release);
+                                              ran1 = true;
+                                            }),
+                                            std::vector<SyncToken>()));
+
+  SyncToken sync_token(namespace_id, command_buffer_id, release);
+  bool ran2 = false;
+  scheduler()->ScheduleTask(Scheduler::Task(sequence_id2, GetClosure([&] {
+                                              EXPECT_TRUE(ran1);
+                                              ran2 = true;
+                                            }),
+                                            {sync_token}));
+
+  bool ran3 = false;
+  scheduler()->ScheduleTask(Scheduler::Task(sequence_id3,
+                                            GetClosure([&] { ran3 = true; }),
+                                            std::vector<SyncToken>()));
+
+  // The sequence that does not wait runs on the worker without the main
+  // task runner running anything.
+  worker_task_runner->RunPendingTasks();
+  EXPECT_TRUE(ran3);
+  EXPECT_FALSE(ran1);
+  EXPECT_FALSE(ran2);
+
+  task_runner()->RunPendingTasks();
+  EXPECT_TRUE(ran1);
+  EXPECT_FALSE(ran2);
+
+  // The release is delivered to the worker, which then runs the waiting task.
+  while (worker_task_runner->HasPendingTask())
+    worker_task_runner->RunPendingTasks();
+  EXPECT_TRUE(ran2);
+
+  release_state->Destroy();
+  scheduler()->DestroySequence(sequence_id1);
+  scheduler()->DestroySequence(sequence_id2);
+  scheduler()->DestroySequence(sequence_id3);
+}
+
+TEST_F(SchedulerTest, TaskRunnerStateIsRemovedWithLastSequence) {
+  auto worker_task_runner = base::MakeRefCounted<base::TestSimpleTaskRunner>();
+
+  SequenceId sequence_id1 = scheduler()->CreateSequence(
+      SchedulingPriority::kNormal, worker_task_runner);
+  scheduler()->ScheduleTask(Scheduler::Task(
+      sequence_id1, GetClosure([] {}), std::vector<SyncToken>()));
+  EXPECT_TRUE(worker_task_runner->HasPendingTask());
+
+  // Destroy the sequence and drop the posted task, as happens when the thread
+  // of the task runner goes away. A task runner that is later created at the
+  // same address must not inherit the running state.
+  scheduler()->DestroySequence(sequence_id1);
+  worker_task_runner->ClearPendingTasks();
+
+  SequenceId sequence_id2 = scheduler()->CreateSequence(
+      SchedulingPriority::kNormal, worker_task_runner);
+  bool ran = false;
+  scheduler()->ScheduleTask(Scheduler::Task(
+      sequence_id2, GetClosure([&] { ran = true; }), std::vector<SyncToken>()));
+  EXPECT_TRUE(worker_task_runner->HasPendingTask());
+  worker_task_runner->RunPendingTasks();
+  EXPECT_TRUE(ran);
+
+  scheduler()->DestroySequence(sequence_id2);
+  worker_task_runner->RunPendingTasks();
+  EXPECT_FALSE(worker_task_runner->HasPendingTask());
+}
+
 class SchedulerTaskRunOrderTest : public SchedulerTest {
  public:
   SchedulerTaskRunOrderTest() = default;
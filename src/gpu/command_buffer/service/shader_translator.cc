@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <string.h>
 #include <algorithm>
+#include <utility>
 
 #include "base/at_exit.h"
 #include "base/check.h"
@@ -14,6 +15,7 @@
 #include "base/lazy_instance.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/trace_event/trace_event.h"
+#include "gpu/command_buffer/service/translated_shader_cache.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_implementation.h"
 #include "ui/gl/gl_version_info.h"
@@ -188,6 +190,12 @@ bool ShaderTranslator::Init(GLenum shader_type,
             std::string(":CompileOptions:" +
                         base::NumberToString(GetCompileOptions())) +
             sh::GetBuiltInResourcesString(compiler_));
+    translation_options_ =
+        ":ShVersion:" + base::NumberToString(ANGLE_SH_VERSION) +
+        ":ShaderType:" + base::NumberToString(shader_type) +
+        ":ShaderSpec:" + base::NumberToString(shader_spec) +
+        ":ShaderOutput:" + base::NumberToString(shader_output_language) +
+        options_affecting_compilation_->data;
   }
 
   return compiler_ != nullptr;
@@ -207,6 +215,62 @@ bool ShaderTranslator::Translate(
     VaryingMap* varying_map,
     InterfaceBlockMap* interface_block_map,
     OutputVariableList* output_variable_list) const {
+  if (!translated_shader_cache_) {
+    return TranslateUncached(shader_source, info_log, translated_source,
+                             shader_version, attrib_map, uniform_map,
+                             varying_map, interface_block_map,
+                             output_variable_list);
+  }
+
+  const std::string key =
+      TranslatedShaderCache::ComputeKey(translation_options_, shader_source);
+  TranslatedShaderCache::Result result;
+  const TranslatedShaderCache::Result* cached_result =
+      translated_shader_cache_->Get(key);
+  if (cached_result) {
+    TRACE_EVENT0("gpu", "ShaderTranslator::TranslateCacheHit");
+    result = *cached_result;
+  } else {
+    // The cached result must be complete, whichever outputs this caller
+    // asked for.
+    result.success = TranslateUncached(
+        shader_source, &result.info_log, &result.translated_source,
+        &result.shader_version, &result.attrib_map, &result.uniform_map,
+        &result.varying_map, &result.interface_block_map,
+        &result.output_variable_list);
+    translated_shader_cache_->Put(key, result);
+  }
+
+  if (result.success) {
+    if (translated_source)
+      *translated_source = std::move(result.translated_source);
+    *shader_version = result.shader_version;
+    if (attrib_map)
+      *attrib_map = std::move(result.attrib_map);
+    if (uniform_map)
+      *uniform_map = std::move(result.uniform_map);
+    if (varying_map)
+      *varying_map = std::move(result.varying_map);
+    if (interface_block_map)
+      *interface_block_map = std::move(result.interface_block_map);
+    if (output_variable_list)
+      *output_variable_list = std::move(result.output_variable_list);
+  }
+  if (info_log)
+    *info_log = std::move(result.info_log);
+  return result.success;
+}
+
+bool ShaderTranslator::TranslateUncached(
+    const std::string& shader_source,
+    std::string* info_log,
+    std::string* translated_source,
+    int* shader_version,
+    AttributeMap* attrib_map,
+    UniformMap* uniform_map,
+    VaryingMap* varying_map,
+    InterfaceBlockMap* interface_block_map,
+    OutputVariableList* output_variable_list) const {
   // Make sure this instance is initialized.
   DCHECK(compiler_ != nullptr);
 
@@ -21,6 +21,8 @@ struct GLVersionInfo;
 namespace gpu {
 namespace gles2 {
 
+class TranslatedShaderCache;
+
 // Mapping between variable name and info.
 typedef std::unordered_map<std::string, sh::Attribute> AttributeMap;
 typedef std::vector<sh::OutputVariable> OutputVariableList;
@@ -118,15 +120,35 @@ class GPU_GLES2_EXPORT ShaderTranslator : public ShaderTranslatorInterface {
   void AddDestructionObserver(DestructionObserver* observer);
   void RemoveDestructionObserver(DestructionObserver* observer);
 
+  // Results of Translate are looked up in and added to |cache| if it is
+  // non-null. |cache| must outlive this translator.
+  void set_translated_shader_cache(TranslatedShaderCache* cache) {
+    translated_shader_cache_ = cache;
+  }
+
  private:
   ~ShaderTranslator() override;
 
   ShCompileOptions GetCompileOptions() const;
 
+  bool TranslateUncached(const std::string& shader_source,
+                         std::string* info_log,
+                         std::string* translated_source,
+                         int* shader_version,
+                         AttributeMap* attrib_map,
+                         UniformMap* uniform_map,
+                         VaryingMap* varying_map,
+                         InterfaceBlockMap* interface_block_map,
+                         OutputVariableList* output_variable_list) const;
+
   ShHandle compiler_;
   ShCompileOptions compile_options_;
   scoped_refptr<OptionsAffectingCompilationString>
       options_affecting_compilation_;
+  // Identifies everything besides the source that affects the output of
+  // Translate.
+  std::string translation_options_;
+  TranslatedShaderCache* translated_shader_cache_ = nullptr;
   base::ObserverList<DestructionObserver>::Unchecked destruction_observers_;
 };
 
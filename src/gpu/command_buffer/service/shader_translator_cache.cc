@@ -7,10 +7,17 @@
 namespace gpu {
 namespace gles2 {
 
+namespace {
+
+// Enough for the shaders of a few large WebGL applications.
+constexpr size_t kTranslatedShaderCacheSizeBytes = 4 * 1024 * 1024;
+
+}  // namespace
+
 ShaderTranslatorCache::ShaderTranslatorCache(
     const GpuPreferences& gpu_preferences)
-    : gpu_preferences_(gpu_preferences) {
-}
+    : gpu_preferences_(gpu_preferences),
+      translated_shader_cache_(kTranslatedShaderCacheSizeBytes) {}
 
 ShaderTranslatorCache::~ShaderTranslatorCache() {
   DCHECK(cache_.empty());
@@ -46,6 +53,7 @@ scoped_refptr<ShaderTranslator> ShaderTranslatorCache::GetTranslator(
                        shader_output_language, driver_bug_workarounds,
                        gpu_preferences_.gl_shader_interm_output)) {
     cache_[params] = translator;
+    translator->set_translated_shader_cache(&translated_shader_cache_);
     translator->AddDestructionObserver(this);
     return translator;
   } else {
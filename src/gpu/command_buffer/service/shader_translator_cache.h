@@ -12,6 +12,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "gpu/command_buffer/service/shader_translator.h"
+#include "gpu/command_buffer/service/translated_shader_cache.h"
 #include "gpu/config/gpu_preferences.h"
 #include "third_party/angle/include/GLSLANG/ShaderLang.h"
 
@@ -43,6 +44,11 @@ class GPU_GLES2_EXPORT ShaderTranslatorCache
       ShShaderOutput shader_output_language,
       ShCompileOptions driver_bug_workarounds);
 
+  // Shared by all the translators handed out by this cache.
+  TranslatedShaderCache* translated_shader_cache() {
+    return &translated_shader_cache_;
+  }
+
  private:
   friend class ShaderTranslatorCacheTest_InitParamComparable_Test;
 
@@ -86,6 +92,7 @@ class GPU_GLES2_EXPORT ShaderTranslatorCache
   };
 
   const GpuPreferences gpu_preferences_;
+  TranslatedShaderCache translated_shader_cache_;
 
   typedef std::map<ShaderTranslatorInitParams, ShaderTranslator* > Cache;
   Cache cache_;
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "gpu/command_buffer/service/shader_translator.h"
+#include "gpu/command_buffer/service/translated_shader_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_version_info.h"
@@ -433,6 +434,73 @@ TEST_F(ShaderTranslatorTest, OptionsString) {
   EXPECT_NE(options_3, options_4);
 }
 
+TEST_F(ShaderTranslatorTest, TranslatedShaderCache) {
+  const char* shader =
+      "attribute vec4 vPosition;\n"
+      "uniform mat4 mvp;\n"
+      "void main() {\n"
+      "  gl_Position = mvp * vPosition;\n"
+      "}";
+  const char* bad_shader =
+      "void main() {\n"
+      "  gl_Position = vec4(1.0)\n"
+      "}";
+
+  std::string info_log, translated_source;
+  int shader_version;
+  AttributeMap attrib_map;
+  UniformMap uniform_map;
+  ASSERT_TRUE(vertex_translator_->Translate(
+      shader, &info_log, &translated_source, &shader_version, &attrib_map,
+      &uniform_map, nullptr, nullptr, nullptr));
+
+  TranslatedShaderCache cache(1024 * 1024);
+  vertex_translator_->set_translated_shader_cache(&cache);
+  fragment_translator_->set_translated_shader_cache(&cache);
+  for (int i = 0; i < 2; ++i) {
+    std::string cached_info_log, cached_translated_source;
+    int cached_shader_version;
+    AttributeMap cached_attrib_map;
+    UniformMap cached_uniform_map;
+    // The first translation only asks for the translated source.
+    EXPECT_TRUE(vertex_translator_->Translate(
+        shader, nullptr, &cached_translated_source, &cached_shader_version,
+        nullptr, nullptr, nullptr, nullptr, nullptr));
+    EXPECT_EQ(translated_source, cached_translated_source);
+    EXPECT_EQ(1u, cache.num_entries());
+
+    EXPECT_TRUE(vertex_translator_->Translate(
+        shader, &cached_info_log, &cached_translated_source,
+        &cached_shader_version, &cached_attrib_map, &cached_uniform_map,
+        nullptr, nullptr, nullptr));
+    EXPECT_EQ(info_log, cached_info_log);
+    EXPECT_EQ(translated_source, cached_translated_source);
+    EXPECT_EQ(shader_version, cached_shader_version);
+    EXPECT_EQ(attrib_map.size(), cached_attrib_map.size());
+    EXPECT_EQ(uniform_map.size(), cached_uniform_map.size());
+    EXPECT_EQ(1u, cache.num_entries());
+  }
+
+  // The same source translated for another shader type has its own entry.
+  EXPECT_FALSE(fragment_translator_->Translate(
+      shader, nullptr, nullptr, &shader_version, nullptr, nullptr, nullptr,
+      nullptr, nullptr));
+  EXPECT_EQ(2u, cache.num_entries());
+
+  // Errors are cached too.
+  for (int i = 0; i < 2; ++i) {
+    std::string error_log;
+    EXPECT_FALSE(vertex_translator_->Translate(
+        bad_shader, &error_log, nullptr, &shader_version, nullptr, nullptr,
+        nullptr, nullptr, nullptr));
+    EXPECT_FALSE(error_log.empty());
+    EXPECT_EQ(3u, cache.num_entries());
+  }
+
+  vertex_translator_->set_translated_shader_cache(nullptr);
+  fragment_translator_->set_translated_shader_cache(nullptr);
+}
+
 class ShaderTranslatorOutputVersionTest
     : public testing::TestWithParam<testing::tuple<const char*, const char*>> {
 };
@@ -155,6 +155,22 @@ bool SharedImageBacking::HasAnyRefs() const {
   return !refs_.empty();
 }
 
+bool SharedImageBacking::HasOnlyRef(
+    SharedImageRepresentation* representation) const {
+  AutoLock auto_lock(this);
+
+  return refs_.size() == 1u && refs_[0] == representation;
+}
+
+void SharedImageBacking::ResetForReuse(const Mailbox& mailbox) {
+  DCHECK_CALLED_ON_VALID_THREAD(factory_thread_checker_);
+  DCHECK(!HasAnyRefs());
+  DCHECK(!factory_);
+
+  mailbox_ = mailbox;
+  SetClearedRect(gfx::Rect());
+}
+
 void SharedImageBacking::OnReadSucceeded() {
   AutoLock auto_lock(this);
   if (scoped_write_uma_) {
@@ -89,6 +89,13 @@ class GPU_GLES2_EXPORT SharedImageBacking {
   void AddRef(SharedImageRepresentation* representation);
   void ReleaseRef(SharedImageRepresentation* representation);
   bool HasAnyRefs() const;
+  // Returns true if |representation| is the only ref.
+  bool HasOnlyRef(SharedImageRepresentation* representation) const;
+
+  // Gives an unregistered backing the |mailbox| of a new shared image with the
+  // same properties, so that it can be reused instead of being reallocated.
+  // Its contents are treated as uninitialized.
+  void ResetForReuse(const Mailbox& mailbox);
 
   // Notify backing a read access is succeeded
   void OnReadSucceeded();
@@ -226,7 +233,7 @@ class GPU_GLES2_EXPORT SharedImageBacking {
     DISALLOW_COPY_AND_ASSIGN(ScopedWriteUMA);
   };
 
-  const Mailbox mailbox_;
+  Mailbox mailbox_;
   const viz::ResourceFormat format_;
   const gfx::Size size_;
   const gfx::ColorSpace color_space_;
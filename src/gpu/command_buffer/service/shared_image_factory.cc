@@ -6,8 +6,11 @@
 
 #include <inttypes.h>
 
+#include <iterator>
+
 #include "base/strings/stringprintf.h"
 #include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "build/chromecast_buildflags.h"
 #include "build/chromeos_buildflags.h"
@@ -66,6 +69,16 @@
 
 namespace gpu {
 
+namespace {
+
+// The number and total estimated size of the backings of destroyed shared
+// images that are kept for reuse. A backing larger than the size limit is not
+// kept at all.
+constexpr size_t kMaxPooledBackings = 16;
+constexpr size_t kMaxPooledBackingBytes = 16 * 1024 * 1024;
+
+}  // namespace
+
 #if defined(OS_LINUX) && !BUILDFLAG(IS_CHROMEOS_ASH) &&            \
     !BUILDFLAG(IS_CHROMEOS_LACROS) && !BUILDFLAG(IS_CHROMECAST) && \
     BUILDFLAG(ENABLE_VULKAN)
@@ -209,6 +222,7 @@ SharedImageFactory::SharedImageFactory(
 
 SharedImageFactory::~SharedImageFactory() {
   DCHECK(shared_images_.empty());
+  DCHECK(backing_pool_.empty());
 }
 
 bool SharedImageFactory::CreateSharedImage(const Mailbox& mailbox,
@@ -223,10 +237,29 @@ bool SharedImageFactory::CreateSharedImage(const Mailbox& mailbox,
   auto* factory = GetFactoryByUsage(usage, format, &allow_legacy_mailbox);
   if (!factory)
     return false;
-  auto backing = factory->CreateSharedImage(
-      mailbox, format, surface_handle, size, color_space, surface_origin,
-      alpha_type, usage, IsSharedBetweenThreads(usage));
-  return RegisterBacking(std::move(backing), allow_legacy_mailbox);
+
+  // Only backings that are not registered with the legacy mailbox system or
+  // tied to a surface are pooled, since nothing else refers to them by their
+  // mailbox.
+  const bool poolable =
+      !allow_legacy_mailbox && surface_handle == kNullSurfaceHandle &&
+      (factory == wrapped_sk_image_factory_.get() ||
+       factory == backing_factory_for_testing_);
+  std::unique_ptr<SharedImageBacking> backing;
+  if (poolable) {
+    backing = TakePooledBacking(mailbox, format, size, color_space,
+                                surface_origin, alpha_type, usage);
+  }
+  if (!backing) {
+    backing = factory->CreateSharedImage(
+        mailbox, format, surface_handle, size, color_space, surface_origin,
+        alpha_type, usage, IsSharedBetweenThreads(usage));
+  }
+  if (!RegisterBacking(std::move(backing), allow_legacy_mailbox))
+    return false;
+  if (poolable)
+    poolable_shared_images_.insert(mailbox);
+  return true;
 }
 
 bool SharedImageFactory::CreateSharedImage(const Mailbox& mailbox,
@@ -320,7 +353,32 @@ bool SharedImageFactory::DestroySharedImage(const Mailbox& mailbox) {
     LOG(ERROR) << "DestroySharedImage: Could not find shared image mailbox";
     return false;
   }
+
+  if (!poolable_shared_images_.erase(mailbox)) {
+    shared_images_.erase(it);
+    return true;
+  }
+
+  // The factory ref is moved out of the set before the backing is taken, so
+  // that it is not left holding a destroyed ref.
+  using FactoryRefPtr = std::unique_ptr<SharedImageRepresentationFactoryRef>;
+  FactoryRefPtr shared_image = std::move(const_cast<FactoryRefPtr&>(*it));
   shared_images_.erase(it);
+  std::unique_ptr<SharedImageBacking> backing =
+      shared_image_manager_->TakeBacking(std::move(shared_image));
+  if (!backing)
+    return true;
+
+  TRACE_EVENT0("gpu", "SharedImageFactory::PoolBacking");
+  memory_tracker_->TrackMemAlloc(backing->estimated_size());
+  backing_pool_bytes_ += backing->estimated_size();
+  backing_pool_.push_back(std::move(backing));
+  while (backing_pool_.size() > kMaxPooledBackings ||
+         backing_pool_bytes_ > kMaxPooledBackingBytes) {
+    memory_tracker_->TrackMemFree(backing_pool_.front()->estimated_size());
+    backing_pool_bytes_ -= backing_pool_.front()->estimated_size();
+    backing_pool_.pop_front();
+  }
   return true;
 }
 
@@ -330,6 +388,51 @@ void SharedImageFactory::DestroyAllSharedImages(bool have_context) {
       shared_image->OnContextLost();
   }
   shared_images_.clear();
+  poolable_shared_images_.clear();
+  ClearBackingPool(have_context);
+}
+
+void SharedImageFactory::PurgeBackingPool() {
+  TRACE_EVENT0("gpu", "SharedImageFactory::PurgeBackingPool");
+  ClearBackingPool(true);
+}
+
+std::unique_ptr<SharedImageBacking> SharedImageFactory::TakePooledBacking(
+    const Mailbox& mailbox,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage) {
+  // Take the most recently pooled match, which is the most likely to still be
+  // resident.
+  for (auto it = backing_pool_.rbegin(); it != backing_pool_.rend(); ++it) {
+    SharedImageBacking* backing = it->get();
+    if (backing->format() != format || backing->size() != size ||
+        backing->color_space() != color_space ||
+        backing->surface_origin() != surface_origin ||
+        backing->alpha_type() != alpha_type || backing->usage() != usage) {
+      continue;
+    }
+    std::unique_ptr<SharedImageBacking> pooled_backing = std::move(*it);
+    backing_pool_.erase(std::next(it).base());
+    memory_tracker_->TrackMemFree(pooled_backing->estimated_size());
+    backing_pool_bytes_ -= pooled_backing->estimated_size();
+    pooled_backing->ResetForReuse(mailbox);
+    return pooled_backing;
+  }
+  return nullptr;
+}
+
+void SharedImageFactory::ClearBackingPool(bool have_context) {
+  for (auto& backing : backing_pool_) {
+    if (!have_context)
+      backing->OnContextLost();
+    memory_tracker_->TrackMemFree(backing->estimated_size());
+  }
+  backing_pool_.clear();
+  backing_pool_bytes_ = 0;
 }
 
 #if defined(OS_WIN)
@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "base/containers/circular_deque.h"
 #include "base/containers/flat_set.h"
 #include "base/memory/scoped_refptr.h"
 #include "build/build_config.h"
@@ -93,7 +94,11 @@ class GPU_GLES2_EXPORT SharedImageFactory {
                          std::unique_ptr<gfx::GpuFence> in_fence);
   bool DestroySharedImage(const Mailbox& mailbox);
   bool HasImages() const { return !shared_images_.empty(); }
+  size_t backing_pool_size_for_testing() const { return backing_pool_.size(); }
   void DestroyAllSharedImages(bool have_context);
+  // Releases the backings kept for reuse, e.g. under memory pressure. Must be
+  // called with the context current.
+  void PurgeBackingPool();
 
 #if defined(OS_WIN)
   bool CreateSwapChain(const Mailbox& front_buffer_mailbox,
@@ -139,6 +144,18 @@ class GPU_GLES2_EXPORT SharedImageFactory {
   MailboxManager* mailbox_manager() { return mailbox_manager_; }
 
  private:
+  // Returns a pooled backing with the given properties, given |mailbox|, or
+  // null if there is none.
+  std::unique_ptr<SharedImageBacking> TakePooledBacking(
+      const Mailbox& mailbox,
+      viz::ResourceFormat format,
+      const gfx::Size& size,
+      const gfx::ColorSpace& color_space,
+      GrSurfaceOrigin surface_origin,
+      SkAlphaType alpha_type,
+      uint32_t usage);
+  void ClearBackingPool(bool have_context);
+
   bool IsSharedBetweenThreads(uint32_t usage);
   bool CanUseWrappedSkImage(uint32_t usage) const;
   SharedImageBackingFactory* GetFactoryByUsage(
@@ -162,6 +179,17 @@ class GPU_GLES2_EXPORT SharedImageFactory {
   base::flat_set<std::unique_ptr<SharedImageRepresentationFactoryRef>>
       shared_images_;
 
+  // The shared images in |shared_images_| whose backings can be pooled when
+  // they are destroyed.
+  base::flat_set<Mailbox> poolable_shared_images_;
+
+  // Backings of destroyed shared images, oldest first, that are reused for
+  // new shared images with the same properties instead of allocating new
+  // ones. Tile resizing and video playback replace many images at once.
+  base::circular_deque<std::unique_ptr<SharedImageBacking>> backing_pool_;
+  // Sum of the estimated sizes of the backings in |backing_pool_|.
+  size_t backing_pool_bytes_ = 0;
+
   // TODO(ericrk): This should be some sort of map from usage to factory
   // eventually.
   std::unique_ptr<SharedImageBackingFactoryGLTexture> gl_backing_factory_;
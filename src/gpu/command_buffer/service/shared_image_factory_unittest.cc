@@ -9,6 +9,9 @@
 #include "gpu/command_buffer/common/shared_image_usage.h"
 #include "gpu/command_buffer/service/mailbox_manager_impl.h"
 #include "gpu/command_buffer/service/service_utils.h"
+#include "gpu/command_buffer/service/shared_image_backing_factory.h"
+#include "gpu/command_buffer/service/shared_image_representation.h"
+#include "gpu/command_buffer/service/test_shared_image_backing.h"
 #include "gpu/command_buffer/service/texture_manager.h"
 #include "gpu/command_buffer/tests/texture_image_factory.h"
 #include "gpu/config/gpu_driver_bug_workarounds.h"
@@ -107,5 +110,150 @@ TEST_F(SharedImageFactoryTest, DestroyInexistentMailbox) {
   EXPECT_FALSE(factory_->DestroySharedImage(mailbox));
 }
 
+// Creates TestSharedImageBackings and counts them.
+class CountingBackingFactory : public SharedImageBackingFactory {
+ public:
+  std::unique_ptr<SharedImageBacking> CreateSharedImage(
+      const Mailbox& mailbox,
+      viz::ResourceFormat format,
+      SurfaceHandle surface_handle,
+      const gfx::Size& size,
+      const gfx::ColorSpace& color_space,
+      GrSurfaceOrigin surface_origin,
+      SkAlphaType alpha_type,
+      uint32_t usage,
+      bool is_thread_safe) override {
+    ++created_count_;
+    return std::make_unique<TestSharedImageBacking>(
+        mailbox, format, size, color_space, surface_origin, alpha_type, usage,
+        size.GetArea() * 4);
+  }
+  std::unique_ptr<SharedImageBacking> CreateSharedImage(
+      const Mailbox& mailbox,
+      viz::ResourceFormat format,
+      const gfx::Size& size,
+      const gfx::ColorSpace& color_space,
+      GrSurfaceOrigin surface_origin,
+      SkAlphaType alpha_type,
+      uint32_t usage,
+      base::span<const uint8_t> pixel_data) override {
+    return nullptr;
+  }
+  std::unique_ptr<SharedImageBacking> CreateSharedImage(
+      const Mailbox& mailbox,
+      int client_id,
+      gfx::GpuMemoryBufferHandle handle,
+      gfx::BufferFormat format,
+      SurfaceHandle surface_handle,
+      const gfx::Size& size,
+      const gfx::ColorSpace& color_space,
+      GrSurfaceOrigin surface_origin,
+      SkAlphaType alpha_type,
+      uint32_t usage) override {
+    return nullptr;
+  }
+  bool CanImportGpuMemoryBuffer(
+      gfx::GpuMemoryBufferType memory_buffer_type) override {
+    return false;
+  }
+
+  int created_count() const { return created_count_; }
+
+ private:
+  int created_count_ = 0;
+};
+
+TEST_F(SharedImageFactoryTest, ReusesPooledBackings) {
+  CountingBackingFactory backing_factory;
+  factory_->RegisterSharedImageBackingFactoryForTesting(&backing_factory);
+  MemoryTypeTracker memory_tracker(nullptr);
+  auto format = viz::ResourceFormat::RGBA_8888;
+  gfx::Size size(256, 256);
+  auto color_space = gfx::ColorSpace::CreateSRGB();
+  uint32_t usage = SHARED_IMAGE_USAGE_RASTER | SHARED_IMAGE_USAGE_DISPLAY;
+
+  auto mailbox1 = Mailbox::GenerateForSharedImage();
+  EXPECT_TRUE(factory_->CreateSharedImage(
+      mailbox1, format, size, color_space, kTopLeft_GrSurfaceOrigin,
+      kPremul_SkAlphaType, gpu::kNullSurfaceHandle, usage));
+  shared_image_manager_.ProduceGLTexture(mailbox1, &memory_tracker)
+      ->SetCleared();
+  EXPECT_TRUE(factory_->DestroySharedImage(mailbox1));
+  EXPECT_EQ(1u, factory_->backing_pool_size_for_testing());
+
+  // The backing is reused under the new mailbox, with its contents
+  // uninitialized.
+  auto mailbox2 = Mailbox::GenerateForSharedImage();
+  EXPECT_TRUE(factory_->CreateSharedImage(
+      mailbox2, format, size, color_space, kTopLeft_GrSurfaceOrigin,
+      kPremul_SkAlphaType, gpu::kNullSurfaceHandle, usage));
+  EXPECT_EQ(1, backing_factory.created_count());
+  EXPECT_EQ(0u, factory_->backing_pool_size_for_testing());
+  EXPECT_FALSE(
+      shared_image_manager_.ProduceGLTexture(mailbox1, &memory_tracker));
+  auto representation =
+      shared_image_manager_.ProduceGLTexture(mailbox2, &memory_tracker);
+  ASSERT_TRUE(representation);
+  EXPECT_FALSE(representation->IsCleared());
+
+  // A backing that still has other refs is not pooled.
+  EXPECT_TRUE(factory_->DestroySharedImage(mailbox2));
+  EXPECT_EQ(0u, factory_->backing_pool_size_for_testing());
+  EXPECT_EQ(mailbox2, representation->mailbox());
+  representation.reset();
+
+  // Images with other properties get new backings.
+  auto mailbox3 = Mailbox::GenerateForSharedImage();
+  EXPECT_TRUE(factory_->CreateSharedImage(
+      mailbox3, format, gfx::Size(128, 128), color_space,
+      kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType, gpu::kNullSurfaceHandle,
+      usage));
+  EXPECT_EQ(2, backing_factory.created_count());
+  EXPECT_TRUE(factory_->DestroySharedImage(mailbox3));
+  EXPECT_EQ(1u, factory_->backing_pool_size_for_testing());
+
+  factory_->DestroyAllSharedImages(true);
+  EXPECT_EQ(0u, factory_->backing_pool_size_for_testing());
+}
+
+TEST_F(SharedImageFactoryTest, BackingPoolIsLimitedBySize) {
+  CountingBackingFactory backing_factory;
+  factory_->RegisterSharedImageBackingFactoryForTesting(&backing_factory);
+  auto format = viz::ResourceFormat::RGBA_8888;
+  auto color_space = gfx::ColorSpace::CreateSRGB();
+  uint32_t usage = SHARED_IMAGE_USAGE_RASTER | SHARED_IMAGE_USAGE_DISPLAY;
+
+  // Each of these backings is about 8MB, and the pool keeps at most 16MB.
+  for (int i = 0; i < 3; ++i) {
+    auto mailbox = Mailbox::GenerateForSharedImage();
+    EXPECT_TRUE(factory_->CreateSharedImage(
+        mailbox, format, gfx::Size(2048, 1024 + i), color_space,
+        kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType, gpu::kNullSurfaceHandle,
+        usage));
+    EXPECT_TRUE(factory_->DestroySharedImage(mailbox));
+  }
+  EXPECT_EQ(1u, factory_->backing_pool_size_for_testing());
+
+  // A backing larger than the limit is not kept.
+  auto mailbox = Mailbox::GenerateForSharedImage();
+  EXPECT_TRUE(factory_->CreateSharedImage(
+      mailbox, format, gfx::Size(4096, 2048), color_space,
+      kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType, gpu::kNullSurfaceHandle,
+      usage));
+  EXPECT_TRUE(factory_->DestroySharedImage(mailbox));
+  EXPECT_EQ(0u, factory_->backing_pool_size_for_testing());
+
+  // Memory pressure purges the pool.
+  mailbox = Mailbox::GenerateForSharedImage();
+  EXPECT_TRUE(factory_->CreateSharedImage(
+      mailbox, format, gfx::Size(256, 256), color_space,
+      kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType, gpu::kNullSurfaceHandle,
+      usage));
+  EXPECT_TRUE(factory_->DestroySharedImage(mailbox));
+  EXPECT_EQ(1u, factory_->backing_pool_size_for_testing());
+  factory_->PurgeBackingPool();
+  EXPECT_EQ(0u, factory_->backing_pool_size_for_testing());
+}
+
 }  // anonymous namespace
 }  // namespace gpu
@@ -119,6 +119,31 @@ SharedImageManager::Register(std::unique_ptr<SharedImageBacking> backing,
   return factory_ref;
 }
 
+std::unique_ptr<SharedImageBacking> SharedImageManager::TakeBacking(
+    std::unique_ptr<SharedImageRepresentationFactoryRef> factory_ref) {
+  CALLED_ON_VALID_THREAD();
+
+  const Mailbox mailbox = factory_ref->mailbox();
+  {
+    AutoLock autolock(this);
+    auto found = images_.find(mailbox);
+    if (found != images_.end() && (*found)->HasOnlyRef(factory_ref.get()))
+      backings_to_take_.emplace(mailbox, nullptr);
+  }
+
+  // Releasing the last ref moves the backing to |backings_to_take_|, unless
+  // another ref was taken in the meantime.
+  factory_ref.reset();
+
+  AutoLock autolock(this);
+  auto found = backings_to_take_.find(mailbox);
+  if (found == backings_to_take_.end())
+    return nullptr;
+  std::unique_ptr<SharedImageBacking> backing = std::move(found->second);
+  backings_to_take_.erase(found);
+  return backing;
+}
+
 void SharedImageManager::OnContextLost(const Mailbox& mailbox) {
   CALLED_ON_VALID_THREAD();
 
@@ -344,8 +369,16 @@ void SharedImageManager::OnRepresentationDestroyed(
     // SharedImageManager::OnRepresentationDestroyed can be nested, so we need
     // to get the iterator again.
     auto found = images_.find(mailbox);
-    if (found != images_.end() && (!(*found)->HasAnyRefs()))
+    if (found != images_.end() && (!(*found)->HasAnyRefs())) {
+      auto to_take = backings_to_take_.find(mailbox);
+      if (to_take != backings_to_take_.end()) {
+        // The set is ordered by mailbox, which moving the pointer out of the
+        // element does not change before it is erased.
+        to_take->second =
+            std::move(const_cast<std::unique_ptr<SharedImageBacking>&>(*found));
+      }
       images_.erase(found);
+    }
   }
 }
 
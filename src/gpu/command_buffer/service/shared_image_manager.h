@@ -5,6 +5,7 @@
 #ifndef GPU_COMMAND_BUFFER_SERVICE_SHARED_IMAGE_MANAGER_H_
 #define GPU_COMMAND_BUFFER_SERVICE_SHARED_IMAGE_MANAGER_H_
 
+#include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/optional.h"
@@ -40,6 +41,13 @@ class GPU_GLES2_EXPORT SharedImageManager {
       std::unique_ptr<SharedImageBacking> backing,
       MemoryTypeTracker* ref);
 
+  // Destroys |factory_ref|. If it was the only ref on its backing, the backing
+  // is unregistered and returned instead of being destroyed, so that the
+  // caller can register it again for another shared image. Returns null
+  // otherwise.
+  std::unique_ptr<SharedImageBacking> TakeBacking(
+      std::unique_ptr<SharedImageRepresentationFactoryRef> factory_ref);
+
   // Marks the backing associated with a mailbox as context lost.
   void OnContextLost(const Mailbox& mailbox);
 
@@ -120,6 +128,11 @@ class GPU_GLES2_EXPORT SharedImageManager {
 
   base::flat_set<std::unique_ptr<SharedImageBacking>> images_ GUARDED_BY(lock_);
 
+  // Backings that TakeBacking() is taking, moved here instead of being
+  // destroyed when their last ref is released.
+  base::flat_map<Mailbox, std::unique_ptr<SharedImageBacking>>
+      backings_to_take_ GUARDED_BY(lock_);
+
   const bool display_context_on_another_thread_;
 
 #if defined(OS_ANDROID)
@@ -0,0 +1,142 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/translated_shader_cache.h"
+
+#include <utility>
+
+#include "base/base64.h"
+#include "base/hash/sha1.h"
+#include "base/trace_event/trace_event.h"
+#include "gpu/command_buffer/service/disk_cache_proto.pb.h"
+#include "gpu/command_buffer/service/disk_cache_proto_utils.h"
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+template <typename Map>
+size_t EstimateMapSize(const Map& map) {
+  size_t size = 0;
+  for (const auto& entry : map)
+    size += entry.first.size() + sizeof(entry.second);
+  return size;
+}
+
+}  // namespace
+
+TranslatedShaderCache::Result::Result() = default;
+TranslatedShaderCache::Result::Result(const Result& other) = default;
+TranslatedShaderCache::Result::~Result() = default;
+
+size_t TranslatedShaderCache::Result::EstimateSize() const {
+  return sizeof(*this) + info_log.size() + translated_source.size() +
+         EstimateMapSize(attrib_map) + EstimateMapSize(uniform_map) +
+         EstimateMapSize(varying_map) + EstimateMapSize(interface_block_map) +
+         output_variable_list.size() * sizeof(sh::OutputVariable);
+}
+
+TranslatedShaderCache::TranslatedShaderCache(size_t max_size_bytes)
+    : max_size_bytes_(max_size_bytes), cache_(ResultMRUCache::NO_AUTO_EVICT) {}
+
+TranslatedShaderCache::~TranslatedShaderCache() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+}
+
+// static
+std::string TranslatedShaderCache::ComputeKey(
+    const std::string& translator_options,
+    const std::string& shader_source) {
+  std::string key;
+  base::Base64Encode(
+      base::SHA1HashString(translator_options + ":Source:" + shader_source),
+      &key);
+  return key;
+}
+
+const TranslatedShaderCache::Result* TranslatedShaderCache::Get(
+    const std::string& key) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  auto it = cache_.Get(key);
+  if (it == cache_.end())
+    return nullptr;
+  return &it->second;
+}
+
+void TranslatedShaderCache::Put(const std::string& key, const Result& result) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (max_size_bytes_ == 0)
+    return;
+  Insert(key, result);
+
+  if (persist_callback_.is_null())
+    return;
+  TRACE_EVENT0("gpu", "TranslatedShaderCache::PersistResult");
+  TranslatedShaderProto proto;
+  proto.set_success(result.success);
+  proto.set_info_log(result.info_log);
+  proto.set_translated_source(result.translated_source);
+  proto.set_shader_version(result.shader_version);
+  FillShaderVariablesProto(proto.mutable_variables(), result.attrib_map,
+                           result.uniform_map, result.varying_map,
+                           result.output_variable_list,
+                           result.interface_block_map);
+  std::string data;
+  proto.SerializeToString(&data);
+  persist_callback_.Run(key, data);
+}
+
+bool TranslatedShaderCache::LoadResult(const std::string& key,
+                                       const std::string& data) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  TranslatedShaderProto proto;
+  if (!proto.ParseFromString(data))
+    return false;
+
+  Result result;
+  result.success = proto.success();
+  result.info_log = proto.info_log();
+  result.translated_source = proto.translated_source();
+  result.shader_version = proto.shader_version();
+  RetrieveShaderVariables(proto.variables(), &result.attrib_map,
+                          &result.uniform_map, &result.varying_map,
+                          &result.output_variable_list,
+                          &result.interface_block_map);
+  Insert(key, result);
+  return true;
+}
+
+void TranslatedShaderCache::SetPersistCallback(
+    PersistCallback persist_callback) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  persist_callback_ = std::move(persist_callback);
+}
+
+void TranslatedShaderCache::set_max_size_bytes(size_t max_size_bytes) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  max_size_bytes_ = max_size_bytes;
+  EnforceLimits();
+}
+
+void TranslatedShaderCache::Insert(const std::string& key,
+                                   const Result& result) {
+  auto it = cache_.Peek(key);
+  if (it != cache_.end())
+    curr_size_bytes_ -= key.size() + it->second.EstimateSize();
+  cache_.Put(key, result);
+  curr_size_bytes_ += key.size() + result.EstimateSize();
+  EnforceLimits();
+}
+
+void TranslatedShaderCache::EnforceLimits() {
+  while (curr_size_bytes_ > max_size_bytes_ && !cache_.empty()) {
+    auto it = cache_.rbegin();
+    curr_size_bytes_ -= it->first.size() + it->second.EstimateSize();
+    cache_.Erase(it);
+  }
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -0,0 +1,94 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_TRANSLATED_SHADER_CACHE_H_
+#define GPU_COMMAND_BUFFER_SERVICE_TRANSLATED_SHADER_CACHE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/threading/thread_checker.h"
+#include "gpu/command_buffer/service/shader_translator.h"
+#include "gpu/gpu_gles2_export.h"
+
+namespace gpu {
+namespace gles2 {
+
+// Caches the output of ShaderTranslator::Translate, so that compiling a shader
+// that has been compiled with the same translator options before, in any
+// context sharing this cache, skips the ANGLE translation. The cache is bounded
+// by the approximate size of the cached results.
+class GPU_GLES2_EXPORT TranslatedShaderCache {
+ public:
+  struct GPU_GLES2_EXPORT Result {
+    Result();
+    Result(const Result& other);
+    ~Result();
+
+    size_t EstimateSize() const;
+
+    bool success = false;
+    std::string info_log;
+    std::string translated_source;
+    int shader_version = 0;
+    AttributeMap attrib_map;
+    UniformMap uniform_map;
+    VaryingMap varying_map;
+    InterfaceBlockMap interface_block_map;
+    OutputVariableList output_variable_list;
+  };
+
+  // Called with the key and serialized result of each new entry.
+  using PersistCallback =
+      base::RepeatingCallback<void(const std::string& key,
+                                   const std::string& data)>;
+
+  explicit TranslatedShaderCache(size_t max_size_bytes);
+  ~TranslatedShaderCache();
+
+  // Returns the key of |shader_source| translated with |translator_options|,
+  // which must identify everything that affects the translation.
+  static std::string ComputeKey(const std::string& translator_options,
+                                const std::string& shader_source);
+
+  // Returns the cached result for |key|, or nullptr. The result is only valid
+  // until the cache is next modified.
+  const Result* Get(const std::string& key);
+  void Put(const std::string& key, const Result& result);
+
+  // Adds an entry serialized by the persist callback, e.g. loaded from disk.
+  // Returns false if |data| could not be parsed.
+  bool LoadResult(const std::string& key, const std::string& data);
+
+  void SetPersistCallback(PersistCallback persist_callback);
+
+  void set_max_size_bytes(size_t max_size_bytes);
+  size_t max_size_bytes() const { return max_size_bytes_; }
+  size_t curr_size_bytes() const { return curr_size_bytes_; }
+  size_t num_entries() const { return cache_.size(); }
+
+ private:
+  using ResultMRUCache = base::MRUCache<std::string, Result>;
+
+  void Insert(const std::string& key, const Result& result);
+  void EnforceLimits();
+
+  size_t max_size_bytes_;
+  size_t curr_size_bytes_ = 0;
+  ResultMRUCache cache_;
+  PersistCallback persist_callback_;
+
+  THREAD_CHECKER(thread_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(TranslatedShaderCache);
+};
+
+}  // namespace gles2
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_TRANSLATED_SHADER_CACHE_H_
@@ -0,0 +1,135 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/translated_shader_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gl/gl_bindings.h"
+
+namespace gpu {
+namespace gles2 {
+namespace {
+
+constexpr char kOptions[] = ":CompileOptions:1";
+
+TranslatedShaderCache::Result CreateResult(const std::string& source) {
+  TranslatedShaderCache::Result result;
+  result.success = true;
+  result.translated_source = source;
+  result.shader_version = 100;
+
+  sh::Attribute attrib;
+  attrib.type = GL_FLOAT_VEC4;
+  attrib.precision = GL_HIGH_FLOAT;
+  attrib.name = "a_position";
+  attrib.mappedName = "_ua_position";
+  attrib.location = 0;
+  result.attrib_map[attrib.mappedName] = attrib;
+
+  sh::Uniform uniform;
+  uniform.type = GL_FLOAT_MAT4;
+  uniform.precision = GL_HIGH_FLOAT;
+  uniform.name = "u_mvp";
+  uniform.mappedName = "_uu_mvp";
+  result.uniform_map[uniform.mappedName] = uniform;
+  return result;
+}
+
+}  // namespace
+
+TEST(TranslatedShaderCacheTest, KeyDependsOnOptionsAndSource) {
+  const std::string key =
+      TranslatedShaderCache::ComputeKey(kOptions, "void main() {}");
+  EXPECT_EQ(key, TranslatedShaderCache::ComputeKey(kOptions, "void main() {}"));
+  EXPECT_NE(key, TranslatedShaderCache::ComputeKey(":CompileOptions:2",
+                                                   "void main() {}"));
+  EXPECT_NE(key, TranslatedShaderCache::ComputeKey(kOptions, "void main(){}"));
+}
+
+TEST(TranslatedShaderCacheTest, GetAndPut) {
+  TranslatedShaderCache cache(1024 * 1024);
+  EXPECT_EQ(nullptr, cache.Get("a"));
+
+  cache.Put("a", CreateResult("a source"));
+  const TranslatedShaderCache::Result* result = cache.Get("a");
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ("a source", result->translated_source);
+  EXPECT_EQ(1u, cache.num_entries());
+
+  cache.Put("a", CreateResult("other source"));
+  EXPECT_EQ(1u, cache.num_entries());
+  EXPECT_EQ("other source", cache.Get("a")->translated_source);
+}
+
+TEST(TranslatedShaderCacheTest, EvictsLeastRecentlyUsed) {
+  const std::string large_source(1000, 'x');
+  const size_t entry_size = 1 + CreateResult(large_source).EstimateSize();
+  TranslatedShaderCache cache(2 * entry_size);
+
+  cache.Put("a", CreateResult(large_source));
+  cache.Put("b", CreateResult(large_source));
+  EXPECT_NE(nullptr, cache.Get("a"));
+  cache.Put("c", CreateResult(large_source));
+  EXPECT_EQ(2u, cache.num_entries());
+  EXPECT_LE(cache.curr_size_bytes(), cache.max_size_bytes());
+  EXPECT_NE(nullptr, cache.Get("a"));
+  EXPECT_EQ(nullptr, cache.Get("b"));
+
+  cache.set_max_size_bytes(0);
+  EXPECT_EQ(0u, cache.num_entries());
+  EXPECT_EQ(0u, cache.curr_size_bytes());
+  cache.Put("d", CreateResult(large_source));
+  EXPECT_EQ(0u, cache.num_entries());
+}
+
+TEST(TranslatedShaderCacheTest, PersistAndLoad) {
+  std::vector<std::pair<std::string, std::string>> persisted;
+  TranslatedShaderCache cache(1024 * 1024);
+  cache.SetPersistCallback(base::BindRepeating(
+      [](std::vector<std::pair<std::string, std::string>>* persisted,
+         const std::string& key, const std::string& data) {
+        persisted->emplace_back(key, data);
+      },
+      &persisted));
+
+  TranslatedShaderCache::Result failed_result;
+  failed_result.info_log = "ERROR: 0:2: '}' : syntax error";
+  cache.Put("a", CreateResult("a source"));
+  cache.Put("b", failed_result);
+  ASSERT_EQ(2u, persisted.size());
+
+  TranslatedShaderCache loaded_cache(1024 * 1024);
+  EXPECT_FALSE(loaded_cache.LoadResult("c", "\xff not a proto"));
+  for (const auto& entry : persisted)
+    EXPECT_TRUE(loaded_cache.LoadResult(entry.first, entry.second));
+  EXPECT_EQ(2u, loaded_cache.num_entries());
+
+  const TranslatedShaderCache::Result* result = loaded_cache.Get("a");
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(result->success);
+  EXPECT_EQ("a source", result->translated_source);
+  EXPECT_EQ(100, result->shader_version);
+  ASSERT_EQ(1u, result->attrib_map.count("_ua_position"));
+  EXPECT_EQ("a_position", result->attrib_map.at("_ua_position").name);
+  EXPECT_EQ(0, result->attrib_map.at("_ua_position").location);
+  ASSERT_EQ(1u, result->uniform_map.count("_uu_mvp"));
+  EXPECT_EQ(static_cast<GLenum>(GL_FLOAT_MAT4),
+            result->uniform_map.at("_uu_mvp").type);
+
+  result = loaded_cache.Get("b");
+  ASSERT_NE(nullptr, result);
+  EXPECT_FALSE(result->success);
+  EXPECT_EQ(failed_result.info_log, result->info_log);
+
+  // Loading does not persist the entries again.
+  EXPECT_EQ(2u, persisted.size());
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -3,10 +3,13 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/process/process.h"
 #include "base/threading/platform_thread.h"
+#include "base/time/time.h"
 #include "gpu/command_buffer/client/gles2_cmd_helper.h"
 #include "gpu/command_buffer/client/gles2_implementation.h"
 #include "gpu/command_buffer/client/gpu_control.h"
@@ -30,6 +33,7 @@
 #include "gpu/command_buffer/service/shared_image_manager.h"
 #include "gpu/command_buffer/service/sync_point_manager.h"
 #include "gpu/command_buffer/service/transfer_buffer_manager.h"
+#include "gpu/command_buffer/service/translated_shader_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
 #include "ui/gfx/geometry/size.h"
@@ -82,6 +86,7 @@ class RecordReplayCommandBuffer : public CommandBufferDirect {
   void Flush(int32_t put_offset) override {
     DCHECK_NE(mode_, kReplay);
     if (mode_ == kDirect) {
+      ++flush_count_;
       CommandBufferDirect::Flush(put_offset);
     } else {
       DCHECK_GE(put_offset, saved_put_offset_);
@@ -131,9 +136,11 @@ class RecordReplayCommandBuffer : public CommandBufferDirect {
 
   int32_t saved_put_offset() const { return saved_put_offset_; }
   Mode mode() const { return mode_; }
+  int flush_count() const { return flush_count_; }
 
  private:
   Mode mode_ = kDirect;
+  int flush_count_ = 0;
   int32_t saved_put_offset_ = 0;
   int32_t saved_get_buffer_ = -1;
   int32_t current_get_buffer_ = -1;
@@ -257,6 +264,12 @@ class RecordReplayContext : public GpuControl {
 
   gles2::GLES2Implementation* gl() { return gles2_implementation_.get(); }
 
+  int flush_count() const { return command_buffer_->flush_count(); }
+
+  gles2::TranslatedShaderCache* translated_shader_cache() {
+    return translator_cache_.translated_shader_cache();
+  }
+
  private:
   // GpuControl implementation;
   void SetGpuControlClient(GpuControlClient*) override {}
@@ -704,5 +717,158 @@ TEST_F(DecoderPerfTest, ProgramDraw) {
     Replay();
 }
 
+// Measures texture uploads issued directly instead of replayed, so that the
+// client side flush and transfer buffer policies are part of the measurement.
+TEST_F(DecoderPerfTest, StreamingTextureUpload) {
+  constexpr int kSize = 32;
+  constexpr int kUploadsPerFrame = 10;
+  GLuint texture;
+  gl_->GenTextures(1, &texture);
+  gl_->BindTexture(GL_TEXTURE_2D, texture);
+  gl_->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kSize, kSize, 0, GL_RGBA,
+                  GL_UNSIGNED_BYTE, nullptr);
+  std::vector<uint8_t> pixels(kSize * kSize * 4, 0x80);
+
+  const int start_flush_count = context_->flush_count();
+  int frames = 0;
+  PerfIterator iterator("streaming_texture_upload", kDefaultRuns,
+                        kDefaultIterations / 50);
+  while (iterator.Iterate()) {
+    for (int i = 0; i < kUploadsPerFrame; ++i) {
+      gl_->TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kSize, kSize, GL_RGBA,
+                         GL_UNSIGNED_BYTE, pixels.data());
+    }
+    gl_->ShallowFlushCHROMIUM();
+    ++frames;
+  }
+
+  perf_test::PerfResultReporter reporter("Decoder.",
+                                         "streaming_texture_upload");
+  reporter.RegisterImportantMetric("flushes_per_frame", "count");
+  reporter.AddResult(
+      "flushes_per_frame",
+      static_cast<double>(context_->flush_count() - start_flush_count) /
+          frames);
+}
+
+// A few shaders typical of WebGL content: a textured quad, per-vertex
+// lighting and a per-pixel lit, fogged fragment shader.
+constexpr const char* kShaderCorpus[][2] = {
+    {kVertexShader, kFragmentShader},
+    {"attribute vec3 a_position;\n"
+     "attribute vec3 a_normal;\n"
+     "attribute vec2 a_texcoord;\n"
+     "uniform mat4 u_modelViewProjection;\n"
+     "uniform mat4 u_model;\n"
+     "uniform mat3 u_normalMatrix;\n"
+     "uniform vec3 u_lightPosition;\n"
+     "varying vec3 v_normal;\n"
+     "varying vec3 v_toLight;\n"
+     "varying vec2 v_texcoord;\n"
+     "varying float v_fogDepth;\n"
+     "void main() {\n"
+     "  vec4 world = u_model * vec4(a_position, 1.0);\n"
+     "  gl_Position = u_modelViewProjection * vec4(a_position, 1.0);\n"
+     "  v_normal = u_normalMatrix * a_normal;\n"
+     "  v_toLight = u_lightPosition - world.xyz;\n"
+     "  v_texcoord = a_texcoord;\n"
+     "  v_fogDepth = gl_Position.z;\n"
+     "}\n",
+     "precision mediump float;\n"
+     "varying vec3 v_normal;\n"
+     "varying vec3 v_toLight;\n"
+     "varying vec2 v_texcoord;\n"
+     "varying float v_fogDepth;\n"
+     "uniform sampler2D u_diffuse;\n"
+     "uniform sampler2D u_specular;\n"
+     "uniform vec3 u_ambient;\n"
+     "uniform vec4 u_fogColor;\n"
+     "uniform float u_fogNear;\n"
+     "uniform float u_fogFar;\n"
+     "uniform float u_shininess;\n"
+     "void main() {\n"
+     "  vec3 normal = normalize(v_normal);\n"
+     "  vec3 to_light = normalize(v_toLight);\n"
+     "  float diffuse = max(dot(normal, to_light), 0.0);\n"
+     "  vec3 half_vector = normalize(to_light + vec3(0.0, 0.0, 1.0));\n"
+     "  float specular = pow(max(dot(normal, half_vector), 0.0),\n"
+     "                       u_shininess);\n"
+     "  vec4 color = texture2D(u_diffuse, v_texcoord);\n"
+     "  color.rgb = color.rgb * (u_ambient + diffuse) +\n"
+     "              texture2D(u_specular, v_texcoord).rgb * specular;\n"
+     "  float fog = smoothstep(u_fogNear, u_fogFar, v_fogDepth);\n"
+     "  gl_FragColor = mix(color, u_fogColor, fog);\n"
+     "}\n"},
+    {"attribute vec4 a_position;\n"
+     "attribute vec4 a_color;\n"
+     "attribute vec4 a_weights;\n"
+     "attribute vec4 a_joints;\n"
+     "uniform mat4 u_viewProjection;\n"
+     "uniform mat4 u_bones[16];\n"
+     "varying vec4 v_color;\n"
+     "void main() {\n"
+     "  mat4 skin = a_weights.x * u_bones[int(a_joints.x)] +\n"
+     "              a_weights.y * u_bones[int(a_joints.y)] +\n"
+     "              a_weights.z * u_bones[int(a_joints.z)] +\n"
+     "              a_weights.w * u_bones[int(a_joints.w)];\n"
+     "  gl_Position = u_viewProjection * skin * a_position;\n"
+     "  v_color = a_color;\n"
+     "}\n",
+     "precision mediump float;\n"
+     "varying vec4 v_color;\n"
+     "uniform float u_time;\n"
+     "void main() {\n"
+     "  vec4 color = v_color;\n"
+     "  for (int i = 0; i < 4; ++i)\n"
+     "    color.rgb += 0.05 * sin(u_time * float(i + 1) + color.gbr);\n"
+     "  gl_FragColor = clamp(color, 0.0, 1.0);\n"
+     "}\n"},
+};
+
+// Measures compiling the same shaders over and over, as when many pages or
+// contexts use the same WebGL engine. Run with --use-stub to leave out the
+// driver.
+class ShaderCompilePerfTest : public DecoderPerfTest {
+ public:
+  void RunTest(bool use_translated_shader_cache, const std::string& story) {
+    gles2::TranslatedShaderCache* cache = context_->translated_shader_cache();
+    if (!use_translated_shader_cache)
+      cache->set_max_size_bytes(0);
+
+    constexpr int kIterations = 100;
+    int num_shaders = 0;
+    base::TimeTicks start;
+    // The first iteration warms up the cache and is not measured.
+    for (int i = 0; i <= kIterations; ++i) {
+      if (i == 1)
+        start = base::TimeTicks::Now();
+      for (const auto& shaders : kShaderCorpus) {
+        GLuint vshader = CompileShader(GL_VERTEX_SHADER, shaders[0]);
+        GLuint fshader = CompileShader(GL_FRAGMENT_SHADER, shaders[1]);
+        ASSERT_NE(0u, vshader);
+        ASSERT_NE(0u, fshader);
+        gl_->DeleteShader(vshader);
+        gl_->DeleteShader(fshader);
+        if (i > 0)
+          num_shaders += 2;
+      }
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    perf_test::PerfResultReporter reporter("Decoder.", story);
+    reporter.RegisterImportantMetric("compile_wall_time", "us");
+    reporter.AddResult("compile_wall_time",
+                       elapsed.InMicrosecondsF() / num_shaders);
+  }
+};
+
+TEST_F(ShaderCompilePerfTest, Uncached) {
+  RunTest(/*use_translated_shader_cache=*/false, "shader_compile_uncached");
+}
+
+TEST_F(ShaderCompilePerfTest, Cached) {
+  RunTest(/*use_translated_shader_cache=*/true, "shader_compile_cached");
+}
+
 }  // anonymous namespace
 }  // namespace gpu
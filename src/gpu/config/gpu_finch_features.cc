@@ -4,14 +4,16 @@
 
 #include "gpu/config/gpu_finch_features.h"
 
+#include <algorithm>
+
 #include "base/command_line.h"
+#include "base/metrics/field_trial_params.h"
 #include "build/chromeos_buildflags.h"
 #include "gpu/config/gpu_switches.h"
 
 #if defined(OS_ANDROID)
 #include "base/android/android_image_reader_compat.h"
 #include "base/android/build_info.h"
-#include "base/metrics/field_trial_params.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
@@ -214,6 +216,20 @@ const base::Feature kEnableGrShaderCacheForVulkan{
 const base::Feature kEnableVkPipelineCache{"EnableVkPipelineCache",
                                            base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Let the OOP raster context keep serializing into another transfer buffer
+// segment while the service replays a full one.
+const base::Feature kOopRasterTransferBufferSegments{
+    "OopRasterTransferBufferSegments", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::FeatureParam<int> kOopRasterTransferBufferMaxSegments{
+    &kOopRasterTransferBufferSegments, "max_segments", 3};
+
+uint32_t GetMaxOopRasterTransferBufferSegments() {
+  if (!base::FeatureList::IsEnabled(kOopRasterTransferBufferSegments))
+    return 1;
+  return std::max(kOopRasterTransferBufferMaxSegments.Get(), 1);
+}
+
 bool IsUsingVulkan() {
 #if defined(OS_ANDROID)
   // Force on if Vulkan feature is enabled from command line.
@@ -8,6 +8,8 @@
 #ifndef GPU_CONFIG_GPU_FEATURES_H_
 #define GPU_CONFIG_GPU_FEATURES_H_
 
+#include <stdint.h>
+
 #include "base/feature_list.h"
 #include "build/build_config.h"
 #include "gpu/gpu_export.h"
@@ -58,7 +60,12 @@ GPU_EXPORT extern const base::Feature kEnableGrShaderCacheForVulkan;
 
 GPU_EXPORT extern const base::Feature kEnableVkPipelineCache;
 
+GPU_EXPORT extern const base::Feature kOopRasterTransferBufferSegments;
+
 GPU_EXPORT bool IsUsingVulkan();
+// Returns the number of transfer buffer segments the OOP raster context may
+// serialize into in turn. 1 when kOopRasterTransferBufferSegments is disabled.
+GPU_EXPORT uint32_t GetMaxOopRasterTransferBufferSegments();
 #if defined(OS_ANDROID)
 GPU_EXPORT bool IsAImageReaderEnabled();
 GPU_EXPORT bool IsAndroidSurfaceControlEnabled();
@@ -15,9 +15,9 @@ ClientSharedImageInterface::ClientSharedImageInterface(
 
 ClientSharedImageInterface::~ClientSharedImageInterface() {
   gpu::SyncToken sync_token;
-  auto mailboxes_to_delete = mailboxes_;
-  for (const auto& mailbox : mailboxes_to_delete)
-    DestroySharedImage(sync_token, mailbox);
+  std::vector<Mailbox> mailboxes_to_delete(mailboxes_.begin(),
+                                           mailboxes_.end());
+  DestroySharedImages(sync_token, mailboxes_to_delete);
 }
 
 void ClientSharedImageInterface::UpdateSharedImage(const SyncToken& sync_token,
@@ -89,6 +89,21 @@ Mailbox ClientSharedImageInterface::CreateSharedImage(
       format, size, color_space, surface_origin, alpha_type, usage));
 }
 
+std::vector<Mailbox> ClientSharedImageInterface::CreateSharedImages(
+    size_t count,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage) {
+  std::vector<Mailbox> mailboxes = proxy_->CreateSharedImages(
+      count, format, size, color_space, surface_origin, alpha_type, usage);
+  for (const auto& mailbox : mailboxes)
+    AddMailbox(mailbox);
+  return mailboxes;
+}
+
 Mailbox ClientSharedImageInterface::CreateSharedImage(
     viz::ResourceFormat format,
     const gfx::Size& size,
@@ -150,6 +165,23 @@ void ClientSharedImageInterface::DestroySharedImage(const SyncToken& sync_token,
   proxy_->DestroySharedImage(sync_token, mailbox);
 }
 
+void ClientSharedImageInterface::DestroySharedImages(
+    const SyncToken& sync_token,
+    const std::vector<Mailbox>& mailboxes) {
+  if (mailboxes.empty())
+    return;
+
+  {
+    base::AutoLock lock(lock_);
+    for (const auto& mailbox : mailboxes) {
+      DCHECK(!mailbox.IsZero());
+      DCHECK_NE(mailboxes_.count(mailbox), 0u);
+      mailboxes_.erase(mailbox);
+    }
+  }
+  proxy_->DestroySharedImages(sync_token, mailboxes);
+}
+
 uint32_t ClientSharedImageInterface::UsageForMailbox(const Mailbox& mailbox) {
   return proxy_->UsageForMailbox(mailbox);
 }
@@ -52,6 +52,13 @@ class GPU_EXPORT ClientSharedImageInterface : public SharedImageInterface {
                             SkAlphaType alpha_type,
                             uint32_t usage,
                             gpu::SurfaceHandle surface_handle) override;
+  std::vector<Mailbox> CreateSharedImages(size_t count,
+                                          viz::ResourceFormat format,
+                                          const gfx::Size& size,
+                                          const gfx::ColorSpace& color_space,
+                                          GrSurfaceOrigin surface_origin,
+                                          SkAlphaType alpha_type,
+                                          uint32_t usage) override;
   Mailbox CreateSharedImage(viz::ResourceFormat format,
                             const gfx::Size& size,
                             const gfx::ColorSpace& color_space,
@@ -78,6 +85,8 @@ class GPU_EXPORT ClientSharedImageInterface : public SharedImageInterface {
                                      uint32_t usage) override;
   void DestroySharedImage(const SyncToken& sync_token,
                           const Mailbox& mailbox) override;
+  void DestroySharedImages(const SyncToken& sync_token,
+                           const std::vector<Mailbox>& mailboxes) override;
   uint32_t UsageForMailbox(const Mailbox& mailbox) override;
   void NotifyMailboxAdded(const Mailbox& mailbox, uint32_t usage) override;
 
@@ -106,6 +106,41 @@ Mailbox SharedImageInterfaceProxy::CreateSharedImage(
   return params.mailbox;
 }
 
+std::vector<Mailbox> SharedImageInterfaceProxy::CreateSharedImages(
+    size_t count,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage) {
+  if (!count)
+    return std::vector<Mailbox>();
+
+  GpuChannelMsg_CreateSharedImages_Params params;
+  params.mailboxes.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    params.mailboxes.push_back(Mailbox::GenerateForSharedImage());
+  params.format = format;
+  params.size = size;
+  params.color_space = color_space;
+  params.usage = usage;
+  params.surface_origin = surface_origin;
+  params.alpha_type = alpha_type;
+  {
+    base::AutoLock lock(lock_);
+    for (const auto& mailbox : params.mailboxes)
+      AddMailbox(mailbox, usage);
+    params.release_id = ++next_release_id_;
+    // Note: we enqueue the IPC under the lock to guarantee monotonicity of the
+    // release ids as seen by the service.
+    last_flush_id_ = host_->EnqueueDeferredMessage(
+        GpuChannelMsg_CreateSharedImages(route_id_, params));
+  }
+
+  return params.mailboxes;
+}
+
 Mailbox SharedImageInterfaceProxy::CreateSharedImage(
     viz::ResourceFormat format,
     const gfx::Size& size,
@@ -282,6 +317,28 @@ void SharedImageInterfaceProxy::DestroySharedImage(const SyncToken& sync_token,
   }
 }
 
+void SharedImageInterfaceProxy::DestroySharedImages(
+    const SyncToken& sync_token,
+    const std::vector<Mailbox>& mailboxes) {
+  if (mailboxes.empty())
+    return;
+
+  std::vector<SyncToken> dependencies =
+      GenerateDependenciesFromSyncToken(std::move(sync_token), host_);
+  {
+    base::AutoLock lock(lock_);
+
+    for (const auto& mailbox : mailboxes) {
+      DCHECK_NE(mailbox_to_usage_.count(mailbox), 0u);
+      mailbox_to_usage_.erase(mailbox);
+    }
+
+    last_flush_id_ = host_->EnqueueDeferredMessage(
+        GpuChannelMsg_DestroySharedImages(route_id_, mailboxes),
+        std::move(dependencies));
+  }
+}
+
 SyncToken SharedImageInterfaceProxy::GenVerifiedSyncToken() {
   SyncToken sync_token = GenUnverifiedSyncToken();
   // Force a synchronous IPC to validate sync token.
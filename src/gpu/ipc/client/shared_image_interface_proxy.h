@@ -26,6 +26,13 @@ class SharedImageInterfaceProxy {
                             GrSurfaceOrigin surface_origin,
                             SkAlphaType alpha_type,
                             uint32_t usage);
+  std::vector<Mailbox> CreateSharedImages(size_t count,
+                                          viz::ResourceFormat format,
+                                          const gfx::Size& size,
+                                          const gfx::ColorSpace& color_space,
+                                          GrSurfaceOrigin surface_origin,
+                                          SkAlphaType alpha_type,
+                                          uint32_t usage);
   Mailbox CreateSharedImage(viz::ResourceFormat format,
                             const gfx::Size& size,
                             const gfx::ColorSpace& color_space,
@@ -52,6 +59,8 @@ class SharedImageInterfaceProxy {
                          const Mailbox& mailbox);
 
   void DestroySharedImage(const SyncToken& sync_token, const Mailbox& mailbox);
+  void DestroySharedImages(const SyncToken& sync_token,
+                           const std::vector<Mailbox>& mailboxes);
   SyncToken GenVerifiedSyncToken();
   SyncToken GenUnverifiedSyncToken();
   void WaitSyncToken(const SyncToken& sync_token);
@@ -0,0 +1,134 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "components/viz/common/resources/resource_format.h"
+#include "gpu/command_buffer/client/raster_interface.h"
+#include "gpu/command_buffer/client/shared_image_interface.h"
+#include "gpu/command_buffer/client/shared_memory_limits.h"
+#include "gpu/command_buffer/common/shared_image_usage.h"
+#include "gpu/ipc/in_process_gpu_thread_holder.h"
+#include "gpu/ipc/raster_in_process_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "ui/gfx/color_space.h"
+#include "ui/gl/test/gl_surface_test_support.h"
+
+namespace gpu {
+namespace {
+
+constexpr char kMetricPrefixSharedImage[] = "SharedImage.";
+constexpr char kMetricCreateUs[] = "create_per_image";
+constexpr char kMetricDestroyUs[] = "destroy_per_image";
+
+constexpr viz::ResourceFormat kResourceFormat = viz::RGBA_8888;
+constexpr gfx::Size kTileSize(256, 256);
+constexpr size_t kNumImages = 64;
+constexpr int kNumIterations = 20;
+
+// Measures the cost of creating and destroying a set of tiles through
+// SharedImageInterfaceInProcess, one call per image or in a single batch.
+class SharedImagePerfTest : public testing::Test {
+ public:
+  static void SetUpTestSuite() { gl::GLSurfaceTestSupport::InitializeOneOff(); }
+
+  void SetUp() override {
+    if (!RasterInProcessContext::SupportedInTest())
+      return;
+
+    ContextCreationAttribs attributes;
+    attributes.bind_generates_resource = false;
+    attributes.enable_oop_rasterization = true;
+    attributes.enable_gles2_interface = false;
+    attributes.enable_raster_interface = true;
+
+    context_ = std::make_unique<RasterInProcessContext>();
+    auto result = context_->Initialize(
+        gpu_thread_holder_.GetTaskExecutor(), attributes, SharedMemoryLimits(),
+        /*gpu_memory_buffer_manager=*/nullptr, /*image_factory=*/nullptr,
+        /*gpu_channel_manager_delegate=*/nullptr, nullptr, nullptr);
+    if (result != ContextResult::kSuccess)
+      context_.reset();
+  }
+
+  void TearDown() override { context_.reset(); }
+
+  void RunTest(bool batched, const std::string& story) {
+    if (!context_)
+      return;
+
+    SharedImageInterface* sii = context_->GetSharedImageInterface();
+    const uint32_t usage = SHARED_IMAGE_USAGE_RASTER |
+                           SHARED_IMAGE_USAGE_OOP_RASTERIZATION |
+                           SHARED_IMAGE_USAGE_DISPLAY;
+    base::TimeDelta create_time;
+    base::TimeDelta destroy_time;
+    for (int i = 0; i < kNumIterations; ++i) {
+      base::TimeTicks start = base::TimeTicks::Now();
+      std::vector<Mailbox> mailboxes;
+      if (batched) {
+        mailboxes = sii->CreateSharedImages(
+            kNumImages, kResourceFormat, kTileSize,
+            gfx::ColorSpace::CreateSRGB(), kTopLeft_GrSurfaceOrigin,
+            kPremul_SkAlphaType, usage);
+      } else {
+        for (size_t j = 0; j < kNumImages; ++j) {
+          mailboxes.push_back(sii->CreateSharedImage(
+              kResourceFormat, kTileSize, gfx::ColorSpace::CreateSRGB(),
+              kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType, usage,
+              kNullSurfaceHandle));
+        }
+      }
+      WaitForGpu(sii->GenUnverifiedSyncToken());
+      create_time += base::TimeTicks::Now() - start;
+
+      start = base::TimeTicks::Now();
+      if (batched) {
+        sii->DestroySharedImages(SyncToken(), mailboxes);
+      } else {
+        for (const auto& mailbox : mailboxes)
+          sii->DestroySharedImage(SyncToken(), mailbox);
+      }
+      WaitForGpu(SyncToken());
+      destroy_time += base::TimeTicks::Now() - start;
+    }
+
+    const int num_images = kNumIterations * kNumImages;
+    perf_test::PerfResultReporter reporter(kMetricPrefixSharedImage, story);
+    reporter.RegisterImportantMetric(kMetricCreateUs, "us");
+    reporter.RegisterImportantMetric(kMetricDestroyUs, "us");
+    reporter.AddResult(kMetricCreateUs,
+                       create_time.InMicrosecondsF() / num_images);
+    reporter.AddResult(kMetricDestroyUs,
+                       destroy_time.InMicrosecondsF() / num_images);
+  }
+
+ private:
+  // Shared image tasks run on the same GPU sequence as the raster context, so
+  // finishing the context waits for all of them.
+  void WaitForGpu(const SyncToken& sync_token) {
+    raster::RasterInterface* ri = context_->GetImplementation();
+    if (sync_token.HasData())
+      ri->WaitSyncTokenCHROMIUM(sync_token.GetConstData());
+    ri->Finish();
+  }
+
+  InProcessGpuThreadHolder gpu_thread_holder_;
+  std::unique_ptr<RasterInProcessContext> context_;
+};
+
+TEST_F(SharedImagePerfTest, SingleImages) {
+  RunTest(/*batched=*/false, "single");
+}
+
+TEST_F(SharedImagePerfTest, BatchedImages) {
+  RunTest(/*batched=*/true, "batched");
+}
+
+}  // namespace
+}  // namespace gpu
@@ -26,6 +26,10 @@ constexpr int32_t kGrShaderCacheClientId = -2;
 // the same client ID for all clients.
 constexpr int32_t kPlatformVideoFramePoolClientId = -3;
 
+// The ID used for storing the results of the shader translator in the GPU
+// process. Like kGrShaderCacheClientId, it only names a disk cache namespace.
+constexpr int32_t kTranslatedShaderCacheClientId = -4;
+
 inline bool IsReservedClientId(int32_t client_id) {
   return client_id < 0;
 }
@@ -92,6 +92,17 @@ IPC_STRUCT_BEGIN(GpuChannelMsg_CreateSharedImage_Params)
   IPC_STRUCT_MEMBER(SkAlphaType, alpha_type)
 IPC_STRUCT_END()
 
+IPC_STRUCT_BEGIN(GpuChannelMsg_CreateSharedImages_Params)
+  IPC_STRUCT_MEMBER(std::vector<gpu::Mailbox>, mailboxes)
+  IPC_STRUCT_MEMBER(viz::ResourceFormat, format)
+  IPC_STRUCT_MEMBER(gfx::Size, size)
+  IPC_STRUCT_MEMBER(gfx::ColorSpace, color_space)
+  IPC_STRUCT_MEMBER(uint32_t, usage)
+  IPC_STRUCT_MEMBER(uint32_t, release_id)
+  IPC_STRUCT_MEMBER(GrSurfaceOrigin, surface_origin)
+  IPC_STRUCT_MEMBER(SkAlphaType, alpha_type)
+IPC_STRUCT_END()
+
 IPC_STRUCT_BEGIN(GpuChannelMsg_CreateSharedImageWithData_Params)
   IPC_STRUCT_MEMBER(gpu::Mailbox, mailbox)
   IPC_STRUCT_MEMBER(viz::ResourceFormat, format)
@@ -181,6 +192,11 @@ IPC_MESSAGE_ROUTED1(GpuChannelMsg_CreateSharedImageWithData,
 IPC_MESSAGE_ROUTED1(GpuChannelMsg_CreateGMBSharedImage,
                     GpuChannelMsg_CreateGMBSharedImage_Params /* params */)
 
+// Creates a SharedImage with the same properties for each of the mailboxes.
+// The sync token at |release_id| is released once all of them are created.
+IPC_MESSAGE_ROUTED1(GpuChannelMsg_CreateSharedImages,
+                    GpuChannelMsg_CreateSharedImages_Params /* params */)
+
 // The following IPC message, that can be used by the browser or renderers,
 // updates the SharedImage referenced by |id| after its contents are modified
 // (e.g: its GpuMemoryBuffer is modified via the CPU or through external
@@ -201,6 +217,8 @@ IPC_MESSAGE_ROUTED4(GpuChannelMsg_CreateSharedImageWithAHB,
                     uint32_t /* release_id */)
 #endif
 IPC_MESSAGE_ROUTED1(GpuChannelMsg_DestroySharedImage, gpu::Mailbox /* id */)
+IPC_MESSAGE_ROUTED1(GpuChannelMsg_DestroySharedImages,
+                    std::vector<gpu::Mailbox> /* ids */)
 #if defined(OS_WIN)
 IPC_MESSAGE_ROUTED1(GpuChannelMsg_CreateSwapChain,
                     GpuChannelMsg_CreateSwapChain_Params /* params */)
@@ -256,7 +256,9 @@ bool GpuChannelMessageFilter::OnMessageReceived(const IPC::Message& message) {
     case GpuCommandBufferMsg_ReturnFrontBuffer::ID:
     case GpuCommandBufferMsg_TakeFrontBuffer::ID:
     case GpuChannelMsg_CreateSharedImage::ID:
+    case GpuChannelMsg_CreateSharedImages::ID:
     case GpuChannelMsg_DestroySharedImage::ID:
+    case GpuChannelMsg_DestroySharedImages::ID:
       return MessageErrorHandler(message, "Invalid message");
     case GpuChannelMsg_CrashForTesting::ID:
       // Handle this message early, on the IO thread, in case the main
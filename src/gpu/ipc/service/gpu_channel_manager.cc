@@ -30,6 +30,7 @@
 #include "gpu/command_buffer/service/passthrough_program_cache.h"
 #include "gpu/command_buffer/service/scheduler.h"
 #include "gpu/command_buffer/service/service_utils.h"
+#include "gpu/command_buffer/service/shared_image_factory.h"
 #include "gpu/command_buffer/service/sync_point_manager.h"
 #include "gpu/ipc/common/gpu_client_ids.h"
 #include "gpu/ipc/common/gpu_messages.h"
@@ -475,6 +476,12 @@ void GpuChannelManager::PopulateShaderCache(int32_t client_id,
     return;
   }
 
+  if (client_id == kTranslatedShaderCacheClientId) {
+    shader_translator_cache_.translated_shader_cache()->LoadResult(key,
+                                                                   program);
+    return;
+  }
+
   if (program_cache())
     program_cache()->LoadProgram(key, program);
 }
@@ -669,6 +676,13 @@ void GpuChannelManager::HandleMemoryPressure(
       passthrough_discardable_manager_.HandleMemoryPressure(
           memory_pressure_level);
     shared_context_state_->PurgeMemory(memory_pressure_level);
+
+    // Drop the backings that shared image factories keep for reuse.
+    for (auto& kv : gpu_channels_) {
+      SharedImageFactory* factory = kv.second->shared_image_stub()->factory();
+      if (factory)
+        factory->PurgeBackingPool();
+    }
   }
 
   if (gr_shader_cache_)
@@ -879,6 +893,12 @@ void GpuChannelManager::StoreShader(const std::string& key,
   delegate_->StoreShaderToDisk(kGrShaderCacheClientId, key, shader);
 }
 
+void GpuChannelManager::ShaderUsed(const std::string& key) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+
+  delegate_->DidUseShader(kGrShaderCacheClientId, key);
+}
+
 void GpuChannelManager::SetImageDecodeAcceleratorWorkerForTesting(
     ImageDecodeAcceleratorWorker* worker) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
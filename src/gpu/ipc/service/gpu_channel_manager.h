@@ -191,6 +191,7 @@ class GPU_IPC_SERVICE_EXPORT GpuChannelManager
 
   // raster::GrShaderCache::Client implementation.
   void StoreShader(const std::string& key, const std::string& shader) override;
+  void ShaderUsed(const std::string& key) override;
 
   void SetImageDecodeAcceleratorWorkerForTesting(
       ImageDecodeAcceleratorWorker* worker);
@@ -58,6 +58,10 @@ class GpuChannelManagerDelegate {
                                  const std::string& key,
                                  const std::string& shader) = 0;
 
+  // Tells the delegate that the shader it was asked to store for |key| was
+  // used again, so that it can be kept over less recently used ones.
+  virtual void DidUseShader(int32_t client_id, const std::string& key) = 0;
+
   // Cleanly exits the GPU process in response to an error. This will not exit
   // with in-process GPU as that would also exit the browser. This can only be
   // called from the GPU thread.
@@ -0,0 +1,205 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/ipc/service/shader_disk_store.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/trace_event/trace_event.h"
+
+namespace gpu {
+
+namespace {
+
+// Increment when the layout of the file changes.
+constexpr uint32_t kFormatVersion = 1;
+
+// Every entry takes at least its client id and the lengths of its key and
+// data, which bounds the number of entries that a file of a given size can
+// hold.
+constexpr size_t kMinPickledEntrySize = 3 * sizeof(uint32_t);
+
+}  // namespace
+
+ShaderDiskStore::Entry::Entry() = default;
+ShaderDiskStore::Entry::Entry(int32_t client_id, std::string data)
+    : client_id(client_id), data(std::move(data)) {}
+ShaderDiskStore::Entry::Entry(Entry&& other) = default;
+ShaderDiskStore::Entry::~Entry() = default;
+ShaderDiskStore::Entry& ShaderDiskStore::Entry::operator=(Entry&& other) =
+    default;
+
+ShaderDiskStore::ShaderDiskStore(
+    const base::FilePath& path,
+    const std::string& fingerprint,
+    size_t max_size_bytes,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : fingerprint_(fingerprint),
+      max_size_bytes_(max_size_bytes),
+      task_runner_(task_runner),
+      writer_(path, std::move(task_runner)),
+      entries_(EntryMRUCache::NO_AUTO_EVICT) {}
+
+ShaderDiskStore::~ShaderDiskStore() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Flush();
+}
+
+void ShaderDiskStore::Load(LoadedEntryCallback callback,
+                           base::OnceClosure done_callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&ShaderDiskStore::ReadFile, writer_.path(), fingerprint_),
+      base::BindOnce(&ShaderDiskStore::OnLoaded, weak_ptr_factory_.GetWeakPtr(),
+                     std::move(callback), std::move(done_callback)));
+}
+
+void ShaderDiskStore::Store(int32_t client_id,
+                            const std::string& key,
+                            const std::string& data) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = entries_.Peek(key);
+  if (it != entries_.end())
+    curr_size_bytes_ -= key.size() + it->second.data.size();
+  entries_.Put(key, Entry(client_id, data));
+  curr_size_bytes_ += key.size() + data.size();
+  EnforceLimits();
+  writer_.ScheduleWrite(this);
+}
+
+void ShaderDiskStore::Touch(const std::string& key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = entries_.Peek(key);
+  if (it == entries_.end() || it == entries_.begin())
+    return;
+  entries_.Get(key);
+  order_changed_ = true;
+}
+
+void ShaderDiskStore::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (order_changed_ && !writer_.HasPendingWrite())
+    writer_.ScheduleWrite(this);
+  if (writer_.HasPendingWrite())
+    writer_.DoScheduledWrite();
+}
+
+bool ShaderDiskStore::SerializeData(std::string* data) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  TRACE_EVENT1("gpu", "ShaderDiskStore::SerializeData", "entries",
+               entries_.size());
+  order_changed_ = false;
+  base::Pickle pickle;
+  pickle.WriteUInt32(kFormatVersion);
+  pickle.WriteString(fingerprint_);
+  pickle.WriteUInt32(static_cast<uint32_t>(entries_.size()));
+  for (const auto& entry : entries_) {
+    pickle.WriteInt(entry.second.client_id);
+    pickle.WriteString(entry.first);
+    pickle.WriteString(entry.second.data);
+  }
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
+
+// static
+ShaderDiskStore::EntryList ShaderDiskStore::ReadFile(
+    const base::FilePath& path,
+    const std::string& fingerprint) {
+  TRACE_EVENT0("gpu", "ShaderDiskStore::ReadFile");
+  EntryList entries;
+  {
+    base::MemoryMappedFile file;
+    if (!file.Initialize(path))
+      return entries;
+
+    // The pickle reads from the mapping without copying it.
+    base::Pickle pickle(reinterpret_cast<const char*>(file.data()),
+                        file.length());
+    if (pickle.data()) {
+      base::PickleIterator iter(pickle);
+      uint32_t version = 0;
+      std::string file_fingerprint;
+      uint32_t num_entries = 0;
+      if (iter.ReadUInt32(&version) && version == kFormatVersion &&
+          iter.ReadString(&file_fingerprint) &&
+          file_fingerprint == fingerprint && iter.ReadUInt32(&num_entries) &&
+          num_entries <= pickle.payload_size() / kMinPickledEntrySize) {
+        entries.reserve(num_entries);
+        for (uint32_t i = 0; i < num_entries; ++i) {
+          std::string key;
+          Entry entry;
+          if (!iter.ReadInt(&entry.client_id) || !iter.ReadString(&key) ||
+              !iter.ReadString(&entry.data)) {
+            entries.clear();
+            break;
+          }
+          entries.emplace_back(std::move(key), std::move(entry));
+        }
+        if (!entries.empty() || num_entries == 0)
+          return entries;
+      }
+    }
+  }
+
+  // The file is stale or corrupt, so drop it instead of reading it again on
+  // the next start.
+  base::DeleteFile(path);
+  return EntryList();
+}
+
+void ShaderDiskStore::OnLoaded(LoadedEntryCallback callback,
+                               base::OnceClosure done_callback,
+                               EntryList loaded_entries) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  TRACE_EVENT1("gpu", "ShaderDiskStore::OnLoaded", "entries",
+               loaded_entries.size());
+
+  // Rebuild the store with the loaded entries behind the ones stored since.
+  EntryList stored_entries;
+  stored_entries.reserve(entries_.size());
+  for (auto& entry : entries_)
+    stored_entries.emplace_back(entry.first, std::move(entry.second));
+  entries_.Clear();
+  curr_size_bytes_ = 0;
+  for (auto it = loaded_entries.rbegin(); it != loaded_entries.rend(); ++it) {
+    curr_size_bytes_ += it->first.size() + it->second.data.size();
+    entries_.Put(it->first, std::move(it->second));
+  }
+  for (auto it = stored_entries.rbegin(); it != stored_entries.rend(); ++it) {
+    auto existing = entries_.Peek(it->first);
+    if (existing != entries_.end())
+      curr_size_bytes_ -= it->first.size() + existing->second.data.size();
+    curr_size_bytes_ += it->first.size() + it->second.data.size();
+    entries_.Put(it->first, std::move(it->second));
+  }
+  EnforceLimits();
+
+  // Hand out the loaded entries that are still current, most recently used
+  // first, so that the caches are warm before they are first used.
+  for (const auto& loaded_entry : loaded_entries) {
+    auto it = entries_.Peek(loaded_entry.first);
+    if (it == entries_.end())
+      continue;
+    callback.Run(it->second.client_id, it->first, it->second.data);
+  }
+  std::move(done_callback).Run();
+}
+
+void ShaderDiskStore::EnforceLimits() {
+  while (curr_size_bytes_ > max_size_bytes_ && !entries_.empty()) {
+    auto it = entries_.rbegin();
+    curr_size_bytes_ -= it->first.size() + it->second.data.size();
+    entries_.Erase(it);
+  }
+}
+
+}  // namespace gpu
@@ -0,0 +1,128 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_IPC_SERVICE_SHADER_DISK_STORE_H_
+#define GPU_IPC_SERVICE_SHADER_DISK_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "gpu/ipc/service/gpu_ipc_service_export.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace gpu {
+
+// Keeps the program binaries and Skia shaders that the GPU process would
+// otherwise ask the browser to store in its shader disk cache, in a single
+// file owned by the GPU process. The file is stamped with a format version and
+// a fingerprint of the GPU driver, and is discarded when either changes.
+// Entries are kept in most recently used order and the least recently used
+// ones are dropped to stay within the size limit.
+//
+// The file is memory-mapped and parsed on a background sequence at startup, so
+// that the caches can be prewarmed before the first frame without waiting for
+// the browser to read its cache. Writes are batched and done atomically on the
+// background sequence.
+class GPU_IPC_SERVICE_EXPORT ShaderDiskStore
+    : public base::ImportantFileWriter::DataSerializer {
+ public:
+  // Called for each loaded entry, most recently used first.
+  using LoadedEntryCallback =
+      base::RepeatingCallback<void(int32_t client_id,
+                                   const std::string& key,
+                                   const std::string& data)>;
+
+  struct Entry {
+    Entry();
+    Entry(int32_t client_id, std::string data);
+    Entry(Entry&& other);
+    ~Entry();
+    Entry& operator=(Entry&& other);
+
+    int32_t client_id = 0;
+    std::string data;
+  };
+  using EntryList = std::vector<std::pair<std::string, Entry>>;
+
+  // |fingerprint| identifies the GPU and driver that the stored binaries were
+  // built by. |task_runner| must allow blocking.
+  ShaderDiskStore(const base::FilePath& path,
+                  const std::string& fingerprint,
+                  size_t max_size_bytes,
+                  scoped_refptr<base::SequencedTaskRunner> task_runner);
+  ~ShaderDiskStore() override;
+
+  // Loads the file on the background sequence, then runs |callback| for each
+  // of its entries and |done_callback| on the calling sequence. Entries stored
+  // before the file has been loaded take precedence over the loaded ones.
+  void Load(LoadedEntryCallback callback, base::OnceClosure done_callback);
+
+  // Adds or replaces the entry for |key|, and schedules a write of the file.
+  void Store(int32_t client_id,
+             const std::string& key,
+             const std::string& data);
+
+  // Makes the entry for |key|, if any, the most recently used one, e.g. when
+  // its shader is used again. The new order is written with the next change of
+  // the entries, or by Flush().
+  void Touch(const std::string& key);
+
+  // Writes any scheduled changes, and the order of the entries if it changed,
+  // now.
+  void Flush();
+
+  size_t num_entries() const { return entries_.size(); }
+  size_t curr_size_bytes() const { return curr_size_bytes_; }
+
+  // base::ImportantFileWriter::DataSerializer implementation.
+  bool SerializeData(std::string* data) override;
+
+  // Reads the entries of the file at |path|, most recently used first. Returns
+  // an empty list if the file cannot be read, is malformed, or was written for
+  // another format version or |fingerprint|.
+  static EntryList ReadFile(const base::FilePath& path,
+                            const std::string& fingerprint);
+
+ private:
+  using EntryMRUCache = base::MRUCache<std::string, Entry>;
+
+  void OnLoaded(LoadedEntryCallback callback,
+                base::OnceClosure done_callback,
+                EntryList loaded_entries);
+  void EnforceLimits();
+
+  const std::string fingerprint_;
+  const size_t max_size_bytes_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::ImportantFileWriter writer_;
+
+  EntryMRUCache entries_;
+  size_t curr_size_bytes_ = 0;
+  // Set by Touch() until the entries are next serialized.
+  bool order_changed_ = false;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<ShaderDiskStore> weak_ptr_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ShaderDiskStore);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_IPC_SERVICE_SHADER_DISK_STORE_H_
@@ -0,0 +1,188 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/ipc/service/shader_disk_store.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/pickle.h"
+#include "base/strings/string_piece.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+namespace {
+
+constexpr char kFingerprint[] = "1234:5678|driver 1.0";
+constexpr size_t kMaxSizeBytes = 1024;
+
+class ShaderDiskStoreTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("shader_store");
+  }
+
+  std::unique_ptr<ShaderDiskStore> CreateStore(
+      const std::string& fingerprint = kFingerprint) {
+    return std::make_unique<ShaderDiskStore>(
+        path_, fingerprint, kMaxSizeBytes,
+        base::ThreadPool::CreateSequencedTaskRunner({base::MayBlock()}));
+  }
+
+  // Loads |store| and returns the keys of the loaded entries in the order they
+  // were handed out.
+  std::vector<std::string> Load(ShaderDiskStore* store) {
+    std::vector<std::string> keys;
+    bool done = false;
+    store->Load(base::BindRepeating(
+                    [](std::vector<std::string>* keys, int32_t client_id,
+                       const std::string& key, const std::string& data) {
+                      EXPECT_EQ(key + " data", data);
+                      keys->push_back(key);
+                    },
+                    &keys),
+                base::BindOnce([](bool* done) { *done = true; }, &done));
+    task_environment_.RunUntilIdle();
+    EXPECT_TRUE(done);
+    return keys;
+  }
+
+  void Store(ShaderDiskStore* store, const std::string& key) {
+    store->Store(1, key, key + " data");
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+};
+
+TEST_F(ShaderDiskStoreTest, LoadsMostRecentlyUsedFirst) {
+  {
+    auto store = CreateStore();
+    Store(store.get(), "a");
+    Store(store.get(), "b");
+    Store(store.get(), "c");
+    Store(store.get(), "a");
+    store->Flush();
+    task_environment_.RunUntilIdle();
+  }
+  ASSERT_TRUE(base::PathExists(path_));
+
+  auto store = CreateStore();
+  EXPECT_EQ(std::vector<std::string>({"a", "c", "b"}), Load(store.get()));
+  EXPECT_EQ(3u, store->num_entries());
+}
+
+TEST_F(ShaderDiskStoreTest, WritesOnDestruction) {
+  {
+    auto store = CreateStore();
+    Store(store.get(), "a");
+  }
+  task_environment_.RunUntilIdle();
+
+  auto store = CreateStore();
+  EXPECT_EQ(std::vector<std::string>({"a"}), Load(store.get()));
+}
+
+TEST_F(ShaderDiskStoreTest, DiscardsOtherDriver) {
+  {
+    auto store = CreateStore();
+    Store(store.get(), "a");
+  }
+  task_environment_.RunUntilIdle();
+
+  auto store = CreateStore("1234:5678|driver 2.0");
+  EXPECT_TRUE(Load(store.get()).empty());
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+TEST_F(ShaderDiskStoreTest, DiscardsCorruptFile) {
+  ASSERT_TRUE(base::WriteFile(path_, "not a shader store"));
+
+  auto store = CreateStore();
+  EXPECT_TRUE(Load(store.get()).empty());
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+TEST_F(ShaderDiskStoreTest, DiscardsFileWithMoreEntriesThanItCanHold) {
+  base::Pickle pickle;
+  pickle.WriteUInt32(1);
+  pickle.WriteString(kFingerprint);
+  pickle.WriteUInt32(0xffffffff);
+  ASSERT_TRUE(base::WriteFile(
+      path_, base::StringPiece(static_cast<const char*>(pickle.data()),
+                               pickle.size())));
+
+  auto store = CreateStore();
+  EXPECT_TRUE(Load(store.get()).empty());
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+TEST_F(ShaderDiskStoreTest, TouchedEntriesAreWrittenFirst) {
+  {
+    auto store = CreateStore();
+    Store(store.get(), "a");
+    Store(store.get(), "b");
+  }
+  task_environment_.RunUntilIdle();
+
+  // Loaded entries that are used again move ahead of the others.
+  {
+    auto store = CreateStore();
+    EXPECT_EQ(std::vector<std::string>({"b", "a"}), Load(store.get()));
+    store->Touch("a");
+    store->Touch("c");
+  }
+  task_environment_.RunUntilIdle();
+
+  auto store = CreateStore();
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), Load(store.get()));
+}
+
+TEST_F(ShaderDiskStoreTest, EvictsLeastRecentlyUsed) {
+  auto store = CreateStore();
+  const std::string large_data(kMaxSizeBytes / 2, 'x');
+  store->Store(1, "a", large_data);
+  store->Store(1, "b", large_data);
+  EXPECT_EQ(1u, store->num_entries());
+  EXPECT_LE(store->curr_size_bytes(), kMaxSizeBytes);
+
+  Store(store.get(), "c");
+  EXPECT_EQ(2u, store->num_entries());
+}
+
+TEST_F(ShaderDiskStoreTest, StoredEntriesTakePrecedence) {
+  {
+    auto store = CreateStore();
+    Store(store.get(), "a");
+    Store(store.get(), "b");
+  }
+  task_environment_.RunUntilIdle();
+
+  // "c" is stored before the file has been loaded, and stays the most recently
+  // used entry.
+  auto store = CreateStore();
+  Store(store.get(), "c");
+  EXPECT_EQ(std::vector<std::string>({"b", "a"}), Load(store.get()));
+  store->Flush();
+  task_environment_.RunUntilIdle();
+
+  ShaderDiskStore::EntryList entries =
+      ShaderDiskStore::ReadFile(path_, kFingerprint);
+  ASSERT_EQ(3u, entries.size());
+  EXPECT_EQ("c", entries[0].first);
+  EXPECT_EQ("b", entries[1].first);
+  EXPECT_EQ("a", entries[2].first);
+}
+
+}  // namespace
+}  // namespace gpu
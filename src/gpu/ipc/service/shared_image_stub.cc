@@ -71,6 +71,7 @@ bool SharedImageStub::OnMessageReceived(const IPC::Message& msg) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(SharedImageStub, msg)
     IPC_MESSAGE_HANDLER(GpuChannelMsg_CreateSharedImage, OnCreateSharedImage)
+    IPC_MESSAGE_HANDLER(GpuChannelMsg_CreateSharedImages, OnCreateSharedImages)
     IPC_MESSAGE_HANDLER(GpuChannelMsg_CreateSharedImageWithData,
                         OnCreateSharedImageWithData)
     IPC_MESSAGE_HANDLER(GpuChannelMsg_CreateGMBSharedImage,
@@ -81,6 +82,8 @@ bool SharedImageStub::OnMessageReceived(const IPC::Message& msg) {
                         OnCreateSharedImageWithAHB)
 #endif
     IPC_MESSAGE_HANDLER(GpuChannelMsg_DestroySharedImage, OnDestroySharedImage)
+    IPC_MESSAGE_HANDLER(GpuChannelMsg_DestroySharedImages,
+                        OnDestroySharedImages)
     IPC_MESSAGE_HANDLER(GpuChannelMsg_RegisterSharedImageUploadBuffer,
                         OnRegisterSharedImageUploadBuffer)
 #if defined(OS_WIN)
@@ -209,6 +212,38 @@ void SharedImageStub::OnCreateSharedImage(
   sync_point_client_state_->ReleaseFenceSync(params.release_id);
 }
 
+void SharedImageStub::OnCreateSharedImages(
+    const GpuChannelMsg_CreateSharedImages_Params& params) {
+  TRACE_EVENT2("gpu", "SharedImageStub::OnCreateSharedImages", "count",
+               params.mailboxes.size(), "width", params.size.width());
+  for (const auto& mailbox : params.mailboxes) {
+    if (!mailbox.IsSharedImage()) {
+      LOG(ERROR) << "SharedImageStub: Trying to create a SharedImage with a "
+                    "non-SharedImage mailbox.";
+      OnError();
+      return;
+    }
+  }
+
+  if (!MakeContextCurrent()) {
+    OnError();
+    return;
+  }
+
+  for (const auto& mailbox : params.mailboxes) {
+    if (!factory_->CreateSharedImage(mailbox, params.format, params.size,
+                                     params.color_space, params.surface_origin,
+                                     params.alpha_type, gpu::kNullSurfaceHandle,
+                                     params.usage)) {
+      LOG(ERROR) << "SharedImageStub: Unable to create shared image";
+      OnError();
+      return;
+    }
+  }
+
+  sync_point_client_state_->ReleaseFenceSync(params.release_id);
+}
+
 void SharedImageStub::OnCreateSharedImageWithData(
     const GpuChannelMsg_CreateSharedImageWithData_Params& params) {
   TRACE_EVENT2("gpu", "SharedImageStub::OnCreateSharedImageWithData", "width",
@@ -337,6 +372,33 @@ void SharedImageStub::OnDestroySharedImage(const Mailbox& mailbox) {
   }
 }
 
+void SharedImageStub::OnDestroySharedImages(
+    const std::vector<Mailbox>& mailboxes) {
+  TRACE_EVENT1("gpu", "SharedImageStub::OnDestroySharedImages", "count",
+               mailboxes.size());
+  for (const auto& mailbox : mailboxes) {
+    if (!mailbox.IsSharedImage()) {
+      LOG(ERROR) << "SharedImageStub: Trying to destroy a SharedImage with a "
+                    "non-SharedImage mailbox.";
+      OnError();
+      return;
+    }
+  }
+
+  if (!MakeContextCurrent()) {
+    OnError();
+    return;
+  }
+
+  for (const auto& mailbox : mailboxes) {
+    if (!factory_->DestroySharedImage(mailbox)) {
+      LOG(ERROR) << "SharedImageStub: Unable to destroy shared image";
+      OnError();
+      return;
+    }
+  }
+}
+
 #if defined(OS_WIN)
 void SharedImageStub::OnCreateSwapChain(
     const GpuChannelMsg_CreateSwapChain_Params& params) {
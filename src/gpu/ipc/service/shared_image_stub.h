@@ -5,6 +5,8 @@
 #ifndef GPU_IPC_SERVICE_SHARED_IMAGE_STUB_H_
 #define GPU_IPC_SERVICE_SHARED_IMAGE_STUB_H_
 
+#include <vector>
+
 #include "base/memory/weak_ptr.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "build/build_config.h"
@@ -82,6 +84,8 @@ class GPU_IPC_SERVICE_EXPORT SharedImageStub
 
   void OnCreateSharedImage(
       const GpuChannelMsg_CreateSharedImage_Params& params);
+  void OnCreateSharedImages(
+      const GpuChannelMsg_CreateSharedImages_Params& params);
   void OnCreateSharedImageWithData(
       const GpuChannelMsg_CreateSharedImageWithData_Params& params);
   void OnCreateGMBSharedImage(GpuChannelMsg_CreateGMBSharedImage_Params params);
@@ -95,6 +99,7 @@ class GPU_IPC_SERVICE_EXPORT SharedImageStub
                                   uint32_t release_id);
 #endif
   void OnDestroySharedImage(const Mailbox& mailbox);
+  void OnDestroySharedImages(const std::vector<Mailbox>& mailboxes);
   void OnRegisterSharedImageUploadBuffer(base::ReadOnlySharedMemoryRegion shm);
 #if defined(OS_WIN)
   void OnCreateSwapChain(const GpuChannelMsg_CreateSwapChain_Params& params);
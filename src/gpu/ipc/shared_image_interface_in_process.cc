@@ -176,6 +176,65 @@ void SharedImageInterfaceInProcess::CreateSharedImageOnGpuThread(
   sync_point_client_state_->ReleaseFenceSync(sync_token.release_count());
 }
 
+std::vector<Mailbox> SharedImageInterfaceInProcess::CreateSharedImages(
+    size_t count,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage) {
+  std::vector<Mailbox> mailboxes;
+  if (!count)
+    return mailboxes;
+
+  mailboxes.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    mailboxes.push_back(Mailbox::GenerateForSharedImage());
+  {
+    base::AutoLock lock(lock_);
+    // Note: we enqueue the task under the lock to guarantee monotonicity of
+    // the release ids as seen by the service. Unretained is safe because
+    // SharedImageInterfaceInProcess synchronizes with the GPU thread at
+    // destruction time, cancelling tasks, before |this| is destroyed.
+    ScheduleGpuTask(
+        base::BindOnce(
+            &SharedImageInterfaceInProcess::CreateSharedImagesOnGpuThread,
+            base::Unretained(this), mailboxes, format, size, color_space,
+            surface_origin, alpha_type, usage,
+            MakeSyncToken(next_fence_sync_release_++)),
+        {});
+  }
+  return mailboxes;
+}
+
+void SharedImageInterfaceInProcess::CreateSharedImagesOnGpuThread(
+    const std::vector<Mailbox>& mailboxes,
+    viz::ResourceFormat format,
+    const gfx::Size& size,
+    const gfx::ColorSpace& color_space,
+    GrSurfaceOrigin surface_origin,
+    SkAlphaType alpha_type,
+    uint32_t usage,
+    const SyncToken& sync_token) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(gpu_sequence_checker_);
+  if (!MakeContextCurrent())
+    return;
+
+  LazyCreateSharedImageFactory();
+
+  for (const auto& mailbox : mailboxes) {
+    if (!shared_image_factory_->CreateSharedImage(
+            mailbox, format, size, color_space, surface_origin, alpha_type,
+            kNullSurfaceHandle, usage)) {
+      // Signal errors by losing the command buffer.
+      command_buffer_helper_->SetError();
+      return;
+    }
+  }
+  sync_point_client_state_->ReleaseFenceSync(sync_token.release_count());
+}
+
 Mailbox SharedImageInterfaceInProcess::CreateSharedImage(
     viz::ResourceFormat format,
     const gfx::Size& size,
@@ -442,6 +501,37 @@ void SharedImageInterfaceInProcess::DestroySharedImageOnGpuThread(
   }
 }
 
+void SharedImageInterfaceInProcess::DestroySharedImages(
+    const SyncToken& sync_token,
+    const std::vector<Mailbox>& mailboxes) {
+  if (mailboxes.empty())
+    return;
+
+  // Use sync token dependency to ensure that the destroy task does not run
+  // before sync token is released.
+  ScheduleGpuTask(
+      base::BindOnce(
+          &SharedImageInterfaceInProcess::DestroySharedImagesOnGpuThread,
+          base::Unretained(this), mailboxes),
+      {sync_token});
+}
+
+void SharedImageInterfaceInProcess::DestroySharedImagesOnGpuThread(
+    const std::vector<Mailbox>& mailboxes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(gpu_sequence_checker_);
+  if (!MakeContextCurrent())
+    return;
+
+  for (const auto& mailbox : mailboxes) {
+    if (!shared_image_factory_ ||
+        !shared_image_factory_->DestroySharedImage(mailbox)) {
+      // Signal errors by losing the command buffer.
+      command_buffer_helper_->SetError();
+      return;
+    }
+  }
+}
+
 void SharedImageInterfaceInProcess::WaitSyncTokenOnGpuThread(
     const SyncToken& sync_token) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(gpu_sequence_checker_);
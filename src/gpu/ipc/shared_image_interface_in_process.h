@@ -46,6 +46,16 @@ class GL_IN_PROCESS_CONTEXT_EXPORT SharedImageInterfaceInProcess
                             uint32_t usage,
                             gpu::SurfaceHandle surface_handle) override;
 
+  // Creates |count| shared images with the above properties in a single GPU
+  // task.
+  std::vector<Mailbox> CreateSharedImages(size_t count,
+                                          viz::ResourceFormat format,
+                                          const gfx::Size& size,
+                                          const gfx::ColorSpace& color_space,
+                                          GrSurfaceOrigin surface_origin,
+                                          SkAlphaType alpha_type,
+                                          uint32_t usage) override;
+
   // Same behavior as the above, except that this version takes |pixel_data|
   // which is used to populate the SharedImage.  |pixel_data| should have the
   // same format which would be passed to glTexImage2D to populate a similarly
@@ -103,6 +113,11 @@ class GL_IN_PROCESS_CONTEXT_EXPORT SharedImageInterfaceInProcess
   void DestroySharedImage(const SyncToken& sync_token,
                           const Mailbox& mailbox) override;
 
+  // Destroys all of |mailboxes| in a single GPU task after |sync_token| has
+  // been released.
+  void DestroySharedImages(const SyncToken& sync_token,
+                           const std::vector<Mailbox>& mailboxes) override;
+
   // Creates a swap chain. Not reached in this implementation.
   SwapChainMailboxes CreateSwapChain(viz::ResourceFormat format,
                                      const gfx::Size& size,
@@ -171,6 +186,14 @@ class GL_IN_PROCESS_CONTEXT_EXPORT SharedImageInterfaceInProcess
                                     SkAlphaType alpha_type,
                                     uint32_t usage,
                                     const SyncToken& sync_token);
+  void CreateSharedImagesOnGpuThread(const std::vector<Mailbox>& mailboxes,
+                                     viz::ResourceFormat format,
+                                     const gfx::Size& size,
+                                     const gfx::ColorSpace& color_space,
+                                     GrSurfaceOrigin surface_origin,
+                                     SkAlphaType alpha_type,
+                                     uint32_t usage,
+                                     const SyncToken& sync_token);
   void CreateSharedImageWithDataOnGpuThread(const Mailbox& mailbox,
                                             viz::ResourceFormat format,
                                             const gfx::Size& size,
@@ -193,6 +216,7 @@ class GL_IN_PROCESS_CONTEXT_EXPORT SharedImageInterfaceInProcess
   void UpdateSharedImageOnGpuThread(const Mailbox& mailbox,
                                     const SyncToken& sync_token);
   void DestroySharedImageOnGpuThread(const Mailbox& mailbox);
+  void DestroySharedImagesOnGpuThread(const std::vector<Mailbox>& mailboxes);
   void WaitSyncTokenOnGpuThread(const SyncToken& sync_token);
   void WrapTaskWithGpuUrl(base::OnceClosure task);
 #if defined(OS_ANDROID)
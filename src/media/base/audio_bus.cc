@@ -15,10 +15,20 @@
 #include "base/memory/ptr_util.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
 #include "media/base/audio_parameters.h"
 #include "media/base/limits.h"
 #include "media/base/vector_math.h"
 
+// NaCl does not allow intrinsics.
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#define HAS_STEREO_CONVERSION_SIMD
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+#include <arm_neon.h>
+#define HAS_STEREO_CONVERSION_SIMD
+#endif
+
 namespace media {
 
 static bool IsAligned(void* ptr) {
@@ -333,4 +343,229 @@ void AudioBus::SwapChannels(int a, int b) {
   std::swap(channel_data_[a], channel_data_[b]);
 }
 
+#if defined(HAS_STEREO_CONVERSION_SIMD)
+// The conversions below match SignedInt16SampleTypeTraits and
+// Float32SampleTypeTraits exactly, including the clipping of NaN to the minimum
+// value.
+static constexpr float kInt16ScaleForNegative = 32768.0f;
+static constexpr float kInt16ScaleForPositive = 32767.0f;
+static constexpr float kInt16InverseScaleForNegative =
+    1.0f / kInt16ScaleForNegative;
+static constexpr float kInt16InverseScaleForPositive =
+    1.0f / kInt16ScaleForPositive;
+
+#if defined(ARCH_CPU_X86_FAMILY)
+static __m128 ClipFloat32x4(__m128 value) {
+  // _mm_max_ps() returns its second operand if either is NaN.
+  return _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+}
+
+static __m128 Int32x4ToFloat32x4(__m128i value) {
+  const __m128 float_value = _mm_cvtepi32_ps(value);
+  const __m128 is_negative = _mm_cmplt_ps(float_value, _mm_setzero_ps());
+  const __m128 scale = _mm_or_ps(
+      _mm_and_ps(is_negative, _mm_set1_ps(kInt16InverseScaleForNegative)),
+      _mm_andnot_ps(is_negative, _mm_set1_ps(kInt16InverseScaleForPositive)));
+  return _mm_mul_ps(float_value, scale);
+}
+
+static __m128i Float32x4ToInt32x4(__m128 value) {
+  value = ClipFloat32x4(value);
+  const __m128 is_negative = _mm_cmplt_ps(value, _mm_setzero_ps());
+  const __m128 scale = _mm_or_ps(
+      _mm_and_ps(is_negative, _mm_set1_ps(kInt16ScaleForNegative)),
+      _mm_andnot_ps(is_negative, _mm_set1_ps(kInt16ScaleForPositive)));
+  // Truncates towards zero like static_cast<int16_t>().
+  return _mm_cvttps_epi32(_mm_mul_ps(value, scale));
+}
+#elif defined(ARCH_CPU_ARM_FAMILY)
+static float32x4_t ClipFloat32x4(float32x4_t value) {
+  // Comparisons with NaN are false, so NaN becomes -1.
+  const float32x4_t min_value = vdupq_n_f32(-1.0f);
+  const float32x4_t max_value = vdupq_n_f32(1.0f);
+  value = vbslq_f32(vcgeq_f32(value, min_value), value, min_value);
+  return vbslq_f32(vcgeq_f32(value, max_value), max_value, value);
+}
+
+static float32x4_t Int16x4ToFloat32x4(int16x4_t value) {
+  const float32x4_t float_value = vcvtq_f32_s32(vmovl_s16(value));
+  const float32x4_t scale =
+      vbslq_f32(vcltq_f32(float_value, vdupq_n_f32(0.0f)),
+                vdupq_n_f32(kInt16InverseScaleForNegative),
+                vdupq_n_f32(kInt16InverseScaleForPositive));
+  return vmulq_f32(float_value, scale);
+}
+
+static int16x4_t Float32x4ToInt16x4(float32x4_t value) {
+  value = ClipFloat32x4(value);
+  const float32x4_t scale = vbslq_f32(vcltq_f32(value, vdupq_n_f32(0.0f)),
+                                      vdupq_n_f32(kInt16ScaleForNegative),
+                                      vdupq_n_f32(kInt16ScaleForPositive));
+  // Truncates towards zero like static_cast<int16_t>().
+  return vmovn_s32(vcvtq_s32_f32(vmulq_f32(value, scale)));
+}
+#endif
+
+template <>
+bool AudioBus::CopyConvertFromInterleavedStereoSource<Float32SampleTypeTraits>(
+    const float* source_buffer,
+    int write_offset_in_frames,
+    int num_frames_to_write,
+    AudioBus* dest) {
+  float* left = dest->channel(0) + write_offset_in_frames;
+  float* right = dest->channel(1) + write_offset_in_frames;
+  int i = 0;
+  for (; i + 4 <= num_frames_to_write; i += 4) {
+    const float* source = source_buffer + 2 * i;
+#if defined(ARCH_CPU_X86_FAMILY)
+    const __m128 a = _mm_loadu_ps(source);
+    const __m128 b = _mm_loadu_ps(source + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+#elif defined(ARCH_CPU_ARM_FAMILY)
+    const float32x4x2_t frames = vld2q_f32(source);
+    vst1q_f32(left + i, frames.val[0]);
+    vst1q_f32(right + i, frames.val[1]);
+#endif
+  }
+  for (; i < num_frames_to_write; ++i) {
+    left[i] = Float32SampleTypeTraits::ToFloat(source_buffer[2 * i]);
+    right[i] = Float32SampleTypeTraits::ToFloat(source_buffer[2 * i + 1]);
+  }
+  return true;
+}
+
+template <>
+bool AudioBus::CopyConvertFromInterleavedStereoSource<
+    SignedInt16SampleTypeTraits>(const int16_t* source_buffer,
+                                 int write_offset_in_frames,
+                                 int num_frames_to_write,
+                                 AudioBus* dest) {
+  float* left = dest->channel(0) + write_offset_in_frames;
+  float* right = dest->channel(1) + write_offset_in_frames;
+  int i = 0;
+  for (; i + 4 <= num_frames_to_write; i += 4) {
+    const int16_t* source = source_buffer + 2 * i;
+#if defined(ARCH_CPU_X86_FAMILY)
+    const __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    // Sign extend the samples of the first and the last two frames.
+    const __m128 a = Int32x4ToFloat32x4(
+        _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+    const __m128 b = Int32x4ToFloat32x4(
+        _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+#elif defined(ARCH_CPU_ARM_FAMILY)
+    const int16x4x2_t frames = vld2_s16(source);
+    vst1q_f32(left + i, Int16x4ToFloat32x4(frames.val[0]));
+    vst1q_f32(right + i, Int16x4ToFloat32x4(frames.val[1]));
+#endif
+  }
+  for (; i < num_frames_to_write; ++i) {
+    left[i] = SignedInt16SampleTypeTraits::ToFloat(source_buffer[2 * i]);
+    right[i] = SignedInt16SampleTypeTraits::ToFloat(source_buffer[2 * i + 1]);
+  }
+  return true;
+}
+
+template <>
+bool AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    Float32SampleTypeTraits>(const AudioBus* source,
+                             int read_offset_in_frames,
+                             int num_frames_to_read,
+                             float* dest_buffer) {
+  const float* left = source->channel(0) + read_offset_in_frames;
+  const float* right = source->channel(1) + read_offset_in_frames;
+  int i = 0;
+  for (; i + 4 <= num_frames_to_read; i += 4) {
+    float* dest = dest_buffer + 2 * i;
+#if defined(ARCH_CPU_X86_FAMILY)
+    const __m128 l = ClipFloat32x4(_mm_loadu_ps(left + i));
+    const __m128 r = ClipFloat32x4(_mm_loadu_ps(right + i));
+    _mm_storeu_ps(dest, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(dest + 4, _mm_unpackhi_ps(l, r));
+#elif defined(ARCH_CPU_ARM_FAMILY)
+    float32x4x2_t frames;
+    frames.val[0] = ClipFloat32x4(vld1q_f32(left + i));
+    frames.val[1] = ClipFloat32x4(vld1q_f32(right + i));
+    vst2q_f32(dest, frames);
+#endif
+  }
+  for (; i < num_frames_to_read; ++i) {
+    dest_buffer[2 * i] = Float32SampleTypeTraits::FromFloat(left[i]);
+    dest_buffer[2 * i + 1] = Float32SampleTypeTraits::FromFloat(right[i]);
+  }
+  return true;
+}
+
+template <>
+bool AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    SignedInt16SampleTypeTraits>(const AudioBus* source,
+                                 int read_offset_in_frames,
+                                 int num_frames_to_read,
+                                 int16_t* dest_buffer) {
+  const float* left = source->channel(0) + read_offset_in_frames;
+  const float* right = source->channel(1) + read_offset_in_frames;
+  int i = 0;
+  for (; i + 4 <= num_frames_to_read; i += 4) {
+    int16_t* dest = dest_buffer + 2 * i;
+#if defined(ARCH_CPU_X86_FAMILY)
+    const __m128i l = Float32x4ToInt32x4(_mm_loadu_ps(left + i));
+    const __m128i r = Float32x4ToInt32x4(_mm_loadu_ps(right + i));
+    // The values are in range, so packing does not saturate.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_packs_epi32(_mm_unpacklo_epi32(l, r),
+                                     _mm_unpackhi_epi32(l, r)));
+#elif defined(ARCH_CPU_ARM_FAMILY)
+    int16x4x2_t frames;
+    frames.val[0] = Float32x4ToInt16x4(vld1q_f32(left + i));
+    frames.val[1] = Float32x4ToInt16x4(vld1q_f32(right + i));
+    vst2_s16(dest, frames);
+#endif
+  }
+  for (; i < num_frames_to_read; ++i) {
+    dest_buffer[2 * i] = SignedInt16SampleTypeTraits::FromFloat(left[i]);
+    dest_buffer[2 * i + 1] = SignedInt16SampleTypeTraits::FromFloat(right[i]);
+  }
+  return true;
+}
+#else
+template <>
+bool AudioBus::CopyConvertFromInterleavedStereoSource<Float32SampleTypeTraits>(
+    const float* source_buffer,
+    int write_offset_in_frames,
+    int num_frames_to_write,
+    AudioBus* dest) {
+  return false;
+}
+
+template <>
+bool AudioBus::CopyConvertFromInterleavedStereoSource<
+    SignedInt16SampleTypeTraits>(const int16_t* source_buffer,
+                                 int write_offset_in_frames,
+                                 int num_frames_to_write,
+                                 AudioBus* dest) {
+  return false;
+}
+
+template <>
+bool AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    Float32SampleTypeTraits>(const AudioBus* source,
+                             int read_offset_in_frames,
+                             int num_frames_to_read,
+                             float* dest_buffer) {
+  return false;
+}
+
+template <>
+bool AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    SignedInt16SampleTypeTraits>(const AudioBus* source,
+                                 int read_offset_in_frames,
+                                 int num_frames_to_read,
+                                 int16_t* dest_buffer) {
+  return false;
+}
+#endif  // defined(HAS_STEREO_CONVERSION_SIMD)
+
 }  // namespace media
@@ -203,6 +203,27 @@ class MEDIA_SHMEM_EXPORT AudioBus {
       int num_frames_to_read,
       typename TargetSampleTypeTraits::ValueType* dest_buffer);
 
+  // Vectorized versions of the above for stereo buses, specialized in the .cc
+  // for the most commonly used sample formats. Return false if there is no
+  // such version for the sample format.
+  template <class SourceSampleTypeTraits>
+  static bool CopyConvertFromInterleavedStereoSource(
+      const typename SourceSampleTypeTraits::ValueType* source_buffer,
+      int write_offset_in_frames,
+      int num_frames_to_write,
+      AudioBus* dest) {
+    return false;
+  }
+
+  template <class TargetSampleTypeTraits>
+  static bool CopyConvertFromStereoAudioBusToInterleavedTarget(
+      const AudioBus* source,
+      int read_offset_in_frames,
+      int num_frames_to_read,
+      typename TargetSampleTypeTraits::ValueType* dest_buffer) {
+    return false;
+  }
+
   // Contiguous block of channel memory.
   std::unique_ptr<float, base::AlignedFreeDeleter> data_;
 
@@ -226,6 +247,39 @@ class MEDIA_SHMEM_EXPORT AudioBus {
   DISALLOW_COPY_AND_ASSIGN(AudioBus);
 };
 
+// Defined in the .cc, see CopyConvertFromInterleavedStereoSource().
+template <>
+MEDIA_SHMEM_EXPORT bool
+AudioBus::CopyConvertFromInterleavedStereoSource<Float32SampleTypeTraits>(
+    const float* source_buffer,
+    int write_offset_in_frames,
+    int num_frames_to_write,
+    AudioBus* dest);
+
+template <>
+MEDIA_SHMEM_EXPORT bool
+AudioBus::CopyConvertFromInterleavedStereoSource<SignedInt16SampleTypeTraits>(
+    const int16_t* source_buffer,
+    int write_offset_in_frames,
+    int num_frames_to_write,
+    AudioBus* dest);
+
+template <>
+MEDIA_SHMEM_EXPORT bool
+AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    Float32SampleTypeTraits>(const AudioBus* source,
+                             int read_offset_in_frames,
+                             int num_frames_to_read,
+                             float* dest_buffer);
+
+template <>
+MEDIA_SHMEM_EXPORT bool
+AudioBus::CopyConvertFromStereoAudioBusToInterleavedTarget<
+    SignedInt16SampleTypeTraits>(const AudioBus* source,
+                                 int read_offset_in_frames,
+                                 int num_frames_to_read,
+                                 int16_t* dest_buffer);
+
 // Delegates to FromInterleavedPartial()
 template <class SourceSampleTypeTraits>
 void AudioBus::FromInterleaved(
@@ -266,8 +320,8 @@ void AudioBus::ToInterleavedPartial(
       this, read_offset_in_frames, num_frames_to_read, dest);
 }
 
-// TODO(chfremer): Consider using vector instructions to speed this up,
-//                 https://crbug.com/619628
+// TODO(chfremer): Consider using vector instructions for more channel counts
+//                 and sample formats, https://crbug.com/619628
 template <class SourceSampleTypeTraits>
 void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
     const typename SourceSampleTypeTraits::ValueType* source_buffer,
@@ -275,6 +329,11 @@ void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
     int num_frames_to_write,
     AudioBus* dest) {
   const int channels = dest->channels();
+  if (channels == 2 &&
+      CopyConvertFromInterleavedStereoSource<SourceSampleTypeTraits>(
+          source_buffer, write_offset_in_frames, num_frames_to_write, dest)) {
+    return;
+  }
   for (int ch = 0; ch < channels; ++ch) {
     float* channel_data = dest->channel(ch);
     for (int target_frame_index = write_offset_in_frames,
@@ -288,8 +347,8 @@ void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
   }
 }
 
-// TODO(chfremer): Consider using vector instructions to speed this up,
-//                 https://crbug.com/619628
+// TODO(chfremer): Consider using vector instructions for more channel counts
+//                 and sample formats, https://crbug.com/619628
 template <class TargetSampleTypeTraits>
 void AudioBus::CopyConvertFromAudioBusToInterleavedTarget(
     const AudioBus* source,
@@ -297,6 +356,11 @@ void AudioBus::CopyConvertFromAudioBusToInterleavedTarget(
     int num_frames_to_read,
     typename TargetSampleTypeTraits::ValueType* dest_buffer) {
   const int channels = source->channels();
+  if (channels == 2 &&
+      CopyConvertFromStereoAudioBusToInterleavedTarget<TargetSampleTypeTraits>(
+          source, read_offset_in_frames, num_frames_to_read, dest_buffer)) {
+    return;
+  }
   for (int ch = 0; ch < channels; ++ch) {
     const float* channel_data = source->channel(ch);
     for (int source_frame_index = read_offset_in_frames, write_pos_in_dest = ch;
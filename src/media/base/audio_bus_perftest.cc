@@ -68,6 +68,18 @@ TEST(AudioBusPerfTest, Interleave) {
   RunInterleaveBench<float, Float32SampleTypeTraits>(bus.get(), "float");
 }
 
+// Stereo buses use the vectorized conversions where they exist, so compare
+// with the generic conversion of a 5.1 bus, per sample.
+TEST(AudioBusPerfTest, Interleave5_1) {
+  std::unique_ptr<AudioBus> bus = AudioBus::Create(6, kSampleRate * 40);
+  FakeAudioRenderCallback callback(0.2, kSampleRate);
+  callback.Render(base::TimeDelta(), base::TimeTicks::Now(), 0, bus.get());
+
+  RunInterleaveBench<int16_t, SignedInt16SampleTypeTraits>(bus.get(),
+                                                           "int16_t_5_1");
+  RunInterleaveBench<float, Float32SampleTypeTraits>(bus.get(), "float_5_1");
+}
+
 TEST(AudioBusPerfTest, DISABLED_ToInterleavedFloat) {
   std::unique_ptr<AudioBus> bus = AudioBus::Create(2, kSampleRate * 120);
   FakeAudioRenderCallback callback(0.2, kSampleRate);
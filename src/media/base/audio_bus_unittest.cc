@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <cmath>
 #include <limits>
 #include <memory>
 
@@ -476,6 +477,70 @@ TEST_F(AudioBusTest, ToInterleavedSanitized) {
   }
 }
 
+// Stereo buses use vectorized conversions for some sample formats, which must
+// give the same results as the per-sample conversions, including for the frames
+// after the last full vector and for out of range values.
+TEST_F(AudioBusTest, StereoConversionsMatchSampleTypeTraits) {
+  constexpr int kFrames = 37;
+  constexpr int kOffset = 3;
+  std::unique_ptr<AudioBus> bus = AudioBus::Create(2, kFrames + kOffset);
+  for (int ch = 0; ch < bus->channels(); ++ch) {
+    for (int i = 0; i < bus->frames(); ++i)
+      bus->channel(ch)[i] = 1.5f * std::sin(0.3f * i + ch);
+  }
+  bus->channel(0)[kOffset] = 1.0f;
+  bus->channel(1)[kOffset] = -1.0f;
+  bus->channel(0)[kOffset + 5] = std::numeric_limits<float>::quiet_NaN();
+
+  {
+    SCOPED_TRACE("SignedInt16SampleTypeTraits");
+    int16_t interleaved[2 * kFrames];
+    bus->ToInterleavedPartial<SignedInt16SampleTypeTraits>(kOffset, kFrames,
+                                                           interleaved);
+    for (int i = 0; i < kFrames; ++i) {
+      for (int ch = 0; ch < 2; ++ch) {
+        ASSERT_EQ(SignedInt16SampleTypeTraits::FromFloat(
+                      bus->channel(ch)[kOffset + i]),
+                  interleaved[2 * i + ch]);
+      }
+    }
+    EXPECT_EQ(std::numeric_limits<int16_t>::min(), interleaved[2 * 5]);
+
+    std::unique_ptr<AudioBus> result = AudioBus::Create(2, kFrames + kOffset);
+    result->FromInterleavedPartial<SignedInt16SampleTypeTraits>(
+        interleaved, kOffset, kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+      for (int ch = 0; ch < 2; ++ch) {
+        ASSERT_EQ(
+            SignedInt16SampleTypeTraits::ToFloat(interleaved[2 * i + ch]),
+            result->channel(ch)[kOffset + i]);
+      }
+    }
+  }
+
+  {
+    SCOPED_TRACE("Float32SampleTypeTraits");
+    float interleaved[2 * kFrames];
+    bus->ToInterleavedPartial<Float32SampleTypeTraits>(kOffset, kFrames,
+                                                       interleaved);
+    for (int i = 0; i < kFrames; ++i) {
+      for (int ch = 0; ch < 2; ++ch) {
+        ASSERT_EQ(Float32SampleTypeTraits::FromFloat(
+                      bus->channel(ch)[kOffset + i]),
+                  interleaved[2 * i + ch]);
+      }
+    }
+
+    std::unique_ptr<AudioBus> result = AudioBus::Create(2, kFrames + kOffset);
+    result->FromInterleavedPartial<Float32SampleTypeTraits>(interleaved,
+                                                            kOffset, kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+      for (int ch = 0; ch < 2; ++ch)
+        ASSERT_EQ(interleaved[2 * i + ch], result->channel(ch)[kOffset + i]);
+    }
+  }
+}
+
 TEST_F(AudioBusTest, CopyAndClipTo) {
   auto bus = AudioBus::Create(kTestVectorChannelCount, kTestVectorFrameCount);
   bus->FromInterleaved<Float32SampleTypeTraits>(kTestVectorFloat32Invalid,
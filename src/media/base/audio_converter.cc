@@ -52,12 +52,16 @@ AudioConverter::AudioConverter(const AudioParameters& input_params,
     downmix_early_ = input_params.channels() > output_params.channels();
   }
 
+  // Number of frames each SourceCallback() is expected to produce.
+  int source_frames = output_params.frames_per_buffer();
+
   // Only resample if necessary since it's expensive.
   if (input_params.sample_rate() != output_params.sample_rate()) {
     DVLOG(1) << "Resampling from " << input_params.sample_rate() << " to "
              << output_params.sample_rate();
     const int request_size = disable_fifo ? SincResampler::kDefaultRequestSize :
         input_params.frames_per_buffer();
+    source_frames = request_size;
     resampler_ = std::make_unique<MultiChannelResampler>(
         downmix_early_ ? output_params.channels() : input_params.channels(),
         io_sample_rate_ratio_, request_size,
@@ -65,24 +69,33 @@ AudioConverter::AudioConverter(const AudioParameters& input_params,
                             base::Unretained(this)));
   }
 
-  // The resampler can be configured to work with a specific request size, so a
-  // FIFO is not necessary when resampling.
-  if (disable_fifo || resampler_)
-    return;
-
   // Since the output device may want a different buffer size than the caller
   // asked for, we need to use a FIFO to ensure that both sides read in chunk
-  // sizes they're configured for.
-  if (input_params.frames_per_buffer() != output_params.frames_per_buffer()) {
+  // sizes they're configured for.  The resampler can be configured to work with
+  // a specific request size, so a FIFO is not necessary when resampling.
+  if (!disable_fifo && !resampler_ &&
+      input_params.frames_per_buffer() != output_params.frames_per_buffer()) {
     DVLOG(1) << "Rebuffering from " << input_params.frames_per_buffer()
              << " to " << output_params.frames_per_buffer();
     chunk_size_ = input_params.frames_per_buffer();
+    source_frames = chunk_size_;
     audio_fifo_ = std::make_unique<AudioPullFifo>(
         downmix_early_ ? output_params.channels() : input_params.channels(),
         chunk_size_,
         base::BindRepeating(&AudioConverter::SourceCallback,
                             base::Unretained(this)));
   }
+
+  // Allocate the temporary buses for the expected buffer sizes up front, so the
+  // first Convert() on a real-time thread doesn't have to.  They're recreated
+  // on demand if callers use other sizes.
+  mixer_input_audio_bus_ =
+      AudioBus::Create(input_channel_count_, source_frames);
+  if (channel_mixer_) {
+    CreateUnmixedAudioIfNecessary(downmix_early_
+                                      ? source_frames
+                                      : output_params.frames_per_buffer());
+  }
 }
 
 AudioConverter::~AudioConverter() = default;
@@ -102,6 +115,13 @@ void AudioConverter::RemoveInput(InputCallback* input) {
     Reset();
 }
 
+void AudioConverter::SwapInputs(InputCallbackList* inputs) {
+  transform_inputs_.swap(*inputs);
+
+  if (transform_inputs_.empty())
+    Reset();
+}
+
 void AudioConverter::Reset() {
   if (audio_fifo_)
     audio_fifo_->Clear();
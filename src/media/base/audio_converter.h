@@ -64,6 +64,9 @@ class MEDIA_EXPORT AudioConverter {
     virtual ~InputCallback() {}
   };
 
+  // Ordered list of inputs; see SwapInputs().
+  using InputCallbackList = std::list<InputCallback*>;
+
   // Constructs an AudioConverter for converting between the given input and
   // output parameters.  Specifying |disable_fifo| means all InputCallbacks are
   // capable of handling arbitrary buffer size requests; i.e. one call might ask
@@ -86,6 +89,11 @@ class MEDIA_EXPORT AudioConverter {
   void AddInput(InputCallback* input);
   void RemoveInput(InputCallback* input);
 
+  // Exchanges the current inputs with |inputs| without allocating, so that a
+  // list built on another thread can be handed to the thread calling Convert().
+  // Calls Reset() if no inputs remain afterward, like RemoveInput().
+  void SwapInputs(InputCallbackList* inputs);
+
   // Flushes all buffered data.
   void Reset();
 
@@ -117,8 +125,7 @@ class MEDIA_EXPORT AudioConverter {
   void CreateUnmixedAudioIfNecessary(int frames);
 
   // Set of inputs for Convert().
-  typedef std::list<InputCallback*> InputCallbackSet;
-  InputCallbackSet transform_inputs_;
+  InputCallbackList transform_inputs_;
 
   // Used to buffer data between the client and the output device in cases where
   // the client buffer size is not the same as the output device buffer size.
@@ -4,9 +4,11 @@
 
 #include <memory>
 
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "media/base/audio_converter.h"
 #include "media/base/fake_audio_render_callback.h"
+#include "media/base/media_switches.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
 
@@ -62,6 +64,23 @@ TEST(AudioConverterPerfTest, ConvertBenchmark) {
   RunConvertBenchmark(input_params, output_params, false, "convert");
 }
 
+TEST(AudioConverterPerfTest, ConvertBenchmarkPolyphase) {
+  // 44.1kHz <-> 48kHz is a rational ratio which SincResampler handles with
+  // polyphase kernels; compare against the interpolated kernels.
+  AudioParameters input_params(AudioParameters::AUDIO_PCM_LINEAR,
+                               CHANNEL_LAYOUT_STEREO, 44100, 441);
+  AudioParameters output_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                CHANNEL_LAYOUT_STEREO, 48000, 480);
+
+  {
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitAndDisableFeature(kPolyphaseResampling);
+    RunConvertBenchmark(input_params, output_params, false,
+                        "convert_interpolated");
+  }
+  RunConvertBenchmark(input_params, output_params, false, "convert_polyphase");
+}
+
 TEST(AudioConverterPerfTest, ConvertBenchmarkFIFO) {
   // Create input and output parameters to convert between common buffer sizes
   // without any resampling for the FIFO vs no FIFO benchmarks.
@@ -4,10 +4,15 @@
 
 #include "media/base/audio_renderer_mixer.h"
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 #include "base/check_op.h"
+#include "base/containers/contains.h"
 #include "base/memory/ptr_util.h"
+#include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "media/base/audio_renderer_mixer_input.h"
@@ -17,13 +22,57 @@ namespace media {
 
 constexpr base::TimeDelta kPauseDelay = base::TimeDelta::FromSeconds(10);
 
+// Snapshots are built by PublishSnapshot() under |lock_| and then exchanged
+// with the rendering thread through |current_snapshot_|:
+//
+// 1) Render() exchanges the slot with nullptr, so only it owns the snapshot
+//    for the duration of the callback.  The first time it sees a snapshot it
+//    swaps the lists into the converters, which takes constant time and
+//    doesn't allocate.
+// 2) At the end of Render() the snapshot is put back into the slot, unless the
+//    slot was refilled meanwhile.  Then the snapshot is handed back via
+//    |retired_snapshot_| instead.
+// 3) PublishSnapshot() exchanges a new snapshot into the slot.  If it gets back
+//    nullptr, a Render() is in flight, and it waits for the retired snapshot;
+//    at most one callback's worth of time.  Either way the old snapshot, which
+//    now holds the lists the converters used before, is deleted on the calling
+//    thread.
+//
+// The rendering thread therefore never waits on, or allocates for, the threads
+// which add and remove inputs.
+struct AudioRendererMixer::InputSnapshot {
+  AudioConverter::InputCallbackList master_inputs;
+  std::vector<std::pair<LoopbackAudioConverter*,
+                        AudioConverter::InputCallbackList>>
+      converter_inputs;
+  base::TimeTicks last_play_time;
+
+  // Set by the rendering thread once the lists above have been swapped in.
+  bool applied = false;
+};
+
+AudioRendererMixer::ResamplingConverter::ResamplingConverter() = default;
+AudioRendererMixer::ResamplingConverter::ResamplingConverter(
+    ResamplingConverter&&) = default;
+AudioRendererMixer::ResamplingConverter&
+AudioRendererMixer::ResamplingConverter::operator=(ResamplingConverter&&) =
+    default;
+AudioRendererMixer::ResamplingConverter::~ResamplingConverter() = default;
+
 AudioRendererMixer::AudioRendererMixer(const AudioParameters& output_params,
                                        scoped_refptr<AudioRendererSink> sink)
     : output_params_(output_params),
       audio_sink_(std::move(sink)),
       master_converter_(output_params, output_params, true),
+      render_last_play_time_(base::TimeTicks::Now()),
+      current_snapshot_(new InputSnapshot()),
+      retired_snapshot_(nullptr),
+      render_callbacks_(0),
+      render_glitches_(0),
+      render_frames_skipped_(0),
+      render_overruns_(0),
       pause_delay_(kPauseDelay),
-      last_play_time_(base::TimeTicks::Now()),
+      last_play_time_(render_last_play_time_),
       // Initialize |playing_| to true since Start() results in an auto-play.
       playing_(true) {
   DCHECK(audio_sink_);
@@ -39,8 +88,16 @@ AudioRendererMixer::~AudioRendererMixer() {
   // AudioRendererSink must be stopped before mixer is destructed.
   audio_sink_->Stop();
 
+  // Rendering has stopped, so pick up any snapshot it didn't get to.
+  std::unique_ptr<InputSnapshot> snapshot(current_snapshot_.exchange(nullptr));
+  DCHECK(snapshot);
+  DCHECK(!retired_snapshot_.load());
+  if (!snapshot->applied)
+    ApplySnapshot(snapshot.get());
+
   // Ensure that all mixer inputs have removed themselves prior to destruction.
   DCHECK(master_converter_.empty());
+  DCHECK(master_inputs_.empty());
   DCHECK(converters_.empty());
   DCHECK(error_callbacks_.empty());
 }
@@ -48,32 +105,41 @@ AudioRendererMixer::~AudioRendererMixer() {
 void AudioRendererMixer::AddMixerInput(const AudioParameters& input_params,
                                        AudioConverter::InputCallback* input) {
   base::AutoLock auto_lock(lock_);
-  if (!playing_) {
-    playing_ = true;
-    last_play_time_ = base::TimeTicks::Now();
-    audio_sink_->Play();
-  }
 
   int input_sample_rate = input_params.sample_rate();
   if (is_master_sample_rate(input_sample_rate)) {
-    master_converter_.AddInput(input);
+    DCHECK(!base::Contains(master_inputs_, input));
+    master_inputs_.push_back(input);
   } else {
     auto converter = converters_.find(input_sample_rate);
     if (converter == converters_.end()) {
-      std::pair<AudioConvertersMap::iterator, bool> result =
-          converters_.insert(std::make_pair(
-              input_sample_rate, std::make_unique<LoopbackAudioConverter>(
-                                     // We expect all InputCallbacks to be
-                                     // capable of handling arbitrary buffer
-                                     // size requests, disabling FIFO.
-                                     input_params, output_params_, true)));
-      converter = result.first;
+      ResamplingConverter resampling_converter;
+      resampling_converter.converter = std::make_unique<LoopbackAudioConverter>(
+          // We expect all InputCallbacks to be capable of handling arbitrary
+          // buffer size requests, disabling FIFO.
+          input_params, output_params_, true);
 
       // Add newly-created resampler as an input to the master mixer.
-      master_converter_.AddInput(converter->second.get());
+      master_inputs_.push_back(resampling_converter.converter.get());
+      converter = converters_
+                      .emplace(input_sample_rate,
+                               std::move(resampling_converter))
+                      .first;
     }
-    converter->second->AddInput(input);
+    DCHECK(!base::Contains(converter->second.inputs, input));
+    converter->second.inputs.push_back(input);
+  }
+
+  const bool start_playing = !playing_;
+  if (start_playing) {
+    playing_ = true;
+    last_play_time_ = base::TimeTicks::Now();
   }
+
+  // Publish before Play() so the first callback already includes |input|.
+  PublishSnapshot();
+  if (start_playing)
+    audio_sink_->Play();
 }
 
 void AudioRendererMixer::RemoveMixerInput(
@@ -81,19 +147,60 @@ void AudioRendererMixer::RemoveMixerInput(
     AudioConverter::InputCallback* input) {
   base::AutoLock auto_lock(lock_);
 
+  // Destroyed after PublishSnapshot(), once rendering can't reach it anymore.
+  std::unique_ptr<LoopbackAudioConverter> removed_converter;
+
   int input_sample_rate = input_params.sample_rate();
   if (is_master_sample_rate(input_sample_rate)) {
-    master_converter_.RemoveInput(input);
+    DCHECK(base::Contains(master_inputs_, input));
+    master_inputs_.remove(input);
   } else {
     auto converter = converters_.find(input_sample_rate);
     DCHECK(converter != converters_.end());
-    converter->second->RemoveInput(input);
-    if (converter->second->empty()) {
+    DCHECK(base::Contains(converter->second.inputs, input));
+    converter->second.inputs.remove(input);
+    if (converter->second.inputs.empty()) {
       // Remove converter when it's empty.
-      master_converter_.RemoveInput(converter->second.get());
+      removed_converter = std::move(converter->second.converter);
+      master_inputs_.remove(removed_converter.get());
       converters_.erase(converter);
     }
   }
+
+  PublishSnapshot();
+}
+
+void AudioRendererMixer::PublishSnapshot() {
+  auto snapshot = std::make_unique<InputSnapshot>();
+  snapshot->master_inputs = master_inputs_;
+  snapshot->converter_inputs.reserve(converters_.size());
+  for (const auto& converter : converters_) {
+    snapshot->converter_inputs.emplace_back(converter.second.converter.get(),
+                                            converter.second.inputs);
+  }
+  snapshot->last_play_time = last_play_time_;
+
+  std::unique_ptr<InputSnapshot> old_snapshot(
+      current_snapshot_.exchange(snapshot.release()));
+  if (old_snapshot)
+    return;
+
+  // Render() has the previous snapshot checked out; wait for it to finish and
+  // hand the snapshot back so the caller may destroy what was removed.
+  InputSnapshot* retired_snapshot;
+  while (!(retired_snapshot = retired_snapshot_.exchange(nullptr)))
+    base::PlatformThread::YieldCurrentThread();
+  old_snapshot.reset(retired_snapshot);
+}
+
+void AudioRendererMixer::ApplySnapshot(InputSnapshot* snapshot) {
+  DCHECK(!snapshot->applied);
+  master_converter_.SwapInputs(&snapshot->master_inputs);
+  for (auto& converter_inputs : snapshot->converter_inputs)
+    converter_inputs.first->SwapInputs(&converter_inputs.second);
+  render_last_play_time_ =
+      std::max(render_last_play_time_, snapshot->last_play_time);
+  snapshot->applied = true;
 }
 
 void AudioRendererMixer::AddErrorCallback(AudioRendererMixerInput* input) {
@@ -110,6 +217,15 @@ bool AudioRendererMixer::CurrentThreadIsRenderingThread() {
   return audio_sink_->CurrentThreadIsRenderingThread();
 }
 
+AudioRendererMixer::RenderStats AudioRendererMixer::GetRenderStats() const {
+  RenderStats stats;
+  stats.callbacks = render_callbacks_.load(std::memory_order_relaxed);
+  stats.glitches = render_glitches_.load(std::memory_order_relaxed);
+  stats.frames_skipped = render_frames_skipped_.load(std::memory_order_relaxed);
+  stats.overruns = render_overruns_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void AudioRendererMixer::SetPauseDelayForTesting(base::TimeDelta delay) {
   base::AutoLock auto_lock(lock_);
   pause_delay_ = delay;
@@ -120,17 +236,28 @@ int AudioRendererMixer::Render(base::TimeDelta delay,
                                int prior_frames_skipped,
                                AudioBus* audio_bus) {
   TRACE_EVENT0("audio", "AudioRendererMixer::Render");
-  base::AutoLock auto_lock(lock_);
+  const base::TimeTicks now = base::TimeTicks::Now();
+
+  InputSnapshot* snapshot = current_snapshot_.exchange(nullptr);
+  DCHECK(snapshot);
+  if (!snapshot->applied)
+    ApplySnapshot(snapshot);
 
   // If there are no mixer inputs and we haven't seen one for a while, pause the
   // sink to avoid wasting resources when media elements are present but remain
-  // in the pause state.
-  const base::TimeTicks now = base::TimeTicks::Now();
+  // in the pause state.  This must not race with AddMixerInput(), but we can't
+  // wait for it either; if it's busy, just check again on the next callback.
   if (!master_converter_.empty()) {
-    last_play_time_ = now;
-  } else if (now - last_play_time_ >= pause_delay_ && playing_) {
-    audio_sink_->Pause();
-    playing_ = false;
+    render_last_play_time_ = now;
+  } else if (lock_.Try()) {
+    // A non-empty |current_snapshot_| means inputs were added since this
+    // callback started.
+    if (playing_ && now - render_last_play_time_ >= pause_delay_ &&
+        !current_snapshot_.load()) {
+      audio_sink_->Pause();
+      playing_ = false;
+    }
+    lock_.Release();
   }
 
   // Since AudioConverter uses uint32_t for delay calculations, we must drop
@@ -141,6 +268,25 @@ int AudioRendererMixer::Render(base::TimeDelta delay,
   uint32_t frames_delayed =
       AudioTimestampHelper::TimeToFrames(delay, output_params_.sample_rate());
   master_converter_.ConvertWithDelay(frames_delayed, audio_bus);
+
+  // Return the snapshot, or hand it back to PublishSnapshot() if a newer one
+  // has been published during this callback.
+  InputSnapshot* expected = nullptr;
+  if (!current_snapshot_.compare_exchange_strong(expected, snapshot))
+    retired_snapshot_.store(snapshot);
+
+  render_callbacks_.fetch_add(1, std::memory_order_relaxed);
+  if (prior_frames_skipped > 0) {
+    render_glitches_.fetch_add(1, std::memory_order_relaxed);
+    render_frames_skipped_.fetch_add(prior_frames_skipped,
+                                     std::memory_order_relaxed);
+  }
+  if (base::TimeTicks::Now() - now >
+      AudioTimestampHelper::FramesToTime(audio_bus->frames(),
+                                         output_params_.sample_rate())) {
+    render_overruns_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   return audio_bus->frames();
 }
 
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -27,9 +28,27 @@ class AudioRendererMixerInput;
 // Mixes a set of AudioConverter::InputCallbacks into a single output stream
 // which is funneled into a single shared AudioRendererSink; saving a bundle
 // on renderer side resources.
+//
+// Render() never blocks on the threads adding and removing inputs: input
+// changes are published as snapshots which the rendering thread picks up at
+// the start of its next callback.
 class MEDIA_EXPORT AudioRendererMixer
     : public AudioRendererSink::RenderCallback {
  public:
+  // Counters describing the health of the rendering thread.
+  struct RenderStats {
+    // Total number of Render() callbacks.
+    int64_t callbacks = 0;
+
+    // Callbacks for which the sink reported skipped frames (i.e., underruns),
+    // and the total number of frames skipped.
+    int64_t glitches = 0;
+    int64_t frames_skipped = 0;
+
+    // Callbacks which took longer than the duration of audio they rendered.
+    int64_t overruns = 0;
+  };
+
   AudioRendererMixer(const AudioParameters& output_params,
                      scoped_refptr<AudioRendererSink> sink);
   ~AudioRendererMixer() override;
@@ -48,6 +67,9 @@ class MEDIA_EXPORT AudioRendererMixer
   // Returns true if called on rendering thread, otherwise false.
   bool CurrentThreadIsRenderingThread();
 
+  // May be called from any thread.
+  RenderStats GetRenderStats() const;
+
   void SetPauseDelayForTesting(base::TimeDelta delay);
   const AudioParameters& get_output_params_for_testing() const {
     return output_params_;
@@ -61,6 +83,19 @@ class MEDIA_EXPORT AudioRendererMixer
              AudioBus* audio_bus) override;
   void OnRenderError() override;
 
+  // The input lists for |master_converter_| and each resampling converter at
+  // some point in time.  See the .cc file for how these are exchanged.
+  struct InputSnapshot;
+
+  // Hands a snapshot of the current inputs to the rendering thread.  Once this
+  // returns, the rendering thread no longer references inputs or converters
+  // missing from the snapshot.
+  void PublishSnapshot() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Swaps the input lists in |snapshot| into the converters.  Only called on
+  // the rendering thread, or after the sink has been stopped.
+  void ApplySnapshot(InputSnapshot* snapshot);
+
   bool is_master_sample_rate(int sample_rate) const {
     return sample_rate == output_params_.sample_rate();
   }
@@ -71,24 +106,54 @@ class MEDIA_EXPORT AudioRendererMixer
   // Output sink for this mixer.
   const scoped_refptr<AudioRendererSink> audio_sink_;
 
+  // Master converter which mixes all the outputs from |converters_| as well as
+  // mixer inputs that are in the output sample rate.  Only used on the
+  // rendering thread; its inputs are changed via ApplySnapshot().
+  AudioConverter master_converter_;
+
+  // Latest play time seen by the rendering thread.
+  base::TimeTicks render_last_play_time_;
+
+  // The most recently published snapshot.  Render() takes it out of the slot
+  // for the duration of the callback and puts it back afterward, unless a newer
+  // one was published meanwhile; in which case the old one is handed back to
+  // PublishSnapshot() via |retired_snapshot_|.
+  std::atomic<InputSnapshot*> current_snapshot_;
+  std::atomic<InputSnapshot*> retired_snapshot_;
+
+  // Backing for GetRenderStats(); only written on the rendering thread.
+  std::atomic<int64_t> render_callbacks_;
+  std::atomic<int64_t> render_glitches_;
+  std::atomic<int64_t> render_frames_skipped_;
+  std::atomic<int64_t> render_overruns_;
+
   // ---------------[ All variables below protected by |lock_| ]---------------
+  // The rendering thread only ever uses Try() on this lock.
   base::Lock lock_;
 
   // List of error callbacks used by this mixer.
   base::flat_set<AudioRendererMixerInput*> error_callbacks_ GUARDED_BY(lock_);
 
-  // Maps input sample rate to the dedicated converter.
-  using AudioConvertersMap =
-      base::flat_map<int, std::unique_ptr<LoopbackAudioConverter>>;
-
-  // Each of these converters mixes inputs with a given sample rate and
-  // resamples them to the output sample rate. Inputs not requiring resampling
-  // go directly to |master_converter_|.
+  // A converter which mixes inputs with a given sample rate and resamples them
+  // to the output sample rate, along with the inputs it should be mixing.
+  struct ResamplingConverter {
+    ResamplingConverter();
+    ResamplingConverter(ResamplingConverter&&);
+    ResamplingConverter& operator=(ResamplingConverter&&);
+    ~ResamplingConverter();
+
+    std::unique_ptr<LoopbackAudioConverter> converter;
+    AudioConverter::InputCallbackList inputs;
+  };
+
+  // Maps input sample rate to the dedicated converter.  Inputs not requiring
+  // resampling go directly to |master_converter_|.
+  using AudioConvertersMap = base::flat_map<int, ResamplingConverter>;
   AudioConvertersMap converters_ GUARDED_BY(lock_);
 
-  // Master converter which mixes all the outputs from |converters_| as well as
+  // The inputs |master_converter_| should be mixing: the converters above plus
   // mixer inputs that are in the output sample rate.
-  AudioConverter master_converter_ GUARDED_BY(lock_);
+  AudioConverter::InputCallbackList master_inputs_ GUARDED_BY(lock_);
 
   // Handles physical stream pause when no inputs are playing.  For latency
   // reasons we don't want to immediately pause the physical stream.
@@ -0,0 +1,120 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/synchronization/atomic_flag.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "media/base/audio_renderer_mixer.h"
+#include "media/base/fake_audio_render_callback.h"
+#include "media/base/mock_audio_renderer_sink.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+static const int kRenderCallbacks = 20000;
+static const int kSampleRate = 48000;
+static const int kResampledRate = 44100;
+static const int kBufferSize = 512;
+
+// Calls Render() back to back on its own thread, timing each call.
+class RenderLoop : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit RenderLoop(AudioRendererSink::RenderCallback* callback)
+      : callback_(callback),
+        audio_bus_(AudioBus::Create(2, kBufferSize)) {
+    callback_times_.reserve(kRenderCallbacks);
+  }
+
+  void Run() override {
+    for (int i = 0; i < kRenderCallbacks; ++i) {
+      const base::TimeTicks start = base::TimeTicks::Now();
+      callback_->Render(base::TimeDelta(), start, 0, audio_bus_.get());
+      callback_times_.push_back(base::TimeTicks::Now() - start);
+    }
+    done_.Set();
+  }
+
+  bool done() const { return done_.IsSet(); }
+  std::vector<base::TimeDelta>& callback_times() { return callback_times_; }
+
+ private:
+  AudioRendererSink::RenderCallback* const callback_;
+  std::unique_ptr<AudioBus> audio_bus_;
+  std::vector<base::TimeDelta> callback_times_;
+  base::AtomicFlag done_;
+};
+
+// Renders from a separate thread while, if |churn| is set, the test thread
+// repeatedly adds and removes inputs; reports Render() time percentiles.
+static void RunRenderBenchmark(bool churn, const std::string& trace_name) {
+  auto sink = base::MakeRefCounted<testing::NiceMock<MockAudioRendererSink>>();
+  const AudioParameters output_params(AudioParameters::AUDIO_PCM_LOW_LATENCY,
+                                      CHANNEL_LAYOUT_STEREO, kSampleRate,
+                                      kBufferSize);
+  const AudioParameters input_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                     CHANNEL_LAYOUT_STEREO, kSampleRate,
+                                     kBufferSize);
+  const AudioParameters resampled_input_params(
+      AudioParameters::AUDIO_PCM_LINEAR, CHANNEL_LAYOUT_STEREO, kResampledRate,
+      kBufferSize);
+  AudioRendererMixer mixer(output_params, sink);
+
+  // A steady input, plus one which is added and removed; the latter needs its
+  // own resampling converter so that is created and destroyed as well.
+  FakeAudioRenderCallback steady_input(0.01, kSampleRate);
+  FakeAudioRenderCallback churned_input(0.01, kResampledRate);
+  mixer.AddMixerInput(input_params, &steady_input);
+
+  RenderLoop render_loop(sink->callback());
+  base::DelegateSimpleThread render_thread(&render_loop, "RenderLoop");
+  render_thread.Start();
+  int churn_count = 0;
+  while (churn && !render_loop.done()) {
+    mixer.AddMixerInput(resampled_input_params, &churned_input);
+    mixer.RemoveMixerInput(resampled_input_params, &churned_input);
+    ++churn_count;
+  }
+  render_thread.Join();
+  mixer.RemoveMixerInput(input_params, &steady_input);
+
+  std::vector<base::TimeDelta>& times = render_loop.callback_times();
+  std::sort(times.begin(), times.end());
+  auto percentile = [&times](double p) {
+    return times[std::min(times.size() - 1,
+                          static_cast<size_t>(p * times.size()))]
+        .InMicrosecondsF();
+  };
+
+  perf_test::PerfResultReporter reporter("audio_renderer_mixer", trace_name);
+  reporter.RegisterImportantMetric("_render_p50", "us");
+  reporter.RegisterImportantMetric("_render_p99", "us");
+  reporter.RegisterImportantMetric("_render_p999", "us");
+  reporter.RegisterImportantMetric("_render_max", "us");
+  reporter.RegisterImportantMetric("_overruns", "count");
+  reporter.RegisterImportantMetric("_churns", "count");
+  reporter.AddResult("_render_p50", percentile(0.5));
+  reporter.AddResult("_render_p99", percentile(0.99));
+  reporter.AddResult("_render_p999", percentile(0.999));
+  reporter.AddResult("_render_max", times.back().InMicrosecondsF());
+  reporter.AddResult("_overruns",
+                     static_cast<size_t>(mixer.GetRenderStats().overruns));
+  reporter.AddResult("_churns", static_cast<size_t>(churn_count));
+}
+
+TEST(AudioRendererMixerPerfTest, Render) {
+  RunRenderBenchmark(false, "steady");
+}
+
+TEST(AudioRendererMixerPerfTest, RenderWhileChurningInputs) {
+  RunRenderBenchmark(true, "churn");
+}
+
+}  // namespace media
@@ -15,9 +15,11 @@
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/stl_util.h"
+#include "base/synchronization/atomic_flag.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/test/task_environment.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
 #include "media/base/audio_renderer_mixer_input.h"
 #include "media/base/audio_renderer_mixer_pool.h"
 #include "media/base/fake_audio_render_callback.h"
@@ -520,6 +522,56 @@ TEST_P(AudioRendererMixerBehavioralTest, MixerPausesStream) {
   mixer_inputs_[0]->Stop();
 }
 
+// Ensure skipped frames reported by the sink are counted.
+TEST_P(AudioRendererMixerBehavioralTest, RenderStats) {
+  mixer_callback_->Render(base::TimeDelta(), base::TimeTicks::Now(), 0,
+                          audio_bus_.get());
+  mixer_callback_->Render(base::TimeDelta(), base::TimeTicks::Now(), 128,
+                          audio_bus_.get());
+
+  AudioRendererMixer::RenderStats stats = mixer_->GetRenderStats();
+  EXPECT_EQ(2, stats.callbacks);
+  EXPECT_EQ(1, stats.glitches);
+  EXPECT_EQ(128, stats.frames_skipped);
+}
+
+// Ensure inputs can be added and removed while another thread is rendering,
+// and that an input is no longer used once RemoveMixerInput() returns.
+TEST_P(AudioRendererMixerBehavioralTest, AddRemoveInputsWhileRendering) {
+  base::AtomicFlag stop_rendering;
+  base::Thread render_thread("AudioRendererMixerRenderThread");
+  ASSERT_TRUE(render_thread.Start());
+  render_thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(
+                     [](AudioRendererSink::RenderCallback* callback,
+                        AudioBus* audio_bus, base::AtomicFlag* stop) {
+                       while (!stop->IsSet()) {
+                         callback->Render(base::TimeDelta(),
+                                          base::TimeTicks::Now(), 0, audio_bus);
+                       }
+                     },
+                     mixer_callback_, audio_bus_.get(), &stop_rendering));
+
+  // Alternate between an input which needs resampling, and thus a converter
+  // which is created and destroyed each time, and one which doesn't.
+  const int kResampledRate = output_parameters_.sample_rate() / 2;
+  for (int i = 0; i < 100; ++i) {
+    AudioParameters params(
+        AudioParameters::AUDIO_PCM_LINEAR, kChannelLayout,
+        i % 2 ? output_parameters_.sample_rate() : kResampledRate,
+        kHighLatencyBufferSize);
+    auto input = std::make_unique<FakeAudioRenderCallback>(
+        0.1, params.sample_rate());
+    mixer_->AddMixerInput(params, input.get());
+    base::PlatformThread::Sleep(base::TimeDelta::FromMicroseconds(100));
+    mixer_->RemoveMixerInput(params, input.get());
+  }
+
+  stop_rendering.Set();
+  render_thread.Stop();
+  EXPECT_GT(mixer_->GetRenderStats().callbacks, 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     All,
     AudioRendererMixerTest,
@@ -207,9 +207,12 @@ class FixedSampleTypeTraits {
     // adding |kZeroPointValue|, because the scaled source value may be negative
     // and SampleType may be an unsigned integer type. The result of casting a
     // negative float to an unsigned integer is undefined.
-    if (source_value < 0) {
+    //
+    // NaN fails every comparison, so it takes the negative branch and is
+    // clipped to |kMinValue|, like FloatSampleTypeTraits does.
+    if (!(source_value >= 0)) {
       // Apply clipping (aka. clamping).
-      if (source_value <= FloatSampleTypeTraits<float>::kMinValue)
+      if (!(source_value > FloatSampleTypeTraits<float>::kMinValue))
         return kMinValue;
 
       return static_cast<SampleType>(
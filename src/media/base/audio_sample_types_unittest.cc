@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#include <limits>
+
 #include "base/macros.h"
 #include "media/base/audio_sample_types.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -226,4 +228,15 @@ typedef ::testing::Types<UnsignedInt8ToFloat32TestConfig,
     TestConfigs;
 INSTANTIATE_TYPED_TEST_SUITE_P(CommonTypes, SampleTypeTraitsTest, TestConfigs);
 
+TEST(SampleTypeTraitsTest, ConvertNaNToMinValue) {
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+  EXPECT_EQ(-1.0f, Float32SampleTypeTraits::FromFloat(kNaN));
+  EXPECT_EQ(0, UnsignedInt8SampleTypeTraits::FromFloat(kNaN));
+  EXPECT_EQ(std::numeric_limits<int16_t>::min(),
+            SignedInt16SampleTypeTraits::FromFloat(kNaN));
+  EXPECT_EQ(std::numeric_limits<int32_t>::min(),
+            SignedInt32SampleTypeTraits::FromDouble(
+                std::numeric_limits<double>::quiet_NaN()));
+}
+
 }  // namespace media
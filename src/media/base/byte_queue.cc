@@ -6,19 +6,48 @@
 
 #include <algorithm>
 #include <cstring>
+#include <memory>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/numerics/checked_math.h"
+#include "base/numerics/safe_conversions.h"
 
 namespace media {
 
-ByteQueue::ByteQueue() : buffer_(new uint8_t[size_]) {}
+// Storage allocated by ByteQueue. Note that it is purposely not initialized.
+class ByteQueue::Chunk : public base::RefCountedMemory {
+ public:
+  explicit Chunk(size_t size) : data_(new uint8_t[size]), size_(size) {}
+
+  uint8_t* writable_data() { return data_.get(); }
+
+  // base::RefCountedMemory implementation.
+  const unsigned char* front() const override { return data_.get(); }
+  size_t size() const override { return size_; }
+
+ private:
+  ~Chunk() override = default;
+
+  const std::unique_ptr<uint8_t[]> data_;
+  const size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(Chunk);
+};
+
+ByteQueue::ByteQueue() {
+  Allocate(size_);
+}
 
 ByteQueue::~ByteQueue() = default;
 
 void ByteQueue::Reset() {
   offset_ = 0;
   used_ = 0;
+
+  // Buffers created from PeekChunk() may still refer to the old contents.
+  if (!writable_buffer_ || !buffer_->HasOneRef())
+    Allocate(kDefaultQueueSize);
 }
 
 void ByteQueue::Push(const uint8_t* data, int size) {
@@ -28,43 +57,63 @@ void ByteQueue::Push(const uint8_t* data, int size) {
   // This can never overflow since used and size are both ints.
   const size_t size_needed = static_cast<size_t>(used_) + size;
 
-  // Check to see if we need a bigger buffer.
-  if (size_needed > size_) {
-    // Growth is based on base::circular_deque which grows at 25%.
-    const size_t safe_size =
-        (base::CheckedNumeric<size_t>(size_) + size_ / 4).ValueOrDie();
-    const size_t new_size = std::max(size_needed, safe_size);
-
-    // Copy the data from the old buffer to the start of the new one.
-    if (used_ > 0) {
-      // Note: We could use realloc() here, but would need an additional move to
-      // pack data at offset_ = 0 after a potential internal new allocation +
-      // copy by realloc().
-      //
-      // In local tests on a few top video sites that ends up being the common
-      // case, so just prefer to copy and pack ourselves.
-      std::unique_ptr<uint8_t[]> new_buffer(new uint8_t[new_size]);
-      memcpy(new_buffer.get(), Front(), used_);
-      buffer_ = std::move(new_buffer);
-    } else {
-      // Free the existing |data| first so that the memory can be reused, if
-      // possible. Note that the new array is purposely not initialized.
-      buffer_.reset();
-      buffer_.reset(new uint8_t[new_size]);
-    }
-
-    size_ = new_size;
-    offset_ = 0;
-  } else if ((offset_ + used_ + size) > size_) {
+  if (writable_buffer_ && offset_ + used_ + size <= size_) {
+    // There is room after the queued data; nothing can refer to it yet.
+  } else if (writable_buffer_ && size_needed <= size_ &&
+             buffer_->HasOneRef()) {
     // The buffer is big enough, but we need to move the data in the queue.
-    memmove(buffer_.get(), Front(), used_);
+    memmove(writable_buffer_, Front(), used_);
     offset_ = 0;
+  } else {
+    // Either the buffer is too small, or its queued data can't be moved since
+    // it was adopted or may be referenced through PeekChunk(). Growth is based
+    // on base::circular_deque which grows at 25%.
+    size_t new_size = writable_buffer_ ? size_ : kDefaultQueueSize;
+    if (size_needed > new_size) {
+      const size_t safe_size =
+          (base::CheckedNumeric<size_t>(new_size) + new_size / 4).ValueOrDie();
+      new_size = std::max(size_needed, safe_size);
+    }
+
+    // Note: We could use realloc() here, but would need an additional move to
+    // pack data at offset_ = 0 after a potential internal new allocation +
+    // copy by realloc().
+    //
+    // In local tests on a few top video sites that ends up being the common
+    // case, so just prefer to copy and pack ourselves.
+    scoped_refptr<base::RefCountedMemory> old_buffer = std::move(buffer_);
+    const uint8_t* old_front = old_buffer->front() + offset_;
+    if (used_ == 0) {
+      // Free the existing data first so that the memory can be reused, if
+      // possible.
+      old_buffer.reset();
+    }
+    Allocate(new_size);
+    if (used_ > 0)
+      memcpy(writable_buffer_, old_front, used_);
   }
 
-  memcpy(Front() + used_, data, size);
+  memcpy(writable_buffer_ + offset_ + used_, data, size);
   used_ += size;
 }
 
+void ByteQueue::Push(scoped_refptr<base::RefCountedMemory> chunk) {
+  DCHECK(chunk);
+  const int size = base::checked_cast<int>(chunk->size());
+  DCHECK_GT(size, 0);
+
+  if (used_ > 0) {
+    Push(chunk->front(), size);
+    return;
+  }
+
+  buffer_ = std::move(chunk);
+  writable_buffer_ = nullptr;
+  size_ = size;
+  offset_ = 0;
+  used_ = size;
+}
+
 void ByteQueue::Peek(const uint8_t** data, int* size) const {
   DCHECK(data);
   DCHECK(size);
@@ -72,21 +121,38 @@ void ByteQueue::Peek(const uint8_t** data, int* size) const {
   *size = used_;
 }
 
+scoped_refptr<base::RefCountedMemory> ByteQueue::PeekChunk(
+    size_t* offset) const {
+  DCHECK(offset);
+  *offset = offset_;
+  return buffer_;
+}
+
 void ByteQueue::Pop(int count) {
   DCHECK_LE(count, used_);
 
   offset_ += count;
   used_ -= count;
 
-  // Move the offset back to 0 if we have reached the end of the buffer.
+  // Move the offset back to 0 if we have reached the end of the buffer and no
+  // buffers created from PeekChunk() can refer to its contents.
   if (offset_ == size_) {
     DCHECK_EQ(used_, 0);
-    offset_ = 0;
+    if (writable_buffer_ && buffer_->HasOneRef())
+      offset_ = 0;
   }
 }
 
-uint8_t* ByteQueue::Front() const {
-  return buffer_.get() + offset_;
+void ByteQueue::Allocate(size_t size) {
+  auto chunk = base::MakeRefCounted<Chunk>(size);
+  writable_buffer_ = chunk->writable_data();
+  buffer_ = std::move(chunk);
+  size_ = size;
+  offset_ = 0;
+}
+
+const uint8_t* ByteQueue::Front() const {
+  return buffer_->front() + offset_;
 }
 
 }  // namespace media
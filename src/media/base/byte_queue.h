@@ -8,9 +8,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <memory>
-
 #include "base/macros.h"
+#include "base/memory/ref_counted_memory.h"
 #include "media/base/media_export.h"
 
 namespace media {
@@ -20,7 +19,10 @@ namespace media {
 // via the Peek() method.
 //
 // This class manages the underlying storage of the queue and tries to minimize
-// the number of buffer copies when data is appended and removed.
+// the number of buffer copies when data is appended and removed. The storage
+// is refcounted so that parsers can hand out buffers referring to the queued
+// bytes instead of copying them; see PeekChunk(). Bytes that may be referenced
+// that way are never overwritten or moved.
 class MEDIA_EXPORT ByteQueue {
  public:
   ByteQueue();
@@ -32,10 +34,21 @@ class MEDIA_EXPORT ByteQueue {
   // Appends new bytes onto the end of the queue.
   void Push(const uint8_t* data, int size);
 
+  // Appends |chunk| onto the end of the queue. If the queue is empty, it adopts
+  // |chunk| as its storage instead of copying it; |chunk| must then not change
+  // while the queue or any buffer created from PeekChunk() refers to it.
+  void Push(scoped_refptr<base::RefCountedMemory> chunk);
+
   // Get a pointer to the front of the queue and the queue size. These values
   // are only valid until the next Push() or Pop() call.
   void Peek(const uint8_t** data, int* size) const;
 
+  // Returns the storage holding the bytes returned by Peek(), and sets
+  // |offset| to the position of the front of the queue within it. Unlike the
+  // Peek() pointer, the returned chunk stays valid after Push() and Pop();
+  // e.g. StreamParserBuffer::FromSharedChunk() can slice frames out of it.
+  scoped_refptr<base::RefCountedMemory> PeekChunk(size_t* offset) const;
+
   // Remove |count| bytes from the front of the queue.
   void Pop(int count);
 
@@ -43,8 +56,13 @@ class MEDIA_EXPORT ByteQueue {
   // Default starting size for the queue.
   enum { kDefaultQueueSize = 1024 };
 
+  class Chunk;
+
+  // Replaces |buffer_| with a new, exclusively owned chunk of |size| bytes.
+  void Allocate(size_t size);
+
   // Returns a pointer to the front of the queue.
-  uint8_t* Front() const;
+  const uint8_t* Front() const;
 
   // Size of |buffer_|.
   size_t size_ = kDefaultQueueSize;
@@ -55,7 +73,11 @@ class MEDIA_EXPORT ByteQueue {
   // Number of bytes stored in |buffer_|.
   int used_ = 0;
 
-  std::unique_ptr<uint8_t[]> buffer_;
+  scoped_refptr<base::RefCountedMemory> buffer_;
+
+  // |buffer_|'s memory, if it was allocated by this queue and can be written
+  // past |offset_| + |used_|. Null if |buffer_| was adopted by Push().
+  uint8_t* writable_buffer_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(ByteQueue);
 };
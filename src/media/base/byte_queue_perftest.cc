@@ -0,0 +1,159 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "media/base/byte_queue.h"
+#include "media/base/stream_parser_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+// A synthetic 4K stream: 25 Mbps at 60fps with 2 second GOPs, delivered as
+// whole-GOP media segments. Each frame is stored as a 4 byte big-endian size,
+// a key frame flag byte and the frame data.
+static const int kBitrate = 25000000;
+static const int kFramesPerSecond = 60;
+static const int kSegmentSeconds = 2;
+static const int kFramesPerSegment = kSegmentSeconds * kFramesPerSecond;
+static const int kMediaSeconds = 120;
+static const size_t kFrameHeaderSize = 5;
+static const size_t kNetworkReadSize = 64 * 1024;
+
+static std::vector<uint8_t> CreateSegment() {
+  // Key frames are about eight times the size of other frames.
+  const size_t segment_size = kBitrate / 8 * kSegmentSeconds;
+  const size_t frame_size = segment_size / (kFramesPerSegment + 7);
+
+  std::vector<uint8_t> segment;
+  segment.reserve(segment_size + kFramesPerSegment * kFrameHeaderSize);
+  for (int frame = 0; frame < kFramesPerSegment; ++frame) {
+    const bool is_key_frame = frame == 0;
+    const size_t size = is_key_frame ? frame_size * 8 : frame_size;
+    segment.push_back(static_cast<uint8_t>(size >> 24));
+    segment.push_back(static_cast<uint8_t>(size >> 16));
+    segment.push_back(static_cast<uint8_t>(size >> 8));
+    segment.push_back(static_cast<uint8_t>(size));
+    segment.push_back(is_key_frame);
+    segment.resize(segment.size() + size, static_cast<uint8_t>(frame));
+  }
+  return segment;
+}
+
+// Pushes |chunk| into |queue| and emits a StreamParserBuffer for every whole
+// frame queued, either copied out of the queue or sharing its storage. Adds
+// the number of bytes copied to |bytes_copied|.
+static void ParseChunk(scoped_refptr<base::RefCountedMemory> chunk,
+                       bool share_chunks,
+                       ByteQueue* queue,
+                       StreamParserBuffer::BufferQueue* buffers,
+                       size_t* bytes_copied) {
+  if (share_chunks) {
+    // The queue copies |chunk| unless it adopts it as its storage.
+    scoped_refptr<base::RefCountedMemory> pushed_chunk = chunk;
+    queue->Push(std::move(chunk));
+    size_t offset;
+    if (queue->PeekChunk(&offset) != pushed_chunk)
+      *bytes_copied += pushed_chunk->size();
+  } else {
+    queue->Push(chunk->front(), static_cast<int>(chunk->size()));
+    *bytes_copied += chunk->size();
+  }
+
+  for (;;) {
+    const uint8_t* data;
+    int size;
+    queue->Peek(&data, &size);
+    if (static_cast<size_t>(size) < kFrameHeaderSize)
+      return;
+
+    const size_t frame_size = (static_cast<size_t>(data[0]) << 24) |
+                              (data[1] << 16) | (data[2] << 8) | data[3];
+    if (static_cast<size_t>(size) < kFrameHeaderSize + frame_size)
+      return;
+
+    const bool is_key_frame = data[4];
+    if (share_chunks) {
+      size_t offset;
+      scoped_refptr<base::RefCountedMemory> queued = queue->PeekChunk(&offset);
+      buffers->push_back(StreamParserBuffer::FromSharedChunk(
+          std::move(queued), offset + kFrameHeaderSize, frame_size,
+          is_key_frame, DemuxerStream::VIDEO, 0));
+    } else {
+      buffers->push_back(StreamParserBuffer::CopyFrom(
+          data + kFrameHeaderSize, frame_size, is_key_frame,
+          DemuxerStream::VIDEO, 0));
+      *bytes_copied += frame_size;
+    }
+    queue->Pop(static_cast<int>(kFrameHeaderSize + frame_size));
+  }
+}
+
+// Appends |kMediaSeconds| of the stream, in |append_size| byte appends if
+// non-zero or whole segments otherwise, and reports the bytes copied and the
+// CPU time spent per second of media. Counted copies are a lower bound; they
+// exclude copies made by the queue when it grows or compacts.
+static void RunAppendBenchmark(bool share_chunks,
+                               size_t append_size,
+                               const std::string& story) {
+  if (!base::ThreadTicks::IsSupported())
+    return;
+  base::ThreadTicks::WaitUntilInitialized();
+
+  // The segment plays the role of the network buffers; appends reference it
+  // instead of allocating, as the network stack would hand them over.
+  const std::vector<uint8_t> segment = CreateSegment();
+  if (!append_size)
+    append_size = segment.size();
+
+  ByteQueue queue;
+  size_t bytes_copied = 0;
+  size_t frames = 0;
+  const base::ThreadTicks start = base::ThreadTicks::Now();
+  for (int i = 0; i < kMediaSeconds / kSegmentSeconds; ++i) {
+    for (size_t offset = 0; offset < segment.size(); offset += append_size) {
+      StreamParserBuffer::BufferQueue buffers;
+      ParseChunk(base::MakeRefCounted<base::RefCountedStaticMemory>(
+                     segment.data() + offset,
+                     std::min(append_size, segment.size() - offset)),
+                 share_chunks, &queue, &buffers, &bytes_copied);
+      frames += buffers.size();
+    }
+  }
+  const base::TimeDelta cpu_time = base::ThreadTicks::Now() - start;
+  ASSERT_EQ(static_cast<size_t>(kMediaSeconds * kFramesPerSecond), frames);
+
+  perf_test::PerfResultReporter reporter("byte_queue", story);
+  reporter.RegisterImportantMetric("_memcpy_per_media_second", "bytes");
+  reporter.RegisterImportantMetric("_cpu_per_media_second", "us");
+  reporter.AddResult("_memcpy_per_media_second",
+                     bytes_copied / static_cast<size_t>(kMediaSeconds));
+  reporter.AddResult("_cpu_per_media_second", cpu_time / kMediaSeconds);
+}
+
+TEST(ByteQueuePerfTest, Append4KSegments) {
+  RunAppendBenchmark(false, 0, "4k_segments");
+}
+
+TEST(ByteQueuePerfTest, Append4KSegmentsShared) {
+  RunAppendBenchmark(true, 0, "4k_segments_shared");
+}
+
+TEST(ByteQueuePerfTest, Append4KNetworkReads) {
+  RunAppendBenchmark(false, kNetworkReadSize, "4k_network_reads");
+}
+
+TEST(ByteQueuePerfTest, Append4KNetworkReadsShared) {
+  RunAppendBenchmark(true, kNetworkReadSize, "4k_network_reads_shared");
+}
+
+}  // namespace media
@@ -0,0 +1,113 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/byte_queue.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "base/memory/ref_counted_memory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static std::vector<uint8_t> MakeData(size_t size, uint8_t first) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(first + i);
+  return data;
+}
+
+static void ExpectContents(const ByteQueue& queue,
+                           const std::vector<uint8_t>& expected) {
+  const uint8_t* data;
+  int size;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(expected.size(), static_cast<size_t>(size));
+  EXPECT_EQ(0, memcmp(expected.data(), data, expected.size()));
+}
+
+TEST(ByteQueueTest, PushPeekPop) {
+  ByteQueue queue;
+  ExpectContents(queue, {});
+
+  const std::vector<uint8_t> data = MakeData(3000, 0);
+  queue.Push(data.data(), 1000);
+  queue.Push(data.data() + 1000, 2000);
+  ExpectContents(queue, data);
+
+  queue.Pop(1500);
+  ExpectContents(queue,
+                 std::vector<uint8_t>(data.begin() + 1500, data.end()));
+
+  queue.Pop(1500);
+  ExpectContents(queue, {});
+}
+
+TEST(ByteQueueTest, PushChunkIntoEmptyQueueAdoptsIt) {
+  ByteQueue queue;
+  const std::vector<uint8_t> data = MakeData(100, 0);
+  auto chunk = base::MakeRefCounted<base::RefCountedBytes>(data);
+  queue.Push(chunk);
+  ExpectContents(queue, data);
+
+  size_t offset;
+  EXPECT_EQ(chunk, queue.PeekChunk(&offset));
+  EXPECT_EQ(0u, offset);
+
+  queue.Pop(10);
+  EXPECT_EQ(chunk, queue.PeekChunk(&offset));
+  EXPECT_EQ(10u, offset);
+}
+
+TEST(ByteQueueTest, PushChunkIntoNonEmptyQueueCopiesIt) {
+  ByteQueue queue;
+  const std::vector<uint8_t> data = MakeData(200, 0);
+  queue.Push(data.data(), 100);
+  auto chunk = base::MakeRefCounted<base::RefCountedBytes>(data.data() + 100,
+                                                           100);
+  queue.Push(chunk);
+  ExpectContents(queue, data);
+
+  size_t offset;
+  EXPECT_NE(chunk, queue.PeekChunk(&offset));
+}
+
+TEST(ByteQueueTest, PeekedChunkIsNotModified) {
+  ByteQueue queue;
+  const std::vector<uint8_t> data = MakeData(600, 0);
+  queue.Push(data.data(), 400);
+
+  size_t offset;
+  scoped_refptr<base::RefCountedMemory> chunk = queue.PeekChunk(&offset);
+  const std::vector<uint8_t> peeked(chunk->front() + offset,
+                                    chunk->front() + offset + 400);
+
+  // Popping everything and pushing more must not reuse the memory still
+  // referenced by |chunk|.
+  queue.Pop(400);
+  queue.Push(data.data() + 400, 200);
+  ExpectContents(queue, std::vector<uint8_t>(data.begin() + 400, data.end()));
+  EXPECT_EQ(0, memcmp(peeked.data(), chunk->front() + offset, 400));
+
+  queue.Reset();
+  queue.Push(data.data() + 200, 400);
+  EXPECT_EQ(0, memcmp(peeked.data(), chunk->front() + offset, 400));
+}
+
+TEST(ByteQueueTest, Reset) {
+  ByteQueue queue;
+  const std::vector<uint8_t> data = MakeData(100, 0);
+  queue.Push(base::MakeRefCounted<base::RefCountedBytes>(data));
+  queue.Reset();
+  ExpectContents(queue, {});
+
+  queue.Push(data.data(), 50);
+  ExpectContents(queue, std::vector<uint8_t>(data.begin(), data.begin() + 50));
+}
+
+}  // namespace media
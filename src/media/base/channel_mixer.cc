@@ -7,6 +7,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "base/check_op.h"
 #include "media/base/audio_bus.h"
 #include "media/base/audio_parameters.h"
@@ -55,11 +57,10 @@ void ChannelMixer::TransformPartial(const AudioBus* input,
   CHECK_LE(frame_count, input->frames());
   CHECK_LE(frame_count, output->frames());
 
-  // Zero initialize |output| so we're accumulating from zero.
-  output->ZeroFrames(frame_count);
-
   // If we're just remapping we can simply copy the correct input to output.
   if (remapping_) {
+    // Output channels without an input stay silent.
+    output->ZeroFrames(frame_count);
     for (int output_ch = 0; output_ch < output->channels(); ++output_ch) {
       for (int input_ch = 0; input_ch < input->channels(); ++input_ch) {
         float scale = matrix_[output_ch][input_ch];
@@ -75,15 +76,28 @@ void ChannelMixer::TransformPartial(const AudioBus* input,
   }
 
   for (int output_ch = 0; output_ch < output->channels(); ++output_ch) {
+    // The first input is scaled into the output instead of being accumulated
+    // onto zeros, which saves a pass over the output.
+    bool has_input = false;
     for (int input_ch = 0; input_ch < input->channels(); ++input_ch) {
       float scale = matrix_[output_ch][input_ch];
       // Scale should always be positive.  Don't bother scaling by zero.
       DCHECK_GE(scale, 0);
       if (scale > 0) {
-        vector_math::FMAC(input->channel(input_ch), scale, frame_count,
-                          output->channel(output_ch));
+        if (has_input) {
+          vector_math::FMAC(input->channel(input_ch), scale, frame_count,
+                            output->channel(output_ch));
+        } else {
+          vector_math::FMUL(input->channel(input_ch), scale, frame_count,
+                            output->channel(output_ch));
+          has_input = true;
+        }
       }
     }
+    if (!has_input) {
+      std::fill(output->channel(output_ch),
+                output->channel(output_ch) + frame_count, 0.0f);
+    }
   }
 }
 
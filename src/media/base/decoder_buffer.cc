@@ -60,6 +60,19 @@ DecoderBuffer::DecoderBuffer(
       shared_mem_mapping_(std::move(shared_mem_mapping)),
       is_key_frame_(false) {}
 
+DecoderBuffer::DecoderBuffer(scoped_refptr<base::RefCountedMemory> chunk,
+                             size_t offset,
+                             size_t size)
+    : size_(size),
+      side_data_size_(0),
+      chunk_(std::move(chunk)),
+      chunk_offset_(offset),
+      is_key_frame_(false) {
+  CHECK(chunk_);
+  CHECK_LE(chunk_offset_, chunk_->size());
+  CHECK_LE(size_, chunk_->size() - chunk_offset_);
+}
+
 DecoderBuffer::~DecoderBuffer() {
   data_.reset();
   side_data_.reset();
@@ -131,6 +144,15 @@ scoped_refptr<DecoderBuffer> DecoderBuffer::FromSharedMemoryRegion(
       new DecoderBuffer(std::move(unaligned_mapping), size));
 }
 
+// static
+scoped_refptr<DecoderBuffer> DecoderBuffer::FromSharedChunk(
+    scoped_refptr<base::RefCountedMemory> chunk,
+    size_t offset,
+    size_t size) {
+  return base::WrapRefCounted(
+      new DecoderBuffer(std::move(chunk), offset, size));
+}
+
 // static
 scoped_refptr<DecoderBuffer> DecoderBuffer::CreateEOSBuffer() {
   return base::WrapRefCounted(new DecoderBuffer(NULL, 0, NULL, 0));
@@ -17,6 +17,7 @@
 #include "base/memory/aligned_memory.h"
 #include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "media/base/decrypt_config.h"
@@ -89,6 +90,15 @@ class MEDIA_EXPORT DecoderBuffer
       off_t offset,
       size_t size);
 
+  // Create a DecoderBuffer where data() of |size| bytes resides within |chunk|
+  // at offset |offset|, without copying it. The buffer holds a reference to
+  // |chunk|, whose contents must not change while any buffer refers to it. The
+  // buffer's |is_key_frame_| will default to false.
+  static scoped_refptr<DecoderBuffer> FromSharedChunk(
+      scoped_refptr<base::RefCountedMemory> chunk,
+      size_t offset,
+      size_t size);
+
   // Create a DecoderBuffer indicating we've reached end of stream.
   //
   // Calling any method other than end_of_stream() on the resulting buffer
@@ -123,6 +133,8 @@ class MEDIA_EXPORT DecoderBuffer
       return static_cast<const uint8_t*>(shared_mem_mapping_->memory());
     if (shm_)
       return static_cast<uint8_t*>(shm_->memory());
+    if (chunk_)
+      return chunk_->front() + chunk_offset_;
     return data_.get();
   }
 
@@ -131,6 +143,7 @@ class MEDIA_EXPORT DecoderBuffer
     DCHECK(!end_of_stream());
     DCHECK(!shm_);
     DCHECK(!shared_mem_mapping_);
+    DCHECK(!chunk_);
     return data_.get();
   }
 
@@ -173,7 +186,9 @@ class MEDIA_EXPORT DecoderBuffer
   }
 
   // If there's no data in this buffer, it represents end of stream.
-  bool end_of_stream() const { return !shared_mem_mapping_ && !shm_ && !data_; }
+  bool end_of_stream() const {
+    return !shared_mem_mapping_ && !shm_ && !chunk_ && !data_;
+  }
 
   bool is_key_frame() const {
     DCHECK(!end_of_stream());
@@ -213,6 +228,10 @@ class MEDIA_EXPORT DecoderBuffer
   DecoderBuffer(std::unique_ptr<ReadOnlyUnalignedMapping> shared_mem_mapping,
                 size_t size);
 
+  DecoderBuffer(scoped_refptr<base::RefCountedMemory> chunk,
+                size_t offset,
+                size_t size);
+
   virtual ~DecoderBuffer();
 
   // Encoded data, if it is stored on the heap.
@@ -237,6 +256,11 @@ class MEDIA_EXPORT DecoderBuffer
   // Encoded data, if it is stored in SHM.
   std::unique_ptr<UnalignedSharedMemory> shm_;
 
+  // Encoded data, if it is a slice starting at |chunk_offset_| of a chunk
+  // shared with other buffers.
+  scoped_refptr<base::RefCountedMemory> chunk_;
+  size_t chunk_offset_ = 0;
+
   // Encryption parameters for the encoded data.
   std::unique_ptr<DecryptConfig> decrypt_config_;
 
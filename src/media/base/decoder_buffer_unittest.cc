@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/unsafe_shared_memory_region.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
@@ -186,6 +187,26 @@ TEST(DecoderBufferTest, FromSharedMemoryRegion_ZeroSize) {
   ASSERT_FALSE(buffer.get());
 }
 
+TEST(DecoderBufferTest, FromSharedChunk) {
+  const uint8_t kData[] = "hello";
+  const size_t kDataSize = base::size(kData);
+
+  auto chunk = base::MakeRefCounted<base::RefCountedBytes>(kData, kDataSize);
+  scoped_refptr<DecoderBuffer> buffer(
+      DecoderBuffer::FromSharedChunk(chunk, 1, kDataSize - 2));
+  ASSERT_TRUE(buffer.get());
+  EXPECT_EQ(chunk->front() + 1, buffer->data());
+  EXPECT_EQ(kDataSize - 2, buffer->data_size());
+  EXPECT_EQ(0, memcmp(buffer->data(), kData + 1, kDataSize - 2));
+  EXPECT_FALSE(buffer->end_of_stream());
+
+  // The buffer keeps the chunk alive.
+  const uint8_t* data = chunk->front();
+  chunk = nullptr;
+  EXPECT_EQ(data + 1, buffer->data());
+  EXPECT_EQ(0, memcmp(buffer->data(), kData + 1, kDataSize - 2));
+}
+
 TEST(DecoderBufferTest, ReadingWriting) {
   const char kData[] = "hello";
   const size_t kDataSize = base::size(kData);
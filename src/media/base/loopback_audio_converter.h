@@ -32,6 +32,10 @@ class LoopbackAudioConverter : public AudioConverter::InputCallback {
     audio_converter_.RemoveInput(input);
   }
 
+  void SwapInputs(AudioConverter::InputCallbackList* inputs) {
+    audio_converter_.SwapInputs(inputs);
+  }
+
   bool empty() { return audio_converter_.empty(); }
 
  private:
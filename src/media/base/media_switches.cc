@@ -237,6 +237,12 @@ const base::Feature kPictureInPicture {
 #endif
 };
 
+// Resample rational sample rate ratios (e.g. 44.1kHz <-> 48kHz) in
+// SincResampler with a precomputed polyphase kernel bank instead of
+// interpolating between kernels for every output frame.
+const base::Feature kPolyphaseResampling{"PolyphaseResampling",
+                                         base::FEATURE_ENABLED_BY_DEFAULT};
+
 // Only decode preload=metadata elements upon visibility.
 // TODO(crbug.com/879406): Remove this after M76 ships to stable
 const base::Feature kPreloadMetadataLazyLoad{"PreloadMetadataLazyLoad",
@@ -306,6 +312,12 @@ const base::Feature kCdmProcessSiteIsolation{"CdmProcessSiteIsolation",
 const base::Feature kMemoryPressureBasedSourceBufferGC{
     "MemoryPressureBasedSourceBufferGC", base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Bound the time an MSE garbage collection pass spends freeing data beyond the
+// hard memory limit (e.g. under memory pressure); the rest is freed by later
+// passes.
+const base::Feature kIncrementalSourceBufferGC{
+    "IncrementalSourceBufferGC", base::FEATURE_ENABLED_BY_DEFAULT};
+
 // Approach original pre-REC MSE object URL autorevoking behavior, though await
 // actual attempt to use the object URL for attachment to perform revocation.
 // This will hopefully reduce runtime memory bloat for pages that do not
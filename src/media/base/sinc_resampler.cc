@@ -75,13 +75,16 @@
 
 #include "media/base/sinc_resampler.h"
 
+#include <cmath>
 #include <limits>
 
 #include "base/check_op.h"
+#include "base/feature_list.h"
 #include "base/numerics/math_constants.h"
 #include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "cc/base/math_util.h"
+#include "media/base/media_switches.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
 #include <immintrin.h>
@@ -113,22 +116,53 @@ static double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
+static float PreSinc(int i, float subsample_offset) {
+  return base::kPiFloat *
+         (i - SincResampler::kKernelSize / 2 - subsample_offset);
+}
+
+static float BlackmanWindow(int i, float subsample_offset) {
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  const float x = (i - subsample_offset) / SincResampler::kKernelSize;
+  return static_cast<float>(kA0 - kA1 * cos(2.0 * base::kPiDouble * x) +
+                            kA2 * cos(4.0 * base::kPiDouble * x));
+}
+
+static float WindowedSinc(float window,
+                          float pre_sinc,
+                          double sinc_scale_factor) {
+  return static_cast<float>(
+      window * (pre_sinc ? sin(sinc_scale_factor * pre_sinc) / pre_sinc
+                         : sinc_scale_factor));
+}
+
 // If we know the minimum architecture at compile time, avoid CPU detection.
 void SincResampler::InitializeCPUSpecificFeatures() {
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
   convolve_proc_ = Convolve_NEON;
+  convolve_single_proc_ = ConvolveSingle_NEON;
 #elif defined(ARCH_CPU_X86_FAMILY)
   base::CPU cpu;
   // Using AVX2 instead of SSE2 when AVX2 supported.
-  if (cpu.has_avx2())
+  if (cpu.has_avx2()) {
     convolve_proc_ = Convolve_AVX2;
-  else if (cpu.has_sse2())
+    convolve_single_proc_ = ConvolveSingle_AVX2;
+  } else if (cpu.has_sse2()) {
     convolve_proc_ = Convolve_SSE;
-  else
+    convolve_single_proc_ = ConvolveSingle_SSE;
+  } else {
     convolve_proc_ = Convolve_C;
+    convolve_single_proc_ = ConvolveSingle_C;
+  }
 #else
   // Unknown architecture.
   convolve_proc_ = Convolve_C;
+  convolve_single_proc_ = ConvolveSingle_C;
 #endif
 }
 
@@ -140,6 +174,13 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
                              int request_frames,
                              const ReadCB read_cb)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
+      polyphase_enabled_(base::FeatureList::IsEnabled(kPolyphaseResampling)),
+      polyphase_kernel_count_(0),
+      polyphase_io_sample_rate_ratio_(io_sample_rate_ratio),
+      polyphase_frame_step_(0),
+      polyphase_phase_step_(0),
+      polyphase_phase_(0),
+      polyphase_active_(false),
       read_cb_(std::move(read_cb)),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
@@ -156,6 +197,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       r2_(input_buffer_.get() + kKernelSize / 2) {
   InitializeCPUSpecificFeatures();
   DCHECK(convolve_proc_);
+  DCHECK(convolve_single_proc_);
   CHECK_GT(request_frames_, 0);
   Flush();
   CHECK_GT(block_size_, kKernelSize)
@@ -191,12 +233,6 @@ void SincResampler::UpdateRegions(bool second_load) {
 }
 
 void SincResampler::InitializeKernel() {
-  // Blackman window parameters.
-  static const double kAlpha = 0.16;
-  static const double kA0 = 0.5 * (1.0 - kAlpha);
-  static const double kA1 = 0.5;
-  static const double kA2 = 0.5 * kAlpha;
-
   // Generates a set of windowed sinc() kernels.
   // We generate a range of sub-sample offsets from 0.0 to 1.0.
   const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
@@ -206,24 +242,102 @@ void SincResampler::InitializeKernel() {
 
     for (int i = 0; i < kKernelSize; ++i) {
       const int idx = i + offset_idx * kKernelSize;
-      const float pre_sinc =
-          base::kPiFloat * (i - kKernelSize / 2 - subsample_offset);
+      const float pre_sinc = PreSinc(i, subsample_offset);
       kernel_pre_sinc_storage_[idx] = pre_sinc;
 
       // Compute Blackman window, matching the offset of the sinc().
-      const float x = (i - subsample_offset) / kKernelSize;
-      const float window =
-          static_cast<float>(kA0 - kA1 * cos(2.0 * base::kPiDouble * x) +
-                             kA2 * cos(4.0 * base::kPiDouble * x));
+      const float window = BlackmanWindow(i, subsample_offset);
       kernel_window_storage_[idx] = window;
 
       // Compute the sinc with offset, then window the sinc() function and store
       // at the correct offset.
-      kernel_storage_[idx] = static_cast<float>(
-          window * (pre_sinc ? sin(sinc_scale_factor * pre_sinc) / pre_sinc
-                             : sinc_scale_factor));
+      kernel_storage_[idx] = WindowedSinc(window, pre_sinc, sinc_scale_factor);
+    }
+  }
+
+  InitializePolyphaseKernels();
+}
+
+void SincResampler::InitializePolyphaseKernels() {
+  int input_frames = 0;
+  const int kernel_count =
+      polyphase_enabled_
+          ? FindPolyphaseKernelCount(io_sample_rate_ratio_, &input_frames)
+          : 0;
+  if (!kernel_count)
+    return;
+
+  polyphase_kernel_storage_.reset(static_cast<float*>(
+      base::AlignedAlloc(sizeof(float) * kernel_count * kKernelSize, 32)));
+  polyphase_kernel_count_ = kernel_count;
+  polyphase_frame_step_ = input_frames / kernel_count;
+  polyphase_phase_step_ = input_frames % kernel_count;
+
+  // Each output frame lands on one of exactly |kernel_count| sub-sample
+  // offsets, so compute those kernels directly instead of interpolating.
+  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
+  for (int phase = 0; phase < kernel_count; ++phase) {
+    const float subsample_offset = static_cast<float>(phase) / kernel_count;
+    float* kernel = polyphase_kernel_storage_.get() + phase * kKernelSize;
+    for (int i = 0; i < kKernelSize; ++i) {
+      kernel[i] = WindowedSinc(BlackmanWindow(i, subsample_offset),
+                               PreSinc(i, subsample_offset),
+                               sinc_scale_factor);
+    }
+  }
+
+  MaybeResumePolyphase();
+}
+
+void SincResampler::MaybeResumePolyphase() {
+  polyphase_active_ = false;
+  if (!polyphase_kernel_count_ ||
+      fabs(io_sample_rate_ratio_ - polyphase_io_sample_rate_ratio_) >=
+          std::numeric_limits<double>::epsilon()) {
+    return;
+  }
+
+  // Only switch once |virtual_source_idx_| is on one of the kernel phases, so
+  // the read position doesn't jump.  It always is after Flush(), but rarely
+  // once the interpolated kernels have run at another ratio.
+  static const double kPhaseTolerance = 1e-6;
+  int source_idx = static_cast<int>(virtual_source_idx_);
+  const double phase =
+      (virtual_source_idx_ - source_idx) * polyphase_kernel_count_;
+  const double rounded_phase = std::round(phase);
+  if (fabs(phase - rounded_phase) > kPhaseTolerance)
+    return;
+
+  polyphase_phase_ = static_cast<int>(rounded_phase);
+  if (polyphase_phase_ == polyphase_kernel_count_) {
+    polyphase_phase_ = 0;
+    ++source_idx;
+  }
+  virtual_source_idx_ =
+      source_idx +
+      static_cast<double>(polyphase_phase_) / polyphase_kernel_count_;
+  polyphase_active_ = true;
+}
+
+// static
+int SincResampler::FindPolyphaseKernelCount(double io_sample_rate_ratio,
+                                            int* input_frames) {
+  // Sample rates are integers, so their ratio is only off from the exact
+  // fraction by double rounding error.  Anything further off than this is a
+  // genuinely irrational (e.g. drift compensated) ratio.
+  static const double kTolerance = 1e-10;
+  for (int output_frames = 1; output_frames <= kMaxPolyphaseKernelCount;
+       ++output_frames) {
+    const double frames = io_sample_rate_ratio * output_frames;
+    const double rounded_frames = std::round(frames);
+    if (rounded_frames >= 1 &&
+        rounded_frames <= std::numeric_limits<int>::max() &&
+        fabs(frames - rounded_frames) < kTolerance) {
+      *input_frames = static_cast<int>(rounded_frames);
+      return output_frames;
     }
   }
+  return 0;
 }
 
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
@@ -241,14 +355,13 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
   for (int offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
     for (int i = 0; i < kKernelSize; ++i) {
       const int idx = i + offset_idx * kKernelSize;
-      const float window = kernel_window_storage_[idx];
-      const float pre_sinc = kernel_pre_sinc_storage_[idx];
-
-      kernel_storage_[idx] = static_cast<float>(
-          window * (pre_sinc ? sin(sinc_scale_factor * pre_sinc) / pre_sinc
-                             : sinc_scale_factor));
+      kernel_storage_[idx] =
+          WindowedSinc(kernel_window_storage_[idx],
+                       kernel_pre_sinc_storage_[idx], sinc_scale_factor);
     }
   }
+
+  MaybeResumePolyphase();
 }
 
 void SincResampler::Resample(int frames, float* destination) {
@@ -269,6 +382,39 @@ void SincResampler::Resample(int frames, float* destination) {
     {
       cc::ScopedSubnormalFloatDisabler disable_subnormals;
 
+      if (polyphase_active_) {
+        // The ratio is rational, so |virtual_source_idx_| only ever takes
+        // |polyphase_kernel_count_| distinct sub-sample offsets.  Track it as
+        // an integer index plus phase and convolve with the exact kernel for
+        // that phase; no per-frame kernel interpolation is needed.
+        int source_idx = static_cast<int>(virtual_source_idx_);
+        while (source_idx < block_size_) {
+          const float* k = polyphase_kernel_storage_.get() +
+                           polyphase_phase_ * kKernelSize;
+          DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(k) & 0x1F);
+          *destination++ = convolve_single_proc_(r1_ + source_idx, k);
+
+          // Advance the index and phase.
+          source_idx += polyphase_frame_step_;
+          polyphase_phase_ += polyphase_phase_step_;
+          if (polyphase_phase_ >= polyphase_kernel_count_) {
+            polyphase_phase_ -= polyphase_kernel_count_;
+            ++source_idx;
+          }
+          if (!--remaining_frames)
+            break;
+        }
+
+        virtual_source_idx_ =
+            source_idx +
+            static_cast<double>(polyphase_phase_) / polyphase_kernel_count_;
+        if (!remaining_frames)
+          return;
+
+        // |virtual_source_idx_| is now past |block_size_|, so the interpolated
+        // loop below is skipped and we go straight to wrapping.
+      }
+
       while (virtual_source_idx_ < block_size_) {
         // |virtual_source_idx_| lies in between two kernel offsets so figure
         // out what they are.
@@ -334,6 +480,7 @@ void SincResampler::Flush() {
   memset(input_buffer_.get(), 0,
          sizeof(*input_buffer_.get()) * input_buffer_size_);
   UpdateRegions(false);
+  MaybeResumePolyphase();
 }
 
 int SincResampler::GetMaxInputFramesRequested(
@@ -367,6 +514,14 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       kernel_interpolation_factor * sum2);
 }
 
+float SincResampler::ConvolveSingle_C(const float* input_ptr, const float* k) {
+  float sum = 0;
+  int n = kKernelSize;
+  while (n--)
+    sum += *input_ptr++ * *k++;
+  return sum;
+}
+
 #if defined(ARCH_CPU_X86_FAMILY)
 float SincResampler::Convolve_SSE(const float* input_ptr, const float* k1,
                                   const float* k2,
@@ -407,6 +562,38 @@ float SincResampler::Convolve_SSE(const float* input_ptr, const float* k1,
   return result;
 }
 
+float SincResampler::ConvolveSingle_SSE(const float* input_ptr,
+                                        const float* k) {
+  // Two accumulators to break up the add dependency chain.
+  __m128 m_sums1 = _mm_setzero_ps();
+  __m128 m_sums2 = _mm_setzero_ps();
+
+  if (reinterpret_cast<uintptr_t>(input_ptr) & 0x0F) {
+    for (int i = 0; i < kKernelSize; i += 8) {
+      m_sums1 = _mm_add_ps(
+          m_sums1, _mm_mul_ps(_mm_loadu_ps(input_ptr + i), _mm_load_ps(k + i)));
+      m_sums2 = _mm_add_ps(m_sums2, _mm_mul_ps(_mm_loadu_ps(input_ptr + i + 4),
+                                               _mm_load_ps(k + i + 4)));
+    }
+  } else {
+    for (int i = 0; i < kKernelSize; i += 8) {
+      m_sums1 = _mm_add_ps(
+          m_sums1, _mm_mul_ps(_mm_load_ps(input_ptr + i), _mm_load_ps(k + i)));
+      m_sums2 = _mm_add_ps(m_sums2, _mm_mul_ps(_mm_load_ps(input_ptr + i + 4),
+                                               _mm_load_ps(k + i + 4)));
+    }
+  }
+  m_sums1 = _mm_add_ps(m_sums1, m_sums2);
+
+  // Sum components together.
+  float result;
+  m_sums2 = _mm_add_ps(_mm_movehl_ps(m_sums1, m_sums1), m_sums1);
+  _mm_store_ss(&result, _mm_add_ss(m_sums2, _mm_shuffle_ps(
+      m_sums2, m_sums2, 1)));
+
+  return result;
+}
+
 __attribute__((target("avx2,fma"))) float SincResampler::Convolve_AVX2(
     const float* input_ptr,
     const float* k1,
@@ -453,6 +640,31 @@ __attribute__((target("avx2,fma"))) float SincResampler::Convolve_AVX2(
 
   return result;
 }
+__attribute__((target("avx2,fma"))) float SincResampler::ConvolveSingle_AVX2(
+    const float* input_ptr,
+    const float* k) {
+  // Two accumulators to break up the fma dependency chain.
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+  for (size_t i = 0; i < kKernelSize; i += 16) {
+    m_sums1 = _mm256_fmadd_ps(_mm256_loadu_ps(input_ptr + i),
+                              _mm256_load_ps(k + i), m_sums1);
+    m_sums2 = _mm256_fmadd_ps(_mm256_loadu_ps(input_ptr + i + 8),
+                              _mm256_load_ps(k + i + 8), m_sums2);
+  }
+  m_sums1 = _mm256_add_ps(m_sums1, m_sums2);
+
+  // Sum components together.
+  __m128 m128_sums1 = _mm_add_ps(_mm256_extractf128_ps(m_sums1, 0),
+                                 _mm256_extractf128_ps(m_sums1, 1));
+  float result;
+  __m128 m128_sums2 =
+      _mm_add_ps(_mm_movehl_ps(m128_sums1, m128_sums1), m128_sums1);
+  _mm_store_ss(&result, _mm_add_ss(m128_sums2,
+                                   _mm_shuffle_ps(m128_sums2, m128_sums2, 1)));
+
+  return result;
+}
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
                                    const float* k2,
@@ -480,6 +692,23 @@ float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
   float32x2_t m_half = vadd_f32(vget_high_f32(m_sums1), vget_low_f32(m_sums1));
   return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
 }
+
+float SincResampler::ConvolveSingle_NEON(const float* input_ptr,
+                                         const float* k) {
+  float32x4_t m_sums1 = vmovq_n_f32(0);
+  float32x4_t m_sums2 = vmovq_n_f32(0);
+
+  const float* upper = input_ptr + kKernelSize;
+  for (; input_ptr < upper; input_ptr += 8, k += 8) {
+    m_sums1 = vmlaq_f32(m_sums1, vld1q_f32(input_ptr), vld1q_f32(k));
+    m_sums2 = vmlaq_f32(m_sums2, vld1q_f32(input_ptr + 4), vld1q_f32(k + 4));
+  }
+  m_sums1 = vaddq_f32(m_sums1, m_sums2);
+
+  // Sum components together.
+  float32x2_t m_half = vadd_f32(vget_high_f32(m_sums1), vget_low_f32(m_sums1));
+  return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
+}
 #endif
 
 }  // namespace media
@@ -34,6 +34,12 @@ class MEDIA_EXPORT SincResampler {
     // at the expense of allocating more memory.
     kKernelOffsetCount = 32,
     kKernelStorageSize = kKernelSize * (kKernelOffsetCount + 1),
+
+    // Ratios which reduce to input_frames / output_frames with |output_frames|
+    // at most this value (e.g., 44.1kHz <-> 48kHz, 16kHz -> 44.1kHz) are
+    // resampled with a precomputed bank of |output_frames| exact polyphase
+    // kernels instead of interpolating between kKernelOffsetCount kernels.
+    kMaxPolyphaseKernelCount = 480,
   };
 
   // Callback type for providing more data into the resampler.  Expects |frames|
@@ -76,12 +82,24 @@ class MEDIA_EXPORT SincResampler {
   void Flush();
 
   // Update |io_sample_rate_ratio_|.  SetRatio() will cause a reconstruction of
-  // the kernels used for resampling.  Not thread safe, do not call while
-  // Resample() is in progress.
+  // the kernels used for resampling.  Polyphase kernels are only built for the
+  // ratio given at construction; see MaybeResumePolyphase().  Not thread safe,
+  // do not call while Resample() is in progress.
   void SetRatio(double io_sample_rate_ratio);
 
   float* get_kernel_for_testing() { return kernel_storage_.get(); }
 
+  // Returns true if the current ratio is resampled with polyphase kernels; see
+  // kMaxPolyphaseKernelCount.  Can be disabled via kPolyphaseResampling.
+  bool is_polyphase_for_testing() const { return polyphase_active_; }
+
+  // Returns the number of polyphase kernels needed to resample exactly at
+  // |io_sample_rate_ratio|, or zero if it isn't a rational ratio whose output
+  // term is at most kMaxPolyphaseKernelCount.  On success, |input_frames| is
+  // set such that input_frames / kernel count == |io_sample_rate_ratio|.
+  static int FindPolyphaseKernelCount(double io_sample_rate_ratio,
+                                      int* input_frames);
+
   // Return number of input frames consumed by a callback but not yet processed.
   // Since input/output ratio can be fractional, so can this value.
   // Zero before first call to Resample().
@@ -89,11 +107,23 @@ class MEDIA_EXPORT SincResampler {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveSingle);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_unoptimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_unaligned);
 
   void InitializeKernel();
+
+  // Builds the polyphase kernels for |io_sample_rate_ratio_| if possible.
+  // Only called on construction, so that SetRatio() never allocates or
+  // computes kernels on the audio thread.
+  void InitializePolyphaseKernels();
+
+  // Resamples with the polyphase kernels if |io_sample_rate_ratio_| is the
+  // ratio they were built for and |virtual_source_idx_| lies on one of their
+  // phases, otherwise with the interpolated kernels.  Never moves the read
+  // position by more than rounding error.
+  void MaybeResumePolyphase();
   void UpdateRegions(bool second_load);
 
   // Compute convolution of |k1| and |k2| over |input_ptr|, resultant sums are
@@ -116,6 +146,16 @@ class MEDIA_EXPORT SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute the convolution of a single kernel |k| over |input_ptr|; used for
+  // polyphase resampling where no kernel interpolation is necessary.
+  static float ConvolveSingle_C(const float* input_ptr, const float* k);
+#if defined(ARCH_CPU_X86_FAMILY)
+  static float ConvolveSingle_SSE(const float* input_ptr, const float* k);
+  static float ConvolveSingle_AVX2(const float* input_ptr, const float* k);
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  static float ConvolveSingle_NEON(const float* input_ptr, const float* k);
+#endif
+
   // Selects runtime specific CPU features like SSE.  Must be called before
   // using SincResampler.
   void InitializeCPUSpecificFeatures();
@@ -127,6 +167,27 @@ class MEDIA_EXPORT SincResampler {
   // double precision to avoid drift.
   double virtual_source_idx_;
 
+  // Whether polyphase kernels may be used; see kPolyphaseResampling.
+  const bool polyphase_enabled_;
+
+  // Number of kernels in |polyphase_kernel_storage_|, or zero if there are no
+  // polyphase kernels for |polyphase_io_sample_rate_ratio_|, the ratio given
+  // at construction.
+  int polyphase_kernel_count_;
+  const double polyphase_io_sample_rate_ratio_;
+
+  // While polyphase resampling, each output frame advances the source index by
+  // |polyphase_frame_step_| frames plus |polyphase_phase_step_| phases, and
+  // |virtual_source_idx_| is kept equal to its integer part plus
+  // |polyphase_phase_| / |polyphase_kernel_count_|.
+  int polyphase_frame_step_;
+  int polyphase_phase_step_;
+  int polyphase_phase_;
+
+  // Whether the current ratio is resampled using |polyphase_kernel_storage_|
+  // rather than the interpolated |kernel_storage_|.
+  bool polyphase_active_;
+
   // The buffer is primed once at the very beginning of processing.
   bool buffer_primed_;
 
@@ -153,6 +214,10 @@ class MEDIA_EXPORT SincResampler {
   std::unique_ptr<float[], base::AlignedFreeDeleter> kernel_pre_sinc_storage_;
   std::unique_ptr<float[], base::AlignedFreeDeleter> kernel_window_storage_;
 
+  // Contains |polyphase_kernel_count_| kernels back-to-back, one for each
+  // sub-sample offset reachable at |polyphase_io_sample_rate_ratio_|.
+  std::unique_ptr<float[], base::AlignedFreeDeleter> polyphase_kernel_storage_;
+
   // Data from the source is copied into this buffer for each processing pass.
   std::unique_ptr<float[], base::AlignedFreeDeleter> input_buffer_;
 
@@ -162,6 +227,8 @@ class MEDIA_EXPORT SincResampler {
                                  const float*,
                                  double);
   ConvolveProc convolve_proc_;
+  using ConvolveSingleProc = float (*)(const float*, const float*);
+  ConvolveSingleProc convolve_single_proc_;
 
   // Pointers to the various regions inside |input_buffer_|.  See the diagram at
   // the top of the .cc file for more information.
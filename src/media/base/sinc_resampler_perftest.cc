@@ -2,10 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cmath>
+#include <memory>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/numerics/math_constants.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
+#include "media/base/media_switches.h"
 #include "media/base/sinc_resampler.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -38,6 +44,80 @@ static void RunConvolveBenchmark(
   reporter.AddResult("_convolve", kBenchmarkIterations / total_time_seconds);
 }
 
+// Provides a 1kHz sine wave at |sample_rate| for measuring resampling SNR.
+class SineSource {
+ public:
+  explicit SineSource(int sample_rate) : sample_rate_(sample_rate) {}
+
+  void ProvideInput(int frames, float* destination) {
+    for (int i = 0; i < frames; ++i, ++frame_)
+      destination[i] = Sample(frame_, sample_rate_);
+  }
+
+  static float Sample(int frame, int sample_rate) {
+    return sin(2.0 * base::kPiDouble * kFrequency * frame / sample_rate);
+  }
+
+ private:
+  static constexpr double kFrequency = 1000;
+
+  const int sample_rate_;
+  int frame_ = 0;
+};
+
+// Compares polyphase and interpolated resampling of a common rational ratio,
+// reporting both throughput and the SNR against an ideal sine wave.
+static void RunResampleBenchmark(int input_rate,
+                                 int output_rate,
+                                 bool polyphase,
+                                 const std::string& trace_name) {
+  static const int kResampleIterations = 2000;
+  base::test::ScopedFeatureList feature_list;
+  if (!polyphase)
+    feature_list.InitAndDisableFeature(kPolyphaseResampling);
+
+  // Measure SNR over one second of output, skipping the initial frames where
+  // the kernel overlaps the zero initialized part of the input buffer.
+  SineSource source(input_rate);
+  SincResampler resampler(
+      static_cast<double>(input_rate) / output_rate,
+      SincResampler::kDefaultRequestSize,
+      base::BindRepeating(&SineSource::ProvideInput,
+                          base::Unretained(&source)));
+  ASSERT_EQ(polyphase, resampler.is_polyphase_for_testing());
+
+  std::unique_ptr<float[]> destination(new float[output_rate]);
+  resampler.Resample(output_rate, destination.get());
+  double signal_power = 0;
+  double noise_power = 0;
+  for (int i = SincResampler::kKernelSize; i < output_rate; ++i) {
+    const double expected = SineSource::Sample(i, output_rate);
+    signal_power += expected * expected;
+    noise_power += (destination[i] - expected) * (destination[i] - expected);
+  }
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kResampleIterations; ++i)
+    resampler.Resample(resampler.ChunkSize(), destination.get());
+  double total_time_seconds = (base::TimeTicks::Now() - start).InSecondsF();
+
+  perf_test::PerfResultReporter reporter("sinc_resampler", trace_name);
+  reporter.RegisterImportantMetric("_resample", "runs/s");
+  reporter.RegisterImportantMetric("_snr", "dB");
+  reporter.AddResult("_resample", kResampleIterations / total_time_seconds);
+  reporter.AddResult("_snr", 10 * log10(signal_power / noise_power));
+}
+
+TEST(SincResamplerPerfTest, Resample_44100_to_48000) {
+  RunResampleBenchmark(44100, 48000, false, "44100_to_48000_interpolated");
+  RunResampleBenchmark(44100, 48000, true, "44100_to_48000_polyphase");
+}
+
+TEST(SincResamplerPerfTest, Resample_48000_to_16000) {
+  RunResampleBenchmark(48000, 16000, false, "48000_to_16000_interpolated");
+  RunResampleBenchmark(48000, 16000, true, "48000_to_16000_polyphase");
+}
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that DCHECKs are compiled out when benchmarking.
 TEST(SincResamplerPerfTest, Convolve_unoptimized_aligned) {
@@ -9,8 +9,10 @@
 #include "base/macros.h"
 #include "base/numerics/math_constants.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
+#include "media/base/media_switches.h"
 #include "media/base/sinc_resampler.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -184,6 +186,102 @@ TEST(SincResamplerTest, Convolve) {
   EXPECT_NEAR(result2, result, kEpsilon);
 }
 
+// Ensure the optimized ConvolveSingle() methods used for polyphase resampling
+// match ConvolveSingle_C().
+TEST(SincResamplerTest, ConvolveSingle) {
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          base::BindRepeating(&MockSource::ProvideInput,
+                                              base::Unretained(&mock_source)));
+  static const double kEpsilon = 0.00000005;
+
+  const float* kernel = resampler.kernel_storage_.get();
+  double result = resampler.ConvolveSingle_C(kernel, kernel);
+  double result2 = resampler.convolve_single_proc_(kernel, kernel);
+  EXPECT_NEAR(result2, result, kEpsilon);
+
+  // Test ConvolveSingle() w/ unaligned input pointer.
+  result = resampler.ConvolveSingle_C(kernel + 1, kernel);
+  result2 = resampler.convolve_single_proc_(kernel + 1, kernel);
+  EXPECT_NEAR(result2, result, kEpsilon);
+}
+
+TEST(SincResamplerTest, FindPolyphaseKernelCount) {
+  int input_frames = 0;
+  EXPECT_EQ(160, SincResampler::FindPolyphaseKernelCount(44100.0 / 48000,
+                                                         &input_frames));
+  EXPECT_EQ(147, input_frames);
+  EXPECT_EQ(147, SincResampler::FindPolyphaseKernelCount(48000.0 / 44100,
+                                                         &input_frames));
+  EXPECT_EQ(160, input_frames);
+  EXPECT_EQ(1, SincResampler::FindPolyphaseKernelCount(48000.0 / 16000,
+                                                       &input_frames));
+  EXPECT_EQ(3, input_frames);
+  EXPECT_EQ(441, SincResampler::FindPolyphaseKernelCount(16000.0 / 44100,
+                                                         &input_frames));
+  EXPECT_EQ(160, input_frames);
+
+  // Denominators which are too large and irrational ratios are rejected.
+  EXPECT_EQ(0, SincResampler::FindPolyphaseKernelCount(11025.0 / 192000,
+                                                       &input_frames));
+  EXPECT_EQ(0, SincResampler::FindPolyphaseKernelCount(base::kPiDouble,
+                                                       &input_frames));
+  EXPECT_EQ(0, SincResampler::FindPolyphaseKernelCount(1.000001,
+                                                       &input_frames));
+}
+
+// Ensure SetRatio() switches between polyphase and interpolated kernels
+// without moving the read position, and only resumes polyphase resampling
+// once the position is on one of the polyphase kernel phases.
+TEST(SincResamplerTest, PolyphaseSetRatio) {
+  for (double ratio : {44100.0 / 48000, 2.0}) {
+    SCOPED_TRACE(ratio);
+    MockSource mock_source;
+    SincResampler resampler(
+        ratio, SincResampler::kDefaultRequestSize,
+        base::BindRepeating(&MockSource::ProvideInput,
+                            base::Unretained(&mock_source)));
+    EXPECT_TRUE(resampler.is_polyphase_for_testing());
+
+    std::unique_ptr<float[]> resampled_destination(
+        new float[resampler.ChunkSize()]);
+    EXPECT_CALL(mock_source, ProvideInput(_, _))
+        .Times(1).WillOnce(FillBuffer());
+    resampler.Resample(resampler.ChunkSize() / 2, resampled_destination.get());
+    const double buffered_frames = resampler.BufferedFrames();
+
+    // Switching away and straight back keeps using the same phase.
+    resampler.SetRatio(base::kPiDouble);
+    EXPECT_FALSE(resampler.is_polyphase_for_testing());
+    EXPECT_EQ(buffered_frames, resampler.BufferedFrames());
+    resampler.SetRatio(ratio);
+    EXPECT_TRUE(resampler.is_polyphase_for_testing());
+    EXPECT_EQ(buffered_frames, resampler.BufferedFrames());
+
+    // After advancing by an irrational ratio the position is between phases,
+    // so the interpolated kernels stay in use rather than snapping to one.
+    resampler.SetRatio(base::kPiDouble);
+    resampler.Resample(1, resampled_destination.get());
+    const double shifted_buffered_frames = resampler.BufferedFrames();
+    EXPECT_DOUBLE_EQ(buffered_frames - base::kPiDouble,
+                     shifted_buffered_frames);
+    resampler.SetRatio(ratio);
+    EXPECT_FALSE(resampler.is_polyphase_for_testing());
+    EXPECT_EQ(shifted_buffered_frames, resampler.BufferedFrames());
+
+    // Flush() resets the position onto a phase.
+    resampler.Flush();
+    EXPECT_TRUE(resampler.is_polyphase_for_testing());
+  }
+
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndDisableFeature(kPolyphaseResampling);
+  SincResampler disabled_resampler(44100.0 / 48000,
+                                   SincResampler::kDefaultRequestSize,
+                                   SincResampler::ReadCB());
+  EXPECT_FALSE(disabled_resampler.is_polyphase_for_testing());
+}
+
 // Fake audio source for testing the resampler.  Generates a sinusoidal linear
 // chirp (http://en.wikipedia.org/wiki/Chirp) which can be tuned to stress the
 // resampler for the specific sample rate conversion being used.
@@ -251,6 +349,8 @@ class SincResamplerTest
   virtual ~SincResamplerTest() = default;
 
  protected:
+  void TestResample();
+
   int input_rate_;
   int output_rate_;
   double rms_error_;
@@ -258,7 +358,7 @@ class SincResamplerTest
 };
 
 // Tests resampling using a given input and output sample rate.
-TEST_P(SincResamplerTest, Resample) {
+void SincResamplerTest::TestResample() {
   // Make comparisons using one second of data.
   static const double kTestDurationSecs = 1;
   int input_samples = kTestDurationSecs * input_rate_;
@@ -345,6 +445,17 @@ TEST_P(SincResamplerTest, Resample) {
   EXPECT_LE(high_freq_max_error, kHighFrequencyMaxError);
 }
 
+// Most of the ratios below are rational enough to use polyphase kernels.
+TEST_P(SincResamplerTest, Resample) {
+  TestResample();
+}
+
+TEST_P(SincResamplerTest, ResampleInterpolated) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndDisableFeature(kPolyphaseResampling);
+  TestResample();
+}
+
 // Almost all conversions have an RMS error of around -14 dbFS.
 static const double kResamplingRMSError = -14.58;
 
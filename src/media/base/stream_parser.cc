@@ -4,6 +4,7 @@
 
 #include "media/base/stream_parser.h"
 
+#include "base/numerics/safe_conversions.h"
 #include "media/base/stream_parser_buffer.h"
 
 namespace media {
@@ -25,6 +26,11 @@ bool StreamParser::ProcessChunks(std::unique_ptr<BufferQueue> buffer_queue) {
   return false;
 }
 
+bool StreamParser::ParseSharedChunk(
+    scoped_refptr<base::RefCountedMemory> chunk) {
+  return Parse(chunk->front(), base::checked_cast<int>(chunk->size()));
+}
+
 static bool MergeBufferQueuesInternal(
     const std::vector<const StreamParser::BufferQueue*>& buffer_queues,
     StreamParser::BufferQueue* merged_buffers) {
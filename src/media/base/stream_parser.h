@@ -17,6 +17,7 @@
 #include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/time/time.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/eme_constants.h"
@@ -147,6 +148,11 @@ class MEDIA_EXPORT StreamParser {
   virtual bool Parse(const uint8_t* buf, int size) = 0;
   virtual bool ProcessChunks(std::unique_ptr<BufferQueue> buffer_queue);
 
+  // Like Parse(), but for data the parser may keep a reference to. Parsers can
+  // push |chunk| into their ByteQueue and emit StreamParserBuffers that share
+  // its data instead of copying it. The default implementation calls Parse().
+  virtual bool ParseSharedChunk(scoped_refptr<base::RefCountedMemory> chunk);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(StreamParser);
 };
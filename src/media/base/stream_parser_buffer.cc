@@ -40,6 +40,17 @@ scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
                              is_key_frame, type, track_id));
 }
 
+scoped_refptr<StreamParserBuffer> StreamParserBuffer::FromSharedChunk(
+    scoped_refptr<base::RefCountedMemory> chunk,
+    size_t data_offset,
+    size_t data_size,
+    bool is_key_frame,
+    Type type,
+    TrackId track_id) {
+  return base::WrapRefCounted(new StreamParserBuffer(
+      std::move(chunk), data_offset, data_size, is_key_frame, type, track_id));
+}
+
 DecodeTimestamp StreamParserBuffer::GetDecodeTimestamp() const {
   if (decode_timestamp_ == kNoDecodeTimestamp())
     return DecodeTimestamp::FromPresentationTime(timestamp());
@@ -76,6 +87,24 @@ StreamParserBuffer::StreamParserBuffer(const uint8_t* data,
     set_is_key_frame(true);
 }
 
+StreamParserBuffer::StreamParserBuffer(
+    scoped_refptr<base::RefCountedMemory> chunk,
+    size_t data_offset,
+    size_t data_size,
+    bool is_key_frame,
+    Type type,
+    TrackId track_id)
+    : DecoderBuffer(std::move(chunk), data_offset, data_size),
+      decode_timestamp_(kNoDecodeTimestamp()),
+      config_id_(kInvalidConfigId),
+      type_(type),
+      track_id_(track_id),
+      is_duration_estimated_(false) {
+  set_duration(kNoTimestamp);
+  if (is_key_frame)
+    set_is_key_frame(true);
+}
+
 StreamParserBuffer::~StreamParserBuffer() = default;
 
 int StreamParserBuffer::GetConfigId() const {
@@ -124,6 +124,17 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
                                                     Type type,
                                                     TrackId track_id);
 
+  // Creates a buffer referring to |data_size| bytes of |chunk| at
+  // |data_offset| rather than a copy of them; see
+  // DecoderBuffer::FromSharedChunk().
+  static scoped_refptr<StreamParserBuffer> FromSharedChunk(
+      scoped_refptr<base::RefCountedMemory> chunk,
+      size_t data_offset,
+      size_t data_size,
+      bool is_key_frame,
+      Type type,
+      TrackId track_id);
+
   // Decode timestamp. If not explicitly set, or set to kNoTimestamp, the
   // value will be taken from the normal timestamp.
   DecodeTimestamp GetDecodeTimestamp() const;
@@ -171,6 +182,12 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
                      bool is_key_frame,
                      Type type,
                      TrackId track_id);
+  StreamParserBuffer(scoped_refptr<base::RefCountedMemory> chunk,
+                     size_t data_offset,
+                     size_t data_size,
+                     bool is_key_frame,
+                     Type type,
+                     TrackId track_id);
   ~StreamParserBuffer() override;
 
   DecodeTimestamp decode_timestamp_;
@@ -13,7 +13,14 @@
 
 // NaCl does not allow intrinsics.
 #if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <immintrin.h>
 #include <xmmintrin.h>
+// Including these headers directly should generally be avoided. Since
+// Chrome is compiled with -msse3 (the minimal requirement), we include the
+// headers directly to make the intrinsics available.
+#include <avxintrin.h>
+
+#include "base/cpu.h"
 // Don't use custom SSE versions where the auto-vectorized C version performs
 // better, which is anywhere clang is used.
 // TODO(pcc): Linux currently uses ThinLTO which has broken auto-vectorization
@@ -40,9 +47,26 @@
 namespace media {
 namespace vector_math {
 
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+namespace {
+
+// The AVX2 versions are only chosen when the CPU supports them, which can only
+// be known at runtime.
+bool HasAVX2() {
+  static const bool has_avx2 = base::CPU().has_avx2();
+  return has_avx2;
+}
+
+}  // namespace
+#endif
+
 void FMAC(const float src[], float scale, int len, float dest[]) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
   DCHECK(base::IsAligned(dest, kRequiredAlignment));
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+  if (HasAVX2())
+    return FMAC_AVX2(src, scale, len, dest);
+#endif
   return FMAC_FUNC(src, scale, len, dest);
 }
 
@@ -54,6 +78,10 @@ void FMAC_C(const float src[], float scale, int len, float dest[]) {
 void FMUL(const float src[], float scale, int len, float dest[]) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
   DCHECK(base::IsAligned(dest, kRequiredAlignment));
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+  if (HasAVX2())
+    return FMUL_AVX2(src, scale, len, dest);
+#endif
   return FMUL_FUNC(src, scale, len, dest);
 }
 
@@ -65,6 +93,10 @@ void FMUL_C(const float src[], float scale, int len, float dest[]) {
 std::pair<float, float> EWMAAndMaxPower(
     float initial_value, const float src[], int len, float smoothing_factor) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+  if (HasAVX2())
+    return EWMAAndMaxPower_AVX2(initial_value, src, len, smoothing_factor);
+#endif
   return EWMAAndMaxPower_FUNC(initial_value, src, len, smoothing_factor);
 }
 
@@ -185,6 +217,103 @@ std::pair<float, float> EWMAAndMaxPower_SSE(
 
   return result;
 }
+// The inputs are only guaranteed to be 16 byte aligned, so the AVX2 versions
+// use unaligned loads and stores, which are as fast as aligned ones on CPUs
+// with AVX2 when the data is in fact aligned. Products and sums are not fused
+// so that the results are the same as with the other versions.
+__attribute__((target("avx2"))) void FMUL_AVX2(const float src[],
+                                               float scale,
+                                               int len,
+                                               float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  const __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX2 pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] = src[i] * scale;
+}
+
+__attribute__((target("avx2"))) void FMAC_AVX2(const float src[],
+                                               float scale,
+                                               int len,
+                                               float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  const __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(
+        dest + i,
+        _mm256_add_ps(_mm256_loadu_ps(dest + i),
+                      _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale)));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX2 pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] += src[i] * scale;
+}
+
+__attribute__((target("avx2"))) std::pair<float, float> EWMAAndMaxPower_AVX2(
+    float initial_value,
+    const float src[],
+    int len,
+    float smoothing_factor) {
+  // This is EWMAAndMaxPower_SSE() with 8 lanes: lane 7 computes z[n], where
+  //
+  //   z[n] = a(S[n]^2) + (1-a)^8(z[n-8]) + (1-a)^16(z[n-16]) + ...
+  //
+  // and lanes 6 to 0 compute z[n-1] to z[n-7].
+  const int rem = len % 8;
+  const int last_index = len - rem;
+
+  const __m256 smoothing_factor_x8 = _mm256_set1_ps(smoothing_factor);
+  const float weight_prev = 1.0f - smoothing_factor;
+  const float weight_prev_squared = weight_prev * weight_prev;
+  const float weight_prev_4th = weight_prev_squared * weight_prev_squared;
+  const __m256 weight_prev_8th_x8 =
+      _mm256_set1_ps(weight_prev_4th * weight_prev_4th);
+
+  __m256 max_x8 = _mm256_setzero_ps();
+  __m256 ewma_x8 = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                                  initial_value);
+  int i;
+  for (i = 0; i < last_index; i += 8) {
+    ewma_x8 = _mm256_mul_ps(ewma_x8, weight_prev_8th_x8);
+    const __m256 sample_x8 = _mm256_loadu_ps(src + i);
+    const __m256 sample_squared_x8 = _mm256_mul_ps(sample_x8, sample_x8);
+    max_x8 = _mm256_max_ps(max_x8, sample_squared_x8);
+    ewma_x8 = _mm256_add_ps(
+        ewma_x8, _mm256_mul_ps(sample_squared_x8, smoothing_factor_x8));
+  }
+
+  // y[n] = z[n] + (1-a)^1(z[n-1]) + ... + (1-a)^7(z[n-7])
+  float ewma_lanes[8];
+  float max_lanes[8];
+  _mm256_storeu_ps(ewma_lanes, ewma_x8);
+  _mm256_storeu_ps(max_lanes, max_x8);
+  std::pair<float, float> result(0.0f, 0.0f);
+  float weight = 1.0f;
+  for (int lane = 7; lane >= 0; --lane) {
+    result.first += ewma_lanes[lane] * weight;
+    weight *= weight_prev;
+    result.second = std::max(result.second, max_lanes[lane]);
+  }
+
+  // Handle remaining values at the end of |src|.
+  for (; i < len; ++i) {
+    result.first *= weight_prev;
+    const float sample = src[i];
+    const float sample_squared = sample * sample;
+    result.first += sample_squared * smoothing_factor;
+    result.second = std::max(result.second, sample_squared);
+  }
+
+  return result;
+}
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "base/cpu.h"
 #include "base/macros.h"
 #include "base/memory/aligned_memory.h"
 #include "base/time/time.h"
@@ -119,6 +120,22 @@ TEST_F(VectorMathPerfTest, FMAC_optimized_aligned) {
 }
 #endif
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Benchmark FMAC_AVX2() with unaligned size.
+TEST_F(VectorMathPerfTest, FMAC_avx2_unaligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::FMAC_AVX2, false, "_fmac", "avx2_unaligned");
+}
+
+// Benchmark FMAC_AVX2() with aligned size.
+TEST_F(VectorMathPerfTest, FMAC_avx2_aligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::FMAC_AVX2, true, "_fmac", "avx2_aligned");
+}
+#endif
+
 // Benchmarks for each optimized vector_math::FMUL() method.
 // Benchmark FMUL_C().
 TEST_F(VectorMathPerfTest, FMUL_unoptimized) {
@@ -141,6 +158,22 @@ TEST_F(VectorMathPerfTest, FMUL_optimized_aligned) {
 }
 #endif
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Benchmark FMUL_AVX2() with unaligned size.
+TEST_F(VectorMathPerfTest, FMUL_avx2_unaligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::FMUL_AVX2, false, "_fmul", "avx2_unaligned");
+}
+
+// Benchmark FMUL_AVX2() with aligned size.
+TEST_F(VectorMathPerfTest, FMUL_avx2_aligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::FMUL_AVX2, true, "_fmul", "avx2_aligned");
+}
+#endif
+
 // Benchmarks for each optimized vector_math::EWMAAndMaxPower() method.
 // Benchmark EWMAAndMaxPower_C().
 TEST_F(VectorMathPerfTest, EWMAAndMaxPower_unoptimized) {
@@ -166,4 +199,22 @@ TEST_F(VectorMathPerfTest, EWMAAndMaxPower_optimized_aligned) {
 }
 #endif
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Benchmark EWMAAndMaxPower_AVX2() with unaligned size.
+TEST_F(VectorMathPerfTest, EWMAAndMaxPower_avx2_unaligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::EWMAAndMaxPower_AVX2, kVectorSize - 1,
+               "_ewma_and_max_power", "avx2_unaligned");
+}
+
+// Benchmark EWMAAndMaxPower_AVX2() with aligned size.
+TEST_F(VectorMathPerfTest, EWMAAndMaxPower_avx2_aligned) {
+  if (!base::CPU().has_avx2())
+    return;
+  RunBenchmark(vector_math::EWMAAndMaxPower_AVX2, kVectorSize,
+               "_ewma_and_max_power", "avx2_aligned");
+}
+#endif
+
 } // namespace media
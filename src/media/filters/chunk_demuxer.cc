@@ -910,10 +910,49 @@ bool ChunkDemuxer::AppendData(const std::string& id,
                               TimeDelta append_window_start,
                               TimeDelta append_window_end,
                               TimeDelta* timestamp_offset) {
+  DCHECK(data || length == 0u);
+  DCHECK(timestamp_offset);
+  return AppendDataInternal(
+      id, length,
+      base::BindOnce(
+          [](const uint8_t* data, size_t length, TimeDelta append_window_start,
+             TimeDelta append_window_end, TimeDelta* timestamp_offset,
+             SourceBufferState* source_state) {
+            return source_state->Append(data, length, append_window_start,
+                                        append_window_end, timestamp_offset);
+          },
+          data, length, append_window_start, append_window_end,
+          timestamp_offset));
+}
+
+bool ChunkDemuxer::AppendData(const std::string& id,
+                              scoped_refptr<base::RefCountedMemory> data,
+                              TimeDelta append_window_start,
+                              TimeDelta append_window_end,
+                              TimeDelta* timestamp_offset) {
+  DCHECK(data);
+  DCHECK(timestamp_offset);
+  const size_t length = data->size();
+  return AppendDataInternal(
+      id, length,
+      base::BindOnce(
+          [](scoped_refptr<base::RefCountedMemory> data,
+             TimeDelta append_window_start, TimeDelta append_window_end,
+             TimeDelta* timestamp_offset, SourceBufferState* source_state) {
+            return source_state->Append(std::move(data), append_window_start,
+                                        append_window_end, timestamp_offset);
+          },
+          std::move(data), append_window_start, append_window_end,
+          timestamp_offset));
+}
+
+bool ChunkDemuxer::AppendDataInternal(
+    const std::string& id,
+    size_t length,
+    base::OnceCallback<bool(SourceBufferState*)> append_cb) {
   DVLOG(1) << "AppendData(" << id << ", " << length << ")";
 
   DCHECK(!id.empty());
-  DCHECK(timestamp_offset);
 
   Ranges<TimeDelta> ranges;
 
@@ -928,15 +967,11 @@ bool ChunkDemuxer::AppendData(const std::string& id,
     if (length == 0u)
       return true;
 
-    DCHECK(data);
-
     switch (state_) {
       case INITIALIZING:
       case INITIALIZED:
         DCHECK(IsValidId(id));
-        if (!source_state_map_[id]->Append(data, length, append_window_start,
-                                           append_window_end,
-                                           timestamp_offset)) {
+        if (!std::move(append_cb).Run(source_state_map_[id].get())) {
           ReportError_Locked(CHUNK_DEMUXER_ERROR_APPEND_FAILED);
           return false;
         }
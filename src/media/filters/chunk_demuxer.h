@@ -14,9 +14,11 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/synchronization/lock.h"
 #include "base/thread_annotations.h"
 #include "media/base/byte_queue.h"
@@ -297,6 +299,21 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
                   base::TimeDelta append_window_end,
                   base::TimeDelta* timestamp_offset);
 
+  // Same as above, but for data that the stream parser may keep references to
+  // instead of copying, so that demuxed buffers can share |data|'s memory.
+  // |data| must not be modified afterwards.
+  //
+  // A buffer that shares |data| keeps all of it alive, but SourceBufferStream
+  // only counts the buffer's own data_size() against its memory limit. Parsers
+  // that share slices should copy out small ones, so that a few frames left
+  // after garbage collection don't hold on to whole appends. No parser in
+  // media/ shares slices yet; they all still copy through Parse().
+  bool AppendData(const std::string& id,
+                  scoped_refptr<base::RefCountedMemory> data,
+                  base::TimeDelta append_window_start,
+                  base::TimeDelta append_window_end,
+                  base::TimeDelta* timestamp_offset);
+
   // Appends webcodecs encoded chunks (already converted by caller into a
   // BufferQueue of StreamParserBuffers) to the source buffer associated with
   // |id|, with same semantic for other parameters and return value as
@@ -422,6 +439,14 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
       std::unique_ptr<media::StreamParser> stream_parser,
       std::string expected_codecs);
 
+  // Shared by the AppendData() overloads: runs |append_cb| to append |length|
+  // bytes to the SourceBufferState for |id| and updates the seek and buffered
+  // ranges state afterwards.
+  bool AppendDataInternal(
+      const std::string& id,
+      size_t length,
+      base::OnceCallback<bool(SourceBufferState*)> append_cb);
+
   // Helper for vide and audio track changing.
   void FindAndEnableProperTracks(const std::vector<MediaTrack::Id>& track_ids,
                                  base::TimeDelta curr_time,
@@ -11,10 +11,12 @@
 #include <memory>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/run_loop.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
@@ -1938,6 +1940,41 @@ TEST_F(ChunkDemuxerTest, AppendingInPieces) {
   GenerateExpectedReads(0, 9);
 }
 
+TEST_F(ChunkDemuxerTest, AppendingSharedChunk) {
+  EXPECT_CALL(*this, DemuxerOpened());
+  demuxer_->Initialize(&host_,
+                       CreateInitDoneCallback(kDefaultDuration(), PIPELINE_OK));
+
+  ASSERT_EQ(AddId(), ChunkDemuxer::kOk);
+
+  std::unique_ptr<uint8_t[]> info_tracks;
+  int info_tracks_size = 0;
+  CreateInitSegment(HAS_AUDIO | HAS_VIDEO,
+                    false, false, &info_tracks, &info_tracks_size);
+
+  std::unique_ptr<Cluster> cluster_a(kDefaultFirstCluster());
+  std::unique_ptr<Cluster> cluster_b(kDefaultSecondCluster());
+
+  std::vector<uint8_t> data(info_tracks.get(),
+                            info_tracks.get() + info_tracks_size);
+  data.insert(data.end(), cluster_a->data(),
+              cluster_a->data() + cluster_a->size());
+  data.insert(data.end(), cluster_b->data(),
+              cluster_b->data() + cluster_b->size());
+
+  ExpectInitMediaLogs(HAS_AUDIO | HAS_VIDEO);
+  EXPECT_CALL(*this, InitSegmentReceivedMock(_));
+  EXPECT_CALL(host_, OnBufferedTimeRangesChanged(_)).Times(AnyNumber());
+  EXPECT_FALSE(DidProgress());
+  ASSERT_TRUE(demuxer_->AppendData(
+      kSourceId, base::MakeRefCounted<base::RefCountedBytes>(data),
+      append_window_start_for_next_append_, append_window_end_for_next_append_,
+      &timestamp_offset_map_[kSourceId]));
+  EXPECT_TRUE(DidProgress());
+
+  GenerateExpectedReads(0, 9);
+}
+
 TEST_F(ChunkDemuxerTest, WebMFile_AudioAndVideo) {
   struct BufferTimestamps buffer_timestamps[] = {
     {0, 0},
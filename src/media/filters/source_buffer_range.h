@@ -6,10 +6,13 @@
 #define MEDIA_FILTERS_SOURCE_BUFFER_RANGE_H_
 
 #include <stddef.h>
-#include <map>
+#include <functional>
 #include <memory>
+#include <utility>
 
 #include "base/callback.h"
+#include "base/containers/circular_deque.h"
+#include "base/containers/flat_map.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "media/base/media_export.h"
@@ -250,7 +253,14 @@ class MEDIA_EXPORT SourceBufferRange {
   // Friend of private is only for IsNextInPresentationSequence testing.
   friend class SourceBufferStreamTest;
 
-  using KeyframeMap = std::map<base::TimeDelta, int>;
+  // Keyframes are appended at the end of the range and removed from either
+  // end, so a sorted deque gives binary-searchable lookups and O(1) amortized
+  // updates without a node allocation per keyframe.
+  using KeyframeMap =
+      base::flat_map<base::TimeDelta,
+                     int,
+                     std::less<>,
+                     base::circular_deque<std::pair<base::TimeDelta, int>>>;
 
   // Called during AppendBuffersToEnd to adjust estimated duration at the
   // end of the last append to match the delta in timestamps between
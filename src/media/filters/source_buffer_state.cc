@@ -208,6 +208,28 @@ bool SourceBufferState::Append(const uint8_t* data,
                                TimeDelta append_window_start,
                                TimeDelta append_window_end,
                                TimeDelta* timestamp_offset) {
+  return AppendInternal(
+      length, append_window_start, append_window_end, timestamp_offset,
+      base::BindOnce(&StreamParser::Parse,
+                     base::Unretained(stream_parser_.get()), data, length));
+}
+
+bool SourceBufferState::Append(scoped_refptr<base::RefCountedMemory> data,
+                               TimeDelta append_window_start,
+                               TimeDelta append_window_end,
+                               TimeDelta* timestamp_offset) {
+  const size_t length = data->size();
+  return AppendInternal(
+      length, append_window_start, append_window_end, timestamp_offset,
+      base::BindOnce(&StreamParser::ParseSharedChunk,
+                     base::Unretained(stream_parser_.get()), std::move(data)));
+}
+
+bool SourceBufferState::AppendInternal(size_t length,
+                                       TimeDelta append_window_start,
+                                       TimeDelta append_window_end,
+                                       TimeDelta* timestamp_offset,
+                                       base::OnceCallback<bool()> parse_cb) {
   append_in_progress_ = true;
   DCHECK(timestamp_offset);
   DCHECK(!timestamp_offset_during_append_);
@@ -217,10 +239,10 @@ bool SourceBufferState::Append(const uint8_t* data,
 
   // TODO(wolenetz): Curry and pass a NewBuffersCB here bound with append window
   // and timestamp offset pointer. See http://crbug.com/351454.
-  bool result = stream_parser_->Parse(data, length);
+  bool result = std::move(parse_cb).Run();
   if (!result) {
     MEDIA_LOG(ERROR, media_log_)
-        << __func__ << ": stream parsing failed. Data size=" << length
+        << "Append: stream parsing failed. Data size=" << length
         << " append_window_start=" << append_window_start.InSecondsF()
         << " append_window_end=" << append_window_end.InSecondsF();
   }
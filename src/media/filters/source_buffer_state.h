@@ -10,6 +10,7 @@
 #include "base/bind.h"
 #include "base/macros.h"
 #include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted_memory.h"
 #include "media/base/audio_codecs.h"
 #include "media/base/demuxer.h"
 #include "media/base/demuxer_stream.h"
@@ -68,6 +69,13 @@ class MEDIA_EXPORT SourceBufferState {
               TimeDelta append_window_start,
               TimeDelta append_window_end,
               TimeDelta* timestamp_offset);
+  // As above, but lets the StreamParser keep references to |data|'s contents
+  // rather than copy them; see StreamParser::ParseSharedChunk() and the
+  // memory caveat on ChunkDemuxer::AppendData().
+  bool Append(scoped_refptr<base::RefCountedMemory> data,
+              TimeDelta append_window_start,
+              TimeDelta append_window_end,
+              TimeDelta* timestamp_offset);
   bool AppendChunks(std::unique_ptr<StreamParser::BufferQueue> buffer_queue,
                     TimeDelta append_window_start,
                     TimeDelta append_window_end,
@@ -175,6 +183,15 @@ class MEDIA_EXPORT SourceBufferState {
     PENDING_PARSER_REINIT
   };
 
+  // Shared by the Append() overloads: sets up the append state, runs
+  // |parse_cb| to hand the |length| appended bytes to |stream_parser_|, and
+  // returns its result.
+  bool AppendInternal(size_t length,
+                      TimeDelta append_window_start,
+                      TimeDelta append_window_end,
+                      TimeDelta* timestamp_offset,
+                      base::OnceCallback<bool()> parse_cb);
+
   // Initializes |stream_parser_|. Also, updates |expected_audio_codecs| and
   // |expected_video_codecs|.
   void InitializeParser(const std::string& expected_codecs);
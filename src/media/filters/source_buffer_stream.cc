@@ -570,6 +570,7 @@ void SourceBufferStream::RemoveInternal(base::TimeDelta start,
     std::unique_ptr<SourceBufferRange> new_range = range->SplitRange(end);
     if (new_range) {
       itr = ranges_.insert(++itr, std::move(new_range));
+      range_index_is_stale_ = true;
 
       // Update |range_for_next_append_| if it was previously |range| and should
       // be the new range (that |itr| is at) now.
@@ -773,12 +774,21 @@ void SourceBufferStream::OnMemoryPressure(
 
   memory_pressure_level_ = memory_pressure_level;
 
+  // Nothing schedules another pass if this one stops early, so it isn't time
+  // budgeted.
   if (force_instant_gc)
-    GarbageCollectIfNeeded(media_time, 0);
+    GarbageCollectIfNeededInternal(media_time, 0, false);
 }
 
 bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
                                                 size_t newDataSize) {
+  return GarbageCollectIfNeededInternal(media_time, newDataSize, true);
+}
+
+bool SourceBufferStream::GarbageCollectIfNeededInternal(
+    base::TimeDelta media_time,
+    size_t newDataSize,
+    bool allow_time_budget) {
   DCHECK(media_time != kNoTimestamp);
   // Garbage collection should only happen before/during appending new data,
   // which should not happen in end-of-stream state. Unless we also allow GC to
@@ -825,6 +835,14 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
 
   size_t bytes_to_free = ranges_size + newDataSize - effective_memory_limit;
 
+  // Anything beyond the hard memory limit is only freed to relieve memory
+  // pressure, so that part may be spread over several calls.
+  DCHECK(gc_deadline_.is_null());
+  if (allow_time_budget && bytes_to_free > bytes_over_hard_memory_limit &&
+      base::FeatureList::IsEnabled(kIncrementalSourceBufferGC)) {
+    gc_deadline_ = base::TimeTicks::Now() + gc_time_budget_;
+  }
+
   DVLOG(2) << __func__ << " " << GetStreamTypeName()
            << ": Before GC media_time=" << media_time.InMicroseconds()
            << "us ranges_=" << RangesToString(ranges_)
@@ -863,6 +881,11 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
   }
 
   size_t bytes_freed = 0;
+  auto required_bytes_to_free = [&bytes_freed, bytes_over_hard_memory_limit]() {
+    return bytes_over_hard_memory_limit > bytes_freed
+               ? bytes_over_hard_memory_limit - bytes_freed
+               : 0;
+  };
 
   // If last appended buffer position was earlier than the current playback time
   // then try deleting data between last append and current media_time.
@@ -899,7 +922,8 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
   if (bytes_freed < bytes_to_free && seek_pending_) {
     DCHECK(!ranges_.empty());
     // All data earlier than the seek target |media_time| can be removed safely
-    size_t front = FreeBuffers(bytes_to_free - bytes_freed, media_time, false);
+    size_t front = FreeBuffers(bytes_to_free - bytes_freed,
+                               required_bytes_to_free(), media_time, false);
     DVLOG(3) << __func__ << " Removed " << front
              << " bytes from the front. ranges_=" << RangesToString(ranges_);
     bytes_freed += front;
@@ -907,7 +931,8 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
     // If removing data earlier than |media_time| didn't free up enough space,
     // then try deleting from the back until we reach most recently appended GOP
     if (bytes_freed < bytes_to_free) {
-      size_t back = FreeBuffers(bytes_to_free - bytes_freed, media_time, true);
+      size_t back = FreeBuffers(bytes_to_free - bytes_freed,
+                                required_bytes_to_free(), media_time, true);
       DVLOG(3) << __func__ << " Removed " << back
                << " bytes from the back. ranges_=" << RangesToString(ranges_);
       bytes_freed += back;
@@ -916,19 +941,23 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
     // If even that wasn't enough, then try greedily deleting from the front,
     // that should allow us to remove as much data as necessary to succeed.
     if (bytes_freed < bytes_to_free) {
-      size_t front2 = FreeBuffers(bytes_to_free - bytes_freed,
-                                  ranges_.back()->GetEndTimestamp(), false);
+      size_t front2 = FreeBuffers(
+          bytes_to_free - bytes_freed, required_bytes_to_free(),
+          ranges_.back()->GetEndTimestamp(), false);
       DVLOG(3) << __func__ << " Removed " << front2
                << " bytes from the front. ranges_=" << RangesToString(ranges_);
       bytes_freed += front2;
     }
-    DCHECK(bytes_freed >= bytes_to_free);
+    DCHECK(bytes_freed >= (gc_deadline_.is_null()
+                               ? bytes_to_free
+                               : bytes_over_hard_memory_limit));
   }
 
   // Try removing data from the front of the SourceBuffer up to |media_time|
   // position.
   if (bytes_freed < bytes_to_free) {
-    size_t front = FreeBuffers(bytes_to_free - bytes_freed, media_time, false);
+    size_t front = FreeBuffers(bytes_to_free - bytes_freed,
+                               required_bytes_to_free(), media_time, false);
     DVLOG(3) << __func__ << " Removed " << front
              << " bytes from the front. ranges_=" << RangesToString(ranges_);
     bytes_freed += front;
@@ -937,7 +966,8 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
   // Try removing data from the back of the SourceBuffer, until we reach the
   // most recent append position.
   if (bytes_freed < bytes_to_free) {
-    size_t back = FreeBuffers(bytes_to_free - bytes_freed, media_time, true);
+    size_t back = FreeBuffers(bytes_to_free - bytes_freed,
+                              required_bytes_to_free(), media_time, true);
     DVLOG(3) << __func__ << " Removed " << back
              << " bytes from the back. ranges_=" << RangesToString(ranges_);
     bytes_freed += back;
@@ -949,6 +979,7 @@ bool SourceBufferStream::GarbageCollectIfNeeded(base::TimeDelta media_time,
            << " bytes_over_hard_memory_limit=" << bytes_over_hard_memory_limit
            << " ranges_=" << RangesToString(ranges_);
 
+  gc_deadline_ = base::TimeTicks();
   return bytes_freed >= bytes_over_hard_memory_limit;
 }
 
@@ -1015,6 +1046,7 @@ size_t SourceBufferStream::GetRemovalRange(
 }
 
 size_t SourceBufferStream::FreeBuffers(size_t total_bytes_to_free,
+                                       size_t min_bytes_to_free,
                                        base::TimeDelta media_time,
                                        bool reverse_direction) {
   TRACE_EVENT2("media", "SourceBufferStream::FreeBuffers",
@@ -1029,6 +1061,12 @@ size_t SourceBufferStream::FreeBuffers(size_t total_bytes_to_free,
   std::unique_ptr<SourceBufferRange> new_range_for_append;
 
   while (!ranges_.empty() && bytes_freed < total_bytes_to_free) {
+    if (bytes_freed >= min_bytes_to_free && !gc_deadline_.is_null() &&
+        base::TimeTicks::Now() >= gc_deadline_) {
+      DVLOG(4) << "GC time budget exhausted, deferring the rest";
+      break;
+    }
+
     SourceBufferRange* current_range = NULL;
     BufferQueue buffers;
     size_t bytes_deleted = 0;
@@ -1091,6 +1129,7 @@ size_t SourceBufferStream::FreeBuffers(size_t total_bytes_to_free,
 
       // Delete |current_range| by popping it out of |ranges_|.
       reverse_direction ? ranges_.pop_back() : ranges_.pop_front();
+      range_index_is_stale_ = true;
     }
 
     if (reverse_direction && new_range_for_append) {
@@ -1316,6 +1355,7 @@ void SourceBufferStream::PrepareRangesForNextAppend(
 
     range_for_next_append_ =
         ranges_.insert(++range_for_next_append_, std::move(new_range));
+    range_index_is_stale_ = true;
 
     // Update the selected range if the next buffer position was transferred
     // to the newly inserted range.
@@ -1481,14 +1521,16 @@ void SourceBufferStream::Seek(base::TimeDelta timestamp) {
     return;
   }
 
-  auto itr = ranges_.end();
-  for (itr = ranges_.begin(); itr != ranges_.end(); ++itr) {
-    if ((*itr)->CanSeekTo(timestamp))
-      break;
-  }
-
-  if (itr == ranges_.end())
+  // Ranges ending at or before |timestamp| can't be seeked to. The first one
+  // ending after it is the only candidate, as all later ones start later.
+  const auto& index = GetRangeIndex();
+  auto index_itr = std::partition_point(
+      index.begin(), index.end(), [timestamp](RangeList::iterator range) {
+        return (*range)->GetBufferedEndTimestamp() <= timestamp;
+      });
+  if (index_itr == index.end() || !(**index_itr)->CanSeekTo(timestamp))
     return;
+  auto itr = *index_itr;
 
   if (!audio_configs_.empty()) {
     // Adjust |timestamp| for an Opus stream backward up to the config's seek
@@ -1672,24 +1714,48 @@ base::TimeDelta SourceBufferStream::GetNextBufferTimestamp() {
 
 SourceBufferStream::RangeList::iterator
 SourceBufferStream::FindExistingRangeFor(base::TimeDelta start_timestamp) {
-  for (auto itr = ranges_.begin(); itr != ranges_.end(); ++itr) {
-    if ((*itr)->BelongsToRange(start_timestamp))
-      return itr;
-  }
-  return ranges_.end();
+  // Only ranges starting at or before |start_timestamp| can contain it. Among
+  // those, the ones it belongs to form a suffix, since their highest
+  // timestamps (and so their fudge room windows) increase along |ranges_|.
+  const auto& index = GetRangeIndex();
+  auto candidates_end = std::partition_point(
+      index.begin(), index.end(), [start_timestamp](RangeList::iterator range) {
+        return (*range)->GetStartTimestamp() <= start_timestamp;
+      });
+  auto itr = std::partition_point(
+      index.begin(), candidates_end,
+      [start_timestamp](RangeList::iterator range) {
+        return !(*range)->BelongsToRange(start_timestamp);
+      });
+  return itr == candidates_end ? ranges_.end() : *itr;
 }
 
 SourceBufferStream::RangeList::iterator SourceBufferStream::AddToRanges(
     std::unique_ptr<SourceBufferRange> new_range) {
   base::TimeDelta start_timestamp = new_range->GetStartTimestamp();
-  auto itr = ranges_.end();
-  for (itr = ranges_.begin(); itr != ranges_.end(); ++itr) {
-    if ((*itr)->GetStartTimestamp() > start_timestamp)
-      break;
-  }
+  const auto& index = GetRangeIndex();
+  auto index_itr = std::partition_point(
+      index.begin(), index.end(), [start_timestamp](RangeList::iterator range) {
+        return (*range)->GetStartTimestamp() <= start_timestamp;
+      });
+  auto itr = index_itr == index.end() ? ranges_.end() : *index_itr;
+  range_index_is_stale_ = true;
   return ranges_.insert(itr, std::move(new_range));
 }
 
+const std::vector<SourceBufferStream::RangeList::iterator>&
+SourceBufferStream::GetRangeIndex() {
+  if (range_index_is_stale_) {
+    range_index_.clear();
+    range_index_.reserve(ranges_.size());
+    for (auto itr = ranges_.begin(); itr != ranges_.end(); ++itr)
+      range_index_.push_back(itr);
+    range_index_is_stale_ = false;
+  }
+  DCHECK_EQ(range_index_.size(), ranges_.size());
+  return range_index_;
+}
+
 void SourceBufferStream::SeekAndSetSelectedRange(
     SourceBufferRange* range,
     base::TimeDelta seek_timestamp) {
@@ -1922,7 +1988,13 @@ base::TimeDelta SourceBufferStream::FindNewSelectedRangeSeekTimestamp(
   DCHECK(start_timestamp != kNoTimestamp);
   DCHECK(start_timestamp >= base::TimeDelta());
 
-  auto itr = ranges_.begin();
+  // Skip the ranges that end before |start_timestamp|.
+  const auto& index = GetRangeIndex();
+  auto index_itr = std::partition_point(
+      index.begin(), index.end(), [start_timestamp](RangeList::iterator range) {
+        return (*range)->GetEndTimestamp() < start_timestamp;
+      });
+  auto itr = index_itr == index.end() ? ranges_.end() : *index_itr;
 
   // When checking a range to see if it has or begins soon enough after
   // |start_timestamp|, use the fudge room to determine "soon enough".
@@ -2007,6 +2079,7 @@ void SourceBufferStream::DeleteAndRemoveRange(RangeList::iterator* itr) {
   }
 
   *itr = ranges_.erase(*itr);
+  range_index_is_stale_ = true;
 }
 
 bool SourceBufferStream::SetPendingBuffer(
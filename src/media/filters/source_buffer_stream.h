@@ -24,6 +24,7 @@
 #include "base/macros.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "media/base/audio_decoder_config.h"
 #include "media/base/media_export.h"
 #include "media/base/media_log.h"
@@ -178,12 +179,21 @@ class MEDIA_EXPORT SourceBufferStream {
  private:
   friend class SourceBufferStreamTest;
 
+  // Implements GarbageCollectIfNeeded(). If |allow_time_budget| is false, all
+  // of the data beyond the effective memory limit is freed even when
+  // kIncrementalSourceBufferGC is enabled.
+  bool GarbageCollectIfNeededInternal(base::TimeDelta media_time,
+                                      size_t newDataSize,
+                                      bool allow_time_budget);
+
   // Attempts to delete approximately |total_bytes_to_free| amount of data
   // |ranges_|, starting at the front of |ranges_| and moving linearly forward
   // through the buffers. Deletes starting from the back if |reverse_direction|
-  // is true. |media_time| is current playback position.
+  // is true. |media_time| is current playback position. Once at least
+  // |min_bytes_to_free| have been freed, also stops if |gc_deadline_| passed.
   // Returns the number of bytes freed.
   size_t FreeBuffers(size_t total_bytes_to_free,
+                     size_t min_bytes_to_free,
                      base::TimeDelta media_time,
                      bool reverse_direction);
 
@@ -249,6 +259,10 @@ class MEDIA_EXPORT SourceBufferStream {
   // by |ranges_|.
   RangeList::iterator AddToRanges(std::unique_ptr<SourceBufferRange> new_range);
 
+  // Returns |range_index_|, rebuilding it first if ranges were inserted into or
+  // removed from |ranges_| since it was last built.
+  const std::vector<RangeList::iterator>& GetRangeIndex();
+
   // Sets the |selected_range_| to |range| and resets the next buffer position
   // for the previous |selected_range_|.
   void SetSelectedRange(SourceBufferRange* range);
@@ -393,6 +407,23 @@ class MEDIA_EXPORT SourceBufferStream {
   // List of disjoint buffered ranges, ordered by start time.
   RangeList ranges_;
 
+  // Random-access view of |ranges_| used to binary search it. Since the ranges
+  // are disjoint and sorted, their start and end timestamps both increase
+  // along the list, so this serves as an interval index. Appends and GC within
+  // a range don't invalidate it; only inserting or removing ranges does, which
+  // sets |range_index_is_stale_|.
+  std::vector<RangeList::iterator> range_index_;
+  bool range_index_is_stale_ = true;
+
+  // Time a GarbageCollectIfNeeded() call may spend freeing data beyond what is
+  // needed to get under |memory_limit_|, when kIncrementalSourceBufferGC is
+  // enabled.
+  base::TimeDelta gc_time_budget_ = base::TimeDelta::FromMilliseconds(4);
+
+  // Deadline of the GarbageCollectIfNeeded() call in progress, if it is time
+  // budgeted. Null otherwise.
+  base::TimeTicks gc_deadline_;
+
   // Indicates which decoder config is being used by the decoder.
   // GetNextBuffer() is only allows to return buffers that have a
   // config ID that matches this index. If there is a mismatch then
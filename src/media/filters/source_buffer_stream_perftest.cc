@@ -0,0 +1,163 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "media/base/media_switches.h"
+#include "media/base/media_util.h"
+#include "media/base/stream_parser_buffer.h"
+#include "media/base/test_helpers.h"
+#include "media/filters/source_buffer_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+// A synthetic 30fps video stream with 2 second GOPs, buffered as 30 second
+// ranges separated by one missing GOP, as left behind by seeking around while
+// buffering.
+static const int kFramesPerSecond = 30;
+static const int kFramesPerGop = 2 * kFramesPerSecond;
+static const int kGopsPerRange = 15;
+static const int kStreamHours = 3;
+static const int kStreamGops = kStreamHours * 3600 / 2;
+static const int kFrameSize = 16;
+static const int kSeekCount = 100000;
+static const uint8_t kFrameData[kFrameSize] = {};
+
+static base::TimeDelta FrameTimestamp(int frame) {
+  return base::TimeDelta::FromMicroseconds(
+      frame * base::Time::kMicrosecondsPerSecond / kFramesPerSecond);
+}
+
+// Appends the whole stream to |stream|, one GOP at a time; returns the time it
+// took.
+static base::TimeDelta AppendStream(SourceBufferStream* stream) {
+  stream->set_memory_limit(kStreamGops * kFramesPerGop * kFrameSize);
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int gop = 0; gop < kStreamGops; ++gop) {
+    if (gop % (kGopsPerRange + 1) == kGopsPerRange)
+      continue;
+
+    const int first_frame = gop * kFramesPerGop;
+    if (gop % (kGopsPerRange + 1) == 0)
+      stream->OnStartOfCodedFrameGroup(FrameTimestamp(first_frame));
+
+    StreamParserBuffer::BufferQueue buffers;
+    for (int frame = first_frame; frame < first_frame + kFramesPerGop;
+         ++frame) {
+      scoped_refptr<StreamParserBuffer> buffer = StreamParserBuffer::CopyFrom(
+          kFrameData, kFrameSize, frame == first_frame, DemuxerStream::VIDEO,
+          0);
+      buffer->set_timestamp(FrameTimestamp(frame));
+      buffer->SetDecodeTimestamp(
+          DecodeTimestamp::FromPresentationTime(FrameTimestamp(frame)));
+      buffer->set_duration(FrameTimestamp(frame + 1) - FrameTimestamp(frame));
+      buffers.push_back(std::move(buffer));
+    }
+    stream->Append(buffers);
+  }
+  return base::TimeTicks::Now() - start;
+}
+
+TEST(SourceBufferStreamPerfTest, AppendAndSeek) {
+  NullMediaLog media_log;
+  SourceBufferStream stream(TestVideoConfig::Normal(), &media_log);
+  const base::TimeDelta append_time = AppendStream(&stream);
+  const base::TimeDelta duration = FrameTimestamp(kStreamGops * kFramesPerGop);
+
+  // Seek to pseudo-random positions across the whole stream, reading the
+  // first buffer after each successful seek.
+  uint32_t seed = 1;
+  int satisfied_seeks = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kSeekCount; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    stream.Seek(duration * (seed / 4294967296.0));
+    scoped_refptr<StreamParserBuffer> buffer;
+    if (stream.GetNextBuffer(&buffer) == SourceBufferStreamStatus::kSuccess)
+      ++satisfied_seeks;
+  }
+  const base::TimeDelta seek_time = base::TimeTicks::Now() - start;
+
+  perf_test::PerfResultReporter reporter("source_buffer_stream",
+                                         "hours_long_stream");
+  reporter.RegisterImportantMetric("_ranges", "count");
+  reporter.RegisterImportantMetric("_append", "gops/s");
+  reporter.RegisterImportantMetric("_seek", "seeks/s");
+  reporter.RegisterImportantMetric("_satisfied_seeks", "count");
+  reporter.AddResult("_ranges", stream.GetBufferedTime().size());
+  reporter.AddResult("_append", kStreamGops / append_time.InSecondsF());
+  reporter.AddResult("_seek", kSeekCount / seek_time.InSecondsF());
+  reporter.AddResult("_satisfied_seeks", static_cast<size_t>(satisfied_seeks));
+}
+
+// Measures how long individual GarbageCollectIfNeeded() calls take when
+// critical memory pressure asks to evict everything before the playback
+// position, which is placed in the middle of the stream.
+static void RunGarbageCollectBenchmark(bool incremental,
+                                       const std::string& story) {
+  base::test::ScopedFeatureList feature_list;
+  if (incremental) {
+    feature_list.InitWithFeatures(
+        {kMemoryPressureBasedSourceBufferGC, kIncrementalSourceBufferGC}, {});
+  } else {
+    feature_list.InitWithFeatures({kMemoryPressureBasedSourceBufferGC},
+                                  {kIncrementalSourceBufferGC});
+  }
+
+  NullMediaLog media_log;
+  SourceBufferStream stream(TestVideoConfig::Normal(), &media_log);
+  AppendStream(&stream);
+
+  const base::TimeDelta media_time =
+      FrameTimestamp(kStreamGops / 2 * kFramesPerGop + 1);
+  stream.Seek(media_time);
+  stream.OnMemoryPressure(
+      media_time, base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+      false);
+
+  int calls = 0;
+  base::TimeDelta total_time;
+  base::TimeDelta max_time;
+  size_t buffered_size = stream.GetBufferedSize();
+  for (;;) {
+    const base::TimeTicks start = base::TimeTicks::Now();
+    stream.GarbageCollectIfNeeded(media_time, 0);
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    ++calls;
+    total_time += elapsed;
+    max_time = std::max(max_time, elapsed);
+
+    const size_t new_buffered_size = stream.GetBufferedSize();
+    if (new_buffered_size == buffered_size)
+      break;
+    buffered_size = new_buffered_size;
+  }
+
+  perf_test::PerfResultReporter reporter("source_buffer_stream", story);
+  reporter.RegisterImportantMetric("_gc_calls", "count");
+  reporter.RegisterImportantMetric("_gc_total", "ms");
+  reporter.RegisterImportantMetric("_gc_max_call", "ms");
+  reporter.AddResult("_gc_calls", static_cast<size_t>(calls));
+  reporter.AddResult("_gc_total", total_time);
+  reporter.AddResult("_gc_max_call", max_time);
+}
+
+TEST(SourceBufferStreamPerfTest, GarbageCollect) {
+  RunGarbageCollectBenchmark(false, "gc");
+}
+
+TEST(SourceBufferStreamPerfTest, GarbageCollectIncremental) {
+  RunGarbageCollectBenchmark(true, "gc_incremental");
+}
+
+}  // namespace media
@@ -171,6 +171,10 @@ class SourceBufferStreamTest : public testing::Test {
     return stream_->GarbageCollectIfNeeded(media_time, new_data_size);
   }
 
+  void SetGarbageCollectTimeBudget(base::TimeDelta budget) {
+    stream_->gc_time_budget_ = budget;
+  }
+
   bool GarbageCollectWithPlaybackAtBuffer(int position, int new_data_buffers) {
     return GarbageCollect(position * frame_duration_,
                           new_data_buffers * kDataSize);
@@ -2092,6 +2096,22 @@ TEST_F(SourceBufferStreamTest, Seek_InBetweenTimestamps) {
   CheckExpectedBuffers(0, 0, true);
 }
 
+TEST_F(SourceBufferStreamTest, Seek_ManyRanges) {
+  // Append 20 ranges of 5 buffers each, with a 5 buffer gap between them.
+  for (int i = 0; i < 20; ++i)
+    NewCodedFrameGroupAppend(i * 10, 5);
+
+  // Seek into each range, from the last one to the first.
+  for (int i = 19; i >= 0; --i) {
+    Seek(i * 10 + 3);
+    CheckExpectedBuffers(i * 10, i * 10 + 4, true);
+  }
+
+  // Seeking into a gap can't be satisfied.
+  Seek(57);
+  CheckNoNextBuffer();
+}
+
 // This test will do a complete overlap of an existing range in order to add
 // buffers to the track buffers. Then the test does a seek to another part of
 // the stream. The SourceBufferStream should clear its internal track buffer in
@@ -5170,6 +5190,53 @@ TEST_F(SourceBufferStreamTest, InstantGarbageCollectionUnderMemoryPressure) {
   CheckExpectedRangesByTimestamp("{ [9,16) }");
 }
 
+TEST_F(SourceBufferStreamTest, IncrementalGCUnderMemoryPressure) {
+  SetMemoryLimit(16);
+  NewCodedFrameGroupAppend("0K 1 2 3K 4 5 6K 7 8 9K 10 11 12K 13 14 15K");
+  CheckExpectedRangesByTimestamp("{ [0,16) }");
+
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitWithFeatures(
+      {kMemoryPressureBasedSourceBufferGC, kIncrementalSourceBufferGC}, {});
+  stream_->OnMemoryPressure(
+      base::TimeDelta::FromMilliseconds(0),
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL, false);
+
+  // With no time budget, nothing beyond the hard memory limit is collected.
+  SetGarbageCollectTimeBudget(base::TimeDelta());
+  EXPECT_TRUE(GarbageCollect(base::TimeDelta::FromMilliseconds(13), 0));
+  CheckExpectedRangesByTimestamp("{ [0,16) }");
+
+  // But enough is still collected to make room for an append up to the hard
+  // limit.
+  EXPECT_TRUE(
+      GarbageCollect(base::TimeDelta::FromMilliseconds(13), 4 * kDataSize));
+  CheckExpectedRangesByTimestamp("{ [6,16) }");
+
+  // A later pass with a budget picks up where the previous one stopped.
+  SetGarbageCollectTimeBudget(base::TimeDelta::FromSeconds(1));
+  EXPECT_TRUE(GarbageCollect(base::TimeDelta::FromMilliseconds(13), 0));
+  CheckExpectedRangesByTimestamp("{ [12,16) }");
+}
+
+TEST_F(SourceBufferStreamTest, InstantGCUnderMemoryPressureIsNotBudgeted) {
+  SetMemoryLimit(16);
+  NewCodedFrameGroupAppend("0K 1 2 3K 4 5 6K 7 8 9K 10 11 12K 13 14 15K");
+  CheckExpectedRangesByTimestamp("{ [0,16) }");
+
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitWithFeatures(
+      {kMemoryPressureBasedSourceBufferGC, kIncrementalSourceBufferGC}, {});
+
+  // No append follows to finish the job, so a forced GC frees everything it
+  // can even without any time budget.
+  SetGarbageCollectTimeBudget(base::TimeDelta());
+  stream_->OnMemoryPressure(
+      base::TimeDelta::FromMilliseconds(13),
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL, true);
+  CheckExpectedRangesByTimestamp("{ [12,16) }");
+}
+
 TEST_F(SourceBufferStreamTest, GCFromFrontThenExplicitRemoveFromMiddleToEnd) {
   // Attempts to exercise SourceBufferRange::GetBufferIndexAt() after its
   // |keyframe_map_index_base_| has been increased, and when there is a GOP
@@ -5,8 +5,11 @@
 #include "ui/gfx/blit.h"
 
 #include <stddef.h>
+#include <string.h>
 
-#include "base/check.h"
+#include <algorithm>
+
+#include "base/check_op.h"
 #include "build/build_config.h"
 #include "skia/ext/platform_canvas.h"
 #include "third_party/skia/include/core/SkPixmap.h"
@@ -14,10 +17,130 @@
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/vector2d.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#define BLIT_USE_SSE2 1
+#include <emmintrin.h>
+#elif (defined(ARCH_CPU_ARM64) || defined(CPU_ARM_NEON)) && !defined(OS_NACL)
+#define BLIT_USE_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace gfx {
 
 namespace {
 
+// The kernels address the alpha as the high byte of a pixel.
+static_assert(SK_A32_SHIFT == 24, "The alpha must be in the high byte");
+
+// Returns |a| * |b| / 255, rounded to the nearest integer.
+inline uint32_t MulDiv255(uint32_t a, uint32_t b) {
+  uint32_t product = a * b + 128;
+  return (product + (product >> 8)) >> 8;
+}
+
+#if defined(BLIT_USE_SSE2)
+// Same as above for eight 16-bit lanes holding 8-bit values.
+inline __m128i MulDiv255(__m128i a, __m128i b) {
+  __m128i product =
+      _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+                        8);
+}
+
+// Returns the alpha of each of the two pixels unpacked into |pixels|,
+// broadcast to the lanes of its channels.
+inline __m128i BroadcastAlpha(__m128i pixels) {
+  return _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+}
+#elif defined(BLIT_USE_NEON)
+inline uint8x8_t MulDiv255(uint8x8_t a, uint8x8_t b) {
+  uint16x8_t product = vmull_u8(a, b);
+  return vraddhn_u16(product, vrshrq_n_u16(product, 8));
+}
+#endif
+
+void FillRow(uint32_t* dst, int width, uint32_t pixel) {
+  int x = 0;
+#if defined(BLIT_USE_SSE2)
+  const __m128i pixels = _mm_set1_epi32(pixel);
+  for (; x + 4 <= width; x += 4)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), pixels);
+#elif defined(BLIT_USE_NEON)
+  const uint32x4_t pixels = vdupq_n_u32(pixel);
+  for (; x + 4 <= width; x += 4)
+    vst1q_u32(dst + x, pixels);
+#endif
+  for (; x < width; ++x)
+    dst[x] = pixel;
+}
+
+inline uint32_t BlendPixel(uint32_t src, uint8_t alpha, uint32_t dst) {
+  uint32_t inverse_alpha = 255 - MulDiv255(src >> 24, alpha);
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t channel = MulDiv255((src >> shift) & 0xff, alpha) +
+                       MulDiv255((dst >> shift) & 0xff, inverse_alpha);
+    result |= std::min(channel, 255u) << shift;
+  }
+  return result;
+}
+
+void BlendRow(const uint32_t* src, uint8_t alpha, uint32_t* dst, int width) {
+  int x = 0;
+#if defined(BLIT_USE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alphas = _mm_set1_epi16(alpha);
+  const __m128i max = _mm_set1_epi16(255);
+  for (; x + 4 <= width; x += 4) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+    __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+    __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+    if (alpha != 255) {
+      s_lo = MulDiv255(s_lo, alphas);
+      s_hi = MulDiv255(s_hi, alphas);
+    }
+    __m128i d_lo = MulDiv255(_mm_unpacklo_epi8(d, zero),
+                             _mm_sub_epi16(max, BroadcastAlpha(s_lo)));
+    __m128i d_hi = MulDiv255(_mm_unpackhi_epi8(d, zero),
+                             _mm_sub_epi16(max, BroadcastAlpha(s_hi)));
+    // Saturates the sums of channels that exceed their alpha.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                     _mm_packus_epi16(_mm_add_epi16(s_lo, d_lo),
+                                      _mm_add_epi16(s_hi, d_hi)));
+  }
+#elif defined(BLIT_USE_NEON)
+  const uint8x8_t alphas = vdup_n_u8(alpha);
+  for (; x + 8 <= width; x += 8) {
+    uint8x8x4_t s = vld4_u8(reinterpret_cast<const uint8_t*>(src + x));
+    uint8x8x4_t d = vld4_u8(reinterpret_cast<const uint8_t*>(dst + x));
+    if (alpha != 255) {
+      for (int c = 0; c < 4; ++c)
+        s.val[c] = MulDiv255(s.val[c], alphas);
+    }
+    uint8x8_t inverse_alpha = vmvn_u8(s.val[3]);
+    for (int c = 0; c < 4; ++c)
+      d.val[c] = vqadd_u8(s.val[c], MulDiv255(d.val[c], inverse_alpha));
+    vst4_u8(reinterpret_cast<uint8_t*>(dst + x), d);
+  }
+#endif
+  for (; x < width; ++x)
+    dst[x] = BlendPixel(src[x], alpha, dst[x]);
+}
+
+void DCheckPixmapArgs(const SkPixmap& src,
+                      const Point& src_origin,
+                      const SkPixmap& dst,
+                      const Rect& dst_rect) {
+  DCHECK_EQ(src.info().bytesPerPixel(), 4);
+  DCHECK_EQ(dst.info().bytesPerPixel(), 4);
+  DCHECK(Rect(dst.width(), dst.height()).Contains(dst_rect));
+  DCHECK(Rect(src.width(), src.height())
+             .Contains(Rect(src_origin, dst_rect.size())));
+}
+
 // Returns true if the given canvas has any part of itself clipped out or
 // any non-identity tranform.
 bool HasClipOrTransform(SkCanvas& canvas) {
@@ -96,4 +219,37 @@ void ScrollCanvas(SkCanvas* canvas,
   }
 }
 
+void FillPixels(SkPixmap* dst, const Rect& rect, uint32_t pixel) {
+  DCHECK_EQ(dst->info().bytesPerPixel(), 4);
+  DCHECK(Rect(dst->width(), dst->height()).Contains(rect));
+  for (int y = rect.y(); y < rect.bottom(); ++y)
+    FillRow(dst->writable_addr32(rect.x(), y), rect.width(), pixel);
+}
+
+void CopyPixels(const SkPixmap& src,
+                const Point& src_origin,
+                SkPixmap* dst,
+                const Rect& dst_rect) {
+  DCheckPixmapArgs(src, src_origin, *dst, dst_rect);
+  // memcpy is vectorized already.
+  size_t row_bytes = dst_rect.width() * 4;
+  for (int y = 0; y < dst_rect.height(); ++y) {
+    memcpy(dst->writable_addr32(dst_rect.x(), dst_rect.y() + y),
+           src.addr32(src_origin.x(), src_origin.y() + y), row_bytes);
+  }
+}
+
+void BlendPixels(const SkPixmap& src,
+                 const Point& src_origin,
+                 uint8_t alpha,
+                 SkPixmap* dst,
+                 const Rect& dst_rect) {
+  DCheckPixmapArgs(src, src_origin, *dst, dst_rect);
+  for (int y = 0; y < dst_rect.height(); ++y) {
+    BlendRow(src.addr32(src_origin.x(), src_origin.y() + y), alpha,
+             dst->writable_addr32(dst_rect.x(), dst_rect.y() + y),
+             dst_rect.width());
+  }
+}
+
 }  // namespace gfx
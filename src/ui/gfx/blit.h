@@ -5,13 +5,17 @@
 #ifndef UI_GFX_BLIT_H_
 #define UI_GFX_BLIT_H_
 
+#include <stdint.h>
+
 #include "ui/gfx/gfx_export.h"
 #include "ui/gfx/native_widget_types.h"
 
 class SkCanvas;
+class SkPixmap;
 
 namespace gfx {
 
+class Point;
 class Rect;
 class Vector2d;
 
@@ -22,6 +26,30 @@ GFX_EXPORT void ScrollCanvas(SkCanvas* canvas,
                              const Rect& clip,
                              const Vector2d& offset);
 
+// The kernels below composite 32-bit premultiplied pixels with the alpha in
+// the high byte, such as kN32_SkColorType pixels. |dst_rect| must lie within
+// |dst|, and the rect of the same size at |src_origin| within |src|. They use
+// SSE2 or NEON where available.
+
+// Replaces the pixels in |rect| of |dst| with |pixel|.
+GFX_EXPORT void FillPixels(SkPixmap* dst, const Rect& rect, uint32_t pixel);
+
+// Replaces the pixels in |dst_rect| of |dst| with the pixels of |src| from
+// |src_origin| on.
+GFX_EXPORT void CopyPixels(const SkPixmap& src,
+                           const Point& src_origin,
+                           SkPixmap* dst,
+                           const Rect& dst_rect);
+
+// Blends the pixels of |src| from |src_origin| on, scaled by |alpha|, over the
+// pixels in |dst_rect| of |dst|, i.e. with SkBlendMode::kSrcOver. Every
+// multiplication of two 8-bit values is rounded to the nearest 8-bit value.
+GFX_EXPORT void BlendPixels(const SkPixmap& src,
+                            const Point& src_origin,
+                            uint8_t alpha,
+                            SkPixmap* dst,
+                            const Rect& dst_rect);
+
 }  // namespace gfx
 
 #endif  // UI_GFX_BLIT_H_
@@ -4,10 +4,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+
 #include "base/memory/platform_shared_memory_region.h"
 #include "build/build_config.h"
 #include "skia/ext/platform_canvas.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/blit.h"
 #include "ui/gfx/geometry/point.h"
 #include "ui/gfx/geometry/rect.h"
@@ -58,6 +61,42 @@ void VerifyCanvasValues(SkCanvas* canvas, uint8_t values[h][w]) {
   }
 }
 
+// Returns a premultiplied pixel that varies with |x| and |y| and whose alpha
+// covers every value over a few rows.
+uint32_t MakePixel(int x, int y) {
+  uint32_t alpha = (x * 37 + y * 11) & 0xff;
+  uint32_t red = (x * 13 + y * 7) % (alpha + 1);
+  uint32_t green = (x * 5 + y * 29) % (alpha + 1);
+  uint32_t blue = (x + y * 3) % (alpha + 1);
+  return (alpha << 24) | (red << 16) | (green << 8) | blue;
+}
+
+SkBitmap MakeBitmap(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      *bitmap.getAddr32(x, y) = MakePixel(x, y);
+  }
+  return bitmap;
+}
+
+// Rounds |a| * |b| / 255 to the nearest integer.
+uint32_t ExpectedMul(uint32_t a, uint32_t b) {
+  return (a * b + 127) / 255;
+}
+
+uint32_t ExpectedBlend(uint32_t src, uint8_t alpha, uint32_t dst) {
+  uint32_t inverse_alpha = 255 - ExpectedMul(src >> 24, alpha);
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t channel = ExpectedMul((src >> shift) & 0xff, alpha) +
+                       ExpectedMul((dst >> shift) & 0xff, inverse_alpha);
+    result |= std::min(channel, 255u) << shift;
+  }
+  return result;
+}
+
 }  // namespace
 
 TEST(Blit, ScrollCanvas) {
@@ -143,6 +182,79 @@ TEST(Blit, ScrollCanvas) {
   VerifyCanvasValues<5, 5>(canvas.get(), scroll_diagonal_expected);
 }
 
+// The widths below cover both the vector loops and their tails.
+TEST(Blit, FillPixels) {
+  SkBitmap bitmap = MakeBitmap(21, 6);
+  SkPixmap pixmap = bitmap.pixmap();
+  const gfx::Rect rect(1, 2, 19, 3);
+  gfx::FillPixels(&pixmap, rect, 0x80402010);
+
+  for (int y = 0; y < bitmap.height(); ++y) {
+    for (int x = 0; x < bitmap.width(); ++x) {
+      uint32_t expected = rect.Contains(x, y) ? 0x80402010 : MakePixel(x, y);
+      ASSERT_EQ(expected, *bitmap.getAddr32(x, y)) << x << "," << y;
+    }
+  }
+}
+
+TEST(Blit, CopyPixels) {
+  SkBitmap src = MakeBitmap(24, 8);
+  SkBitmap dst;
+  dst.allocN32Pixels(20, 8);
+  dst.eraseColor(SK_ColorBLUE);
+  SkPixmap dst_pixmap = dst.pixmap();
+  const gfx::Point src_origin(3, 1);
+  const gfx::Rect dst_rect(2, 3, 17, 5);
+  gfx::CopyPixels(src.pixmap(), src_origin, &dst_pixmap, dst_rect);
+
+  for (int y = 0; y < dst.height(); ++y) {
+    for (int x = 0; x < dst.width(); ++x) {
+      uint32_t expected = SkPreMultiplyColor(SK_ColorBLUE);
+      if (dst_rect.Contains(x, y)) {
+        expected = MakePixel(x - dst_rect.x() + src_origin.x(),
+                             y - dst_rect.y() + src_origin.y());
+      }
+      ASSERT_EQ(expected, *dst.getAddr32(x, y)) << x << "," << y;
+    }
+  }
+}
+
+TEST(Blit, BlendPixels) {
+  SkBitmap src = MakeBitmap(40, 16);
+  const gfx::Point src_origin(1, 2);
+  const gfx::Rect dst_rect(3, 1, 37, 13);
+  for (int alpha : {255, 254, 128, 1, 0}) {
+    SCOPED_TRACE(alpha);
+    SkBitmap dst = MakeBitmap(41, 14);
+    // Makes the destination differ from the source where they overlap.
+    for (int y = 0; y < dst.height(); ++y) {
+      for (int x = 0; x < dst.width(); ++x)
+        *dst.getAddr32(x, y) = MakePixel(y * 3, x * 7);
+    }
+    SkBitmap original;
+    original.allocN32Pixels(dst.width(), dst.height());
+    ASSERT_TRUE(dst.readPixels(original.pixmap()));
+
+    SkPixmap dst_pixmap = dst.pixmap();
+    gfx::BlendPixels(src.pixmap(), src_origin, static_cast<uint8_t>(alpha),
+                     &dst_pixmap, dst_rect);
+
+    for (int y = 0; y < dst.height(); ++y) {
+      for (int x = 0; x < dst.width(); ++x) {
+        uint32_t expected = *original.getAddr32(x, y);
+        if (dst_rect.Contains(x, y)) {
+          uint32_t src_pixel =
+              *src.getAddr32(x - dst_rect.x() + src_origin.x(),
+                             y - dst_rect.y() + src_origin.y());
+          expected = ExpectedBlend(src_pixel, static_cast<uint8_t>(alpha),
+                                   expected);
+        }
+        ASSERT_EQ(expected, *dst.getAddr32(x, y)) << x << "," << y;
+      }
+    }
+  }
+}
+
 #if defined(OS_WIN)
 
 TEST(Blit, WithSharedMemory) {
@@ -6,6 +6,8 @@
 
 #include <stdlib.h>
 
+#include <utility>
+
 namespace ui {
 
 void OverlayCandidatesOzone::CheckOverlaySupport(
@@ -13,6 +15,13 @@ void OverlayCandidatesOzone::CheckOverlaySupport(
   NOTREACHED();
 }
 
+void OverlayCandidatesOzone::CheckOverlaySupportAsync(
+    OverlaySurfaceCandidateList surfaces,
+    CheckOverlaySupportCallback callback) {
+  CheckOverlaySupport(&surfaces);
+  std::move(callback).Run(std::move(surfaces));
+}
+
 OverlayCandidatesOzone::~OverlayCandidatesOzone() {}
 
 }  // namespace ui
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "base/callback.h"
 #include "base/component_export.h"
 #include "ui/ozone/public/overlay_surface_candidate.h"
 
@@ -18,6 +19,8 @@ namespace ui {
 class COMPONENT_EXPORT(OZONE_BASE) OverlayCandidatesOzone {
  public:
   using OverlaySurfaceCandidateList = std::vector<OverlaySurfaceCandidate>;
+  using CheckOverlaySupportCallback =
+      base::OnceCallback<void(OverlaySurfaceCandidateList surfaces)>;
 
   // A list of possible overlay candidates is presented to this function.
   // The expected result is that those candidates that can be in a separate
@@ -27,6 +30,13 @@ class COMPONENT_EXPORT(OZONE_BASE) OverlayCandidatesOzone {
   // if necessary.
   virtual void CheckOverlaySupport(OverlaySurfaceCandidateList* surfaces);
 
+  // Same as CheckOverlaySupport(), except that the result is passed to
+  // |callback|, which implementations that have to wait for another process
+  // may run later instead of blocking the caller. The default implementation
+  // calls CheckOverlaySupport() and runs |callback| before returning.
+  virtual void CheckOverlaySupportAsync(OverlaySurfaceCandidateList surfaces,
+                                        CheckOverlaySupportCallback callback);
+
   virtual ~OverlayCandidatesOzone();
 };
 
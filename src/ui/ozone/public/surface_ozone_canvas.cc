@@ -23,4 +23,8 @@ int SurfaceOzoneCanvas::MaxFramesPending() const {
   return 1;
 }
 
+int SurfaceOzoneCanvas::GetBufferAge() const {
+  return 1;
+}
+
 }  // namespace ui
@@ -70,6 +70,15 @@ class COMPONENT_EXPORT(OZONE_BASE) SurfaceOzoneCanvas {
 
   // Returns the maximum number of pending frames.
   virtual int MaxFramesPending() const;
+
+  // Returns the number of frames since the contents of the canvas returned by
+  // GetCanvas() were presented, or 0 if they are undefined. Implementations
+  // that present from several buffers without copying the undamaged pixels
+  // between them return the age of the current buffer, and the compositor
+  // redraws whatever changed since then in addition to the damage that it
+  // passes to PresentCanvas(). The default of 1 is for implementations that
+  // draw into a single retained canvas, and is what they all return for now.
+  virtual int GetBufferAge() const;
 };
 
 }  // namespace ui